@@ -243,6 +243,138 @@ bool tokenizer(char *str) // return false if total number of bLineToken.ts is gr
    return true;
 }
 
+/// DEF FN compilation: token_eval_expression emits the RPN sequence instead of evaluating it
+static struct
+{
+   bool active;
+   uint8_t len;
+   uint8_t argc;
+   char **argv;
+   _bas_deffn_code_t code[BASIC_DEFFN_CODE_LEN];
+   uint8_t skip[RPN_STACK_LEN]; // DEFFN_CODE_SKIP entries waiting for their operator
+   uint8_t skipPtr;
+} Compile = {.active = false};
+
+static _bas_err_e compile_emit(uint8_t kind, uint8_t op, _rpn_type_t value)
+{
+   _bas_deffn_code_t *code = &Compile.code[Compile.len];
+   if (Compile.len >= BASIC_DEFFN_CODE_LEN) return BasicError = BASIC_ERR_STACK_FULL;
+   code->kind = kind;
+   code->op = op;
+   code->data.value = value;
+   if ((kind == DEFFN_CODE_CONST) && (value.type == VAR_TYPE_STRING)) // the token buffer is reused by the next line
+   {
+      if ((code->data.value.var.str = arena_alloc(&VarArena, strlen(value.var.str) + 1)) == NULL) return BasicError = BASIC_ERR_MEM_OUT;
+      strcpy(code->data.value.var.str, value.var.str);
+   }
+   Compile.len++;
+   return BasicError = BASIC_ERR_NONE;
+}
+
+static _bas_err_e compile_name(char *name, uint8_t op)
+{
+   _bas_deffn_code_t *code = &Compile.code[Compile.len];
+   if ((op != '[') && (op != '('))
+      for (uint8_t n = 0; n < Compile.argc; n++)
+         if (!strcmp(name, Compile.argv[n]))
+            return compile_emit(DEFFN_CODE_ARG, n, VarNone);
+   if (compile_emit(op == '[' ? DEFFN_CODE_ARRAY : (op == '(' ? DEFFN_CODE_CALL : DEFFN_CODE_VAR), 0, VarNone)) return BasicError;
+   code->data.ref.var = NULL;
+   if ((code->data.ref.name = arena_alloc(&VarArena, strlen(name) + 1)) == NULL) return BasicError = BASIC_ERR_MEM_OUT;
+   strcpy(code->data.ref.name, name);
+   return BasicError = BASIC_ERR_NONE;
+}
+
+static inline _bas_err_e expr_push(_rpn_type_t value)
+{
+   return Compile.active ? compile_emit(DEFFN_CODE_CONST, 0, value) : rpn_push_queue(value);
+}
+
+static inline _bas_err_e expr_eval(uint8_t op)
+{
+#if BASIC_SHORT_CIRCUIT
+   if (Compile.active && ((op == OPERATOR_AND) || (op == OPERATOR_OR)) && Compile.skipPtr)
+      Compile.code[Compile.skip[--Compile.skipPtr]].data.value.var.i = Compile.len + 1; // past the operator
+#endif
+   return Compile.active ? compile_emit(DEFFN_CODE_OP, op, VarNone) : rpn_eval(op);
+}
+
+#if BASIC_SHORT_CIRCUIT
+/// the left operand decides AND/OR: it is replaced by the result and the right one is not evaluated
+static bool expr_decided(uint8_t op, _rpn_type_t *left)
+{
+   bool truth;
+   if (left->type < VAR_TYPE_FLOAT) return false; // strings and markers, rpn_eval reports them
+   truth = (left->type & VAR_TYPE_FLOAT) ? (left->var.f != 0) : (left->var.i != 0);
+   if ((op == OPERATOR_AND) == truth) return false;
+   *left = (_rpn_type_t){.type = VAR_TYPE_BOOL, .var.i = truth};
+   return true;
+}
+
+/// operators binding as loose as AND/OR end the right operand, '^' is stacked right-to-left so it doesn't
+static bool expr_operand_end(uint8_t op)
+{
+   switch (op)
+   {
+   case '\0':
+   case ':':
+   case ';':
+   case ',':
+   case OPERATOR_AND:
+   case OPERATOR_OR:
+   case OPERATOR_BWAND:
+   case OPERATOR_BWOR:
+   case OPERATOR_BWSL:
+   case OPERATOR_BWSR:
+      return true;
+   default:
+      return false;
+   }
+}
+
+/// called on AND/OR with the left operand on top of the queue, skips the right operand tokens when it is decided
+static bool expr_short_circuit(uint8_t op)
+{
+   uint8_t depth = 0, last = bToken->ptr;
+   bool closed = false;
+   if (Compile.active) // decided when the function runs
+   {
+      if (Compile.skipPtr >= RPN_STACK_LEN) return false;
+      Compile.skip[Compile.skipPtr++] = Compile.len;
+      compile_emit(DEFFN_CODE_SKIP, op, VarNone);
+      return false;
+   }
+   if (!rpn_len_queue()) return false;
+   for (uint8_t i = bToken->ptr + 1; i < PARSER_MAX_TOKENS; last = i++)
+   {
+      char *str = bToken->t[i].str;
+      uint8_t tokOp = bToken->t[i].op;
+      if (!str || (((uint8_t)*str & OPCODE_MASK) && ((uint8_t)*str < FUNC_TYPE_SECONDARY))) // THEN and the like
+         break;
+      last = i;
+      closed = false;
+      if ((tokOp == '(') || (tokOp == '['))
+         depth++;
+      else if ((tokOp == ')') || (tokOp == ']'))
+      {
+         if (!depth)
+            break; // closes the bracket around the AND/OR
+         depth--;
+         closed = true;
+      }
+      else if (!depth && expr_operand_end(tokOp))
+         break;
+   }
+   if (last == bToken->ptr) return false; // no right operand, let the evaluation report it
+   if (!expr_decided(op, rpn_at_queue(rpn_len_queue() - 1))) return false;
+   bToken->t[last].str = ""; // only the delimiter of the last skipped token is processed
+   if (closed)
+      bToken->t[last].op = ' '; // unless it closes a bracket of the skipped operand
+   bToken->ptr = last - 1;
+   return true;
+}
+#endif
+
 _bas_err_e token_eval_expression(uint8_t opParam) // if subEval is true, the will evaluate the first bracked expression, including function
 {
 #define RPN_PRINT_DEBUG 0
@@ -272,25 +404,41 @@ _bas_err_e token_eval_expression(uint8_t opParam) // if subEval is true, the wil
          if (*tokenStr == '\"')
          {
             tokenStr[strlen(tokenStr) - 1] = '\0'; // remove the last quote
-            rpn_push_queue(RPN_STR(tokenStr + 1)); // store without the first quote
+            expr_push(RPN_STR(tokenStr + 1)); // store without the first quote
          }
          else if (is_digit(*tokenStr) || (*tokenStr == '-') || (*tokenStr == '.')) // support numbers, negative numbers and float numbers starting with .
          {
             if ((tokenStr[1] != 'x') && (strchr(tokenStr, '.') || strchr(tokenStr, 'E') || strchr(tokenStr, 'e')))
-               rpn_push_queue(RPN_FLOAT(atof(tokenStr)));
+               expr_push(RPN_FLOAT(atof(tokenStr)));
             else
-               rpn_push_queue(RPN_INT(tokenStr[1] == 'b' ? strtol((char *)(tokenStr + 2), NULL, 2) : strtol(tokenStr, NULL, 0)));
+               expr_push(RPN_INT(tokenStr[1] == 'b' ? strtol((char *)(tokenStr + 2), NULL, 2) : strtol(tokenStr, NULL, 0)));
+         }
+         else if (Compile.active && ((uint8_t)*tokenStr < OPCODE_MASK)) // names are looked up by the call
+         {
+            uint8_t op = bToken->t[bToken->ptr].op;
+            if (compile_name(tokenStr, op)) return BasicError;
+            if ((op == '[') || (op == '('))
+            {
+               if (rpn_push_stack(op == '[' ? __OPCODE_ARRAY : __OPCODE_DEFFN) != BASIC_ERR_NONE) return BasicError;
+               if (rpn_push_stack(op) != BASIC_ERR_NONE) return BasicError;
+               bToken->parCnt++;
+               continue;
+            }
          }
          else
          {
             if ((variable = var_get(bToken->t[bToken->ptr].str)) != NULL)
             {
-               if (variable->value.type & VAR_TYPE_ARRAY) // array
+               if ((variable->value.type & VAR_TYPE_ARRAY) && (bToken->t[bToken->ptr].op != '[')) // whole array, for the array functions
+               {
+                  if (bToken->t[bToken->ptr].op == '(') return BasicError = BASIC_ERR_PAR_MISMATCH;
+                  expr_push((_rpn_type_t){.type = VAR_TYPE_ARRAY, .var.array = variable});
+               }
+               else if (variable->value.type & VAR_TYPE_ARRAY) // array
                {
-                  if (bToken->t[bToken->ptr].op != '[') return BasicError = BASIC_ERR_PAR_MISMATCH;
                   if (rpn_push_stack(__OPCODE_ARRAY) != BASIC_ERR_NONE) return BasicError;
                   if (rpn_push_stack('[') != BASIC_ERR_NONE) return BasicError;
-                  if (rpn_push_queue((_rpn_type_t){
+                  if (expr_push((_rpn_type_t){
                           .type = VAR_TYPE_ARRAY, .var.array = variable}) != BASIC_ERR_NONE) return BasicError;
                   bToken->parCnt++;
                   continue;
@@ -300,13 +448,13 @@ _bas_err_e token_eval_expression(uint8_t opParam) // if subEval is true, the wil
                   if (bToken->t[bToken->ptr].op != '(') return BasicError = BASIC_ERR_PAR_MISMATCH;
                   if (rpn_push_stack(__OPCODE_DEFFN) != BASIC_ERR_NONE) return BasicError;
                   if (rpn_push_stack('(') != BASIC_ERR_NONE) return BasicError;
-                  if (rpn_push_queue((_rpn_type_t){
+                  if (expr_push((_rpn_type_t){
                           .type = VAR_TYPE_DEFFN, .var.deffn = variable}) != BASIC_ERR_NONE) return BasicError;
                   bToken->parCnt++;
                   continue;
                }
                else
-                  rpn_push_queue(variable->value);
+                  expr_push(variable->value);
             }
             else
             {
@@ -336,12 +484,12 @@ _bas_err_e token_eval_expression(uint8_t opParam) // if subEval is true, the wil
          if (bToken->parCnt) // evaluate inside the brackets
          {
             while (rpn_peek_stack_last() != '(' && rpn_peek_stack_last() != '[')
-               if (rpn_eval(rpn_pull_stack()) != BASIC_ERR_NONE) return BasicError;
+               if (expr_eval(rpn_pull_stack()) != BASIC_ERR_NONE) return BasicError;
          }
          else // evaluate the stack and store in the queue
          {
             while ((opCode = rpn_pull_stack())) // && (opCode != '(') && (opCode != '['))
-               if (rpn_eval(opCode) != BASIC_ERR_NONE) return BasicError;
+               if (expr_eval(opCode) != BASIC_ERR_NONE) return BasicError;
          }
          break;
       case '(':
@@ -356,23 +504,25 @@ _bas_err_e token_eval_expression(uint8_t opParam) // if subEval is true, the wil
          while (rpn_peek_stack_last() != '(' && rpn_peek_stack_last() != '[')
          {
             if (!rpn_peek_stack_last()) return BasicError = BASIC_ERR_PAR_MISMATCH;
-            if (rpn_eval(rpn_pull_stack()) != BASIC_ERR_NONE) break;
+            if (expr_eval(rpn_pull_stack()) != BASIC_ERR_NONE) break;
          }
          rpn_pull_stack(); // remove the opening bracket
          if (rpn_peek_stack_last() > OPCODE_MASK)
-            if (rpn_eval(rpn_pull_stack()) != BASIC_ERR_NONE) return BasicError; // evaluate function
+            if (expr_eval(rpn_pull_stack()) != BASIC_ERR_NONE) return BasicError; // evaluate function
          break;
       case '^': // ^ is evaluated right-to-left, natively to RPN, so just stack it
          rpn_push_stack(bToken->t[bToken->ptr].op);
          break;
       default:
-         if (get_precedence(bToken->t[bToken->ptr].op) > get_precedence(rpn_peek_stack_last())) rpn_push_stack(bToken->t[bToken->ptr].op);
-         else
-         {
+         if (get_precedence(bToken->t[bToken->ptr].op) <= get_precedence(rpn_peek_stack_last()))
             while ((rpn_peek_stack_last() != '(' && rpn_peek_stack_last() != '[') && (get_precedence(bToken->t[bToken->ptr].op) <= get_precedence(rpn_peek_stack_last())))
-               if (rpn_eval(rpn_pull_stack()) != BASIC_ERR_NONE) break;
-            rpn_push_stack(bToken->t[bToken->ptr].op);
-         }
+               if (expr_eval(rpn_pull_stack()) != BASIC_ERR_NONE) break;
+#if BASIC_SHORT_CIRCUIT
+         if (!BasicError && ((bToken->t[bToken->ptr].op == OPERATOR_AND) || (bToken->t[bToken->ptr].op == OPERATOR_OR)) &&
+             expr_short_circuit(bToken->t[bToken->ptr].op))
+            break; // the result is in the queue, the operator is not needed
+#endif
+         rpn_push_stack(bToken->t[bToken->ptr].op);
       }
 #if RPN_PRINT_DEBUG
       rpn_print_queue(true);
@@ -385,7 +535,7 @@ _bas_err_e token_eval_expression(uint8_t opParam) // if subEval is true, the wil
    if (bToken->parCnt) return BasicError = BASIC_ERR_PAR_MISMATCH;
    while ((opCode = rpn_pull_stack()))
    {
-      rpn_eval(opCode);
+      expr_eval(opCode);
       taskYIELD();
 #if RPN_PRINT_DEBUG
       rpn_print_queue(true);
@@ -396,3 +546,78 @@ _bas_err_e token_eval_expression(uint8_t opParam) // if subEval is true, the wil
    }
    return BasicError; // = bToken->parCnt ? BASIC_ERR_PAR_MISMATCH : BASIC_ERR_NONE;
 }
+
+/// compile the expression from the current token up to the end of the statement
+_bas_deffn_t *token_compile_expression(char **argv, uint8_t argc)
+{
+   _bas_deffn_t *fn = NULL;
+   Compile.active = true;
+   Compile.len = 0;
+   Compile.argc = argc;
+   Compile.argv = argv;
+   Compile.skipPtr = 0;
+   if (!token_eval_expression(0) && !Compile.len)
+      BasicError = BASIC_ERR_MISSING_OPERAND;
+   Compile.active = false;
+   rpn_purge_queue();
+   if (BasicError)
+      return NULL;
+   if ((fn = arena_alloc(&VarArena, sizeof(_bas_deffn_t) + Compile.len * sizeof(_bas_deffn_code_t))) == NULL)
+   {
+      BasicError = BASIC_ERR_MEM_OUT;
+      return NULL;
+   }
+   fn->argc = argc;
+   fn->len = Compile.len;
+   memcpy(fn->code, Compile.code, Compile.len * sizeof(_bas_deffn_code_t));
+   return fn;
+}
+
+/// run a compiled body, the arguments are the queue values from "base" on
+_bas_err_e deffn_exec(_bas_deffn_t *fn, uint8_t base)
+{
+   _bas_var_t *var;
+   for (_bas_deffn_code_t *code = fn->code; code < fn->code + fn->len; code++)
+   {
+      switch (code->kind)
+      {
+      case DEFFN_CODE_CONST:
+         rpn_push_queue(code->data.value);
+         break;
+      case DEFFN_CODE_ARG:
+         rpn_push_queue(*rpn_at_queue(base + code->op));
+         break;
+      case DEFFN_CODE_OP:
+         rpn_eval(code->op);
+         break;
+#if BASIC_SHORT_CIRCUIT
+      case DEFFN_CODE_SKIP:
+         if (rpn_len_queue() > base && expr_decided(code->op, rpn_at_queue(rpn_len_queue() - 1)))
+            code = fn->code + code->data.value.var.i - 1;
+         break;
+#endif
+      default:
+         if (!(var = code->data.ref.var) && ((var = code->data.ref.var = var_get(code->data.ref.name)) == NULL))
+            return BasicError = BASIC_ERR_UNKNOWN_VAR;
+         if (code->kind == DEFFN_CODE_ARRAY)
+         {
+            if (!(var->value.type & VAR_TYPE_ARRAY)) return BasicError = BASIC_ERR_TYPE_MISMATCH;
+            rpn_push_queue((_rpn_type_t){.type = VAR_TYPE_ARRAY, .var.array = var});
+         }
+         else if (code->kind == DEFFN_CODE_CALL)
+         {
+            if (!(var->value.type & VAR_TYPE_DEFFN)) return BasicError = BASIC_ERR_UNKNOWN_FUNC;
+            rpn_push_queue((_rpn_type_t){.type = VAR_TYPE_DEFFN, .var.deffn = var});
+         }
+         else if (var->value.type & VAR_TYPE_ARRAY) // whole array
+            rpn_push_queue((_rpn_type_t){.type = VAR_TYPE_ARRAY, .var.array = var});
+         else
+         {
+            if (var->value.type & VAR_TYPE_DEFFN) return BasicError = BASIC_ERR_PAR_MISMATCH;
+            rpn_push_queue(var->value);
+         }
+      }
+      if (BasicError) return BasicError;
+   }
+   return BasicError = BASIC_ERR_NONE;
+}
@@ -40,6 +40,40 @@ typedef struct __attribute ((packed))
     uint8_t parCnt;
 } _bas_tok_list_t;
 
+enum
+{
+    DEFFN_CODE_CONST, // push the value
+    DEFFN_CODE_ARG,   // push the argument "op" of the call frame
+    DEFFN_CODE_VAR,   // push a variable, looked up by name on the first call
+    DEFFN_CODE_ARRAY, // array element access, the marker followed by the indexes
+    DEFFN_CODE_CALL,  // defined function call, the marker followed by the arguments
+    DEFFN_CODE_OP,    // operator or built in function "op"
+    DEFFN_CODE_SKIP,  // AND/OR "op" decided by the left operand, continue from .value.var.i
+};
+
+typedef struct
+{
+    uint8_t kind;
+    uint8_t op;
+    union
+    {
+        _rpn_type_t value;
+        struct
+        {
+            char *name;
+            _bas_var_t *var;
+        } ref;
+    } data;
+} _bas_deffn_code_t;
+
+/// DEF FN body compiled to RPN, the arguments are read from the caller's queue
+typedef struct
+{
+    uint8_t argc;
+    uint8_t len;
+    _bas_deffn_code_t code[];
+} _bas_deffn_t;
+
 bool tok_list_push(_bas_tok_list_t *tokensList);
 bool tok_list_pull(void);
 
@@ -47,5 +81,7 @@ extern _bas_tok_list_t *bToken;
 _bas_var_t *var_get(char *name);
 bool tokenizer(char *str);
 _bas_err_e token_eval_expression(uint8_t opParam);
+_bas_deffn_t *token_compile_expression(char **argv, uint8_t argc);
+_bas_err_e deffn_exec(_bas_deffn_t *fn, uint8_t base);
 
 #endif //_BANALIZER_H_INCLUDED
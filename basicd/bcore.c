@@ -37,6 +37,7 @@
 #include "rshell.h"
 #include "task.h"
 #include "uterm.h"
+#include <float.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -63,10 +64,18 @@ _bas_ptr_t ContLine;
 _bas_var_t *BasicVars = NULL;
 _bas_line_t *BasicLineZero = NULL;
 static _bas_line_t *bL;
+static _bas_line_t *ProgLast = NULL; // the highest numbered line, NULL if unknown
 static _bas_line_t *contbL = NULL;
+static bool ProgRom = false; // BasicProg runs from a flash table, copied to the arena on the first edit
 
 uint8_t tmpBasicLine[BASIC_LINE_LEN];
 _bas_gosub_t GosubStack = {.ptr = 0};
+_bas_line_t *JumpLine = NULL;  // resolved jump target, BASIC_STAT_JUMP seeks ExecLine.number when NULL
+uint16_t ProgRevision = 0;     // bumped on every program change, invalidates the line pointers kept by loops
+_bas_loop_t *LoopCache[BASIC_LOOP_CACHE];
+_bas_on_t OnCache[BASIC_ON_CACHE];
+_bas_block_stack_t BlockStack = {.ptr = 0};
+_bas_wend_t WendCache[BASIC_WEND_CACHE];
 /*
 _bas_var_t BasicConstants[] =
 {
@@ -88,6 +97,189 @@ void basic_putch(char cc)
    }
 }
 
+/// basicStream block output, the column is kept local between the line breaks
+void basic_write(const char *buf, uint16_t len)
+{
+   uint8_t col = uTerm.cursorCol, lastCol = uTerm.cols - 1;
+   while (len--)
+   {
+      char cc = *buf++;
+      if (cc != '\n')
+      {
+         glyph_xy(col, uTerm.cursorLine, glyphChar(cc));
+         if (col < lastCol)
+         {
+            col++;
+            continue;
+         }
+      }
+      uTerm.cursorCol = col;
+      ut_new_line(1);
+      col = uTerm.cursorCol;
+   }
+   uTerm.cursorCol = col;
+}
+
+/// PRINT output is collected and handed to the stream in one write per statement
+static struct
+{
+   char str[BASIC_PRINT_BUFFER];
+   uint16_t len;
+} PrintBuf = {.len = 0};
+
+void basic_print_flush(void)
+{
+   if (!PrintBuf.len) return;
+   if (stdio->write)
+      stdio->write(PrintBuf.str, PrintBuf.len);
+   else
+      for (uint16_t i = 0; i < PrintBuf.len; i++)
+         stdio->putch(PrintBuf.str[i]);
+   PrintBuf.len = 0;
+}
+
+void basic_print(const char *str, uint16_t len)
+{
+   while (len)
+   {
+      uint16_t part = BASIC_PRINT_BUFFER - PrintBuf.len;
+      if (part > len) part = len;
+      memcpy(PrintBuf.str + PrintBuf.len, str, part);
+      PrintBuf.len += part;
+      str += part;
+      len -= part;
+      if (PrintBuf.len == BASIC_PRINT_BUFFER) basic_print_flush();
+   }
+}
+
+/// Number formatters, two digits per division and no format string parsing
+static const char DigitPairs[200] =
+   "0001020304050607080910111213141516171819"
+   "2021222324252627282930313233343536373839"
+   "4041424344454647484950515253545556575859"
+   "6061626364656667686970717273747576777879"
+   "8081828384858687888990919293949596979899";
+static const char HexDigits[16] = "0123456789ABCDEF";
+static const uint32_t Pow10[10] = {1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000};
+
+static uint8_t num_utoa(char *buf, uint32_t val)
+{
+   uint8_t len = 1;
+   while (len < 10 && val >= Pow10[len])
+      len++;
+   char *p = buf + len;
+   *p = '\0';
+   while (val >= 100)
+   {
+      uint32_t pair = (val % 100) * 2;
+      val /= 100;
+      *--p = DigitPairs[pair + 1];
+      *--p = DigitPairs[pair];
+   }
+   if (val >= 10)
+   {
+      *--p = DigitPairs[val * 2 + 1];
+      *--p = DigitPairs[val * 2];
+   }
+   else
+      *--p = '0' + val;
+   return len;
+}
+
+uint8_t num_itoa(char *buf, int32_t val)
+{
+   if (val >= 0)
+      return num_utoa(buf, val);
+   *buf = '-';
+   return num_utoa(buf + 1, -(uint32_t)val) + 1;
+}
+
+/// The integer part of a float past 2^32 doesn't fit num_utoa, it is written as d.ddde+NN
+static uint8_t num_etoa(char *buf, float mag, uint8_t decimals)
+{
+   double m = mag / 1e9; // mag is 2^32 at least
+   uint8_t exp = 9, len;
+   if (mag > FLT_MAX)
+   {
+      memcpy(buf, "inf", 4);
+      return 3;
+   }
+   while (m >= 10.0)
+   {
+      m /= 10.0;
+      exp++;
+   }
+   if (m >= 10.0 - 0.5 / Pow10[decimals]) // 9.9996 would round to 10.0
+   {
+      m /= 10.0;
+      exp++;
+   }
+   len = num_ftoa(buf, (float)m, decimals);
+   buf[len++] = 'e';
+   buf[len++] = '+';
+   return len + num_utoa(buf + len, exp);
+}
+
+/// tftoa(val, decimals) output: rounded, trailing zeros dropped, at least one decimal.
+/// Unlike tftoa the rounding carries into the integer part, 0.9999 is 1.0 and not 0.0,
+/// and a value past 2^32 has an exponent instead of the integer part stuck at 4294967295
+uint8_t num_ftoa(char *buf, float val, uint8_t decimals)
+{
+   char *p = buf;
+   float mag = (val < 0) ? -val : val;
+   if (mag != mag) // NaN
+   {
+      memcpy(buf, "nan", 4);
+      return 3;
+   }
+   if (mag < 5e-7f)
+   {
+      memcpy(buf, "0.0", 4);
+      return 3;
+   }
+   if (decimals < 1)
+      decimals = 1;
+   if (decimals > NUM_DECIMALS)
+      decimals = NUM_DECIMALS;
+   if (val < 0)
+      *p++ = '-';
+   if (mag >= 4294967296.0f)
+      return p - buf + num_etoa(p, mag, decimals);
+   uint32_t ip = (uint32_t)mag;
+   uint32_t fp = (uint32_t)((mag - (float)ip) * (float)Pow10[decimals + 1]);
+   fp = fp / 10 + (fp % 10 > 4);
+   if (fp >= Pow10[decimals]) // rounded up to the next integer, below 2^32 still: a float this close to it has no fraction
+   {
+      fp -= Pow10[decimals];
+      ip++;
+   }
+   while (decimals > 1 && !(fp % 10))
+   {
+      fp /= 10;
+      decimals--;
+   }
+   p += num_utoa(p, ip);
+   *p++ = '.';
+   p[decimals] = '\0';
+   for (uint8_t i = decimals; i--; fp /= 10)
+      p[i] = '0' + fp % 10;
+   return p + decimals - buf;
+}
+
+/// Upper case hex, zero padded to width digits
+uint8_t num_htoa(char *buf, uint32_t val, uint8_t width)
+{
+   uint8_t len = 1;
+   while (len < 8 && (val >> (len * 4)))
+      len++;
+   if (len < width)
+      len = width;
+   buf[len] = '\0';
+   for (uint8_t i = len; i--; val >>= 4)
+      buf[i] = HexDigits[val & 0x0f];
+   return len;
+}
+
 _bas_var_t *var_get(char *name)
 {
    _bas_var_t *varPtr = BasicVars; // BasicConstants;
@@ -112,14 +304,14 @@ _bas_var_t *var_add(char *name)
       varSize = (varSize & ~(0x03)) + 4; // allign to 4
    if (!BasicVars)                       // new var
    {
-      BasicVars = pvPortMalloc(varSize);
+      BasicVars = arena_alloc(&VarArena, varSize);
       varPtr = BasicVars;
    }
    else
    {
       while (varPtr->next)
          varPtr = varPtr->next;
-      varPtr->next = pvPortMalloc(varSize);
+      varPtr->next = arena_alloc(&VarArena, varSize);
       if (varPtr->next == NULL)
       {
          BasicError = BASIC_ERR_MEM_OUT;
@@ -130,11 +322,13 @@ _bas_var_t *var_add(char *name)
    varPtr->next = NULL; ///--- already null;
    strcpy(varPtr->name, name);
    varPtr->value.type = VAR_TYPE_FLOAT; 
+   varPtr->value.var.i = 0;
    if (nameLen > 1) // single character variable is always float
       switch (*typeQ--)
       {
       case '$':
          varPtr->value.type = VAR_TYPE_STRING;
+         varPtr->value.var.str = "";
          break;
       case 'b':
          if (*typeQ == '.') varPtr->value.type = VAR_TYPE_BYTE;
@@ -148,14 +342,16 @@ _bas_var_t *var_add(char *name)
       default:
          varPtr->value.type = VAR_TYPE_FLOAT;
       }
-   varPtr->param.size[0] = 0;
+   varPtr->param.loop = NULL; // clears size[] as well, an integer FOR counter keeps its loop here
    return varPtr;
 }
 
 _bas_line_t *prog_find_line(uint16_t number)
 {
    _bas_line_t *line = BasicProg;
-   while (line)
+   if (ProgLast && (number > ProgLast->number)) // appending, the usual case on LOAD
+      return NULL;
+   while (line && (line->number <= number))
       if (line->number == number)
          return line;
       else
@@ -163,6 +359,14 @@ _bas_line_t *prog_find_line(uint16_t number)
    return NULL;
 }
 
+static _bas_line_t *prog_last_line(void)
+{
+   if (!ProgLast && (ProgLast = BasicProg))
+      while (ProgLast->next)
+         ProgLast = ProgLast->next;
+   return ProgLast;
+}
+
 uint8_t *basic_line_totext(uint8_t *line) /// look for an opcode name and replace it with function name
 {
    bool quoted = false;
@@ -174,7 +378,7 @@ uint8_t *basic_line_totext(uint8_t *line) /// look for an opcode name and replac
       if (destPtr > (BASIC_LINE_LEN - 2))
          break;
 
-      if (*line == '\'' || remarked) // REM found
+      if ((*line == '\'' && !quoted) || remarked) // REM found, an apostrophe in quotes is text
       {
          while (*line && (destPtr < (BASIC_LINE_LEN - 1)))
             tmpBasicLine[destPtr++] = *line++;
@@ -206,7 +410,7 @@ uint8_t *basic_line_totext(uint8_t *line) /// look for an opcode name and replac
             remarked = true; // REM found
          while (*opName)
             tmpBasicLine[destPtr++] = *(opName++);
-         if (*line == OPERATOR_NOT)
+         if ((*line == OPERATOR_NOT) && (line[1] != ' ')) // "not x" keeps its own space
             tmpBasicLine[destPtr++] = ' ';
          opName = NULL;
       }
@@ -300,12 +504,156 @@ uint8_t *basic_line_preprocess(
    return tmpBasicLine;
 }
 
+/// index the statement starts, so a FOR/NEXT or RETURN into the middle of a line doesn't rescan it
+static void prog_line_index(_bas_line_t *bLine)
+{
+   bool quoted = false;
+   uint8_t *str = bLine->string;
+   bLine->stmtCount = 0;
+   for (uint8_t i = 0; str[i] && bLine->stmtCount < BASIC_STMT_INDEX; i++)
+   {
+      if (str[i] == '\"')
+      {
+         if (!quoted || str[i - 1] != '\\')
+            quoted = !quoted;
+         continue;
+      }
+      if (quoted)
+         continue;
+      if (str[i] == '\'' || str[i] == __OPCODE_REM)
+         break;
+      if (str[i] == ':')
+         bLine->stmtOffset[bLine->stmtCount++] = i + 1;
+   }
+}
+
+/// copy the lines into fresh chunks once the freed space outweighs the live one
+static void prog_compact(void)
+{
+   _bas_arena_t old;
+   _bas_line_t *newProg = NULL, *newZero = NULL, *newbL = NULL, *newcontbL = NULL;
+   _bas_line_t *tail = NULL, *copy;
+   if ((ProgArena.garbage < BASIC_ARENA_CHUNK) || (ProgArena.garbage < ProgArena.used))
+      return;
+   if (xPortGetFreeHeapSize() < ProgArena.used + 2 * BASIC_ARENA_CHUNK) // both copies exist for a while
+      return;
+   arena_detach(&ProgArena, &old);
+   for (_bas_line_t *bLine = BasicProg; bLine; bLine = bLine->next)
+   {
+      if ((copy = arena_dup(&ProgArena, bLine)) == NULL)
+         goto fail;
+      if (tail)
+         tail->next = copy;
+      else
+         newProg = copy;
+      tail = copy;
+      if (bLine == bL) newbL = copy;
+      if (bLine == contbL) newcontbL = copy;
+   }
+   if (BasicLineZero && ((newZero = arena_dup(&ProgArena, BasicLineZero)) == NULL))
+      goto fail;
+   if (BasicLineZero == bL) newbL = newZero;
+   if (BasicLineZero == contbL) newcontbL = newZero;
+   arena_reset(&old);
+   BasicProg = newProg;
+   BasicLineZero = newZero;
+   bL = newbL;
+   contbL = newcontbL;
+   ProgLast = NULL;
+   JumpLine = NULL;
+   ProgRevision++;
+   ProgArena.compactions++;
+   return;
+fail:
+   arena_reset(&ProgArena);
+   ProgArena = old;
+}
+
+/// insert a new line into the program list, in O(1) when it goes to the end
+static void prog_link_line(_bas_line_t *bLine)
+{
+   if (BasicProg == NULL)
+   {
+      BasicProg = bLine; // Start a new program
+   }
+   else if (bLine->number > prog_last_line()->number) // append
+   {
+      ProgLast->next = bLine;
+   }
+   else
+   {
+      if (bLine->number < BasicProg->number) // swap if got smaller line number than the first one
+      {
+         bLine->next = BasicProg;
+         BasicProg = bLine;
+      }
+      else
+      {
+         _bas_line_t *blSeek = BasicProg;
+         while (blSeek->next != NULL)
+         {
+            if (bLine->number > ((_bas_line_t *)(blSeek->next))->number)
+               blSeek = blSeek->next;
+            else // the new line has lower number
+            {
+               bLine->next = blSeek->next; // Insert the new line before higher line
+               blSeek->next = bLine;
+               break;
+            }
+         }
+         if (blSeek->next == NULL) // add to the end
+            blSeek->next = bLine;
+      }
+   }
+}
+
+/// a new line from an already tokenized string
+static _bas_line_t *prog_put_line(uint16_t number, const uint8_t *str, uint16_t size)
+{
+   _bas_line_t *bLine;
+   if ((bLine = arena_alloc(&ProgArena, sizeof(_bas_line_t) + size)) == NULL)
+      return NULL;
+   bLine->number = number;
+   bLine->next = NULL;
+   bLine->len = size;
+   memcpy(bLine->string, str, size);
+   bLine->string[size - 1] = '\0';
+   prog_line_index(bLine);
+   prog_link_line(bLine);
+   if (!bLine->next)
+      ProgLast = bLine;
+   return bLine;
+}
+
+/// copy-on-edit, the ROM lines move to the arena before anything is changed
+static bool prog_rom_copy(void)
+{
+   _bas_line_t *rom = BasicProg, *copy;
+   if (!ProgRom)
+      return true;
+   ProgRom = false;
+   BasicProg = ProgLast = NULL;
+   for (; rom; rom = rom->next)
+   {
+      if ((copy = prog_put_line(rom->number, rom->string, strlen((char *)rom->string) + 1)) == NULL)
+         return false; // the rest of the program is lost
+      if (rom == bL)
+         bL = copy;
+      if (rom == contbL)
+         contbL = copy;
+   }
+   return true;
+}
+
 bool prog_add_line(uint16_t number, uint8_t **line)
 {
    uint16_t lineLen = 0;
+   ProgRevision++;
+   if (number && !prog_rom_copy())
+      return false;
    if (BasicLineZero == NULL)
    {
-      BasicLineZero = pvPortMalloc(sizeof(_bas_line_t));
+      BasicLineZero = arena_alloc(&ProgArena, sizeof(_bas_line_t));
       memset(BasicLineZero, 0x00, sizeof(_bas_line_t));
    }
    _bas_line_t *bLine = number ? prog_find_line(number) : BasicLineZero; // start new or update existing
@@ -324,7 +672,10 @@ bool prog_add_line(uint16_t number, uint8_t **line)
                break;
             }
       }
-      vPortFree(bLine);
+      if (bLine == ProgLast)
+         ProgLast = NULL;
+      arena_free(&ProgArena, bLine);
+      prog_compact();
       return true;
    }
    /// add/update a basic line
@@ -335,47 +686,19 @@ bool prog_add_line(uint16_t number, uint8_t **line)
                                                      /// b_printf("add line %d,%d\n", sizeof(_bas_line_t), blStrLen);
    if (bLine == NULL)                                // create new
    {
-      if ((bLine = pvPortMalloc(sizeof(_bas_line_t) + blStrLen)) == NULL) // add new line + string length
+      if ((bLine = arena_alloc(&ProgArena, sizeof(_bas_line_t) + blStrLen)) == NULL) // add new line + string length
          return false;
       bLine->number = number;
       bLine->next = NULL;
       bLine->len = blStrLen;
-      if (BasicProg == NULL)
-      {
-         BasicProg = bLine; // Start a new program
-      }
-      else
-      {
-         if (bLine->number < BasicProg->number) // swap if got smaller line number than the first one
-         {
-            bLine->next = BasicProg;
-            BasicProg = bLine;
-         }
-         else
-         {
-            _bas_line_t *blSeek = BasicProg;
-            while (blSeek->next != NULL)
-            {
-               if (bLine->number > ((_bas_line_t *)(blSeek->next))->number)
-                  blSeek = blSeek->next;
-               else // the new line has lower number
-               {
-                  bLine->next = blSeek->next; // Insert the new line before higher line
-                  blSeek->next = bLine;
-                  break;
-               }
-            }
-            if (blSeek->next == NULL) // add to the end
-               blSeek->next = bLine;
-         }
-      }
+      prog_link_line(bLine);
    }
    bLine->number = number;
    while ((*line)[lineLen] > '\r')
       lineLen++;
    if (lineLen >= BASIC_LINE_LEN - 1)
       lineLen = BASIC_LINE_LEN - 2;
-   if ((bLine->len == 0) || (bLine->len < blStrLen)) // reallocate
+   if (arena_size(bLine) < sizeof(_bas_line_t) + blStrLen) // reallocate
    {
       _bas_line_t tmpBline = *bLine;
       _bas_line_t *prevLine = BasicProg;
@@ -385,38 +708,40 @@ bool prog_add_line(uint16_t number, uint8_t **line)
             break;
          prevLine = prevLine->next;
       }
-      vPortFree(bLine);
-      if ((bLine = pvPortMalloc(sizeof(_bas_line_t) + blStrLen)) == NULL) // reallocate line + string length
+      if (bLine == ProgLast)
+         ProgLast = NULL;
+      arena_free(&ProgArena, bLine);
+      if ((bLine = arena_alloc(&ProgArena, sizeof(_bas_line_t) + blStrLen)) == NULL) // reallocate line + string length
          return false;
       *bLine = tmpBline;
       bLine->len = blStrLen;
       if (!number)
          BasicLineZero = bLine;
-      if (prevLine)
+      else if (prevLine)
          prevLine->next = bLine;
+      else
+         BasicProg = bLine; // the first line moved
    }
    strcpy((char *)bLine->string, (char *)blString);
+   prog_line_index(bLine);
    bLine->len = lineLen;
    *line += lineLen;
+   if (number && !bLine->next)
+      ProgLast = bLine;
+   prog_compact();
    return true;
 }
 
 _bas_err_e __new(_rpn_type_t *param)
 {
-   _bas_line_t *blSeek = BasicProg;
    __clear(NULL);
-   while (blSeek)
-   {
-      vPortFree(blSeek);
-      blSeek->len = 0;
-      blSeek = blSeek->next;
-   }
+   ProgRevision++;
+   arena_reset(&ProgArena);
    BasicProg = NULL;
-   if (BasicLineZero)
-   {
-      vPortFree(BasicLineZero);
-      BasicLineZero = NULL;
-   }
+   BasicLineZero = NULL;
+   ProgLast = NULL;
+   ProgRom = false;
+   bL = contbL = NULL; // NEW from a running line ends the run
    b_printf("Free mem: %d bytes\n", xPortGetFreeHeapSize());
    ExecLine = (_bas_ptr_t){0, 0, PROG_STATE_NEW};
    return BasicError = BASIC_ERR_NONE;
@@ -424,25 +749,15 @@ _bas_err_e __new(_rpn_type_t *param)
 
 _bas_err_e __clear(_rpn_type_t *param)
 {
-   _bas_var_t *nextVar, *delVar = BasicVars;
-   while (delVar)
-   {
-      nextVar = delVar->next;
-      if (delVar->value.type == VAR_TYPE_LOOP) // release loop structure
-         vPortFree(delVar->param.loop);
-      else if (delVar->value.type & (VAR_TYPE_ARRAY | VAR_TYPE_STRING)) // release loop structure
-         vPortFree(delVar->value.var.array);
-      else if (delVar->value.type & VAR_TYPE_DEFFN) // release deffn structure
-      {
-         vPortFree(((_bas_tok_list_t *)(delVar->value.var.deffn))->t[0].str);
-         vPortFree(((_bas_tok_list_t *)(delVar->value.var.deffn))->t);
-         vPortFree(delVar->value.var.deffn);
-      }
-      vPortFree(delVar);
-      delVar = nextVar;
-   }
+   arena_reset(&VarArena); // variables, loops, arrays and functions go at once
+   str_reset();
    BasicVars = NULL;
    memset(&GosubStack, 0x00, sizeof(GosubStack));
+   memset(LoopCache, 0x00, sizeof(LoopCache));
+   memset(OnCache, 0x00, sizeof(OnCache));
+   memset(WendCache, 0x00, sizeof(WendCache));
+   BlockStack.ptr = 0;
+   JumpLine = NULL;
    return BasicError = BASIC_ERR_NONE;
 }
 
@@ -504,6 +819,40 @@ _bas_err_e __list(_rpn_type_t *param)
    return BasicError = BASIC_ERR_NONE;
 }
 
+/// tokenized format: the header, then the lines as they are kept in memory
+static void prog_save_binary(FIL *file)
+{
+   _bas_bin_header_t header = {.magic = BASIC_BIN_MAGIC, .version = BASIC_BIN_VERSION, .signature = bas_func_signature()};
+   uint8_t *buf;
+   uint16_t fill = sizeof(header);
+   UINT done;
+   if ((buf = pvPortMalloc(BASIC_LOAD_BLOCK)) == NULL)
+   {
+      BasicError = BASIC_ERR_MEM_OUT;
+      return;
+   }
+   BasicError = BASIC_ERR_NONE;
+   for (_bas_line_t *bLine = BasicProg; bLine; bLine = bLine->next)
+      header.lines++;
+   memcpy(buf, &header, sizeof(header));
+   for (_bas_line_t *bLine = BasicProg; bLine && !BasicError; bLine = bLine->next)
+   {
+      _bas_bin_line_t rec = {.number = bLine->number, .size = strlen((char *)bLine->string) + 1};
+      if (fill + sizeof(rec) + rec.size > BASIC_LOAD_BLOCK)
+      {
+         if ((f_write(file, buf, fill, &done) != FR_OK) || (done != fill))
+            BasicError = BASIC_ERR_FILE_CANT_OPEN;
+         fill = 0;
+      }
+      memcpy(buf + fill, &rec, sizeof(rec));
+      memcpy(buf + fill + sizeof(rec), bLine->string, rec.size);
+      fill += sizeof(rec) + rec.size;
+   }
+   if (!BasicError && ((f_write(file, buf, fill, &done) != FR_OK) || (done != fill)))
+      BasicError = BASIC_ERR_FILE_CANT_OPEN;
+   vPortFree(buf);
+}
+
 _bas_err_e __save(_rpn_type_t *filename)
 {
    FIL progFile;
@@ -537,6 +886,15 @@ _bas_err_e __save(_rpn_type_t *filename)
    else if (f_open(&progFile, filename->var.str, FA_WRITE | FA_CREATE_NEW) != FR_OK)
       return BasicError = BASIC_ERR_FILE_CANT_OPEN;
    f_truncate(&progFile);
+   progStr = strrchr(filename->var.str, '.');
+   if (progStr && !strcmp(progStr, BASIC_BIN_EXT))
+   {
+      prog_save_binary(&progFile);
+      f_close(&progFile);
+      if (!BasicError)
+         b_printf("\"%s\" saved\n", filename->var.str);
+      return BasicError;
+   }
    while (bL != NULL)
    {
       if (bL->number)
@@ -553,10 +911,71 @@ _bas_err_e __save(_rpn_type_t *filename)
    return BasicError = BASIC_ERR_NONE;
 }
 
+static void prog_load_line(uint8_t *str)
+{
+   while ((*str == ' ') || (*str == '\t'))
+      str++;
+   if (*str < '0')
+      return; // skip lines strarting with # or control char
+   if ((ExecLine.number = (uint16_t)strtol((char *)str, (char **)&str, 10)) == 0)
+      BasicError = BASIC_ERR_LOAD_NONUMBER;
+   else if (prog_find_line(ExecLine.number))
+      BasicError = BASIC_ERR_LOAD_DUPLICATE;
+   else if (!prog_add_line(ExecLine.number, &str))
+      BasicError = BASIC_ERR_MEM_OUT;
+}
+
+static void prog_load_binary_line(_bas_bin_line_t *rec)
+{
+   ProgRevision++;
+   ExecLine.number = rec->number;
+   if (!rec->number || !rec->size || (rec->size > BASIC_LINE_LEN))
+      BasicError = BASIC_ERR_INVALID_LINE;
+   else if (prog_find_line(rec->number))
+      BasicError = BASIC_ERR_LOAD_DUPLICATE;
+   else if (!prog_rom_copy() || !prog_put_line(rec->number, (uint8_t *)(rec + 1), rec->size))
+      BasicError = BASIC_ERR_MEM_OUT;
+}
+
+/// the records follow the header in "buf", read the rest block by block
+static uint16_t prog_load_binary(FIL *file, char *buf, uint16_t fill)
+{
+   _bas_bin_header_t *header = (_bas_bin_header_t *)buf;
+   uint16_t lines = 0, total = header->lines, ptr = sizeof(_bas_bin_header_t);
+   UINT got;
+   if ((header->version != BASIC_BIN_VERSION) || (header->signature != bas_func_signature()))
+   {
+      BasicError = BASIC_ERR_LOAD_VERSION; // tokenized with another keyword table, SAVE it as text
+      return 0;
+   }
+   while (!BasicError && (lines < total))
+   {
+      _bas_bin_line_t *rec = (_bas_bin_line_t *)(buf + ptr);
+      if ((fill - ptr < sizeof(_bas_bin_line_t)) || (fill - ptr < sizeof(_bas_bin_line_t) + rec->size))
+      {
+         fill -= ptr;
+         memmove(buf, buf + ptr, fill);
+         ptr = 0;
+         if ((f_read(file, buf + fill, BASIC_LOAD_BLOCK - fill, &got) != FR_OK) || !got)
+            BasicError = BASIC_ERR_INVALID_LINE; // truncated file
+         fill += got;
+         continue;
+      }
+      prog_load_binary_line(rec);
+      ptr += sizeof(_bas_bin_line_t) + rec->size;
+      lines++;
+   }
+   return lines;
+}
+
 _bas_err_e __load(_rpn_type_t *filename)
 {
    FIL prog;
-   char *lineBuffer;
+   char *buf, *str, *eol;
+   UINT got = 0;
+   uint16_t fill = 0, lines = 0;
+   bool eof = false;
+   TickType_t ticks = xTaskGetTickCount();
    if (filename->type != VAR_TYPE_STRING)
    {
       if (token_eval_expression(0))
@@ -572,56 +991,85 @@ _bas_err_e __load(_rpn_type_t *filename)
    }
    if ((f_open(&prog, filename->var.str, FA_READ) != FR_OK))
       return BasicError = BASIC_ERR_FILE_NOT_FOUND;
-   lineBuffer = pvPortMalloc(1024);
-   if (lineBuffer == NULL)
+   buf = pvPortMalloc(BASIC_LOAD_BLOCK + 1); // room for the missing last new line
+   if (buf == NULL)
    {
       f_close(&prog);
       return BasicError = BASIC_ERR_MEM_OUT;
    }
    BasicError = BASIC_ERR_NONE;
-   while (f_gets(lineBuffer, 1023, &prog))
-   {
-      uint8_t *str = (uint8_t *)lineBuffer;
-      if (str[strlen((char *)str) - 1] > '\r') // line is not terminated with \r or \n, end of file
-         strcat((char *)str, "\r");
-      while ((*str == ' ') || (*str == '\t'))
-         str++;
-      if (*str < '0')
-         continue; // skip lines strarting with # or control char
-      if ((!BasicError) && (ExecLine.number = (uint16_t)strtol(
-                                (char *)str, (char **)&str, 10)) == 0)
-         BasicError = BASIC_ERR_LOAD_NONUMBER;
-      if ((!BasicError) && prog_find_line(ExecLine.number))
-         BasicError = BASIC_ERR_LOAD_DUPLICATE;
-      if ((!BasicError) && !prog_add_line(ExecLine.number, &str))
-         BasicError = BASIC_ERR_MEM_OUT;
+   if ((f_read(&prog, buf, BASIC_LOAD_BLOCK, &got) == FR_OK) && (got >= sizeof(_bas_bin_header_t)) &&
+       !memcmp(buf, BASIC_BIN_MAGIC, sizeof(((_bas_bin_header_t *)0)->magic))) // tokenized
+   {
+      lines = prog_load_binary(&prog, buf, got);
+      eof = true;
+   }
+   else
+   {
+      fill = got;
+      eof = got < BASIC_LOAD_BLOCK;
+      if (eof && fill && (buf[fill - 1] != '\n'))
+         buf[fill++] = '\n';
+   }
+   while (!BasicError && (!eof || fill))
+   {
+      if (!eof)
+      {
+         if (f_read(&prog, buf + fill, BASIC_LOAD_BLOCK - fill, &got) != FR_OK)
+         {
+            BasicError = BASIC_ERR_FILE_CANT_OPEN;
+            break;
+         }
+         eof = got < BASIC_LOAD_BLOCK - fill;
+         fill += got;
+         if (eof && fill && (buf[fill - 1] != '\n')) // the last line is not terminated
+            buf[fill++] = '\n';
+      }
+      for (str = buf; !BasicError && (eol = memchr(str, '\n', buf + fill - str)); str = eol + 1, lines++)
+      {
+         *eol = '\0';
+         prog_load_line((uint8_t *)str);
+      }
       if (BasicError)
          break;
+      fill -= str - buf;
+      if (fill >= BASIC_LOAD_BLOCK) // no new line in the whole block
+         BasicError = BASIC_ERR_STRING_LENGTH;
+      memmove(buf, str, fill);
    }
-   vPortFree(lineBuffer);
+   vPortFree(buf);
    f_close(&prog);
+   if (!BasicError)
+      b_printf("%d lines in %d ms\n", lines, (xTaskGetTickCount() - ticks) * portTICK_PERIOD_MS);
 
    return BasicError;
 }
 
+/// the value goes to the PRINT buffer, basic_print_flush() outputs it
 bool basic_printf(_rpn_type_t *var)
 {
    switch (var->type)
    {
    case VAR_TYPE_FLOAT:
    case VAR_TYPE_LOOP:
-      b_printf("%s", tftoa(var->var.f, 3));
+   {
+      char str[NUM_STR_LEN];
+      basic_print(str, num_ftoa(str, var->var.f, 3));
       break;
+   }
    case VAR_TYPE_INT:
    case VAR_TYPE_BYTE:
    case VAR_TYPE_WORD:
-      b_printf("%d", var->var.i);
+   {
+      char str[NUM_STR_LEN];
+      basic_print(str, num_itoa(str, var->var.i));
       break;
+   }
    case VAR_TYPE_BOOL:
-      b_printf("%s", var->var.i ? "true" : "false");
+      basic_print(var->var.i ? "true" : "false", var->var.i ? 4 : 5);
       break;
    case VAR_TYPE_STRING:
-      b_printf("%s", var->var.str);
+      basic_print(var->var.str, strlen(var->var.str));
       break;
    default:
       return false;
@@ -635,6 +1083,7 @@ _bas_stat_e basic_line_eval(void)
    char *str;
    while (1)
    {
+      str_sweep(); // the previous statement's string temporaries
       if (!*bToken->t[bToken->ptr].str && !bToken->t[bToken->ptr].op)
          return BasicStat = BASIC_STAT_SKIP; // empty line (rem found)
       firstOp = bToken->t[bToken->ptr].op;
@@ -686,7 +1135,8 @@ _bas_stat_e basic_line_eval(void)
                if (token_eval_expression(0))
                   return BasicStat = BASIC_STAT_ERR;
                while (basic_printf(rpn_pull_queue()))
-                  b_printf("\n"); // print RPN queue
+                  basic_print("\n", 1); // print RPN queue
+               basic_print_flush();
             }
             if (BasicStat)
                return BasicStat; // other than error
@@ -715,7 +1165,7 @@ _bas_err_e __run(_rpn_type_t *param)
    {
       if (BasicLineZero == NULL)
       {
-         BasicLineZero = pvPortMalloc(sizeof(_bas_line_t));
+         BasicLineZero = arena_alloc(&ProgArena, sizeof(_bas_line_t));
          memset(BasicLineZero, 0x00, sizeof(_bas_line_t));
       }
       bL = BasicLineZero;
@@ -747,11 +1197,22 @@ _bas_err_e __run(_rpn_type_t *param)
         return BasicError = BASIC_ERR_NONE; // will continue from the "command line" instance
    }
    ExecLine.statement = 0;
+   JumpLine = NULL;
    keyboard_break(); // skip previous breaks
 
    while (bL)
    {
-      tokenizer((char *)bL->string);
+      if (ExecLine.statement) // same line for/next implementation, start from the indexed statement
+      {
+         uint8_t s = ExecLine.statement < bL->stmtCount ? ExecLine.statement : bL->stmtCount;
+         tokenizer((char *)bL->string + (s ? bL->stmtOffset[s - 1] : 0));
+         for (; s < ExecLine.statement && bToken->t[bToken->ptr].op; s++)
+            while (bToken->t[bToken->ptr++].op != ':')
+               if (!bToken->t[bToken->ptr].op)
+                  break;
+      }
+      else
+         tokenizer((char *)bL->string);
 #if 0 // Print tokenized strings
         for (uint8_t i=0; i<PARSER_MAX_TOKENS; i++)
         {
@@ -759,12 +1220,6 @@ _bas_err_e __run(_rpn_type_t *param)
             if (!bToken->t[i].op) break;
         }
 #endif
-      if (ExecLine.statement) // same line for/next implementation
-         for (uint8_t s = 0; s < ExecLine.statement && bToken->t[bToken->ptr].op; s++)
-            while (bToken->t[bToken->ptr++].op != ':')
-               if (!bToken->t[bToken->ptr].op)
-                  break;
-
       ExecLine.number = bL->number;
       ExecLine.nextNum = bL->next ? ((_bas_line_t *)bL->next)->number : 0;
 
@@ -790,9 +1245,14 @@ _bas_err_e __run(_rpn_type_t *param)
             return BasicError = BASIC_ERR_NONE;
          case BASIC_STAT_JUMP:
          {
-            if (bL->number != ExecLine.number)
+            if (JumpLine)
             {
-               bL = BasicProg;
+               bL = JumpLine;
+               JumpLine = NULL;
+            }
+            else if (bL->number != ExecLine.number)
+            {
+               bL = ExecLine.number ? BasicProg : BasicLineZero; // RETURN to the command line
                while (bL && (bL->number != ExecLine.number))
                   bL = bL->next;
             }
@@ -832,6 +1292,11 @@ _bas_err_e __run(_rpn_type_t *param)
    return BasicError = BASIC_ERR_NONE;
 }
 
+_bas_line_t *prog_exec_line(void)
+{
+   return bL;
+}
+
 _bas_err_e __cont(_rpn_type_t *param)
 {
    if (ExecLine.state == PROG_STATE_BREAK)
@@ -863,6 +1328,7 @@ _bas_err_e __sys(_rpn_type_t *param)
 {
    _rpn_type_t *var;
    void *lastPutch = stdio->putch;
+   void *lastWrite = stdio->write;
    sysRetStr.ptr = 0;
    *sysRetStr.str = '\0';
    char *response_token;
@@ -875,8 +1341,10 @@ _bas_err_e __sys(_rpn_type_t *param)
    if (var->type != VAR_TYPE_STRING)
       return BasicError = BASIC_ERR_TYPE_MISMATCH;
    stdio->putch = _bbuff_putc;
+   stdio->write = NULL; // the block output would bypass the capture
    exec_line(var->var.str);
    stdio->putch = lastPutch;
+   stdio->write = lastWrite;
    // system call error process
    if (strstr(sysRetStr.str, "E:"))
    {
@@ -932,8 +1400,7 @@ void prog_load(char *progFileName)
       _rpn_type_t fileName = {.type = VAR_TYPE_STRING, .var.str = progFileName};
       __load(&fileName);
    }
-#if 0
-   else /// LOAD from an array
+   else /// LOAD from the ROM
    {
       static const _bas_rom_t *romProg[3] = {&ROM_bounce, &ROM_ctree, &ROM_snake};
       uint8_t romIndex = 0;
@@ -941,25 +1408,34 @@ void prog_load(char *progFileName)
          romIndex = (uint8_t)strtol(progFileName, NULL, 10);
       if (romIndex > 2)
          romIndex = 0;
-      // const _bas_rom_t *romProg = &ROM_bounce;
-      uint8_t *prog = (uint8_t *)romProg[romIndex]->prog;
-      while (*prog && !BasicError)
+      BasicError = BASIC_ERR_NONE;
+      if (!BasicProg && (ROM_LinesSignature == bas_func_signature())) // run in place, nothing to merge with
       {
-         while (*prog && (*prog <= ' '))
-            prog++; // skip spaces and control characters
-         if (!*prog)
-            break; // eol/eof
-         if ((ExecLine.number = (uint16_t)strtol((char *)prog, (char **)&prog, 10)) == 0)
-            BasicError = BASIC_ERR_LOAD_NONUMBER;
-         if (!BasicError && prog_find_line(ExecLine.number))
-            BasicError = BASIC_ERR_LOAD_DUPLICATE;
-         if (!BasicError && !prog_add_line(ExecLine.number, &prog))
-            BasicError = BASIC_ERR_MEM_OUT;
-         procLine++;
+         ProgRevision++;
+         BasicProg = (_bas_line_t *)romProg[romIndex]->lines;
+         ProgLast = NULL;
+         ProgRom = true;
+      }
+      else
+      {
+         uint8_t *prog = (uint8_t *)romProg[romIndex]->prog;
+         while (*prog && !BasicError)
+         {
+            while (*prog && (*prog <= ' '))
+               prog++; // skip spaces and control characters
+            if (!*prog)
+               break; // eol/eof
+            if ((ExecLine.number = (uint16_t)strtol((char *)prog, (char **)&prog, 10)) == 0)
+               BasicError = BASIC_ERR_LOAD_NONUMBER;
+            if (!BasicError && prog_find_line(ExecLine.number))
+               BasicError = BASIC_ERR_LOAD_DUPLICATE;
+            if (!BasicError && !prog_add_line(ExecLine.number, &prog))
+               BasicError = BASIC_ERR_MEM_OUT;
+            procLine++;
+         }
       }
       progFileName = (char *)romProg[romIndex]->name;
    }
-#endif
    if (BasicError)
       b_printf("\n%s, %d:0\n", BErrorText[BasicError], procLine);
    else
@@ -986,17 +1462,175 @@ void prog_run(uint16_t lineNumber)
    vTaskResume(xuTermTask);
 }
 
+static _rpn_type_t array_get_byte(void *data)
+{
+   return RPN_INT(*(uint8_t *)data);
+}
+
+static _rpn_type_t array_get_word(void *data)
+{
+   return RPN_INT(*(uint16_t *)data);
+}
+
+static _rpn_type_t array_get_int(void *data)
+{
+   return RPN_INT(*(int32_t *)data);
+}
+
+static _rpn_type_t array_get_float(void *data)
+{
+   return RPN_FLOAT(*(float *)data);
+}
+
+static _rpn_type_t array_get_string(void *data)
+{
+   return RPN_STR(data);
+}
+
+static _bas_err_e array_set_byte(_bas_array_t *array, void *data, _rpn_type_t *value)
+{
+   if (value->type < VAR_TYPE_FLOAT) return BasicError = BASIC_ERR_TYPE_MISMATCH;
+   *(uint8_t *)data = (uint8_t)(value->type & VAR_TYPE_FLOAT ? value->var.f : value->var.i);
+   return BasicError = BASIC_ERR_NONE;
+}
+
+static _bas_err_e array_set_word(_bas_array_t *array, void *data, _rpn_type_t *value)
+{
+   if (value->type < VAR_TYPE_FLOAT) return BasicError = BASIC_ERR_TYPE_MISMATCH;
+   *(uint16_t *)data = (uint16_t)(value->type & VAR_TYPE_FLOAT ? value->var.f : value->var.i);
+   return BasicError = BASIC_ERR_NONE;
+}
+
+static _bas_err_e array_set_int(_bas_array_t *array, void *data, _rpn_type_t *value)
+{
+   if (value->type < VAR_TYPE_FLOAT) return BasicError = BASIC_ERR_TYPE_MISMATCH;
+   *(int32_t *)data = (int32_t)(value->type & VAR_TYPE_FLOAT ? value->var.f : value->var.i);
+   return BasicError = BASIC_ERR_NONE;
+}
+
+static _bas_err_e array_set_float(_bas_array_t *array, void *data, _rpn_type_t *value)
+{
+   if (value->type < VAR_TYPE_FLOAT) return BasicError = BASIC_ERR_TYPE_MISMATCH;
+   *(float *)data = (float)(value->type & VAR_TYPE_FLOAT ? value->var.f : value->var.i);
+   return BasicError = BASIC_ERR_NONE;
+}
+
+static _bas_err_e array_set_string(_bas_array_t *array, void *data, _rpn_type_t *value)
+{
+   if (value->type != VAR_TYPE_STRING) return BasicError = BASIC_ERR_TYPE_MISMATCH;
+   tstrncpy((char *)data, value->var.str, array->elSize - 1);
+   return BasicError = BASIC_ERR_NONE;
+}
+
+/// DIM storage: the sizes of "dims" indexes, string arrays have the string length as one more size
+_bas_err_e array_alloc(_bas_var_t *var, const uint16_t *size, uint8_t dims)
+{
+   _bas_array_t layout, *array;
+   void *data;
+   _var_type_e type;
+   uint32_t count = 1;
+   switch (var->value.type)
+   {
+   case VAR_TYPE_FLOAT:
+   case VAR_TYPE_LOOP:
+      type = VAR_TYPE_ARRAY_FLOAT;
+      layout = (_bas_array_t){.elSize = sizeof(float), .get = array_get_float, .set = array_set_float};
+      break;
+   case VAR_TYPE_INT:
+   case VAR_TYPE_BOOL:
+      type = VAR_TYPE_ARRAY_INT;
+      layout = (_bas_array_t){.elSize = sizeof(int32_t), .get = array_get_int, .set = array_set_int};
+      break;
+   case VAR_TYPE_WORD:
+      type = VAR_TYPE_ARRAY_WORD;
+      layout = (_bas_array_t){.elSize = sizeof(uint16_t), .get = array_get_word, .set = array_set_word};
+      break;
+   case VAR_TYPE_BYTE:
+      type = VAR_TYPE_ARRAY_BYTE;
+      layout = (_bas_array_t){.elSize = sizeof(uint8_t), .get = array_get_byte, .set = array_set_byte};
+      break;
+   case VAR_TYPE_STRING:
+      if ((dims < 2) || !size[dims - 1] || (size[dims - 1] == UINT16_MAX)) return BasicError = BASIC_ERR_ARRAY_DIMENTION;
+      type = VAR_TYPE_ARRAY_STRING;
+      layout = (_bas_array_t){.elSize = size[--dims] + 1, .get = array_get_string, .set = array_set_string}; // add a termination byte
+      break;
+   default:
+      return BasicError = BASIC_ERR_TYPE_MISMATCH;
+   }
+   if (!dims || (dims > BASIC_ARRAY_DIMS)) return BasicError = BASIC_ERR_ARRAY_DIMENTION;
+   layout.dims = dims;
+   for (uint8_t i = dims; i--;) // the last index is the fastest one
+   {
+      if (!size[i]) return BasicError = BASIC_ERR_ARRAY_DIMENTION;
+      layout.size[i] = size[i];
+      layout.stride[i] = count * layout.elSize;
+      if (count > UINT32_MAX / layout.elSize / size[i]) return BasicError = BASIC_ERR_MEM_OUT;
+      count *= size[i];
+   }
+   layout.count = count;
+   if ((array = arena_alloc(&VarArena, sizeof(_bas_array_t))) == NULL) return BasicError = BASIC_ERR_MEM_OUT;
+   if ((data = arena_alloc(&VarArena, count * layout.elSize)) == NULL) // the variable stays as it was
+   {
+      arena_free(&VarArena, array);
+      return BasicError = BASIC_ERR_MEM_OUT;
+   }
+   memset(data, 0, count * layout.elSize);
+   *array = layout;
+   var->param.array = array;
+   var->value.var.array = data;
+   var->value.type = type;
+   return BasicError = BASIC_ERR_NONE;
+}
+
+/// element address, the indexes are in the RPN queue from "first" to the top
+void *array_element(_bas_var_t *var, uint8_t first)
+{
+   _bas_array_t *array = var->param.array;
+   char *data = var->value.var.array;
+   if (rpn_len_queue() != first + array->dims)
+   {
+      BasicError = BASIC_ERR_ARRAY_DIMENTION;
+      return NULL;
+   }
+   for (uint8_t i = 0; i < array->dims; i++)
+   {
+      _rpn_type_t *index = rpn_at_queue(first + i);
+      int32_t n;
+      if (index->type < VAR_TYPE_FLOAT)
+      {
+         BasicError = BASIC_ERR_TYPE_MISMATCH;
+         return NULL;
+      }
+      n = (index->type & VAR_TYPE_FLOAT) ? (int32_t)index->var.f : index->var.i;
+      if ((n < 0) || (n >= array->size[i]))
+      {
+         BasicError = BASIC_ERR_ARRAY_OUTOFRANGE;
+         return NULL;
+      }
+      data += n * array->stride[i];
+   }
+   return data;
+}
+
 _bas_err_e array_set(char *name, bool init) // set array elements
 {
    uint8_t bracketCnt = 1; // count square brackets
    uint8_t i;
-   uint16_t dimPtr[2] = {0, 0};
-   _rpn_type_t *dimVar;
+   _rpn_type_t *value;
    _bas_var_t *var;
+   _bas_array_t *array;
+   char *data;
+   uint32_t left;
    if ((var = var_get(name)) == NULL)
       return BasicError = BASIC_ERR_UNKNOWN_VAR;
+   if (!(var->value.type & VAR_TYPE_ARRAY))
+      return BasicError = BASIC_ERR_TYPE_MISMATCH;
+   array = var->param.array;
+   data = var->value.var.array;
+   left = array->count;
    if (!init)
    {
+      uint8_t base = rpn_len_queue();
       bToken->ptr++;
       for (i = bToken->ptr; i < PARSER_MAX_TOKENS - 1 && bToken->t[i].op; i++)
       {
@@ -1015,31 +1649,10 @@ _bas_err_e array_set(char *name, bool init) // set array elements
       if (token_eval_expression(0) != BASIC_ERR_NONE)
          return BasicError;
       bToken->ptr++;
-      if ((dimVar = rpn_pull_queue())->type == VAR_TYPE_NONE)
-         return BasicError = BASIC_ERR_ARRAY_DIMENTION;
-      if (var->param.size[1] &&
-          (var->value.type != VAR_TYPE_ARRAY_STRING)) // two dimentional array
-      {
-         dimPtr[0] =
-             (uint16_t)((dimVar->type & VAR_TYPE_FLOAT) ? dimVar->var.f : (dimVar->type & VAR_TYPE_INT) ? dimVar->var.i :
-                                                                                                          0);
-         if (dimPtr[0] >= var->param.size[1])
-            return BasicError = BASIC_ERR_ARRAY_OUTOFRANGE;
-         if ((dimVar = rpn_pull_queue())->type == VAR_TYPE_NONE)
-            return BasicError = BASIC_ERR_ARRAY_DIMENTION;
-         dimPtr[1] =
-             (uint16_t)((dimVar->type & VAR_TYPE_FLOAT) ? dimVar->var.f : (dimVar->type & VAR_TYPE_INT) ? dimVar->var.i :
-                                                                                                          0);
-      }
-      else
-         dimPtr[0] =
-             (uint16_t)((dimVar->type & VAR_TYPE_FLOAT) ? dimVar->var.f : (dimVar->type & VAR_TYPE_INT) ? dimVar->var.i :
-                                                                                                          0);
-      if (dimPtr[0] >= var->param.size[0])
-         return BasicError = BASIC_ERR_ARRAY_OUTOFRANGE;
-      if ((var->value.type != VAR_TYPE_ARRAY_STRING) &&
-          (rpn_pull_queue()->type != VAR_TYPE_NONE))
-         return BasicError = BASIC_ERR_ARRAY_DIMENTION;
+      if ((data = array_element(var, base)) == NULL)
+         return BasicError;
+      rpn_cut_queue(base);
+      left -= (data - (char *)var->value.var.array) / array->elSize; // the following elements can be set too
    }
    if (bToken->t[bToken->ptr++].op != '=')
       return BasicError = BASIC_ERR_MISSING_EQUAL;
@@ -1047,45 +1660,13 @@ _bas_err_e array_set(char *name, bool init) // set array elements
       return BasicError;
 
    bool head = true;
-   uint32_t arrayPtr = dimPtr[0] + dimPtr[1] * var->param.size[1];
-   uint32_t arrayLimit =
-       var->param.size[0] * var->param.size[1] +
-       ((var->value.type == VAR_TYPE_ARRAY_STRING) ? 0 : var->param.size[0]);
-   uint8_t dSize = var->value.type == VAR_TYPE_ARRAY_STRING ? var->param.size[1] : (var->value.type == VAR_TYPE_ARRAY_BYTE ? 1 : var->value.type == VAR_TYPE_ARRAY_WORD ? 2 :
-                                                                                                                                                                          4);
-   void *data = var->value.var.array + arrayPtr * dSize;
-   for (; arrayPtr < arrayLimit; arrayPtr++)
-   {
-      if ((dimVar = rpn_peek_queue(head))->type == VAR_TYPE_NONE)
+   for (; left; left--, data += array->elSize)
+   {
+      if ((value = rpn_peek_queue(head))->type == VAR_TYPE_NONE)
          break;
       head = false;
-      switch (var->value.type)
-      {
-      case VAR_TYPE_ARRAY_BYTE:
-         *(uint8_t *)data =
-             (uint8_t)(dimVar->type & VAR_TYPE_FLOAT ? dimVar->var.f : dimVar->var.i);
-         break;
-      case VAR_TYPE_ARRAY_WORD:
-         *(uint16_t *)data =
-             (uint16_t)(dimVar->type & VAR_TYPE_FLOAT ? dimVar->var.f : dimVar->var.i);
-         break;
-      case VAR_TYPE_ARRAY_INT:
-         *(int32_t *)data = (int32_t)(dimVar->type & VAR_TYPE_FLOAT ? dimVar->var.f : dimVar->var.i);
-         break;
-      case VAR_TYPE_ARRAY_FLOAT:
-         *(float *)data = (float)(dimVar->type & VAR_TYPE_FLOAT ? dimVar->var.f : dimVar->var.i);
-         break;
-      case VAR_TYPE_ARRAY_STRING:
-         if (dimVar->type != VAR_TYPE_STRING)
-            return BasicError = BASIC_ERR_TYPE_MISMATCH;
-         else
-            tstrncpy((char *)data, dimVar->var.str, var->param.size[1] - 1);
-         // b_sprintf((char *)data, var->param.size[1] - 1,"%s",dimVar->var.str);
-         break;
-      default:
-         break;
-      }
-      data += dSize;
+      if (array->set(array, data, value))
+         return BasicError;
    }
    if (rpn_peek_queue(false)->type != VAR_TYPE_NONE)
       return BasicError = BASIC_ERR_ARRAY_OUTOFRANGE;
@@ -30,18 +30,50 @@
 #define PARSER_MAX_TOKENS   32
 #define BASIC_VAR_NAME_LEN  16
 #define BASIC_VAR_MAX_COUNT 64
-#define BASIC_DEFFN_MAX_ARGS 4
+#define BASIC_DEFFN_MAX_ARGS 16 // the arguments are passed in the RPN queue
+#define BASIC_DEFFN_CODE_LEN (PARSER_MAX_TOKENS * 2)
+#define BASIC_DEFFN_DEPTH 8     // nested defined function calls
+#ifndef BASIC_SHORT_CIRCUIT
+#define BASIC_SHORT_CIRCUIT 1   // AND/OR skip the right operand once the left one decides the result, 0 evaluates both
+#endif
+#define BASIC_ARRAY_DIMS 4      // array indexes, string arrays take one more size for the length
+#ifndef BASIC_MAT_CMSIS
+#define BASIC_MAT_CMSIS 0       // MAT uses the CMSIS-DSP arm_mat_* functions, needs ARM_MATH_CM4 and libarm_cortexM4lf_math in the link
+#endif
+#ifndef BASIC_FAST_MATH
+#define BASIC_FAST_MATH 1       // SIN/COS/TAN from a table, polynomial ATN and the FPU square root, see bmath.c for the errors, 0 uses libm
+#endif
+#define BASIC_SIN_STEPS 128     // sin table steps per quarter period, SinTable in bmath.c is computed for it
+#define BASIC_SIN_LIMIT 50.0f   // |x| served by the sin table, a larger angle goes to libm
+#define BASIC_RND_STREAM 1442695040888963407ULL // PCG32 increment, odd
 
 #define BASIC_LINE_LEN 240
+#define BASIC_PRINT_BUFFER 256 // PRINT collects its output and writes it to the stream at once
+#define NUM_DECIMALS 6  // val$() precision, PRINT shows 3
+#define NUM_STR_LEN 20  // longest num_itoa/num_ftoa/num_htoa output with the terminator
 
 #define BASIC_GOSUB_STACK_SIZE 16
+#define BASIC_STMT_INDEX 7 // statement offsets kept per line, the statements after are found by skipping tokens
+#define BASIC_LOOP_CACHE 4 // recently started FOR loops, NEXT checks them before the variables list
+#ifndef BASIC_LOOP_DIRECT
+#define BASIC_LOOP_DIRECT 1 // NEXT takes the loop and the body line from the FOR record, 0 looks both up again
+#endif
+#define BASIC_ON_CACHE 4   // ON GOTO/GOSUB statements with resolved target lists
+#define BASIC_ON_TARGETS 16
+#define BASIC_BLOCK_STACK_SIZE 16 // nested WHILE/REPEAT loops
+#define BASIC_WEND_CACHE 4        // WHILE statements with the matching WEND found
 
 #define BASIC_DEFAULT_FILE_NAME "prog.bas"
+#define BASIC_LOAD_BLOCK 2048 // LOAD reads the file in blocks and cuts the lines in place
+#define BASIC_BIN_EXT ".bdb"     // SAVE writes the tokenized format for this extension, LOAD detects it by the magic
+#define BASIC_BIN_MAGIC "BDB\x1a"
+#define BASIC_BIN_VERSION 1
 
 #include "stdint.h"
 #include "rpn.h" // rpn var types
 #include "bfunc.h" // status
 #include "tstring.h"
+#include "bmem.h"
 
 #define b_printf tprintf
 #define b_sprintf tsnprintf
@@ -51,7 +83,9 @@ typedef struct __attribute ((packed))
     uint16_t number;
     uint16_t len;
     void *next;
-    uint8_t string[0];
+    uint8_t stmtCount;                    // number of indexed statements
+    uint8_t stmtOffset[BASIC_STMT_INDEX]; // string offsets of the statements 1,2...
+    uint8_t string[];
 } _bas_line_t;
 
 enum _prog_state_e
@@ -72,27 +106,96 @@ typedef struct// __attribute ((packed))
     enum _prog_state_e state:8;
 } _bas_ptr_t;
 
+typedef union
+{
+    float f;
+    int32_t i;
+} _bas_loop_val_t;
+
 typedef struct// __attribute ((packed))
 {
     void *next;
-    float limit;
-    float step;
+    void *var;           // control variable (_bas_var_t)
+    _bas_line_t *body;   // first line of the loop body, valid while .revision == ProgRevision
+    _bas_loop_val_t limit;
+    _bas_loop_val_t step;
+    uint16_t revision;
+    bool isInt;          // .i counter, limit/step are integers
     _bas_ptr_t line;
 } _bas_loop_t;
 
+typedef struct
+{
+    _bas_line_t *owner; // line of the ON statement, NULL while unused
+    uint16_t revision;  // ProgRevision the targets were resolved at
+    uint8_t statement;
+    uint8_t count;
+    _bas_line_t *target[BASIC_ON_TARGETS];
+} _bas_on_t;
+
+typedef struct
+{
+    _bas_ptr_t line;    // the WHILE statement, the statement after REPEAT
+    _bas_line_t *body;  // line of "line", used while the revision matches
+    uint16_t revision;
+    uint8_t opCode;     // __OPCODE_WHILE or __OPCODE_REPEAT
+    bool exit;          // the WHILE condition failed, WEND ends the loop
+} _bas_block_t;
+
+typedef struct
+{
+    _bas_block_t frame[BASIC_BLOCK_STACK_SIZE];
+    uint8_t ptr;
+} _bas_block_stack_t;
+
+typedef struct
+{
+    _bas_line_t *owner; // line of the WHILE, NULL while unused
+    _bas_line_t *end;   // line of the matching WEND
+    uint16_t revision;
+    uint8_t statement;
+    uint8_t endStatement;
+} _bas_wend_t;
+
+typedef struct _bas_array_s
+{
+    uint8_t dims;                       // number of indexes
+    uint16_t elSize;                    // element bytes, string length + 1 for strings
+    uint16_t size[BASIC_ARRAY_DIMS];
+    uint32_t stride[BASIC_ARRAY_DIMS];  // bytes per index step, row major
+    uint32_t count;                     // total elements
+    _rpn_type_t (*get)(void *data);     // typed accessors, selected by DIM
+    _bas_err_e (*set)(struct _bas_array_s *array, void *data, _rpn_type_t *value);
+} _bas_array_t;
+
 typedef struct __attribute ((packed,aligned(4)))
 {
     _rpn_type_t value;
     union
     {
-        uint8_t argc;       // function arguments count
-        uint16_t size[2];   // allocated memory size for complex variables,string - size[0], arrays size[dim 0],size[dim 1]
-        _bas_loop_t *loop;  // pointer to loop parameter
+        uint8_t argc;           // function arguments count
+        _bas_array_t *array;    // array layout, the data is in value.var.array
+        _bas_loop_t *loop;      // pointer to loop parameter
     }param;
     void *next;
     char name[0];
 } _bas_var_t;
 
+typedef struct __attribute ((packed))
+{
+    char magic[4];
+    uint8_t version;
+    uint8_t reserved;
+    uint16_t lines;
+    uint32_t signature; // keyword table hash, the opcodes are only valid with the same table
+} _bas_bin_header_t;
+
+typedef struct __attribute ((packed))
+{
+    uint16_t number;
+    uint16_t size; // line string including the terminator, follows the record
+} _bas_bin_line_t;
+
 typedef struct
 {
     _bas_ptr_t line[BASIC_GOSUB_STACK_SIZE];
@@ -108,6 +211,11 @@ void prog_list(void);
 void prog_new(void);
 void prog_run(uint16_t lineNum);
 bool basic_printf(_rpn_type_t *var);
+void basic_print(const char *str, uint16_t len);
+void basic_print_flush(void);
+uint8_t num_itoa(char *buf, int32_t val);
+uint8_t num_ftoa(char *buf, float val, uint8_t decimals);
+uint8_t num_htoa(char *buf, uint32_t val, uint8_t width);
 bool prog_add_line(uint16_t number, uint8_t **line);
 _bas_err_e __new(_rpn_type_t *param);
 _bas_err_e __list(_rpn_type_t *param);
@@ -118,7 +226,10 @@ _bas_err_e __cont(_rpn_type_t *param);
 _bas_err_e __sys(_rpn_type_t *param);
 _bas_err_e __clear(_rpn_type_t *param);
 
+_bas_err_e array_alloc(_bas_var_t *var, const uint16_t *size, uint8_t dims);
+void *array_element(_bas_var_t *var, uint8_t first);
 _bas_err_e array_set(char *name,bool init);
+_bas_line_t *prog_exec_line(void);
 
 extern _bas_stat_e BasicStat;
 extern _bas_err_e BasicError;
@@ -126,6 +237,12 @@ extern _bas_ptr_t ExecLine;
 extern _bas_line_t *BasicProg;
 extern _bas_line_t *BasicLineZero;
 extern _bas_gosub_t GosubStack;
+extern _bas_line_t *JumpLine;
+extern uint16_t ProgRevision;
+extern _bas_loop_t *LoopCache[BASIC_LOOP_CACHE];
+extern _bas_on_t OnCache[BASIC_ON_CACHE];
+extern _bas_block_stack_t BlockStack;
+extern _bas_wend_t WendCache[BASIC_WEND_CACHE];
 
 extern uint8_t tmpBasicLine[BASIC_LINE_LEN];
 
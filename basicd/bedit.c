@@ -43,10 +43,12 @@ _editline_t basicLine =
     };
 
 void basic_putch(char cc);
+void basic_write(const char *buf, uint16_t len);
 _stream_io_t basicStream =
     {
         .putch = basic_putch,
         .getch = keyboard_getch,
+        .write = basic_write,
 };
 
 void basic_message(enum _bas_msg_e type,const char *str, ... )
@@ -209,8 +211,11 @@ cmd_err_t basic_exe(_cl_param_t *sParam)
   uTerm.bgColour = HLScheme[SYNCOL_BACKGROUND];
   uTerm.fgColour = HLScheme[SYNCOL_DEFAULT];
   text_cls();
-  BasicLineZero = pvPortMalloc(sizeof(_bas_line_t));
-  memset(BasicLineZero,0x00,sizeof(_bas_line_t));
+  if (BasicLineZero == NULL)
+  {
+    BasicLineZero = arena_alloc(&ProgArena, sizeof(_bas_line_t));
+    memset(BasicLineZero,0x00,sizeof(_bas_line_t));
+  }
   b_printf("Basic D\n Version %d.%2db\n",BASICD_VESRION,BASICD_SUBVESRION);
   b_printf("Free mem: %d bytes\n\n", xPortGetFreeHeapSize());
   while (!done)
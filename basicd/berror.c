@@ -32,6 +32,7 @@ const char *BErrorText[BASIC_ERR_COUNT] =
     "Cannot open file",
     "No line number",
     "Duplicate line number",
+    "Incompatible program file",
     "Invalid line number",
     "Invalid delimiter",    
     "String too long",
@@ -49,6 +50,7 @@ const char *BErrorText[BASIC_ERR_COUNT] =
     "Unknown function",
     "Using reserved name",
     "Missing \"then\"",
+    "Missing \"goto\" or \"gosub\"",
     "RPN queue is empty",
     "RPN queue is full",
     "RPN stack is full",
@@ -56,9 +58,14 @@ const char *BErrorText[BASIC_ERR_COUNT] =
     "Incomplete FOR loop",
     "GOSUB stack overflow",
     "RETURN without GOSUB",
+    "Loop stack overflow",
+    "WHILE without WEND",
+    "WEND without WHILE",
+    "UNTIL without REPEAT",
     "Array redefine",
     "Array out of range",
     "Wrong array dimentions",
+    "Singular matrix",
     "Variable redefine",
     "Variable out of range",
     "Function redefine",
@@ -31,6 +31,7 @@ typedef enum
     BASIC_ERR_FILE_CANT_OPEN,
     BASIC_ERR_LOAD_NONUMBER,
     BASIC_ERR_LOAD_DUPLICATE,
+    BASIC_ERR_LOAD_VERSION,
     BASIC_ERR_INVALID_LINE,
     BASIC_ERR_INVALID_DELIMITER,    
     BASIC_ERR_STRING_LENGTH,
@@ -48,6 +49,7 @@ typedef enum
     BASIC_ERR_UNKNOWN_FUNC,
     BASIC_ERR_RESERVED_NAME,
     BASIC_ERR_NO_THEN,
+    BASIC_ERR_NO_GOTO,
     BASIC_ERR_QUEUE_EMPTY,
     BASIC_ERR_QUEUE_FULL,
     BASIC_ERR_STACK_FULL,
@@ -55,9 +57,14 @@ typedef enum
     BASIC_ERR_INCOMPLETE_FOR,
     BASIC_ERR_GOSUB_OVERFLOW,
     BASIC_ERR_RETURN_NO_GOSUB,
+    BASIC_ERR_LOOP_OVERFLOW,
+    BASIC_ERR_WHILE_NO_WEND,
+    BASIC_ERR_WEND_NO_WHILE,
+    BASIC_ERR_UNTIL_NO_REPEAT,
     BASIC_ERR_ARRAY_REDEFINE,
     BASIC_ERR_ARRAY_OUTOFRANGE,
     BASIC_ERR_ARRAY_DIMENTION,
+    BASIC_ERR_MAT_SINGULAR,
     BASIC_ERR_VAR_REDEFINE,
     BASIC_ERR_VAR_OUTOFRANGE,
     BASIC_ERR_DEFFN_REDEFINE,
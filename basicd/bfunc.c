@@ -50,10 +50,15 @@ const _bas_func_t BasicFunction[] =
     {"goto",__goto},
     {"gosub",__gosub},
     {"return",__return},
+    {"on",__on},
     {"for",__for},
     {"to",__to},
     {"step",__step},
     {"next",__next},
+    {"while",__while},
+    {"wend",__wend},
+    {"repeat",__repeat},
+    {"until",__until},
     /// --- interpreter control
     {"stop",__stop},
     {"run",__run},
@@ -78,7 +83,9 @@ const _bas_func_t BasicFunction[] =
     /// --- data manipulation
     {"let",__let},
     {"dim",__dim},
+    {"mat",__mat},
     {"def",__def},
+    {"randomize",__randomize},
     {"sys",__sys},
     /// all operators after this point should be executed in context of other operators
     /// --- basic secondary operators (functions)
@@ -92,6 +99,11 @@ const _bas_func_t BasicFunction[] =
     {"val$",__val$},
     {"hex$",__hex$},
     {"bin$",__bin$},
+    {"len",__len},
+    {"left$",__left$},
+    {"right$",__right$},
+    {"mid$",__mid$},
+    {"instr",__instr},
     /// --- data type
     {"int",__int},
     {"byte",__byte},
@@ -110,6 +122,15 @@ const _bas_func_t BasicFunction[] =
     {"rad",__rad},
     {"min",__min},
     {"max",__max},
+    /// --- arrays
+    {"fill",__fill},
+    {"copy",__copy},
+    {"sum",__sum},
+    {"imin",__imin},
+    {"imax",__imax},
+    {"sort",__sort},
+    {"search",__search},
+    {"dot",__dot},
     /// --- no argument functions
     {"inkey",__inkey},
     /// data type 
@@ -118,13 +139,57 @@ const _bas_func_t BasicFunction[] =
     //  {NULL,NULL}
 };
 
-uint8_t bas_func_opcode(char *name)
+static uint8_t FuncIndex[__OPCODE_LAST - OPCODE_MASK]; // BasicFunction[] offsets sorted by name
+static uint8_t FuncIndexCount = 0;
+
+static void bas_func_index(void)
 {
+    uint8_t count = 0;
     for (uint8_t fCnt = 0; fCnt < (__OPCODE_LAST - OPCODE_MASK); fCnt++)
-        if (!strcmp(name,BasicFunction[fCnt].name)) return OPCODE_MASK + fCnt;
+    {
+        if (*BasicFunction[fCnt].name == ' ') // internal opcodes, never typed
+            continue;
+        uint8_t i = count++;
+        for (; i && (strcmp(BasicFunction[FuncIndex[i - 1]].name, BasicFunction[fCnt].name) > 0); i--)
+            FuncIndex[i] = FuncIndex[i - 1];
+        FuncIndex[i] = fCnt;
+    }
+    FuncIndexCount = count;
+}
+
+/// binary search over the sorted names, shared by the preprocessor, the highlighter and the reserved names check
+uint8_t bas_func_opcode(char *name)
+{
+    int16_t low = 0, high, mid;
+    int cmp;
+    if (!FuncIndexCount) bas_func_index();
+    high = FuncIndexCount - 1;
+    while (low <= high)
+    {
+        mid = (low + high) >> 1;
+        if ((cmp = strcmp(name, BasicFunction[FuncIndex[mid]].name)) == 0)
+            return OPCODE_MASK + FuncIndex[mid];
+        if (cmp < 0)
+            high = mid - 1;
+        else
+            low = mid + 1;
+    }
     return 0;
 }
 
+/// FNV-1a over the table in opcode order, tokenized programs are only portable between equal tables
+uint32_t bas_func_signature(void)
+{
+    uint32_t hash = 2166136261UL;
+    for (uint8_t fCnt = 0; fCnt < (__OPCODE_LAST - OPCODE_MASK); fCnt++)
+    {
+        for (const char *c = BasicFunction[fCnt].name; *c; c++)
+            hash = (hash ^ (uint8_t)*c) * 16777619UL;
+        hash = (hash ^ '\0') * 16777619UL; // keeps "ab","c" apart from "a","bc"
+    }
+    return hash;
+}
+
 const char *bas_func_name(uint8_t opCode)
 {
     if (opCode >= __OPCODE_LAST) return "noOp";
@@ -140,74 +205,39 @@ static _bas_err_e __basic_dummy(_rpn_type_t *param)
 static _bas_err_e __array(_rpn_type_t *param)
 {
     _bas_var_t *array;
-    if (!rpn_find_queue(VAR_TYPE_ARRAY)) return BASIC_ERR_QUEUE_EMPTY; // should not happened
-    array = (rpn_peek_queue(false))->var.array; // get array
-    bool stringArray = array->value.type == VAR_TYPE_ARRAY_STRING ? true : false;
-    _rpn_type_t *var;
-    uint16_t tmpArrayPtr, arrayPtr = 0;
-    for (uint8_t i=0; i < ((array->param.size[1] && !stringArray) ? 2 : 1); i++)
-    {
-        if ((var = rpn_peek_queue(false))->type  == VAR_TYPE_NONE) return BasicError = BASIC_ERR_ARRAY_DIMENTION;
-        if (!var->type || (var->type < VAR_TYPE_FLOAT)) 
-            return BasicError = BASIC_ERR_TYPE_MISMATCH;
-        tmpArrayPtr = (var->type < VAR_TYPE_INT) ? (uint16_t)var->var.f : (uint16_t)var->var.i;
-        if (tmpArrayPtr >= array->param.size[i]) // check range
-            return BasicError = BASIC_ERR_ARRAY_OUTOFRANGE;
-        arrayPtr = arrayPtr*array->param.size[1] + tmpArrayPtr;
-    }
-    if (rpn_peek_queue(false)->type != VAR_TYPE_NONE) return BasicError = BASIC_ERR_ARRAY_DIMENTION; // there is something in stack, too much dimentions
     void *data;
-    if (stringArray)
-        data = array->value.var.array + arrayPtr*array->param.size[1];
-    else
-        data = array->value.var.array + arrayPtr*(array->value.type == VAR_TYPE_ARRAY_BYTE ? 1 : array->value.type == VAR_TYPE_ARRAY_WORD ? 2 : 4);
-    switch (array->value.type)
-    {
-    case VAR_TYPE_ARRAY_BYTE:
-        rpn_push_queue(RPN_INT(*(uint8_t *)data));
-        break;
-    case VAR_TYPE_ARRAY_WORD:
-        rpn_push_queue(RPN_INT(*(uint16_t *)data));
-        break;
-    case VAR_TYPE_ARRAY_INT:
-        rpn_push_queue(RPN_INT(*(int32_t *)data));
-        break;
-    case VAR_TYPE_ARRAY_FLOAT:
-        rpn_push_queue(RPN_FLOAT(*(float *)data));
-        break;
-    case VAR_TYPE_ARRAY_STRING:
-        rpn_push_queue(RPN_STR(data));
-        break;
-    default:
-        return BasicError = BASIC_ERR_TYPE_MISMATCH;
-    }
-    return BasicError = BASIC_ERR_NONE;
+    int16_t frame;
+    if ((frame = rpn_index_queue(VAR_TYPE_ARRAY)) < 0) return BASIC_ERR_QUEUE_EMPTY; // should not happened
+    array = rpn_at_queue(frame)->var.array;
+    if ((data = array_element(array, frame + 1)) == NULL) return BasicError;
+    rpn_cut_queue(frame); // the indexes and the marker
+    return rpn_push_queue(array->param.array->get(data));
 };
 
+/// the arguments stay in the queue after the function marker, the body reads them by position
 static _bas_err_e __deffn(_rpn_type_t *param)
 {
-    char argVarName[BASIC_VAR_NAME_LEN];
-    _bas_var_t *func;
-    if (!rpn_find_queue(VAR_TYPE_DEFFN)) return BASIC_ERR_QUEUE_EMPTY; // should not happened
-    func = (rpn_peek_queue(false))->var.deffn; // get function tokens
-    if (func->param.argc) // there are arguments
-    {
-        uint8_t indexChr = strlen(func->name);
-        _bas_var_t *var;
-        strcpy(argVarName,func->name);
-        argVarName[indexChr+1]=0;
-        for (uint8_t i=0;i<func->param.argc;i++)
-        {
-            argVarName[indexChr] = '0'+i;
-            if ((var = var_get(argVarName)) == NULL) return BasicError = BASIC_ERR_UNKNOWN_VAR;
-            var->value = *rpn_peek_queue(false);
-            if (var->value.type == VAR_TYPE_NONE) return BasicError = BASIC_ERR_FEW_ARGUMENTS;
-        }
-        if (rpn_peek_queue(false)->type != VAR_TYPE_NONE) return BasicError = BASIC_ERR_MANY_ARGUMENTS;
-    }
-    ((_bas_tok_list_t *)func->value.var.deffn)->ptr = -1;
-    ((_bas_tok_list_t *)func->value.var.deffn)->parCnt = 0;
-    tok_list_push(func->value.var.deffn);
+    static uint8_t depth = 0;
+    _bas_deffn_t *fn;
+    int16_t frame;
+    uint8_t top;
+    if ((frame = rpn_index_queue(VAR_TYPE_DEFFN)) < 0) return BASIC_ERR_QUEUE_EMPTY; // should not happened
+    fn = ((_bas_var_t *)rpn_at_queue(frame)->var.deffn)->value.var.deffn;
+    top = rpn_len_queue();
+    if (top - frame - 1 < fn->argc) return BasicError = BASIC_ERR_FEW_ARGUMENTS;
+    if (top - frame - 1 > fn->argc) return BasicError = BASIC_ERR_MANY_ARGUMENTS;
+    if (depth >= BASIC_DEFFN_DEPTH) return BasicError = BASIC_ERR_STACK_FULL;
+    for (uint8_t i = frame + 1; i < top; i++) // an argument used twice must outlive the first operator consuming it
+        if (rpn_at_queue(i)->type == VAR_TYPE_STRING) str_hold(rpn_at_queue(i)->var.str);
+    depth++;
+    deffn_exec(fn, frame + 1);
+    depth--;
+    for (uint8_t i = frame + 1; i < top; i++)
+        if (rpn_at_queue(i)->type == VAR_TYPE_STRING) str_release(rpn_at_queue(i)->var.str);
+    if (BasicError) return BasicError;
+    if (rpn_len_queue() != top + 1) return BasicError = BASIC_ERR_MISSING_OPERATOR;
+    *rpn_at_queue(frame) = *rpn_at_queue(top); // the result replaces the call frame
+    rpn_cut_queue(frame + 1);
     return BasicError = BASIC_ERR_NONE;
 };
 
@@ -40,10 +40,15 @@ enum
     __OPCODE_GOTO,
     __OPCODE_GOSUB,
     __OPCODE_RETURN,
+    __OPCODE_ON,
     __OPCODE_FOR,
     __OPCODE_TO,
     __OPCODE_STEP,
     __OPCODE_NEXT,
+    __OPCODE_WHILE,
+    __OPCODE_WEND,
+    __OPCODE_REPEAT,
+    __OPCODE_UNTIL,
     __OPCODE_STOP,
     __OPCODE_RUN,
     __OPCODE_CONT,
@@ -64,7 +69,9 @@ enum
     __OPCODE_BAR,
     __OPCODE_LET,
     __OPCODE_DIM,
+    __OPCODE_MAT,
     __OPCODE_DEF,
+    __OPCODE_RANDOMIZE,
     __OPCODE_SYS,
     __OPCODE_PEEK,
     __OPCODE_POKE,
@@ -74,6 +81,11 @@ enum
     __OPCODE_VAL$,
     __OPCODE_HEX$,
     __OPCODE_BIN$,
+    __OPCODE_LEN,
+    __OPCODE_LEFT$,
+    __OPCODE_RIGHT$,
+    __OPCODE_MID$,
+    __OPCODE_INSTR,
     __OPCODE_INT,
     __OPCODE_BYTE,
     __OPCODE_WORD,
@@ -90,6 +102,14 @@ enum
     __OPCODE_RAD,
     __OPCODE_MIN,
     __OPCODE_MAX,
+    __OPCODE_FILL,
+    __OPCODE_COPY,
+    __OPCODE_SUM,
+    __OPCODE_IMIN,
+    __OPCODE_IMAX,
+    __OPCODE_SORT,
+    __OPCODE_SEARCH,
+    __OPCODE_DOT,
     __OPCODE_INKEY,    
     __OPCODE_ARRAY,
     __OPCODE_DEFFN,
@@ -118,6 +138,7 @@ extern const _bas_func_t BasicFunction[];
 
 uint8_t bas_func_opcode(char *name);
 const char *bas_func_name(uint8_t opCode);
+uint32_t bas_func_signature(void);
 
 
 #endif // _BFUNC_H_INCLUDED
@@ -21,17 +21,25 @@
  * Full license: http://creativecommons.org/licenses/by-nc-sa/4.0/
  * ---------------------------------------------------------------------------*/
 #include <stdlib.h>
+#include <string.h>
 #include <math.h>
 #include "freeRTOS.h"
 #include "task.h"
 #include "bsp.h"
 #include "rpn.h"
+#include "banalizer.h"
 #include "bcore.h"
 #include "bstring.h"
 #include "bfunc.h"
 #include "bprime.h"
 #include "bstring.h"
 #include "berror.h"
+#if BASIC_MAT_CMSIS
+#ifndef ARM_MATH_CM4
+#define ARM_MATH_CM4
+#endif
+#include "arm_math.h"
+#endif
 
 /// type functions
 _bas_err_e __int(_rpn_type_t *param)
@@ -103,6 +111,517 @@ _bas_err_e __word(_rpn_type_t *param)
    return BasicError = BASIC_ERR_NONE;
 };
 
+/// array functions, the arrays are passed by name and processed as a flat row major list of elements
+static _bas_var_t *array_param(_rpn_type_t *param, bool numeric)
+{
+   _bas_var_t *var;
+   if (param->type != VAR_TYPE_ARRAY)
+   {
+      BasicError = param->type ? BASIC_ERR_TYPE_MISMATCH : BASIC_ERR_FEW_ARGUMENTS;
+      return NULL;
+   }
+   var = param->var.array;
+   if (numeric && (var->value.type == VAR_TYPE_ARRAY_STRING))
+   {
+      BasicError = BASIC_ERR_TYPE_MISMATCH;
+      return NULL;
+   }
+   BasicError = BASIC_ERR_NONE;
+   return var;
+}
+
+/// flat index of the smallest or the biggest element, the first one of equals
+static uint32_t array_extreme(_bas_var_t *var, bool biggest)
+{
+   uint32_t found = 0, count = var->param.array->count;
+   switch (var->value.type)
+   {
+   case VAR_TYPE_ARRAY_FLOAT:
+   {
+      const float *d = var->value.var.array;
+      for (uint32_t i = 1; i < count; i++)
+         if (biggest ? (d[i] > d[found]) : (d[i] < d[found])) found = i;
+      break;
+   }
+   case VAR_TYPE_ARRAY_INT:
+   {
+      const int32_t *d = var->value.var.array;
+      for (uint32_t i = 1; i < count; i++)
+         if (biggest ? (d[i] > d[found]) : (d[i] < d[found])) found = i;
+      break;
+   }
+   case VAR_TYPE_ARRAY_WORD:
+   {
+      const uint16_t *d = var->value.var.array;
+      for (uint32_t i = 1; i < count; i++)
+         if (biggest ? (d[i] > d[found]) : (d[i] < d[found])) found = i;
+      break;
+   }
+   case VAR_TYPE_ARRAY_BYTE:
+   {
+      const uint8_t *d = var->value.var.array;
+      for (uint32_t i = 1; i < count; i++)
+         if (biggest ? (d[i] > d[found]) : (d[i] < d[found])) found = i;
+      break;
+   }
+   default:
+      break;
+   }
+   return found;
+}
+
+static _bas_err_e array_extreme_push(_rpn_type_t *param, bool biggest, bool index)
+{
+   _bas_var_t *var;
+   uint32_t found;
+   if ((var = array_param(param, true)) == NULL) return BasicError;
+   found = array_extreme(var, biggest);
+   if (index)
+      rpn_push_queue(RPN_INT(found));
+   else
+      rpn_push_queue(var->param.array->get((char *)var->value.var.array + found * var->param.array->elSize));
+   return BasicError = BASIC_ERR_NONE;
+}
+
+static int array_cmp_float(const void *a, const void *b)
+{
+   float x = *(const float *)a, y = *(const float *)b;
+   return (x > y) - (x < y);
+}
+
+static int array_cmp_int(const void *a, const void *b)
+{
+   int32_t x = *(const int32_t *)a, y = *(const int32_t *)b;
+   return (x > y) - (x < y);
+}
+
+static int array_cmp_word(const void *a, const void *b)
+{
+   return (int)*(const uint16_t *)a - (int)*(const uint16_t *)b;
+}
+
+static int array_cmp_byte(const void *a, const void *b)
+{
+   return (int)*(const uint8_t *)a - (int)*(const uint8_t *)b;
+}
+
+static int (*array_cmp(_bas_var_t *var))(const void *, const void *)
+{
+   switch (var->value.type)
+   {
+   case VAR_TYPE_ARRAY_FLOAT:
+      return array_cmp_float;
+   case VAR_TYPE_ARRAY_INT:
+      return array_cmp_int;
+   case VAR_TYPE_ARRAY_WORD:
+      return array_cmp_word;
+   default:
+      return array_cmp_byte;
+   }
+}
+
+/// fill(array, value)
+_bas_err_e __fill(_rpn_type_t *p2)
+{
+   _rpn_type_t *p1 = rpn_pull_queue();
+   _bas_var_t *var;
+   _bas_array_t *array;
+   char *data;
+   uint32_t done, size;
+   if ((var = array_param(p1, false)) == NULL) return BasicError;
+   array = var->param.array;
+   data = var->value.var.array;
+   if (array->set(array, data, p2)) return BasicError;
+   size = array->count * array->elSize;
+   for (done = array->elSize; done < size; done <<= 1) // double the filled part
+      memcpy(data + done, data, (size - done < done) ? size - done : done);
+   return BasicError = BASIC_ERR_NONE;
+};
+
+/// copy(destination, source), the elements are converted when the types differ, the shorter array limits the count
+_bas_err_e __copy(_rpn_type_t *p2)
+{
+   _rpn_type_t *p1 = rpn_pull_queue();
+   _bas_var_t *dst, *src;
+   _bas_array_t *dArray, *sArray;
+   char *d, *s;
+   uint32_t count;
+   if (((dst = array_param(p1, false)) == NULL) || ((src = array_param(p2, false)) == NULL)) return BasicError;
+   dArray = dst->param.array;
+   sArray = src->param.array;
+   d = dst->value.var.array;
+   s = src->value.var.array;
+   count = (dArray->count < sArray->count) ? dArray->count : sArray->count;
+   if ((dst->value.type == src->value.type) && (dArray->elSize == sArray->elSize))
+      memmove(d, s, count * dArray->elSize);
+   else
+      for (; count--; d += dArray->elSize, s += sArray->elSize)
+      {
+         _rpn_type_t value = sArray->get(s);
+         if (dArray->set(dArray, d, &value)) return BasicError;
+      }
+   return BasicError = BASIC_ERR_NONE;
+};
+
+_bas_err_e __sum(_rpn_type_t *param)
+{
+   _bas_var_t *var;
+   uint32_t count;
+   int32_t sum = 0;
+   if ((var = array_param(param, true)) == NULL) return BasicError;
+   count = var->param.array->count;
+   switch (var->value.type)
+   {
+   case VAR_TYPE_ARRAY_FLOAT:
+   {
+      const float *d = var->value.var.array;
+      float fSum = 0;
+      while (count--) fSum += *d++;
+      rpn_push_queue(RPN_FLOAT(fSum));
+      return BasicError = BASIC_ERR_NONE;
+   }
+   case VAR_TYPE_ARRAY_INT:
+   {
+      const int32_t *d = var->value.var.array;
+      while (count--) sum += *d++;
+      break;
+   }
+   case VAR_TYPE_ARRAY_WORD:
+   {
+      const uint16_t *d = var->value.var.array;
+      while (count--) sum += *d++;
+      break;
+   }
+   default:
+   {
+      const uint8_t *d = var->value.var.array;
+      while (count--) sum += *d++;
+      break;
+   }
+   }
+   rpn_push_queue(RPN_INT(sum));
+   return BasicError = BASIC_ERR_NONE;
+};
+
+/// imin(array), imax(array): flat index of the element
+_bas_err_e __imin(_rpn_type_t *param)
+{
+   return array_extreme_push(param, false, true);
+};
+
+_bas_err_e __imax(_rpn_type_t *param)
+{
+   return array_extreme_push(param, true, true);
+};
+
+/// sort(array), ascending in place
+_bas_err_e __sort(_rpn_type_t *param)
+{
+   _bas_var_t *var;
+   if ((var = array_param(param, true)) == NULL) return BasicError;
+   qsort(var->value.var.array, var->param.array->count, var->param.array->elSize, array_cmp(var));
+   return BasicError = BASIC_ERR_NONE;
+};
+
+/// search(array, value): flat index of the value in a sorted array or -1, the value is converted to the element type
+_bas_err_e __search(_rpn_type_t *p2)
+{
+   _rpn_type_t *p1 = rpn_pull_queue();
+   _bas_var_t *var;
+   _bas_array_t *array;
+   char *found;
+   union
+   {
+      float f;
+      int32_t i;
+      uint16_t w;
+      uint8_t b;
+   } key;
+   if ((var = array_param(p1, true)) == NULL) return BasicError;
+   array = var->param.array;
+   if (array->set(array, &key, p2)) return BasicError;
+   found = bsearch(&key, var->value.var.array, array->count, array->elSize, array_cmp(var));
+   rpn_push_queue(RPN_INT(found ? (int32_t)((found - (char *)var->value.var.array) / array->elSize) : -1));
+   return BasicError = BASIC_ERR_NONE;
+};
+
+/// dot(a, b), float arrays with the same number of elements
+_bas_err_e __dot(_rpn_type_t *p2)
+{
+   _rpn_type_t *p1 = rpn_pull_queue();
+   _bas_var_t *a, *b;
+   uint32_t count;
+   float result = 0;
+   if (((a = array_param(p1, true)) == NULL) || ((b = array_param(p2, true)) == NULL)) return BasicError;
+   if ((a->value.type != VAR_TYPE_ARRAY_FLOAT) || (b->value.type != VAR_TYPE_ARRAY_FLOAT)) return BasicError = BASIC_ERR_TYPE_MISMATCH;
+   if ((count = a->param.array->count) != b->param.array->count) return BasicError = BASIC_ERR_ARRAY_DIMENTION;
+#if BASIC_MAT_CMSIS
+   arm_dot_prod_f32(a->value.var.array, b->value.var.array, count, &result);
+#else
+   for (const float *x = a->value.var.array, *y = b->value.var.array; count--;)
+      result += *x++ * *y++;
+#endif
+   rpn_push_queue(RPN_FLOAT(result));
+   return BasicError = BASIC_ERR_NONE;
+};
+
+/// MAT operates on float arrays of two dimensions, a one dimension array is a column vector
+typedef struct
+{
+   uint16_t rows;
+   uint16_t cols;
+   float *data;
+} _bas_mat_t;
+
+static _bas_err_e mat_get(char *name, _bas_mat_t *m)
+{
+   _bas_var_t *var;
+   if ((var = var_get(name)) == NULL) return BasicError = BASIC_ERR_UNKNOWN_VAR;
+   if (var->value.type != VAR_TYPE_ARRAY_FLOAT) return BasicError = BASIC_ERR_TYPE_MISMATCH;
+   if (var->param.array->dims > 2) return BasicError = BASIC_ERR_ARRAY_DIMENTION;
+   m->rows = var->param.array->size[0];
+   m->cols = (var->param.array->dims == 2) ? var->param.array->size[1] : 1;
+   m->data = var->value.var.array;
+   return BasicError = BASIC_ERR_NONE;
+}
+
+/// the result shape, a vector fits either way
+static _bas_err_e mat_fit(_bas_mat_t *m, uint16_t rows, uint16_t cols)
+{
+   if (((uint32_t)m->rows * m->cols != (uint32_t)rows * cols) || ((m->rows != rows) && (rows != 1) && (cols != 1)))
+      return BasicError = BASIC_ERR_ARRAY_DIMENTION;
+   m->rows = rows;
+   m->cols = cols;
+   return BasicError = BASIC_ERR_NONE;
+}
+
+/// the last operand ends the statement
+static _bas_err_e mat_end(void)
+{
+   uint8_t op = bToken->t[bToken->ptr].op;
+   return BasicError = (!op || (op == ':')) ? BASIC_ERR_NONE : BASIC_ERR_INVALID_DELIMITER;
+}
+
+#if BASIC_MAT_CMSIS
+static arm_matrix_instance_f32 mat_arm(_bas_mat_t *m)
+{
+   arm_matrix_instance_f32 inst;
+   arm_mat_init_f32(&inst, m->rows, m->cols, m->data);
+   return inst;
+}
+#endif
+
+static void mat_add(_bas_mat_t *a, _bas_mat_t *b, _bas_mat_t *c, bool sub)
+{
+#if BASIC_MAT_CMSIS
+   arm_matrix_instance_f32 x = mat_arm(a), y = mat_arm(b), z = mat_arm(c);
+   if (sub)
+      arm_mat_sub_f32(&x, &y, &z);
+   else
+      arm_mat_add_f32(&x, &y, &z);
+#else
+   for (uint32_t i = 0, n = a->rows * a->cols; i < n; i++)
+      c->data[i] = sub ? a->data[i] - b->data[i] : a->data[i] + b->data[i];
+#endif
+}
+
+static void mat_scale(_bas_mat_t *a, float k, _bas_mat_t *c)
+{
+#if BASIC_MAT_CMSIS
+   arm_matrix_instance_f32 x = mat_arm(a), z = mat_arm(c);
+   arm_mat_scale_f32(&x, k, &z);
+#else
+   for (uint32_t i = 0, n = a->rows * a->cols; i < n; i++)
+      c->data[i] = a->data[i] * k;
+#endif
+}
+
+/// "c" doesn't overlap the operands
+static void mat_mult(_bas_mat_t *a, _bas_mat_t *b, _bas_mat_t *c)
+{
+#if BASIC_MAT_CMSIS
+   arm_matrix_instance_f32 x = mat_arm(a), y = mat_arm(b), z = mat_arm(c);
+   arm_mat_mult_f32(&x, &y, &z);
+#else
+   float *dst = c->data;
+   for (uint16_t r = 0; r < a->rows; r++)
+      for (uint16_t col = 0; col < b->cols; col++)
+      {
+         const float *x = a->data + r * a->cols, *y = b->data + col;
+         float sum = 0;
+         for (uint16_t i = a->cols; i--; y += b->cols)
+            sum += *x++ * *y;
+         *dst++ = sum;
+      }
+#endif
+}
+
+static void mat_trans(_bas_mat_t *a, _bas_mat_t *c)
+{
+#if BASIC_MAT_CMSIS
+   arm_matrix_instance_f32 x = mat_arm(a), z = mat_arm(c);
+   arm_mat_trans_f32(&x, &z);
+#else
+   for (uint16_t r = 0; r < a->rows; r++)
+      for (uint16_t col = 0; col < a->cols; col++)
+         c->data[col * a->rows + r] = a->data[r * a->cols + col];
+#endif
+}
+
+/// Gauss-Jordan with partial pivoting, "a" is destroyed
+static _bas_err_e mat_inverse(_bas_mat_t *a, _bas_mat_t *c)
+{
+#if BASIC_MAT_CMSIS
+   arm_matrix_instance_f32 x = mat_arm(a), z = mat_arm(c);
+   if (arm_mat_inverse_f32(&x, &z) == ARM_MATH_SINGULAR) return BasicError = BASIC_ERR_MAT_SINGULAR;
+#else
+   uint16_t n = a->rows;
+   for (uint32_t i = 0; i < n * n; i++)
+      c->data[i] = (i % (n + 1)) ? 0.0f : 1.0f;
+   for (uint16_t col = 0; col < n; col++)
+   {
+      uint16_t pivot = col;
+      float *pa, *pc, k;
+      for (uint16_t r = col + 1; r < n; r++)
+         if (fabsf(a->data[r * n + col]) > fabsf(a->data[pivot * n + col])) pivot = r;
+      if (a->data[pivot * n + col] == 0.0f) return BasicError = BASIC_ERR_MAT_SINGULAR;
+      pa = a->data + col * n;
+      pc = c->data + col * n;
+      if (pivot != col)
+         for (uint16_t i = 0; i < n; i++)
+         {
+            float t = pa[i];
+            pa[i] = a->data[pivot * n + i];
+            a->data[pivot * n + i] = t;
+            t = pc[i];
+            pc[i] = c->data[pivot * n + i];
+            c->data[pivot * n + i] = t;
+         }
+      k = 1.0f / pa[col];
+      for (uint16_t i = 0; i < n; i++)
+      {
+         pa[i] *= k;
+         pc[i] *= k;
+      }
+      for (uint16_t r = 0; r < n; r++)
+      {
+         if ((r == col) || ((k = a->data[r * n + col]) == 0.0f)) continue;
+         for (uint16_t i = 0; i < n; i++)
+         {
+            a->data[r * n + i] -= k * pa[i];
+            c->data[r * n + i] -= k * pc[i];
+         }
+      }
+   }
+#endif
+   return BasicError = BASIC_ERR_NONE;
+}
+
+/// (k) * A, the scalar is an expression in brackets
+static _bas_err_e mat_scalar(float *k)
+{
+   uint8_t depth = 1, i;
+   _rpn_type_t *value;
+   for (i = ++bToken->ptr; i < PARSER_MAX_TOKENS - 1 && bToken->t[i].op; i++)
+   {
+      if (bToken->t[i].op == '(') depth++;
+      if ((bToken->t[i].op == ')') && !--depth)
+      {
+         bToken->t[i].op = ';'; // set delimeter for token evaluation
+         break;
+      }
+   }
+   if (bToken->t[i].op != ';') return BasicError = BASIC_ERR_PAR_MISMATCH;
+   if (token_eval_expression(0) != BASIC_ERR_NONE) return BasicError;
+   if ((value = rpn_pull_queue())->type < VAR_TYPE_FLOAT) return BasicError = BASIC_ERR_TYPE_MISMATCH;
+   *k = (value->type & VAR_TYPE_FLOAT) ? value->var.f : (float)value->var.i;
+   bToken->ptr++;
+   return BasicError = BASIC_ERR_NONE;
+}
+
+/// MAT C = A + B, A - B, A * B, A * k, (k) * A, TRN(A), INV(A) or A
+_bas_err_e __mat(_rpn_type_t *param)
+{
+   _bas_mat_t a, b, c, tmp;
+   char *name;
+   uint8_t op;
+   float k = 0;
+   if (mat_get(bToken->t[bToken->ptr].str, &c)) return BasicError;
+   if (bToken->t[bToken->ptr++].op != '=') return BasicError = BASIC_ERR_MISSING_EQUAL;
+   name = bToken->t[bToken->ptr].str;
+   op = bToken->t[bToken->ptr].op;
+   if (!*name && (op == '(')) // (k) * A
+   {
+      if (mat_scalar(&k)) return BasicError;
+      if (*bToken->t[bToken->ptr].str || (bToken->t[bToken->ptr++].op != '*')) return BasicError = BASIC_ERR_MISSING_OPERATOR;
+      if (mat_get(bToken->t[bToken->ptr].str, &a) || mat_end() || mat_fit(&c, a.rows, a.cols)) return BasicError;
+      mat_scale(&a, k, &c);
+      return BasicError = BASIC_ERR_NONE;
+   }
+   if (op == '(') // TRN(A), INV(A)
+   {
+      bool inverse = !strcmp(name, "inv");
+      if (!inverse && strcmp(name, "trn")) return BasicError = BASIC_ERR_UNKNOWN_FUNC;
+      if (mat_get(bToken->t[++bToken->ptr].str, &a)) return BasicError;
+      if (bToken->t[bToken->ptr++].op != ')') return BasicError = BASIC_ERR_PAR_MISMATCH;
+      if (mat_end() || mat_fit(&c, inverse ? a.rows : a.cols, inverse ? a.cols : a.rows)) return BasicError;
+      if (inverse && (a.rows != a.cols)) return BasicError = BASIC_ERR_ARRAY_DIMENTION;
+      tmp = a;
+      if ((tmp.data = pvPortMalloc(a.rows * a.cols * sizeof(float))) == NULL) return BasicError = BASIC_ERR_MEM_OUT;
+      memcpy(tmp.data, a.data, a.rows * a.cols * sizeof(float)); // the operand may be the result
+      if (inverse)
+         mat_inverse(&tmp, &c);
+      else
+         mat_trans(&tmp, &c);
+      vPortFree(tmp.data);
+      return BasicError;
+   }
+   if (mat_get(name, &a)) return BasicError;
+   switch (op)
+   {
+   case '\0':
+   case ':': // A
+      if (mat_fit(&c, a.rows, a.cols)) return BasicError;
+      memmove(c.data, a.data, a.rows * a.cols * sizeof(float));
+      break;
+   case '+':
+   case '-':
+      if (mat_get(bToken->t[++bToken->ptr].str, &b) || mat_end()) return BasicError;
+      if ((a.rows != b.rows) || (a.cols != b.cols) || mat_fit(&c, a.rows, a.cols)) return BasicError = BASIC_ERR_ARRAY_DIMENTION;
+      mat_add(&a, &b, &c, op == '-');
+      break;
+   case '*':
+   {
+      _bas_var_t *var = var_get(bToken->t[++bToken->ptr].str);
+      if (!var || !(var->value.type & VAR_TYPE_ARRAY) || (bToken->t[bToken->ptr].op && (bToken->t[bToken->ptr].op != ':'))) // A * k
+      {
+         if (token_eval_expression(0) != BASIC_ERR_NONE) return BasicError;
+         _rpn_type_t *value = rpn_pull_queue();
+         if (value->type < VAR_TYPE_FLOAT) return BasicError = BASIC_ERR_TYPE_MISMATCH;
+         if (mat_fit(&c, a.rows, a.cols)) return BasicError;
+         mat_scale(&a, (value->type & VAR_TYPE_FLOAT) ? value->var.f : (float)value->var.i, &c);
+         break;
+      }
+      if (mat_get(bToken->t[bToken->ptr].str, &b)) return BasicError;
+      if ((a.cols != b.rows) || mat_fit(&c, a.rows, b.cols)) return BasicError = BASIC_ERR_ARRAY_DIMENTION;
+      if ((c.data == a.data) || (c.data == b.data)) // the result is collected apart
+      {
+         tmp = c;
+         if ((tmp.data = pvPortMalloc(c.rows * c.cols * sizeof(float))) == NULL) return BasicError = BASIC_ERR_MEM_OUT;
+         mat_mult(&a, &b, &tmp);
+         memcpy(c.data, tmp.data, c.rows * c.cols * sizeof(float));
+         vPortFree(tmp.data);
+      }
+      else
+         mat_mult(&a, &b, &c);
+      break;
+   }
+   default:
+      return BasicError = BASIC_ERR_MISSING_OPERATOR;
+   }
+   return BasicError = BASIC_ERR_NONE;
+};
+
 /// math functions
 _bas_err_e __pwr(_rpn_type_t *p2)
 {
@@ -155,43 +674,171 @@ _bas_err_e var_float(_rpn_type_t *var)
    return BasicError = BASIC_ERR_NONE;
 }
 
+#if BASIC_FAST_MATH
+/// sin over a quarter period, linear interpolation between the entries keeps the error below 2e-5
+/// for |x| < BASIC_SIN_LIMIT. Beyond that the float step count loses its fraction bits, libm takes over
+static const float SinTable[BASIC_SIN_STEPS + 1] = {
+    0.000000000f, 0.012271538f, 0.024541229f, 0.036807223f, 0.049067674f, 0.061320736f, 0.073564564f, 0.085797312f,
+    0.098017140f, 0.110222207f, 0.122410675f, 0.134580709f, 0.146730474f, 0.158858143f, 0.170961889f, 0.183039888f,
+    0.195090322f, 0.207111376f, 0.219101240f, 0.231058108f, 0.242980180f, 0.254865660f, 0.266712757f, 0.278519689f,
+    0.290284677f, 0.302005949f, 0.313681740f, 0.325310292f, 0.336889853f, 0.348418680f, 0.359895037f, 0.371317194f,
+    0.382683432f, 0.393992040f, 0.405241314f, 0.416429560f, 0.427555093f, 0.438616239f, 0.449611330f, 0.460538711f,
+    0.471396737f, 0.482183772f, 0.492898192f, 0.503538384f, 0.514102744f, 0.524589683f, 0.534997620f, 0.545324988f,
+    0.555570233f, 0.565731811f, 0.575808191f, 0.585797857f, 0.595699304f, 0.605511041f, 0.615231591f, 0.624859488f,
+    0.634393284f, 0.643831543f, 0.653172843f, 0.662415778f, 0.671558955f, 0.680600998f, 0.689540545f, 0.698376249f,
+    0.707106781f, 0.715730825f, 0.724247083f, 0.732654272f, 0.740951125f, 0.749136395f, 0.757208847f, 0.765167266f,
+    0.773010453f, 0.780737229f, 0.788346428f, 0.795836905f, 0.803207531f, 0.810457198f, 0.817584813f, 0.824589303f,
+    0.831469612f, 0.838224706f, 0.844853565f, 0.851355193f, 0.857728610f, 0.863972856f, 0.870086991f, 0.876070094f,
+    0.881921264f, 0.887639620f, 0.893224301f, 0.898674466f, 0.903989293f, 0.909167983f, 0.914209756f, 0.919113852f,
+    0.923879533f, 0.928506080f, 0.932992799f, 0.937339012f, 0.941544065f, 0.945607325f, 0.949528181f, 0.953306040f,
+    0.956940336f, 0.960430519f, 0.963776066f, 0.966976471f, 0.970031253f, 0.972939952f, 0.975702130f, 0.978317371f,
+    0.980785280f, 0.983105487f, 0.985277642f, 0.987301418f, 0.989176510f, 0.990902635f, 0.992479535f, 0.993906970f,
+    0.995184727f, 0.996312612f, 0.997290457f, 0.998118113f, 0.998795456f, 0.999322385f, 0.999698819f, 0.999924702f,
+    1.000000000f,
+};
+
+/// "pos" is the angle in table steps, BASIC_SIN_STEPS per quarter period
+static float fast_sin_steps(float pos)
+{
+   bool neg = pos < 0;
+   uint32_t n, quadrant;
+   float frac, s;
+   if (neg) pos = -pos;
+   n = (uint32_t)pos;
+   frac = pos - n;
+   quadrant = (n / BASIC_SIN_STEPS) & 3;
+   n %= BASIC_SIN_STEPS;
+   if (quadrant & 1) // falling quarter, mirrored
+   {
+      n = BASIC_SIN_STEPS - n - 1;
+      frac = 1.0f - frac;
+   }
+   s = SinTable[n] + (SinTable[n + 1] - SinTable[n]) * frac;
+   return ((quadrant & 2) != 0) != neg ? -s : s;
+}
+
+static float fast_sin(float x)
+{
+   return (fabsf(x) < BASIC_SIN_LIMIT) ? fast_sin_steps(x * (float)(BASIC_SIN_STEPS * 2 / M_PI)) : sinf(x);
+}
+
+static float fast_cos(float x)
+{
+   return (fabsf(x) < BASIC_SIN_LIMIT) ? fast_sin_steps(fabsf(x) * (float)(BASIC_SIN_STEPS * 2 / M_PI) + BASIC_SIN_STEPS) : cosf(x);
+}
+
+/// odd polynomial on [-1, 1] (Abramowitz & Stegun 4.4.49), the error is below 1.2e-5, 1/x folds the rest
+static float fast_atan(float x)
+{
+   bool inv = (x > 1.0f) || (x < -1.0f);
+   float t = inv ? 1.0f / x : x, t2 = t * t, a;
+   a = t * (0.9998660f + t2 * (-0.3302995f + t2 * (0.1801410f + t2 * (-0.0851330f + t2 * 0.0208351f))));
+   if (inv) a = (x > 0 ? (float)(M_PI / 2) : (float)(-M_PI / 2)) - a; // the sign of x, 1/inf is +0 or -0
+   return a;
+}
+
+/// the FPU instruction, libm sqrtf adds the errno handling
+static float fast_sqrt(float x)
+{
+#if defined(__ARM_FP)
+   __asm__("vsqrt.f32 %0, %1" : "=t"(x) : "t"(x));
+   return x;
+#else
+   return sqrtf(x);
+#endif
+}
+#define bas_sinf  fast_sin
+#define bas_cosf  fast_cos
+#define bas_tanf(x) (fast_sin(x) / fast_cos(x))
+#define bas_atanf fast_atan
+#define bas_sqrtf fast_sqrt
+#else
+#define bas_sinf  sinf
+#define bas_cosf  cosf
+#define bas_tanf  tanf
+#define bas_atanf atanf
+#define bas_sqrtf sqrtf
+#endif
+
 _bas_err_e __sin(_rpn_type_t *param)
 {
    if (var_float(param) != BASIC_ERR_NONE) return BasicError;
-   rpn_push_queue(RPN_FLOAT(sinf(param->var.f)));
+   rpn_push_queue(RPN_FLOAT(bas_sinf(param->var.f)));
    return BasicError = BASIC_ERR_NONE;
 };
 
 _bas_err_e __cos(_rpn_type_t *param)
 {
    if (var_float(param) != BASIC_ERR_NONE) return BasicError;
-   rpn_push_queue(RPN_FLOAT(cosf(param->var.f)));
+   rpn_push_queue(RPN_FLOAT(bas_cosf(param->var.f)));
    return BasicError = BASIC_ERR_NONE;
 };
 _bas_err_e __tan(_rpn_type_t *param)
 {
    if (var_float(param) != BASIC_ERR_NONE) return BasicError;
-   rpn_push_queue(RPN_FLOAT(tanf(param->var.f)));
+   rpn_push_queue(RPN_FLOAT(bas_tanf(param->var.f)));
    return BasicError = BASIC_ERR_NONE;
 };
 _bas_err_e __atn(_rpn_type_t *param)
 {
    if (var_float(param) != BASIC_ERR_NONE) return BasicError;
-   rpn_push_queue(RPN_FLOAT(atanf(param->var.f)));
+   rpn_push_queue(RPN_FLOAT(bas_atanf(param->var.f)));
    return BasicError = BASIC_ERR_NONE;
 };
 _bas_err_e __sqr(_rpn_type_t *param)
 {
    if (var_float(param) != BASIC_ERR_NONE) return BasicError;
-   rpn_push_queue(RPN_FLOAT(sqrtf(param->var.f)));
+   rpn_push_queue(RPN_FLOAT(bas_sqrtf(param->var.f)));
    return BasicError = BASIC_ERR_NONE;
 };
+/// PCG32 (XSH RR), seeded from the TRNG on the first use or by RANDOMIZE n for repeatable runs
+static uint64_t RndState;
+static bool RndSeeded = false;
+
+static uint32_t rnd_next(void)
+{
+   uint64_t old = RndState;
+   uint32_t xorShifted = (uint32_t)(((old >> 18) ^ old) >> 27);
+   uint32_t rot = (uint32_t)(old >> 59);
+   RndState = old * 6364136223846793005ULL + BASIC_RND_STREAM;
+   return (xorShifted >> rot) | (xorShifted << ((-rot) & 31));
+}
+
+static void rnd_seed(uint64_t seed)
+{
+   RndState = 0;
+   rnd_next();
+   RndState += seed;
+   rnd_next();
+   RndSeeded = true;
+}
+
+/// RANDOMIZE [seed], without the seed the generator is seeded from the TRNG again
+_bas_err_e __randomize(_rpn_type_t *param)
+{
+   _rpn_type_t *var;
+   if (!param->var.i || (param->var.i == ':'))
+   {
+      rnd_seed(((uint64_t)rnd_word() << 32) | rnd_word());
+      return BasicError = BASIC_ERR_NONE;
+   }
+   if (token_eval_expression(param->var.i)) return BasicError;
+   var = rpn_pull_queue();
+   if (var->type < VAR_TYPE_FLOAT) return BasicError = var->type ? BASIC_ERR_TYPE_MISMATCH : BASIC_ERR_FEW_ARGUMENTS;
+   rnd_seed((var->type & VAR_TYPE_FLOAT) ? (uint64_t)(int64_t)var->var.f : (uint64_t)(int64_t)var->var.i);
+   return BasicError = BASIC_ERR_NONE;
+}
+
+/// RND(n) is an integer from 0 to n-1, RND(0) a fraction from 0 to 1
 _bas_err_e __rnd(_rpn_type_t *param)
 {
    if (param->type < VAR_TYPE_FLOAT) return BasicError = param->type ? BASIC_ERR_TYPE_MISMATCH : BASIC_ERR_FEW_ARGUMENTS;
    uint32_t range = (param->type & VAR_TYPE_FLOAT) ? param->var.f : param->var.i;
-   // if(seed < 2) seed = 2;
-   rpn_push_queue(RPN_FLOAT((float)(rnd(range))));
+   if (!RndSeeded) rnd_seed(((uint64_t)rnd_word() << 32) | rnd_word());
+   if (range)
+      rpn_push_queue(RPN_FLOAT((float)(((uint64_t)rnd_next() * range) >> 32))); // scaled without a division
+   else
+      rpn_push_queue(RPN_FLOAT((float)(rnd_next() >> 8) * (1.0f / 16777216.0f))); // 24 bits fit the mantissa
    return BasicError = BASIC_ERR_NONE;
 };
 _bas_err_e __log(_rpn_type_t *param)
@@ -214,6 +861,7 @@ _bas_err_e __rad(_rpn_type_t *param)
 };
 _bas_err_e __min(_rpn_type_t *p1)
 {
+   if (p1->type == VAR_TYPE_ARRAY) return array_extreme_push(p1, false, false); // min(array)
    _rpn_type_t *p2 = rpn_pull_queue();
    if ((p1->type < VAR_TYPE_FLOAT) || (p2->type < VAR_TYPE_FLOAT))
       return BasicError = (p1->type && p2->type) ? BASIC_ERR_TYPE_MISMATCH : BASIC_ERR_FEW_ARGUMENTS;
@@ -227,6 +875,7 @@ _bas_err_e __min(_rpn_type_t *p1)
 };
 _bas_err_e __max(_rpn_type_t *p1)
 {
+   if (p1->type == VAR_TYPE_ARRAY) return array_extreme_push(p1, true, false); // max(array)
    _rpn_type_t *p2 = rpn_pull_queue();
    if ((p1->type < VAR_TYPE_FLOAT) || (p2->type < VAR_TYPE_FLOAT))
       return BasicError = (p1->type && p2->type) ? BASIC_ERR_TYPE_MISMATCH : BASIC_ERR_FEW_ARGUMENTS;
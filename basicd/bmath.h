@@ -37,11 +37,21 @@ _bas_err_e __tan(_rpn_type_t *param);
 _bas_err_e __atn(_rpn_type_t *param);
 _bas_err_e __sqr(_rpn_type_t *param);
 _bas_err_e __rnd(_rpn_type_t *param);
+_bas_err_e __randomize(_rpn_type_t *param);
 _bas_err_e __log(_rpn_type_t *param);
 _bas_err_e __deg(_rpn_type_t *param);
 _bas_err_e __rad(_rpn_type_t *param);
 _bas_err_e __min(_rpn_type_t *param);
 _bas_err_e __max(_rpn_type_t *param);
+_bas_err_e __fill(_rpn_type_t *param);
+_bas_err_e __copy(_rpn_type_t *param);
+_bas_err_e __sum(_rpn_type_t *param);
+_bas_err_e __imin(_rpn_type_t *param);
+_bas_err_e __imax(_rpn_type_t *param);
+_bas_err_e __sort(_rpn_type_t *param);
+_bas_err_e __search(_rpn_type_t *param);
+_bas_err_e __dot(_rpn_type_t *param);
+_bas_err_e __mat(_rpn_type_t *param);
 
 _bas_err_e __and(_rpn_type_t *p1);
 _bas_err_e __or(_rpn_type_t *p1);
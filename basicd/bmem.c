@@ -0,0 +1,211 @@
+/**-----------------------------------------------------------------------------
+ * Copyright (c) 2025 Sergey Sanders
+ * sergey@sesadesign.com
+ * -----------------------------------------------------------------------------
+ * Licensed under Creative Commons Attribution-NonCommercial-ShareAlike 4.0
+ * International (CC BY-NC-SA 4.0). 
+ * 
+ * You are free to:
+ *  - Share: Copy and redistribute the material.
+ *  - Adapt: Remix, transform, and build upon the material.
+ * 
+ * Under the following terms:
+ *  - Attribution: Give appropriate credit and indicate changes.
+ *  - NonCommercial: Do not use for commercial purposes.
+ *  - ShareAlike: Distribute under the same license.
+ * 
+ * DISCLAIMER: This work is provided "as is" without any guarantees. The authors
+ * aren’t responsible for any issues, damages, or claims that come up from using
+ * it. Use at your own risk!
+ * 
+ * Full license: http://creativecommons.org/licenses/by-nc-sa/4.0/
+ * ---------------------------------------------------------------------------*/
+/**
+ * @file bmem.c
+ * @author Sergey Sanders
+ * @brief BASIC memory arenas
+ *
+ * The program, the variables and the strings live in arenas made of chunks taken from
+ * the system heap. Blocks are bump allocated, a freed block on top of its chunk
+ * is rolled back (an emptied chunk goes back to the heap), the others are marked
+ * and reused first fit once the head chunk is full. NEW and CLEAR drop whole arenas, the program arena is
+ * compacted by copying the lines (see prog_compact() in bcore.c).
+ */
+#include <string.h>
+#include "freeRTOS.h"
+#include "bcore.h"
+#include "bmem.h"
+
+#define ARENA_ALIGN(x) (((x) + 3) & ~3)
+#define ARENA_FREE 0x01 // block size is 4 aligned, bit 0 marks a free block
+
+typedef struct
+{
+   uint32_t size; // including the header
+} _arena_block_t;
+
+_bas_arena_t ProgArena = {.name = "program"};
+_bas_arena_t VarArena = {.name = "variables"};
+_bas_arena_t StrArena = {.name = "strings"};
+
+/// first fit over the chunks' free tops and freed blocks, adjacent free blocks are merged on the way
+static _arena_block_t *arena_reuse(_bas_arena_t *arena, uint32_t size)
+{
+   for (_arena_chunk_t *chunk = arena->chunk; chunk; chunk = chunk->next)
+   {
+      uint8_t *end = chunk->data + chunk->top;
+      if (chunk->top + size <= chunk->size) // room left on top of an older chunk
+      {
+         chunk->top += size;
+         ((_arena_block_t *)end)->size = size;
+         return (_arena_block_t *)end;
+      }
+      for (uint8_t *ptr = chunk->data; ptr < end; ptr += ((_arena_block_t *)ptr)->size & ~ARENA_FREE)
+      {
+         _arena_block_t *block = (_arena_block_t *)ptr;
+         if (!(block->size & ARENA_FREE))
+            continue;
+         _arena_block_t *next = (_arena_block_t *)(ptr + (block->size & ~ARENA_FREE));
+         while (((uint8_t *)next < end) && (next->size & ARENA_FREE))
+         {
+            block->size += next->size & ~ARENA_FREE;
+            next = (_arena_block_t *)(ptr + (block->size & ~ARENA_FREE));
+         }
+         if ((block->size & ~ARENA_FREE) < size)
+            continue;
+         if ((block->size & ~ARENA_FREE) - size > sizeof(_arena_block_t)) // split, the rest stays free
+         {
+            ((_arena_block_t *)(ptr + size))->size = ((block->size & ~ARENA_FREE) - size) | ARENA_FREE;
+            block->size = size;
+         }
+         else
+            block->size &= ~ARENA_FREE;
+         arena->garbage -= block->size;
+         return block;
+      }
+   }
+   return NULL;
+}
+
+void *arena_alloc(_bas_arena_t *arena, uint32_t size)
+{
+   _arena_chunk_t *chunk = arena->chunk;
+   _arena_block_t *block;
+   size = ARENA_ALIGN(size + sizeof(_arena_block_t));
+   if (chunk && (chunk->top + size <= chunk->size))
+   {
+      block = (_arena_block_t *)(chunk->data + chunk->top);
+      chunk->top += size;
+      block->size = size;
+   }
+   else if ((block = arena_reuse(arena, size)) == NULL)
+   {
+      uint32_t chunkSize = (size > BASIC_ARENA_CHUNK) ? size : BASIC_ARENA_CHUNK;
+      if ((chunk = pvPortMalloc(sizeof(_arena_chunk_t) + chunkSize)) == NULL)
+         return NULL;
+      chunk->size = chunkSize;
+      chunk->top = size;
+      if ((chunkSize > BASIC_ARENA_CHUNK) && arena->chunk) // keep bumping the current one
+      {
+         chunk->next = arena->chunk->next;
+         arena->chunk->next = chunk;
+      }
+      else
+      {
+         chunk->next = arena->chunk;
+         arena->chunk = chunk;
+      }
+      arena->chunks++;
+      block = (_arena_block_t *)chunk->data;
+      block->size = size;
+   }
+   arena->used += block->size;
+   if (arena->used > arena->peak)
+      arena->peak = arena->used;
+   arena->allocs++;
+   return block + 1;
+}
+
+void arena_free(_bas_arena_t *arena, void *ptr)
+{
+   _arena_block_t *block = (_arena_block_t *)ptr - 1;
+   _arena_chunk_t *chunk = arena->chunk, *prev = NULL;
+   if (!ptr)
+      return;
+   arena->used -= block->size;
+   arena->frees++;
+   while (chunk && (((uint8_t *)block < chunk->data) || ((uint8_t *)block >= chunk->data + chunk->size)))
+   {
+      prev = chunk;
+      chunk = chunk->next;
+   }
+   if (chunk && ((uint8_t *)block + block->size == chunk->data + chunk->top)) // on top, roll back
+   {
+      chunk->top -= block->size;
+      if (!chunk->top && prev) // an emptied chunk other than the head one goes back to the heap
+      {
+         prev->next = chunk->next;
+         vPortFree(chunk);
+         arena->chunks--;
+      }
+   }
+   else
+   {
+      arena->garbage += block->size;
+      block->size |= ARENA_FREE;
+   }
+}
+
+uint32_t arena_size(void *ptr)
+{
+   return ((_arena_block_t *)ptr - 1)->size - sizeof(_arena_block_t);
+}
+
+bool arena_owns(_bas_arena_t *arena, void *ptr)
+{
+   for (_arena_chunk_t *chunk = arena->chunk; chunk; chunk = chunk->next)
+      if (((uint8_t *)ptr >= chunk->data) && ((uint8_t *)ptr < chunk->data + chunk->top))
+         return true;
+   return false;
+}
+
+void *arena_dup(_bas_arena_t *arena, void *ptr)
+{
+   void *copy = arena_alloc(arena, arena_size(ptr));
+   if (copy)
+      memcpy(copy, ptr, arena_size(ptr));
+   return copy;
+}
+
+/// hand the chunks over to "old" and start the arena empty, the statistics carry on
+void arena_detach(_bas_arena_t *arena, _bas_arena_t *old)
+{
+   *old = *arena;
+   arena->chunk = NULL;
+   arena->chunks = 0;
+   arena->used = 0;
+   arena->garbage = 0;
+}
+
+void arena_reset(_bas_arena_t *arena)
+{
+   while (arena->chunk)
+   {
+      _arena_chunk_t *next = arena->chunk->next;
+      vPortFree(arena->chunk);
+      arena->chunk = next;
+   }
+   arena->chunks = 0;
+   arena->used = 0;
+   arena->garbage = 0;
+}
+
+void arena_print(_bas_arena_t *arena)
+{
+   uint32_t total = 0;
+   for (_arena_chunk_t *chunk = arena->chunk; chunk; chunk = chunk->next)
+      total += chunk->size;
+   b_printf("%s: %d used, %d freed, %d total in %d chunks, %d%% fragmented\n", arena->name, arena->used, arena->garbage, total,
+            arena->chunks, (arena->used + arena->garbage) ? arena->garbage * 100 / (arena->used + arena->garbage) : 0);
+   b_printf("   peak %d, %d allocs, %d frees, %d compactions\n", arena->peak, arena->allocs, arena->frees, arena->compactions);
+}
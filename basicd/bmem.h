@@ -0,0 +1,65 @@
+/**-----------------------------------------------------------------------------
+ * Copyright (c) 2025 Sergey Sanders
+ * sergey@sesadesign.com
+ * -----------------------------------------------------------------------------
+ * Licensed under Creative Commons Attribution-NonCommercial-ShareAlike 4.0
+ * International (CC BY-NC-SA 4.0). 
+ * 
+ * You are free to:
+ *  - Share: Copy and redistribute the material.
+ *  - Adapt: Remix, transform, and build upon the material.
+ * 
+ * Under the following terms:
+ *  - Attribution: Give appropriate credit and indicate changes.
+ *  - NonCommercial: Do not use for commercial purposes.
+ *  - ShareAlike: Distribute under the same license.
+ * 
+ * DISCLAIMER: This work is provided "as is" without any guarantees. The authors
+ * aren’t responsible for any issues, damages, or claims that come up from using
+ * it. Use at your own risk!
+ * 
+ * Full license: http://creativecommons.org/licenses/by-nc-sa/4.0/
+ * ---------------------------------------------------------------------------*/
+#ifndef _BMEM_H_INCLUDED
+#define _BMEM_H_INCLUDED
+
+#include "stdint.h"
+#include "stdbool.h"
+
+#define BASIC_ARENA_CHUNK 2048 // taken from the system heap at once, a bigger block gets a chunk of its own
+
+typedef struct _arena_chunk_s
+{
+    struct _arena_chunk_s *next;
+    uint32_t size; // data size
+    uint32_t top;  // bump offset
+    uint8_t data[0];
+} _arena_chunk_t;
+
+typedef struct
+{
+    const char *name;
+    _arena_chunk_t *chunk; // the head chunk is the one being bumped
+    uint32_t used;         // bytes in live blocks
+    uint32_t garbage;      // bytes in freed blocks, reused or dropped by compaction
+    uint32_t peak;
+    uint16_t chunks;
+    uint32_t allocs;
+    uint32_t frees;
+    uint16_t compactions;
+} _bas_arena_t;
+
+extern _bas_arena_t ProgArena; // program lines
+extern _bas_arena_t VarArena;  // variables, loops, arrays and DEF FN
+extern _bas_arena_t StrArena;  // string values, see bstring.c
+
+void *arena_alloc(_bas_arena_t *arena, uint32_t size);
+void arena_free(_bas_arena_t *arena, void *ptr);
+uint32_t arena_size(void *ptr);
+bool arena_owns(_bas_arena_t *arena, void *ptr);
+void *arena_dup(_bas_arena_t *arena, void *ptr);
+void arena_detach(_bas_arena_t *arena, _bas_arena_t *old);
+void arena_reset(_bas_arena_t *arena);
+void arena_print(_bas_arena_t *arena);
+
+#endif //_BMEM_H_INCLUDED
@@ -57,6 +57,7 @@ _bas_err_e __goto(_rpn_type_t *param)
    if (!bL) return BasicError = BASIC_ERR_INVALID_LINE;
    ExecLine.number = lineNum;
    ExecLine.statement = 0;
+   JumpLine = bL;
    BasicStat = BASIC_STAT_JUMP;
    return BasicError = BASIC_ERR_NONE;
 }
@@ -83,13 +84,17 @@ _bas_err_e __print(_rpn_type_t *param)
    }
    while (1)
    {
-      if (token_eval_expression(param->var.i)) return BasicError;
+      if (token_eval_expression(param->var.i))
+      {
+         basic_print_flush(); // what is printed before the error
+         return BasicError;
+      }
       while (1)
       {
          var = rpn_peek_queue(head);
          if (var->type == VAR_TYPE_NONE) // nothing to print
             break;
-         if (!head) b_printf("\n"); // print new line when separated by commas
+         if (!head) basic_print("\n", 1); // print new line when separated by commas
          head = false;
          basic_printf(var);
       }
@@ -99,7 +104,8 @@ _bas_err_e __print(_rpn_type_t *param)
       head = true;
    }
    if (!((bToken->t[bToken->ptr - 1].op == ';') && (*bToken->t[bToken->ptr].str == '\0'))) // string termination
-      b_printf("\n");
+      basic_print("\n", 1);
+   basic_print_flush();
    return BasicError = BASIC_ERR_NONE;
 };
 
@@ -195,7 +201,7 @@ _bas_err_e __let(_rpn_type_t *param)
    return BasicError = BASIC_ERR_NONE;
 };
 
-static _bas_err_e var_get_loop(float *var)
+static _bas_err_e var_get_loop(_bas_loop_val_t *var, bool isInt)
 {
    _rpn_type_t *tmpVar;
    uint8_t opParam = bToken->t[bToken->ptr].op;
@@ -210,10 +216,17 @@ static _bas_err_e var_get_loop(float *var)
    case VAR_TYPE_BOOL:
    case VAR_TYPE_WORD:
    case VAR_TYPE_BYTE:
-      tmpVar->var.f = (float)tmpVar->var.i;
+      if (isInt)
+         var->i = tmpVar->var.i;
+      else
+         var->f = (float)tmpVar->var.i;
+      break;
    case VAR_TYPE_FLOAT:
    case VAR_TYPE_LOOP:
-      *var = tmpVar->var.f;
+      if (isInt)
+         var->i = (int32_t)tmpVar->var.f;
+      else
+         var->f = tmpVar->var.f;
       break;
    default:
       return BasicError = BASIC_ERR_TYPE_MISMATCH;
@@ -221,33 +234,61 @@ static _bas_err_e var_get_loop(float *var)
    return BasicError = BASIC_ERR_NONE;
 }
 
+static void loop_cache_push(_bas_loop_t *loop)
+{
+   uint8_t i;
+   for (i = 0; i < BASIC_LOOP_CACHE - 1; i++)
+      if (LoopCache[i] == loop)
+         break;
+   for (; i; i--)
+      LoopCache[i] = LoopCache[i - 1];
+   LoopCache[0] = loop;
+}
+
 _bas_err_e __for(_rpn_type_t *param)
 {
    _bas_var_t *var;
+   _bas_loop_t *loop;
+   _bas_loop_val_t start;
+   _bas_line_t *bL;
    char *varName = bToken->t[bToken->ptr].str;
    BasicError = BASIC_ERR_NONE;
    if (bToken->t[bToken->ptr].op != '=') return BasicError = BASIC_ERR_MISSING_OPERATOR;
    if (bas_func_opcode(varName)) return BasicError = BASIC_ERR_RESERVED_NAME;
    if ((var = var_get(bToken->t[bToken->ptr].str)) == NULL)
       if ((var = var_add(bToken->t[bToken->ptr].str)) == NULL) return BasicError; // cannot add a variable
-   if (var->value.type != VAR_TYPE_LOOP)
+   bool isInt = var->value.type == VAR_TYPE_INT; // integer counters stay .i, the loop hangs on param.loop
+   if ((var->value.type != VAR_TYPE_LOOP) && !(isInt && var->param.loop))
    {
-      var->value.type = VAR_TYPE_LOOP;
-      if ((var->param.loop = pvPortMalloc(sizeof(_bas_loop_t))) == NULL) return BasicError = BASIC_ERR_MEM_OUT;
+      if (!isInt) var->value.type = VAR_TYPE_LOOP;
+      if ((var->param.loop = arena_alloc(&VarArena, sizeof(_bas_loop_t))) == NULL) return BasicError = BASIC_ERR_MEM_OUT;
    }
+   loop = var->param.loop;
+   loop->var = var;
+   loop->isInt = isInt;
 
-   if (var_get_loop(&var->value.var.f)) return BasicError;
-   var->value.type = VAR_TYPE_LOOP;
+   if (var_get_loop(&start, isInt)) return BasicError;
+   if (isInt)
+      var->value.var.i = start.i;
+   else
+      var->value.var.f = start.f;
    if (!bToken->t[bToken->ptr].op || ((uint8_t)*bToken->t[bToken->ptr].str != __OPCODE_TO))
       return BasicError = BASIC_ERR_INCOMPLETE_FOR;
-   if (var_get_loop(&var->param.loop->limit)) return BasicError;
-   var->param.loop->step = var->value.var.f < var->param.loop->limit ? 1 : -1;
+   if (var_get_loop(&loop->limit, isInt)) return BasicError;
+   if (isInt)
+      loop->step.i = var->value.var.i < loop->limit.i ? 1 : -1;
+   else
+      loop->step.f = var->value.var.f < loop->limit.f ? 1 : -1;
    if ((uint8_t)*bToken->t[bToken->ptr].str == __OPCODE_STEP)
-      if (var_get_loop(&var->param.loop->step)) return BasicError;
+      if (var_get_loop(&loop->step, isInt)) return BasicError;
 
-   var->param.loop->line.number = bToken->t[bToken->ptr].op == ':' ? ExecLine.number : ExecLine.nextNum;
-   var->param.loop->line.statement = bToken->t[bToken->ptr].op == ':' ? ExecLine.statement + 1 : 0;
-   var->param.loop->line.state = ExecLine.state;
+   bL = prog_exec_line();
+   loop->body = bToken->t[bToken->ptr].op == ':' ? bL : (bL ? bL->next : NULL);
+   loop->revision = ProgRevision;
+   loop->line.number = bToken->t[bToken->ptr].op == ':' ? ExecLine.number : ExecLine.nextNum;
+   loop->line.statement = bToken->t[bToken->ptr].op == ':' ? ExecLine.statement + 1 : 0;
+   loop->line.state = ExecLine.state;
+   loop_cache_push(loop);
    return BasicError = BASIC_ERR_NONE;
 };
 
@@ -264,13 +305,42 @@ _bas_err_e __step(_rpn_type_t *param)
 _bas_err_e __next(_rpn_type_t *param)
 {
    _bas_var_t *var;
+   _bas_loop_t *loop = NULL;
+   char *varName = bToken->t[bToken->ptr].str;
+   bool cont;
    BasicError = BASIC_ERR_NONE;
-   if (((var = var_get(bToken->t[bToken->ptr].str)) == NULL) || (var->value.type != VAR_TYPE_LOOP))
-      return BasicError = BASIC_ERR_INCOMPLETE_FOR;
-   var->value.var.f += var->param.loop->step;
-   if (((var->param.loop->step > 0) && (var->value.var.f <= var->param.loop->limit)) || ((var->param.loop->step < 0) && (var->value.var.f >= var->param.loop->limit)))
+#if BASIC_LOOP_DIRECT
+   for (uint8_t i = 0; i < BASIC_LOOP_CACHE && LoopCache[i]; i++)
+      if (!strcmp(varName, ((_bas_var_t *)LoopCache[i]->var)->name))
+      {
+         loop = LoopCache[i];
+         break;
+      }
+#endif
+   if (!loop)
    {
-      ExecLine = var->param.loop->line;
+      if (((var = var_get(varName)) == NULL) || !var->param.loop || ((var->value.type != VAR_TYPE_LOOP) && (var->value.type != VAR_TYPE_INT)))
+         return BasicError = BASIC_ERR_INCOMPLETE_FOR;
+      loop = var->param.loop;
+      loop_cache_push(loop);
+   }
+   var = loop->var;
+   if (loop->isInt)
+   {
+      var->value.var.i += loop->step.i;
+      cont = ((loop->step.i > 0) && (var->value.var.i <= loop->limit.i)) || ((loop->step.i < 0) && (var->value.var.i >= loop->limit.i));
+   }
+   else
+   {
+      var->value.var.f += loop->step.f;
+      cont = ((loop->step.f > 0) && (var->value.var.f <= loop->limit.f)) || ((loop->step.f < 0) && (var->value.var.f >= loop->limit.f));
+   }
+   if (cont)
+   {
+      ExecLine = loop->line;
+#if BASIC_LOOP_DIRECT
+      JumpLine = (loop->revision == ProgRevision) ? loop->body : NULL; // the program wasn't edited since FOR
+#endif
       BasicStat = BASIC_STAT_JUMP;
    }
    else
@@ -278,6 +348,13 @@ _bas_err_e __next(_rpn_type_t *param)
    return BasicError = BASIC_ERR_NONE;
 }
 
+/// return to the next statement, the caller has checked the stack depth
+static void gosub_push(void)
+{
+   GosubStack.line[GosubStack.ptr].number = bToken->t[bToken->ptr].op == ':' ? ExecLine.number : ExecLine.nextNum;
+   GosubStack.line[GosubStack.ptr++].statement = bToken->t[bToken->ptr].op == ':' ? ExecLine.statement + 1 : 0;
+}
+
 _bas_err_e __gosub(_rpn_type_t *param)
 {
    _rpn_type_t *tmpVar;
@@ -287,18 +364,76 @@ _bas_err_e __gosub(_rpn_type_t *param)
    if (token_eval_expression(param->var.i)) return BasicError;
    tmpVar = rpn_pull_queue();
    if (tmpVar->type < VAR_TYPE_FLOAT) return BasicError = BASIC_ERR_INVALID_LINE;
-   GosubStack.line[GosubStack.ptr].number = bToken->t[bToken->ptr].op == ':' ? ExecLine.number : ExecLine.nextNum;
-   GosubStack.line[GosubStack.ptr++].statement = bToken->t[bToken->ptr].op == ':' ? ExecLine.statement + 1 : 0;
+   gosub_push();
    lineNum = (tmpVar->type == VAR_TYPE_FLOAT) ? (uint16_t)tmpVar->var.f : (uint16_t)tmpVar->var.i;
    while (bL && (bL->number != lineNum))
       bL = bL->next;
    if (!bL) return BasicError = BASIC_ERR_INVALID_LINE;
    ExecLine.number = lineNum;
    ExecLine.statement = 0;
+   JumpLine = bL;
    BasicStat = BASIC_STAT_JUMP;
    return BasicError = BASIC_ERR_NONE;
 };
 
+/// ON expr GOTO/GOSUB l1,l2,... the list is resolved to lines once per statement and kept in OnCache,
+/// an index out of 1..count falls through to the next statement
+_bas_err_e __on(_rpn_type_t *param)
+{
+   static uint8_t onNext = 0; // round robin replacement
+   _rpn_type_t *tmpVar;
+   _bas_line_t *owner = prog_exec_line();
+   _bas_on_t *on = NULL;
+   int32_t index;
+   uint8_t opCode;
+   if (token_eval_expression(param->var.i)) return BasicError;
+   tmpVar = rpn_pull_queue();
+   if (tmpVar->type < VAR_TYPE_FLOAT) return BasicError = BASIC_ERR_TYPE_MISMATCH;
+   index = (tmpVar->type < VAR_TYPE_INT) ? (int32_t)tmpVar->var.f : tmpVar->var.i; // FOR variables are floats too
+   opCode = (uint8_t)*bToken->t[bToken->ptr].str;
+   if ((opCode != __OPCODE_GOTO) && (opCode != __OPCODE_GOSUB)) return BasicError = BASIC_ERR_NO_GOTO;
+   if (!bToken->t[bToken->ptr++].op) return BasicError = BASIC_ERR_FEW_ARGUMENTS;
+   for (uint8_t i = 0; i < BASIC_ON_CACHE; i++)
+      if ((OnCache[i].owner == owner) && (OnCache[i].statement == ExecLine.statement) && (OnCache[i].revision == ProgRevision))
+      {
+         on = &OnCache[i];
+         while (bToken->t[bToken->ptr].op == ',')
+            bToken->ptr++;
+         break;
+      }
+   if (!on)
+   {
+      on = &OnCache[onNext];
+      onNext = (onNext + 1) % BASIC_ON_CACHE;
+      on->owner = NULL; // stays unused if the list is wrong
+      on->count = 0;
+      while (1)
+      {
+         char *end;
+         uint16_t lineNum = (uint16_t)strtol(bToken->t[bToken->ptr].str, &end, 10);
+         if (on->count >= BASIC_ON_TARGETS) return BasicError = BASIC_ERR_MANY_ARGUMENTS;
+         if ((end == bToken->t[bToken->ptr].str) || *end) return BasicError = BASIC_ERR_INVALID_LINE;
+         if ((on->target[on->count++] = prog_find_line(lineNum)) == NULL) return BasicError = BASIC_ERR_INVALID_LINE;
+         if (bToken->t[bToken->ptr].op != ',') break;
+         bToken->ptr++;
+      }
+      on->owner = owner;
+      on->statement = ExecLine.statement;
+      on->revision = ProgRevision;
+   }
+   if ((index < 1) || (index > on->count)) return BasicError = BASIC_ERR_NONE;
+   if (opCode == __OPCODE_GOSUB)
+   {
+      if (GosubStack.ptr >= BASIC_GOSUB_STACK_SIZE) return BasicError = BASIC_ERR_GOSUB_OVERFLOW;
+      gosub_push();
+   }
+   JumpLine = on->target[index - 1];
+   ExecLine.number = JumpLine->number;
+   ExecLine.statement = 0;
+   BasicStat = BASIC_STAT_JUMP;
+   return BasicError = BASIC_ERR_NONE;
+}
+
 _bas_err_e __return(_rpn_type_t *param)
 {
    if (!GosubStack.ptr) return BasicError = BASIC_ERR_RETURN_NO_GOSUB;
@@ -307,58 +442,173 @@ _bas_err_e __return(_rpn_type_t *param)
    return BasicError = BASIC_ERR_NONE;
 };
 
-_bas_err_e __dim(_rpn_type_t *param)
+/// a loop entered again (or left by GOTO and restarted) reuses its frame and drops the ones above it
+static _bas_block_t *block_push(uint8_t opCode, _bas_line_t *body, uint16_t number, uint8_t statement)
 {
-   _bas_var_t *var;
-   char *varName = bToken->t[bToken->ptr].str;
-   if (bToken->t[bToken->ptr].op != '[') return BasicError = BASIC_ERR_PAR_MISMATCH;
-   if (bas_func_opcode(varName)) return BasicError = BASIC_ERR_RESERVED_NAME;
-   if ((var = var_get(bToken->t[bToken->ptr].str)) != NULL) return BasicError = BASIC_ERR_ARRAY_REDEFINE;
-   if ((var = var_add(bToken->t[bToken->ptr++].str)) == NULL) return BasicError; // cannot add a variable
-   var->param.size[0] = (uint16_t)strtol(bToken->t[bToken->ptr].str, NULL, 0);
-   var->param.size[1] = (bToken->t[bToken->ptr].op == ',') ? (uint16_t)strtol(bToken->t[++bToken->ptr].str, NULL, 0) : 0;
-   if ((var->param.size[0] == 0 && var->param.size[1] == 0) || (bToken->t[bToken->ptr].op != ']'))
-      return BasicError = BASIC_ERR_ARRAY_DIMENTION;
+   _bas_block_t *frame;
+   uint8_t i = BlockStack.ptr;
+   while (i && !((BlockStack.frame[i - 1].opCode == opCode) && (BlockStack.frame[i - 1].line.number == number) &&
+                 (BlockStack.frame[i - 1].line.statement == statement)))
+      i--;
+   if (i)
+      BlockStack.ptr = i;
+   else if (BlockStack.ptr >= BASIC_BLOCK_STACK_SIZE)
+   {
+      BasicError = BASIC_ERR_LOOP_OVERFLOW;
+      return NULL;
+   }
    else
+      BlockStack.ptr++;
+   frame = &BlockStack.frame[BlockStack.ptr - 1];
+   frame->opCode = opCode;
+   frame->body = body;
+   frame->revision = ProgRevision;
+   frame->line.number = number;
+   frame->line.statement = statement;
+   frame->line.state = ExecLine.state;
+   frame->exit = false;
+   return frame;
+}
+
+static void block_jump(_bas_block_t *frame)
+{
+   ExecLine = frame->line;
+   JumpLine = (frame->revision == ProgRevision) ? frame->body : NULL; // the program wasn't edited since the loop started
+   BasicStat = BASIC_STAT_JUMP;
+}
+
+/// scan the tokenized lines for the WEND closing the WHILE at "statement", nested loops are counted
+static bool block_find_wend(_bas_line_t *line, uint8_t statement, _bas_wend_t *wend)
+{
+   uint8_t depth = 0;
+   for (bool first = true; line; line = line->next, first = false)
    {
-      size_t arraySize;
-      if (var->value.type == VAR_TYPE_STRING)
+      bool quoted = false;
+      uint8_t *str = line->string, s = 0;
+      for (uint8_t i = 0; str[i]; i++)
       {
-         if (!var->param.size[1]) return BasicError = BASIC_ERR_ARRAY_DIMENTION;
-         var->param.size[1]++; // add a termination byte
-         arraySize = var->param.size[0] * var->param.size[1];
+         if (str[i] == '\"')
+         {
+            if (!quoted || str[i - 1] != '\\')
+               quoted = !quoted;
+            continue;
+         }
+         if (quoted)
+            continue;
+         if (str[i] == '\'' || str[i] == __OPCODE_REM)
+            break;
+         if (str[i] == ':')
+            s++;
+         else if (first && (s <= statement))
+            continue;
+         else if (str[i] == __OPCODE_WHILE)
+            depth++;
+         else if ((str[i] == __OPCODE_WEND) && !depth--)
+         {
+            wend->end = line;
+            wend->endStatement = s;
+            return true;
+         }
       }
-      else
+   }
+   return false;
+}
+
+/// WHILE cond ... WEND, the WEND is found once per statement and kept in WendCache
+_bas_err_e __while(_rpn_type_t *param)
+{
+   static uint8_t wendNext = 0; // round robin replacement
+   _rpn_type_t *tmpVar;
+   _bas_block_t *frame;
+   _bas_wend_t *wend = NULL;
+   _bas_line_t *bL = prog_exec_line();
+   if (token_eval_expression(param->var.i)) return BasicError;
+   tmpVar = rpn_pull_queue();
+   if (tmpVar->type < VAR_TYPE_FLOAT) return BasicError = BASIC_ERR_TYPE_MISMATCH;
+   if ((frame = block_push(__OPCODE_WHILE, bL, ExecLine.number, ExecLine.statement)) == NULL) return BasicError;
+   if (tmpVar->var.i) return BasicError = BASIC_ERR_NONE;
+   for (uint8_t i = 0; i < BASIC_WEND_CACHE; i++)
+      if ((WendCache[i].owner == bL) && (WendCache[i].statement == ExecLine.statement) && (WendCache[i].revision == ProgRevision))
       {
-         arraySize = var->param.size[0] * (var->param.size[1] ? var->param.size[1] : 1);
-         arraySize *= (var->value.type == VAR_TYPE_BYTE) ? 1 : (var->value.type == VAR_TYPE_WORD) ? 2 : 4;
+         wend = &WendCache[i];
+         break;
       }
-      if ((var->value.var.array = (char *)pvPortMalloc(arraySize)) == NULL) return BasicError = BASIC_ERR_MEM_OUT;
-   }
-   switch (var->value.type)
+   if (!wend)
    {
-   case VAR_TYPE_FLOAT:
-   case VAR_TYPE_LOOP:
-      var->value.type = VAR_TYPE_ARRAY_FLOAT;
-      break;
-   case VAR_TYPE_INT:
-   case VAR_TYPE_BOOL:
-      var->value.type = VAR_TYPE_ARRAY_INT;
-      break;
-   case VAR_TYPE_WORD:
-      var->value.type = VAR_TYPE_ARRAY_WORD;
-      break;
-   case VAR_TYPE_BYTE:
-      var->value.type = VAR_TYPE_ARRAY_BYTE;
-      break;
-   case VAR_TYPE_STRING:
-      var->value.type = VAR_TYPE_ARRAY_STRING;
-      break;
-   default:
-      break;
+      wend = &WendCache[wendNext];
+      wendNext = (wendNext + 1) % BASIC_WEND_CACHE;
+      wend->owner = NULL;
+      if (!block_find_wend(bL, ExecLine.statement, wend)) return BasicError = BASIC_ERR_WHILE_NO_WEND;
+      wend->owner = bL;
+      wend->statement = ExecLine.statement;
+      wend->revision = ProgRevision;
    }
-   //    b_printf("Array allocated: dim0 = %d, dim1 = %d, size = %lu\n",var->param.size[0],var->param.size[1],(var->param.size[0] * (var->param.size[1] ? var->param.size[1] : 1) * ((var->value.type == VAR_TYPE_ARRAY_BYTE) ? 1 : sizeof(var->value))));
-   bToken->ptr++;
+   frame->exit = true; // continue from the WEND, it drops the frame
+   ExecLine.number = wend->end->number;
+   ExecLine.statement = wend->endStatement;
+   JumpLine = wend->end;
+   BasicStat = BASIC_STAT_JUMP;
+   return BasicError = BASIC_ERR_NONE;
+}
+
+_bas_err_e __wend(_rpn_type_t *param)
+{
+   _bas_block_t *frame;
+   if (!BlockStack.ptr || ((frame = &BlockStack.frame[BlockStack.ptr - 1])->opCode != __OPCODE_WHILE))
+      return BasicError = BASIC_ERR_WEND_NO_WHILE;
+   if (frame->exit)
+      BlockStack.ptr--;
+   else
+      block_jump(frame);
+   return BasicError = BASIC_ERR_NONE;
+}
+
+/// REPEAT ... UNTIL cond, the loop restarts from the statement after REPEAT
+_bas_err_e __repeat(_rpn_type_t *param)
+{
+   _bas_line_t *bL = prog_exec_line();
+   _bas_block_t *frame;
+   if (bToken->t[bToken->ptr].op == ':')
+      frame = block_push(__OPCODE_REPEAT, bL, ExecLine.number, ExecLine.statement + 1);
+   else
+      frame = block_push(__OPCODE_REPEAT, bL ? bL->next : NULL, ExecLine.nextNum, 0);
+   return frame ? (BasicError = BASIC_ERR_NONE) : BasicError;
+}
+
+_bas_err_e __until(_rpn_type_t *param)
+{
+   _rpn_type_t *tmpVar;
+   _bas_block_t *frame;
+   if (token_eval_expression(param->var.i)) return BasicError;
+   tmpVar = rpn_pull_queue();
+   if (tmpVar->type < VAR_TYPE_FLOAT) return BasicError = BASIC_ERR_TYPE_MISMATCH;
+   if (!BlockStack.ptr || ((frame = &BlockStack.frame[BlockStack.ptr - 1])->opCode != __OPCODE_REPEAT))
+      return BasicError = BASIC_ERR_UNTIL_NO_REPEAT;
+   if (tmpVar->var.i)
+      BlockStack.ptr--;
+   else
+      block_jump(frame);
+   return BasicError = BASIC_ERR_NONE;
+}
+
+_bas_err_e __dim(_rpn_type_t *param)
+{
+   _bas_var_t *var;
+   uint16_t size[BASIC_ARRAY_DIMS + 1];
+   uint8_t dims = 0;
+   char *varName = bToken->t[bToken->ptr].str;
+   if (bToken->t[bToken->ptr].op != '[') return BasicError = BASIC_ERR_PAR_MISMATCH;
+   if (bas_func_opcode(varName)) return BasicError = BASIC_ERR_RESERVED_NAME;
+   if ((var = var_get(bToken->t[bToken->ptr].str)) != NULL) return BasicError = BASIC_ERR_ARRAY_REDEFINE;
+   if ((var = var_add(bToken->t[bToken->ptr++].str)) == NULL) return BasicError; // cannot add a variable
+   do
+   {
+      long n = strtol(bToken->t[bToken->ptr].str, NULL, 0);
+      if ((dims > BASIC_ARRAY_DIMS) || (n < 1) || (n > UINT16_MAX)) return BasicError = BASIC_ERR_ARRAY_DIMENTION; // no wrap to a smaller array
+      size[dims++] = (uint16_t)n;
+   } while (bToken->t[bToken->ptr++].op == ',');
+   if (bToken->t[bToken->ptr - 1].op != ']') return BasicError = BASIC_ERR_ARRAY_DIMENTION;
+   if (array_alloc(var, size, dims)) return BasicError;
    if (bToken->t[bToken->ptr].op == '=')
    {
       if (array_set(varName, true)) return BasicError;
@@ -366,78 +616,34 @@ _bas_err_e __dim(_rpn_type_t *param)
    return BasicError = BASIC_ERR_NONE;
 }
 
+/// DEF name(a,b,...) = expression, the body is compiled to RPN once, the arguments are referenced by their position
 _bas_err_e __def(_rpn_type_t *param)
 {
    _bas_var_t *var;
-   uint8_t i, strPtr = 0;
-   char argVarName[BASIC_VAR_NAME_LEN];
-   char argIndName[2] = "0";
+   _bas_deffn_t *fn;
+   uint8_t argc = 0;
    char *argument[BASIC_DEFFN_MAX_ARGS];
    char *varName = bToken->t[bToken->ptr].str;
-   _bas_tok_list_t *tmpTok;
    if (bToken->t[bToken->ptr].op != '(') return BasicError = BASIC_ERR_PAR_MISMATCH;
    if (bas_func_opcode(varName)) return BasicError = BASIC_ERR_RESERVED_NAME;
    if ((var = var_get(varName)) != NULL) return BasicError = BASIC_ERR_DEFFN_REDEFINE;
-   if ((var = var_add(varName)) == NULL) return BasicError; // cannot add a variable
-   var->param.argc = 0;                                     // number of arguments
-   do                                                       // get function arguments
+   do // get function arguments
    {
       bToken->ptr++;
       if (*bToken->t[bToken->ptr].str)
       {
-         strncpy(argVarName, varName, BASIC_VAR_NAME_LEN - 1);
-         argIndName[0] = '0' + var->param.argc;
-         strncat(argVarName, argIndName, BASIC_VAR_NAME_LEN - 1);
-         argument[var->param.argc] = bToken->t[bToken->ptr].str;
-         var->param.argc++;
-         if (var->param.argc >= BASIC_DEFFN_MAX_ARGS) return BASIC_ERR_DEFFN_ARGUMENTS;
-         if (var_get(argVarName) != NULL) return BasicError = BASIC_ERR_VAR_REDEFINE;
-         if (var_add(argVarName) == NULL) return BasicError; // cannot add a variable
+         if (argc >= BASIC_DEFFN_MAX_ARGS) return BasicError = BASIC_ERR_DEFFN_ARGUMENTS;
+         argument[argc++] = bToken->t[bToken->ptr].str;
       }
       if (bToken->t[bToken->ptr].op == '\0') return BasicError = BASIC_ERR_PAR_MISMATCH;
    } while (bToken->t[bToken->ptr].op != ')');
    if (bToken->t[++bToken->ptr].op != '=')
       return BasicError = BASIC_ERR_MISSING_EQUAL;
    bToken->ptr++;
-   for (i = bToken->ptr; i < PARSER_MAX_TOKENS; i++)
-   {
-      varName = bToken->t[i].str; // store the token in varName variable
-      if (var->param.argc)
-         for (uint8_t n = 0; n < var->param.argc; n++)
-            if (!strcmp(varName, argument[n]))
-            {
-               argVarName[strlen(argVarName) - 1] = '0' + n;
-               varName = argVarName; // replace the arg var name with the "local" one
-               break;
-            }
-      bToken->t[i].str = (char *)0 + strPtr; // store the token pointer offsets to the temp buffer
-      if (strPtr >= BASIC_STRING_LEN - 3) return BASIC_ERR_STRING_LENGTH;
-      while (*varName)
-         strTmpBuff[strPtr++] = *(varName++);
-      strTmpBuff[strPtr++] = '\0';
-      if ((!bToken->t[i].op) || (bToken->t[i].op == ':') || (bToken->t[i].op == ';')) break;
-   }
-   i -= bToken->ptr - 1;                                                                                                    // i contains the number of tokens
-   if ((tmpTok = pvPortMalloc(sizeof(_bas_tok_list_t))) == NULL) return BasicError = BASIC_ERR_MEM_OUT;                     // allocate memory for the tokens list
-   if ((tmpTok->t = (_bas_token_t *)pvPortMalloc(sizeof(_bas_token_t) * i)) == NULL) return BasicError = BASIC_ERR_MEM_OUT; // allocate memory for the tokens
-   if ((tmpTok->t[0].str = pvPortMalloc(strPtr)) == NULL) return BasicError = BASIC_ERR_MEM_OUT;                            // allocate memory for the tokens' string
-   memcpy(tmpTok->t[0].str, strTmpBuff, strPtr);                                                                            // copy tokens
-   tmpTok->ptr = 0;
-   for (uint8_t n = 0; n < i; n++)
-   {
-      tmpTok->t[n].str = (char *)((long)bToken->t[bToken->ptr].str + (long)tmpTok->t[0].str); // adding offset only
-      tmpTok->t[n].op = bToken->t[bToken->ptr++].op;
-   }
-#if 0 // Print tokenized strings
-    b_printf("Allocated: tokList(%lu), tokens(%lu), string(%d). Total bytes: %lu\n",sizeof(_bas_tok_list_t),sizeof(_bas_token_t)*i,strPtr,sizeof(_bas_tok_list_t)+sizeof(_bas_token_t)*i+strPtr);
-    b_printf("tmpTok list:\n");
-    for (uint8_t i=0; i<PARSER_MAX_TOKENS; i++)
-    {
-        b_printf("\"%s\", \'%c\'\n",tmpTok->t[i].str,tmpTok->t[i].op);
-        if (!tmpTok->t[i].op) break;
-    }
-#endif
-   var->value.var.deffn = tmpTok;
+   if ((fn = token_compile_expression(argument, argc)) == NULL) return BasicError;
+   if ((var = var_add(varName)) == NULL) return BasicError; // cannot add a variable
+   var->param.argc = argc;
+   var->value.var.deffn = fn;
    switch (var->value.type)
    {
    case VAR_TYPE_FLOAT:
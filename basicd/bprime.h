@@ -38,6 +38,11 @@ _bas_err_e __goto(_rpn_type_t *param);
 _bas_err_e __if(_rpn_type_t *param);
 _bas_err_e __gosub(_rpn_type_t *param);
 _bas_err_e __return(_rpn_type_t *param);
+_bas_err_e __on(_rpn_type_t *param);
+_bas_err_e __while(_rpn_type_t *param);
+_bas_err_e __wend(_rpn_type_t *param);
+_bas_err_e __repeat(_rpn_type_t *param);
+_bas_err_e __until(_rpn_type_t *param);
 _bas_err_e __dim(_rpn_type_t *param);
 _bas_err_e __def(_rpn_type_t *param);
 
@@ -44,7 +44,8 @@ const _bas_rom_t ROM_ctree = {
 170 print \"|||\"\n\
 180 next j\n\
 990 stop\n\
-"};
+",
+    .lines = &ROM_ctree_lines};
 
 const _bas_rom_t ROM_snake = {
     .name = "snake",
@@ -109,7 +110,8 @@ const _bas_rom_t ROM_snake = {
 1100 print ink(7);at(XSIZE.b/2-7,YSIZE.b/2+1);\"Press any key\";\n\
 1110 if !inkey() then goto 1110 \n\
 1120 at(1,YSIZE.b):stop\n\
-"};
+",
+    .lines = &ROM_snake_lines};
 const _bas_rom_t ROM_bounce = {
     .name = "bounce",
     .prog = "\
@@ -133,7 +135,8 @@ const _bas_rom_t ROM_bounce = {
 230 sleep(10)\n\
 240 print ink(rnd(7)+1);at(x.b,y.b);\".\";' erase the character\n\
 250 if inkey <> 48 then goto 90' press 0 to stop\n\
-"};
+",
+    .lines = &ROM_bounce_lines};
 /*
 1 cls
 2 for i=1 to 7:print ink(i);int(i);:next i
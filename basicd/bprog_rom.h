@@ -24,12 +24,19 @@
 #ifndef _BPROGROM_H_INCLUDED
 #define _BPROGROM_H_INCLUDED
 
+#include "bcore.h"
+
 typedef struct
 {
     const char *name;
     const char *prog;
+    const _bas_line_t *lines; // tokenized copy, bprog_rom_tok.c
 } _bas_rom_t;
 extern const _bas_rom_t ROM_ctree;
 extern const _bas_rom_t ROM_snake;
 extern const _bas_rom_t ROM_bounce;
+extern const _bas_line_t ROM_ctree_lines;
+extern const _bas_line_t ROM_snake_lines;
+extern const _bas_line_t ROM_bounce_lines;
+extern const uint32_t ROM_LinesSignature; // bas_func_signature() of the keyword table used for the tokenized copy
 #endif //_BPROGROM_H_INCLUDED
@@ -0,0 +1,143 @@
+/**-----------------------------------------------------------------------------
+ * Copyright (c) 2025 Sergey Sanders
+ * sergey@sesadesign.com
+ * -----------------------------------------------------------------------------
+ * Licensed under Creative Commons Attribution-NonCommercial-ShareAlike 4.0
+ * International (CC BY-NC-SA 4.0). 
+ * 
+ * You are free to:
+ *  - Share: Copy and redistribute the material.
+ *  - Adapt: Remix, transform, and build upon the material.
+ * 
+ * Under the following terms:
+ *  - Attribution: Give appropriate credit and indicate changes.
+ *  - NonCommercial: Do not use for commercial purposes.
+ *  - ShareAlike: Distribute under the same license.
+ * 
+ * DISCLAIMER: This work is provided "as is" without any guarantees. The authors
+ * aren’t responsible for any issues, damages, or claims that come up from using
+ * it. Use at your own risk!
+ * 
+ * Full license: http://creativecommons.org/licenses/by-nc-sa/4.0/
+ * ---------------------------------------------------------------------------*/
+/**
+ * ROM programs of bprog_rom.c as they look after LOAD: tokenized, with the
+ * statement index filled in and linked by line number. prog_load runs them in
+ * place from flash; the first edit copies them to the program arena.
+ *
+ * Generated by host/romtok, which LOADs the texts and writes the lines out.
+ * Regenerate after changing a ROM program or the keyword table, in host/ run
+ * <build>/romtok ../basicd/bprog_rom_tok.c. A stale table is detected by
+ * ROM_LinesSignature and the text is loaded instead.
+ */
+#include "bprog_rom.h"
+
+const uint32_t ROM_LinesSignature = 0x919757e9;
+
+/// bounce
+static const _bas_line_t bounce_20, bounce_30, bounce_40, bounce_50, bounce_60, bounce_70, bounce_80, bounce_90, bounce_100, bounce_110, bounce_120, bounce_130, bounce_140, bounce_200, bounce_210, bounce_220, bounce_230, bounce_240, bounce_250;
+const _bas_line_t ROM_bounce_lines = {10, 4, (void *)&bounce_20, 0, {0, 0, 0, 0, 0, 0, 0}, "\233"};
+static const _bas_line_t bounce_20 = {20, 42, (void *)&bounce_30, 0, {0, 0, 0, 0, 0, 0, 0}, "'for i=1 to 7:print ink(i);int(i);:next i"};
+static const _bas_line_t bounce_30 = {30, 17, (void *)&bounce_40, 0, {0, 0, 0, 0, 0, 0, 0}, "'key.b = inkey()"};
+static const _bas_line_t bounce_40 = {40, 38, (void *)&bounce_50, 0, {0, 0, 0, 0, 0, 0, 0}, "'if key.b then ? at(10,10);key.b;\"  \""};
+static const _bas_line_t bounce_50 = {50, 29, (void *)&bounce_60, 0, {0, 0, 0, 0, 0, 0, 0}, "'if key.b <> 48 then goto 30"};
+static const _bas_line_t bounce_60 = {60, 20, (void *)&bounce_70, 1, {10, 0, 0, 0, 0, 0, 0}, "xMax.b=38:yMax.b=18"};
+static const _bas_line_t bounce_70 = {70, 38, (void *)&bounce_80, 1, {16, 0, 0, 0, 0, 0, 0}, "x.b=\276(xMax.b)+1:y.b = \276(yMax.b)+1"};
+static const _bas_line_t bounce_80 = {80, 30, (void *)&bounce_90, 1, {12, 0, 0, 0, 0, 0, 0}, "dirx.b=\276(2):diry.b = \276(2)"};
+static const _bas_line_t bounce_90 = {90, 67, (void *)&bounce_100, 1, {49, 0, 0, 0, 0, 0, 0}, "\201 x.b=xMax.b+\264(\276(4)-2) \022 x.b>xMax.b+1 \202 dirx.b=0:\203 110"};
+static const _bas_line_t bounce_100 = {100, 25, (void *)&bounce_110, 0, {0, 0, 0, 0, 0, 0, 0}, "\201 x.b=1 \202 dirx.b = 1"};
+static const _bas_line_t bounce_110 = {110, 67, (void *)&bounce_120, 1, {49, 0, 0, 0, 0, 0, 0}, "\201 y.b=yMax.b+\264(\276(4)-2) \022 y.b>yMax.b+1 \202 diry.b=0:\203 130"};
+static const _bas_line_t bounce_120 = {120, 23, (void *)&bounce_130, 0, {0, 0, 0, 0, 0, 0, 0}, "\201 y.b=1 \202 diry.b=1"};
+static const _bas_line_t bounce_130 = {130, 35, (void *)&bounce_140, 1, {21, 0, 0, 0, 0, 0, 0}, "\201 dirx.b \202 x.b=x.b+1: \203 200"};
+static const _bas_line_t bounce_140 = {140, 10, (void *)&bounce_200, 0, {0, 0, 0, 0, 0, 0, 0}, "x.b=x.b-1"};
+static const _bas_line_t bounce_200 = {200, 35, (void *)&bounce_210, 1, {21, 0, 0, 0, 0, 0, 0}, "\201 diry.b \202 y.b=y.b+1: \203 220"};
+static const _bas_line_t bounce_210 = {210, 10, (void *)&bounce_220, 0, {0, 0, 0, 0, 0, 0, 0}, "y.b=y.b-1"};
+static const _bas_line_t bounce_220 = {220, 41, (void *)&bounce_230, 0, {0, 0, 0, 0, 0, 0, 0}, "\227 \251(x.b,y.b);\"O\";'Put the character"};
+static const _bas_line_t bounce_230 = {230, 10, (void *)&bounce_240, 0, {0, 0, 0, 0, 0, 0, 0}, "\232(10)"};
+static const _bas_line_t bounce_240 = {240, 58, (void *)&bounce_250, 0, {0, 0, 0, 0, 0, 0, 0}, "\227 \252(\276(7)+1);\251(x.b,y.b);\".\";' erase the character"};
+static const _bas_line_t bounce_250 = {250, 45, NULL, 0, {0, 0, 0, 0, 0, 0, 0}, "\201 \314 \017 48 \202 \203 90' press 0 to stop"};
+
+/// ctree
+static const _bas_line_t ctree_20, ctree_25, ctree_110, ctree_120, ctree_130, ctree_135, ctree_140, ctree_143, ctree_145, ctree_148, ctree_149, ctree_150, ctree_153, ctree_155, ctree_160, ctree_170, ctree_180, ctree_990;
+const _bas_line_t ROM_ctree_lines = {10, 42, (void *)&ctree_20, 0, {0, 0, 0, 0, 0, 0, 0}, "\230 \"How big is your tree (3-40)?\",size"};
+static const _bas_line_t ctree_20 = {20, 53, (void *)&ctree_25, 1, {39, 0, 0, 0, 0, 0, 0}, "\201 (size<3) \022 (size>40) \202 \227 \"oi oi oi!\":\217"};
+static const _bas_line_t ctree_25 = {25, 14, (void *)&ctree_110, 0, {0, 0, 0, 0, 0, 0, 0}, "size = size-1"};
+static const _bas_line_t ctree_110 = {110, 37, (void *)&ctree_120, 2, {30, 33, 0, 0, 0, 0, 0}, "\227 \252(5);\"Merry christmass !!!\":\227 :\227"};
+static const _bas_line_t ctree_120 = {120, 18, (void *)&ctree_130, 0, {0, 0, 0, 0, 0, 0, 0}, "\207 i = 0 \210 size"};
+static const _bas_line_t ctree_130 = {130, 46, (void *)&ctree_135, 2, {17, 24, 0, 0, 0, 0, 0}, "\207 j = 0 \210 size-i:\227 \" \";:\212 j ' space"};
+static const _bas_line_t ctree_135 = {135, 39, (void *)&ctree_140, 1, {21, 0, 0, 0, 0, 0, 0}, "\201 i = 0 \202 \227 \252(1);\"@\": \212 i"};
+static const _bas_line_t ctree_140 = {140, 17, (void *)&ctree_143, 0, {0, 0, 0, 0, 0, 0, 0}, "\207 j = 0 \210 i*2"};
+static const _bas_line_t ctree_143 = {143, 25, (void *)&ctree_145, 0, {0, 0, 0, 0, 0, 0, 0}, "\227 \252(\276(3)+1);\"*\";"};
+static const _bas_line_t ctree_145 = {145, 14, (void *)&ctree_148, 0, {0, 0, 0, 0, 0, 0, 0}, "\212 j ' tree"};
+static const _bas_line_t ctree_148 = {148, 45, (void *)&ctree_149, 0, {0, 0, 0, 0, 0, 0, 0}, "'for j = 0 to size:print \" \";:next j ' space"};
+static const _bas_line_t ctree_149 = {149, 17, (void *)&ctree_150, 0, {0, 0, 0, 0, 0, 0, 0}, "\227 'next line"};
+static const _bas_line_t ctree_150 = {150, 7, (void *)&ctree_153, 0, {0, 0, 0, 0, 0, 0, 0}, "\212 i"};
+static const _bas_line_t ctree_153 = {153, 14, (void *)&ctree_155, 0, {0, 0, 0, 0, 0, 0, 0}, "\227 \252(7);"};
+static const _bas_line_t ctree_155 = {155, 15, (void *)&ctree_160, 0, {0, 0, 0, 0, 0, 0, 0}, "\207 j = 0 \210 2"};
+static const _bas_line_t ctree_160 = {160, 33, (void *)&ctree_170, 2, {15, 23, 0, 0, 0, 0, 0}, "\207 i=0 \210 size-1: \227 \" \";:\212 i"};
+static const _bas_line_t ctree_170 = {170, 12, (void *)&ctree_180, 0, {0, 0, 0, 0, 0, 0, 0}, "\227 \"|||\""};
+static const _bas_line_t ctree_180 = {180, 7, (void *)&ctree_990, 0, {0, 0, 0, 0, 0, 0, 0}, "\212 j"};
+static const _bas_line_t ctree_990 = {990, 5, NULL, 0, {0, 0, 0, 0, 0, 0, 0}, "\217"};
+
+/// snake
+static const _bas_line_t snake_20, snake_30, snake_40, snake_50, snake_60, snake_70, snake_80, snake_90, snake_100, snake_110, snake_130, snake_135, snake_140, snake_145, snake_150, snake_155, snake_161, snake_162, snake_163, snake_164, snake_165, snake_170, snake_200, snake_210, snake_220, snake_230, snake_240, snake_270, snake_280, snake_290, snake_500, snake_510, snake_520, snake_530, snake_666, snake_800, snake_810, snake_820, snake_830, snake_835, snake_840, snake_850, snake_860, snake_870, snake_900, snake_910, snake_911, snake_920, snake_950, snake_970, snake_975, snake_980, snake_991, snake_995, snake_999, snake_1000, snake_1100, snake_1110, snake_1120;
+const _bas_line_t ROM_snake_lines = {10, 60, (void *)&snake_20, 3, {12, 25, 44, 0, 0, 0, 0}, "XSIZE.b=40 : YSIZE.b=20 : MAx.bLENGTH = 254: MAx.bLEVEL = 9"};
+static const _bas_line_t snake_20 = {20, 61, (void *)&snake_30, 0, {0, 0, 0, 0, 0, 0, 0}, "\227 \" Snake game V1.0 \",\" Use WASD keys for snake control\""};
+static const _bas_line_t snake_30 = {30, 39, (void *)&snake_40, 0, {0, 0, 0, 0, 0, 0, 0}, "\230 \"Enter starting level (1-5)\",lvl"};
+static const _bas_line_t snake_40 = {40, 70, (void *)&snake_50, 2, {42, 50, 0, 0, 0, 0, 0}, "\201 lvl > 5 \202 \227 \"Don't flatter yourself...\":\232(2000):lvl = 5"};
+static const _bas_line_t snake_50 = {50, 55, (void *)&snake_60, 2, {27, 35, 0, 0, 0, 0, 0}, "\201 lvl < 1 \202 \227 \"Chicken...\":\232(2000):lvl = 1"};
+static const _bas_line_t snake_60 = {60, 12, (void *)&snake_70, 0, {0, 0, 0, 0, 0, 0, 0}, "LEVEL = lvl"};
+static const _bas_line_t snake_70 = {70, 18, (void *)&snake_80, 0, {0, 0, 0, 0, 0, 0, 0}, "delay# = 30-lvl*3"};
+static const _bas_line_t snake_80 = {80, 43, (void *)&snake_90, 0, {0, 0, 0, 0, 0, 0, 0}, "\242 snake.b[256,2] = XSIZE.b/2,YSIZE.b/2+2"};
+static const _bas_line_t snake_90 = {90, 80, (void *)&snake_100, 2, {12, 27, 0, 0, 0, 0, 0}, "head.b = 0 : length.b = 1 : dir.b = 0 \200 0 - up, 1 - down, 2 - right, 3 - left"};
+static const _bas_line_t snake_100 = {100, 10, (void *)&snake_110, 0, {0, 0, 0, 0, 0, 0, 0}, "\204 950"};
+static const _bas_line_t snake_110 = {110, 10, (void *)&snake_130, 0, {0, 0, 0, 0, 0, 0, 0}, "\204 840"};
+static const _bas_line_t snake_130 = {130, 58, (void *)&snake_135, 0, {0, 0, 0, 0, 0, 0, 0}, "\227 \251(snake.b[head.b,0],snake.b[head.b,1]);\252(5);\"O\";"};
+static const _bas_line_t snake_135 = {135, 17, (void *)&snake_140, 1, {12, 0, 0, 0, 0, 0, 0}, "\232(10-LEVEL):"};
+static const _bas_line_t snake_140 = {140, 10, (void *)&snake_145, 0, {0, 0, 0, 0, 0, 0, 0}, "\204 500"};
+static const _bas_line_t snake_145 = {145, 58, (void *)&snake_150, 0, {0, 0, 0, 0, 0, 0, 0}, "\227 \251(snake.b[head.b,0],snake.b[head.b,1]);\252(4);\"*\";"};
+static const _bas_line_t snake_150 = {150, 20, (void *)&snake_155, 0, {0, 0, 0, 0, 0, 0, 0}, "head.b = head.b + 1"};
+static const _bas_line_t snake_155 = {155, 16, (void *)&snake_161, 0, {0, 0, 0, 0, 0, 0, 0}, "key.b = \314()"};
+static const _bas_line_t snake_161 = {161, 54, (void *)&snake_162, 1, {39, 0, 0, 0, 0, 0, 0}, "\201 key.b = 119 \022 key.b = 65 \202 dir.b = 0: \203 170"};
+static const _bas_line_t snake_162 = {162, 54, (void *)&snake_163, 1, {39, 0, 0, 0, 0, 0, 0}, "\201 key.b = 115 \022 key.b = 66 \202 dir.b = 1: \203 170"};
+static const _bas_line_t snake_163 = {163, 54, (void *)&snake_164, 1, {39, 0, 0, 0, 0, 0, 0}, "\201 key.b = 100 \022 key.b = 67 \202 dir.b = 2: \203 170"};
+static const _bas_line_t snake_164 = {164, 54, (void *)&snake_165, 1, {38, 0, 0, 0, 0, 0, 0}, "\201 key.b = 97 \022 key.b = 68 \202 dir.b = 3: \203 170"};
+static const _bas_line_t snake_165 = {165, 29, (void *)&snake_170, 0, {0, 0, 0, 0, 0, 0, 0}, "\201 key.b = 32 \202 \203 1000"};
+static const _bas_line_t snake_170 = {170, 81, (void *)&snake_200, 1, {40, 0, 0, 0, 0, 0, 0}, "snake.b[head.b,0] = snake.b[head.b-1,0]: snake.b[head.b,1] = snake.b[head.b-1,1]"};
+static const _bas_line_t snake_200 = {200, 70, (void *)&snake_210, 1, {56, 0, 0, 0, 0, 0, 0}, "\201 dir.b = 0 \202 snake.b[head.b,1] = snake.b[head.b,1] - 1: \203 240"};
+static const _bas_line_t snake_210 = {210, 70, (void *)&snake_220, 1, {56, 0, 0, 0, 0, 0, 0}, "\201 dir.b = 1 \202 snake.b[head.b,1] = snake.b[head.b,1] + 1: \203 240"};
+static const _bas_line_t snake_220 = {220, 70, (void *)&snake_230, 1, {56, 0, 0, 0, 0, 0, 0}, "\201 dir.b = 2 \202 snake.b[head.b,0] = snake.b[head.b,0] + 1: \203 240"};
+static const _bas_line_t snake_230 = {230, 70, (void *)&snake_240, 1, {56, 0, 0, 0, 0, 0, 0}, "\201 dir.b = 3 \202 snake.b[head.b,0] = snake.b[head.b,0] - 1: \203 240"};
+static const _bas_line_t snake_240 = {240, 91, (void *)&snake_270, 1, {72, 0, 0, 0, 0, 0, 0}, "\201 snake.b[head.b,0] = rabbitX.b \021 snake.b[head.b,1] = rabbitY.b \202 \204 800:\203 130"};
+static const _bas_line_t snake_270 = {270, 84, (void *)&snake_280, 0, {0, 0, 0, 0, 0, 0, 0}, "\227 \251(snake.b[head.b-length.b,0],snake.b[head.b-length.b,1]);\" \";'erase the tail"};
+static const _bas_line_t snake_280 = {280, 64, (void *)&snake_290, 1, {32, 0, 0, 0, 0, 0, 0}, "snake.b[head.b-length.b,0] = 0 : snake.b[head.b-length.b,1] = 0"};
+static const _bas_line_t snake_290 = {290, 9, (void *)&snake_500, 0, {0, 0, 0, 0, 0, 0, 0}, "\203 130"};
+static const _bas_line_t snake_500 = {500, 134, (void *)&snake_510, 0, {0, 0, 0, 0, 0, 0, 0}, "\201 (snake.b[head.b,0] = 1) \022 (snake.b[head.b,0] = XSIZE.b) \022 (snake.b[head.b,1] = 1) \022 (snake.b[head.b,1] = YSIZE.b) \202 \203 999"};
+static const _bas_line_t snake_510 = {510, 118, (void *)&snake_520, 1, {12, 0, 0, 0, 0, 0, 0}, "\207 c=0 \210 255:\201 c \017 head.b \021 snake.b[head.b,0] = snake.b[c,0] \021 snake.b[head.b,1] = snake.b[c,1] \202 \203 999"};
+static const _bas_line_t snake_520 = {520, 7, (void *)&snake_530, 0, {0, 0, 0, 0, 0, 0, 0}, "\212 c"};
+static const _bas_line_t snake_530 = {530, 7, (void *)&snake_666, 0, {0, 0, 0, 0, 0, 0, 0}, "\205"};
+static const _bas_line_t snake_666 = {666, 10, (void *)&snake_800, 0, {0, 0, 0, 0, 0, 0, 0}, "\203 1000"};
+static const _bas_line_t snake_800 = {800, 10, (void *)&snake_810, 0, {0, 0, 0, 0, 0, 0, 0}, "\204 900"};
+static const _bas_line_t snake_810 = {810, 88, (void *)&snake_820, 1, {24, 0, 0, 0, 0, 0, 0}, "length.b = length.b + 1:\227 \252(7);\251(XSIZE.b/2-5,YSIZE.b);\" LENGTH : \";length.b;\" \";"};
+static const _bas_line_t snake_820 = {820, 38, (void *)&snake_830, 0, {0, 0, 0, 0, 0, 0, 0}, "\201 length.b < MAx.bLENGTH \202 \205"};
+static const _bas_line_t snake_830 = {830, 107, (void *)&snake_835, 2, {18, 85, 0, 0, 0, 0, 0}, "LEVEL = LEVEL + 1: \201 LEVEL > MAx.bLEVEL \202 \227 \251(XSIZE.b/2-5,YSIZE.b/2);\252(3);\"You WIN!\": \203 1100"};
+static const _bas_line_t snake_835 = {835, 10, (void *)&snake_840, 0, {0, 0, 0, 0, 0, 0, 0}, "\204 950"};
+static const _bas_line_t snake_840 = {840, 58, (void *)&snake_850, 3, {12, 30, 48, 0, 0, 0, 0}, "\207 r=0 \210 255: snake.b[r,0] = 0: snake.b[r,1] = 0:\212 r"};
+static const _bas_line_t snake_850 = {850, 37, (void *)&snake_860, 0, {0, 0, 0, 0, 0, 0, 0}, "snake.b[0,0] = XSIZE.b/2,YSIZE.b/2+2"};
+static const _bas_line_t snake_860 = {860, 24, (void *)&snake_870, 1, {11, 0, 0, 0, 0, 0, 0}, "head.b = 0:length.b = 1"};
+static const _bas_line_t snake_870 = {870, 7, (void *)&snake_900, 0, {0, 0, 0, 0, 0, 0, 0}, "\205"};
+static const _bas_line_t snake_900 = {900, 60, (void *)&snake_910, 1, {28, 0, 0, 0, 0, 0, 0}, "rabbitX.b = \276(XSIZE.b-2)+2 : rabbitY.b = \276(YSIZE.b-2)+2"};
+static const _bas_line_t snake_910 = {910, 86, (void *)&snake_911, 1, {12, 0, 0, 0, 0, 0, 0}, "\207 r=0 \210 255:\201 rabbitX.b = snake.b[r,0] \021 rabbitY.b = snake.b[r,1] \202 \203 900"};
+static const _bas_line_t snake_911 = {911, 7, (void *)&snake_920, 0, {0, 0, 0, 0, 0, 0, 0}, "\212 r"};
+static const _bas_line_t snake_920 = {920, 49, (void *)&snake_950, 1, {35, 0, 0, 0, 0, 0, 0}, "\227 \251(rabbitX.b,rabbitY.b);\252(6);\"@\";:\205"};
+static const _bas_line_t snake_950 = {950, 18, (void *)&snake_970, 1, {2, 0, 0, 0, 0, 0, 0}, "\233:\227 \252(7);"};
+static const _bas_line_t snake_970 = {970, 67, (void *)&snake_975, 2, {18, 50, 0, 0, 0, 0, 0}, "\207 i=2 \210 XSIZE.b-1: \227 \251(i,1);\"-\";\251(i,YSIZE.b);\"-\";: \212 i"};
+static const _bas_line_t snake_975 = {975, 52, (void *)&snake_980, 0, {0, 0, 0, 0, 0, 0, 0}, "\227 \251(XSIZE.b/2-4,1);\" LEVEL : \";\264(LEVEL);\" \";"};
+static const _bas_line_t snake_980 = {980, 67, (void *)&snake_991, 2, {18, 50, 0, 0, 0, 0, 0}, "\207 i=2 \210 YSIZE.b-1: \227 \251(1,i);\"|\";\251(XSIZE.b,i);\"|\";: \212 i"};
+static const _bas_line_t snake_991 = {991, 10, (void *)&snake_995, 0, {0, 0, 0, 0, 0, 0, 0}, "\204 900"};
+static const _bas_line_t snake_995 = {995, 7, (void *)&snake_999, 0, {0, 0, 0, 0, 0, 0, 0}, "\205"};
+static const _bas_line_t snake_999 = {999, 57, (void *)&snake_1000, 0, {0, 0, 0, 0, 0, 0, 0}, "\227 \251(snake.b[head.b,0],snake.b[head.b,1]);\252(2);\"X\""};
+static const _bas_line_t snake_1000 = {1000, 53, (void *)&snake_1100, 0, {0, 0, 0, 0, 0, 0, 0}, "\227 \251(XSIZE.b/2-5,YSIZE.b/2);\252(2);\"Game OVER!\";"};
+static const _bas_line_t snake_1100 = {1100, 58, (void *)&snake_1110, 0, {0, 0, 0, 0, 0, 0, 0}, "\227 \252(7);\251(XSIZE.b/2-7,YSIZE.b/2+1);\"Press any key\";"};
+static const _bas_line_t snake_1110 = {1110, 28, (void *)&snake_1120, 0, {0, 0, 0, 0, 0, 0, 0}, "\201 !\314() \202 \203 1110 "};
+static const _bas_line_t snake_1120 = {1120, 19, NULL, 1, {13, 0, 0, 0, 0, 0, 0}, "\251(1,YSIZE.b):\217"};
@@ -48,6 +48,7 @@ _bas_err_e __at(_rpn_type_t *p2)
     x -= 1;
     y -= 1;
     if (!(x < uTerm.cols && y < uTerm.lines)) return BasicError = BASIC_ERR_VAR_OUTOFRANGE;
+    basic_print_flush(); // the text printed before goes to the old position
     uTerm.cursorCol = x;
     uTerm.cursorLine = y;
     return BasicError = BASIC_ERR_NONE;
@@ -57,6 +58,7 @@ _bas_err_e __ink(_rpn_type_t *p1)
 {
     if (p1->type < VAR_TYPE_FLOAT) return BasicError = BASIC_ERR_TYPE_MISMATCH;
     uint8_t c = ((uint8_t)(p1->type & VAR_TYPE_FLOAT ? p1->var.f : p1->var.i));// & 0x07;
+    basic_print_flush(); // in the previous colour
     if (p1->type == VAR_TYPE_BYTE) 
         uTerm.fgColour = c; 
     else
@@ -68,6 +70,7 @@ _bas_err_e __paper(_rpn_type_t *p1)
 {
     if (p1->type < VAR_TYPE_FLOAT) return BasicError = BASIC_ERR_TYPE_MISMATCH;
     uint8_t c = ((uint8_t)(p1->type & VAR_TYPE_FLOAT ? p1->var.f : p1->var.i));// & 0x07;
+    basic_print_flush(); // in the previous colour
     if (p1->type == VAR_TYPE_BYTE) 
         uTerm.bgColour = c; 
     else
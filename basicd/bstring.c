@@ -21,6 +21,7 @@
  * Full license: http://creativecommons.org/licenses/by-nc-sa/4.0/
  * ---------------------------------------------------------------------------*/
 #include <stdlib.h>
+#include <stddef.h>
 #include "freeRTOS.h"
 #include "task.h"
 #include "bsp.h"
@@ -28,21 +29,239 @@
 #include "banalizer.h"
 #include "bstring.h"
 
+/**
+ * String values live in StrArena with a reference count. An expression result
+ * is a temporary (no references) linked to StrTemps, assigning it to a
+ * variable only takes a reference, so a$=b$ shares the storage. The temporaries
+ * nobody took are freed at the next statement, the ones consumed by a
+ * concatenation are freed right away.
+ * RIGHT$ and MID$ return a tail of their argument as is, such a view into the
+ * heap is listed in StrViews until the next statement so it is never taken for
+ * a string of its own, assigning it takes a copy.
+ */
+typedef struct _bas_str_s
+{
+    struct _bas_str_s *next; // temporaries list
+    uint16_t refs;
+    uint16_t len;
+    char str[0];
+} _bas_str_t;
+
+#define STR_HEADER(s) ((_bas_str_t *)((s) - offsetof(_bas_str_t, str)))
+#define STR_TEMP ((_bas_str_t *)1) // .next of a listed temporary is never NULL
+
 char strTmpBuff[BASIC_STRING_LEN];
-static char strVarBuff[BASIC_STRING_LEN];
 static char strNumBuff[36];
+static _bas_str_t *StrTemps = STR_TEMP;
+static char *StrViews[BASIC_STR_VIEWS];
+static uint8_t StrViewCount = 0;
+
+static bool str_is_heap(char *str)
+{
+    if (!StrArena.chunk || !arena_owns(&StrArena, str))
+        return false;
+    for (uint8_t i = 0; i < StrViewCount; i++)
+        if (StrViews[i] == str)
+            return false;
+    return true;
+}
+
+static uint16_t str_len(char *str)
+{
+    return str_is_heap(str) ? STR_HEADER(str)->len : strlen(str);
+}
+
+char *str_new(uint16_t len)
+{
+    _bas_str_t *str;
+    if ((str = arena_alloc(&StrArena, sizeof(_bas_str_t) + len + 1)) == NULL)
+    {
+        BasicError = BASIC_ERR_MEM_OUT;
+        return NULL;
+    }
+    str->refs = 0;
+    str->len = len;
+    str->next = StrTemps;
+    StrTemps = str;
+    *str->str = '\0';
+    return str->str;
+}
+
+void str_hold(char *str)
+{
+    if (str_is_heap(str))
+        STR_HEADER(str)->refs++;
+}
+
+void str_release(char *str)
+{
+    _bas_str_t *hdr;
+    if (!str_is_heap(str))
+        return;
+    hdr = STR_HEADER(str);
+    if (hdr->refs && --hdr->refs)
+        return;
+    if (!hdr->next) // not a temporary any more
+        arena_free(&StrArena, hdr);
+}
+
+/// free a temporary consumed by an operator
+static void str_consume(char *str)
+{
+    _bas_str_t *hdr, **link = &StrTemps;
+    if (!str_is_heap(str) || (hdr = STR_HEADER(str))->refs)
+        return;
+    while ((*link != STR_TEMP) && (*link != hdr))
+        link = &(*link)->next;
+    if (*link == STR_TEMP)
+        return;
+    *link = hdr->next;
+    arena_free(&StrArena, hdr);
+}
+
+void str_sweep(void)
+{
+    StrViewCount = 0;
+    while (StrTemps != STR_TEMP)
+    {
+        _bas_str_t *str = StrTemps;
+        StrTemps = str->next;
+        str->next = NULL;
+        if (!str->refs)
+            arena_free(&StrArena, str);
+    }
+}
+
+void str_reset(void)
+{
+    arena_reset(&StrArena);
+    StrTemps = STR_TEMP;
+    StrViewCount = 0;
+}
+
+static _bas_err_e str_push(char *str)
+{
+    char *tmp;
+    if ((tmp = str_new(strlen(str))) == NULL)
+        return BasicError;
+    strcpy(tmp, str);
+    rpn_push_queue(RPN_STR(tmp));
+    return BasicError = BASIC_ERR_NONE;
+}
+
+/// the tail of a string from "start" on, shared if it can be listed as a view
+static _bas_err_e str_push_tail(char *str, uint16_t start)
+{
+    if (!start)
+        rpn_push_queue(RPN_STR(str));
+    else if (!arena_owns(&StrArena, str)) // literal or array cell, nothing to free under it
+        rpn_push_queue(RPN_STR(str + start));
+    else if (StrViewCount < BASIC_STR_VIEWS)
+        rpn_push_queue(RPN_STR(StrViews[StrViewCount++] = str + start));
+    else
+        return str_push(str + start);
+    return BasicError = BASIC_ERR_NONE;
+}
+
+static _bas_err_e str_push_part(char *str, uint16_t start, uint16_t len)
+{
+    char *tmp;
+    if ((tmp = str_new(len)) == NULL)
+        return BasicError;
+    memcpy(tmp, str + start, len);
+    tmp[len] = '\0';
+    rpn_push_queue(RPN_STR(tmp));
+    return BasicError = BASIC_ERR_NONE;
+}
+
+static bool str_arg_int(_rpn_type_t *param, int32_t *value)
+{
+    if (param->type < VAR_TYPE_FLOAT)
+        return false;
+    if (!(param->type & VAR_TYPE_FLOAT))
+        *value = param->var.i;
+    else if (param->var.f >= 2147483647.0f) // the cast of an out of range float is undefined
+        *value = INT32_MAX;
+    else if (param->var.f > -2147483648.0f)
+        *value = (int32_t)param->var.f;
+    else
+        *value = (param->var.f < 0) ? INT32_MIN : 0; // NaN is 0
+    return true;
+}
+
+_bas_err_e __len(_rpn_type_t *param)
+{
+    if (param->type != VAR_TYPE_STRING)
+        return BasicError = param->type ? BASIC_ERR_TYPE_MISMATCH : BASIC_ERR_FEW_ARGUMENTS;
+    rpn_push_queue(RPN_INT(str_len(param->var.str)));
+    return BasicError = BASIC_ERR_NONE;
+}
+
+/// left$(s$,n)
+_bas_err_e __left$(_rpn_type_t *param)
+{
+    _rpn_type_t str = *rpn_pull_queue();
+    int32_t n;
+    if ((str.type != VAR_TYPE_STRING) || !str_arg_int(param, &n))
+        return BasicError = (str.type && param->type) ? BASIC_ERR_TYPE_MISMATCH : BASIC_ERR_FEW_ARGUMENTS;
+    uint16_t len = str_len(str.var.str);
+    if (n >= len)
+        return str_push_tail(str.var.str, 0);
+    return str_push_part(str.var.str, 0, n > 0 ? n : 0);
+}
+
+/// right$(s$,n)
+_bas_err_e __right$(_rpn_type_t *param)
+{
+    _rpn_type_t str = *rpn_pull_queue();
+    int32_t n;
+    if ((str.type != VAR_TYPE_STRING) || !str_arg_int(param, &n))
+        return BasicError = (str.type && param->type) ? BASIC_ERR_TYPE_MISMATCH : BASIC_ERR_FEW_ARGUMENTS;
+    uint16_t len = str_len(str.var.str);
+    return str_push_tail(str.var.str, n >= len ? 0 : n > 0 ? len - n : len);
+}
+
+/// mid$(s$,start,n), start from 1
+_bas_err_e __mid$(_rpn_type_t *param)
+{
+    _rpn_type_t start = *rpn_pull_queue();
+    _rpn_type_t str = *rpn_pull_queue();
+    int32_t from, n;
+    if ((str.type != VAR_TYPE_STRING) || !str_arg_int(&start, &from) || !str_arg_int(param, &n))
+        return BasicError = (str.type && start.type && param->type) ? BASIC_ERR_TYPE_MISMATCH : BASIC_ERR_FEW_ARGUMENTS;
+    uint16_t len = str_len(str.var.str);
+    from = from > 1 ? from - 1 : 0;
+    if (from >= len)
+        return str_push_tail(str.var.str, len);
+    if ((n < 0) || (n >= len - from)) // up to the end, no copy
+        return str_push_tail(str.var.str, from);
+    return str_push_part(str.var.str, from, n);
+}
+
+/// instr(s$,find$), position from 1, 0 if not found
+_bas_err_e __instr(_rpn_type_t *param)
+{
+    _rpn_type_t str = *rpn_pull_queue();
+    char *found;
+    if ((str.type != VAR_TYPE_STRING) || (param->type != VAR_TYPE_STRING))
+        return BasicError = (str.type && param->type) ? BASIC_ERR_TYPE_MISMATCH : BASIC_ERR_FEW_ARGUMENTS;
+    found = strstr(str.var.str, param->var.str);
+    rpn_push_queue(RPN_INT(found ? found - str.var.str + 1 : 0));
+    return BasicError = BASIC_ERR_NONE;
+}
+
 _bas_err_e __val$(_rpn_type_t *param)
 {
     switch (param->type)
     {
     case VAR_TYPE_FLOAT:
     case VAR_TYPE_LOOP:
-      b_sprintf(strNumBuff,sizeof(strNumBuff),"%s",tftoa(param->var.f,0));
+      num_ftoa(strNumBuff, param->var.f, NUM_DECIMALS);
       break;
     case VAR_TYPE_INT:
     case VAR_TYPE_BYTE:
     case VAR_TYPE_WORD:
-      b_sprintf(strNumBuff,sizeof(strNumBuff),"%d", param->var.i);
+      num_itoa(strNumBuff, param->var.i);
       break;
     case VAR_TYPE_BOOL:
       b_sprintf(strNumBuff,sizeof(strNumBuff),"%s", param->var.i ? "true" : "false");
@@ -53,15 +272,13 @@ _bas_err_e __val$(_rpn_type_t *param)
     default:
       return BasicError = BASIC_ERR_TYPE_MISMATCH;
     }
-    rpn_push_queue(RPN_STR(strNumBuff));
-    return BasicError = BASIC_ERR_NONE;
+    return str_push(strNumBuff);
 };
 
 _bas_err_e __hex$(_rpn_type_t *param)
 {
-    b_sprintf(strNumBuff,sizeof(strNumBuff),(param->type == VAR_TYPE_BYTE) ? "%2X" : (param->type == VAR_TYPE_WORD) ? "%4X" : "%8X",param->var.i);
-    rpn_push_queue(RPN_STR(strNumBuff));
-    return BasicError = BASIC_ERR_NONE;
+    num_htoa(strNumBuff, param->var.w, (param->type == VAR_TYPE_BYTE) ? 2 : (param->type == VAR_TYPE_WORD) ? 4 : 8);
+    return str_push(strNumBuff);
 };
 
 _bas_err_e __bin$(_rpn_type_t *param)
@@ -71,32 +288,36 @@ _bas_err_e __bin$(_rpn_type_t *param)
     for (i=0;i<len;i++,mask>>=1)
         strNumBuff[i]=param->var.w&mask?'1':'0';
     strNumBuff[i]='\0';
-    rpn_push_queue(RPN_STR(strNumBuff));
-    return BasicError = BASIC_ERR_NONE;
+    return str_push(strNumBuff);
 };
 
 _bas_err_e string_add(char *str1, char *str2)
 {
-    if((strlen(str1) + strlen(str2)) > BASIC_STRING_LEN-2) return BasicError = BASIC_ERR_STRING_LENGTH;
-    *strTmpBuff = '\0';
-    strcpy(strTmpBuff,str1);
-    strcat(strTmpBuff,str2);
-    strcpy(strVarBuff,strTmpBuff);
-    rpn_push_queue(RPN_STR(strVarBuff));
+    uint32_t len1 = strlen(str1), len2 = strlen(str2);
+    char *str;
+    if (len1 + len2 > BASIC_STRING_MAX) return BasicError = BASIC_ERR_STRING_LENGTH;
+    if ((str = str_new(len1 + len2)) == NULL) return BasicError;
+    memcpy(str, str1, len1);
+    memcpy(str + len1, str2, len2 + 1);
+    str_consume(str1);
+    str_consume(str2);
+    rpn_push_queue(RPN_STR(str));
     return BasicError = BASIC_ERR_NONE;
 }
 
 _bas_err_e var_set_string(_bas_var_t *var, char *str)
 {
-    if(var->param.size[0] < (strlen(str)+1))
+    char *old = var->value.var.str;
+    if (!str_is_heap(str)) // a literal or a buffer, take a copy
     {
-        if (var->param.size[0]) vPortFree(var->value.var.str);
-        var->param.size[0] = strlen(str)+1;
-        if ((var->value.var.str = (char *)pvPortMalloc(var->param.size[0])) == NULL)
-            return BasicError = BASIC_ERR_MEM_OUT;
-        //b_printf("\n *** Reallocate %d bytes for %s\n", var->size, var->value.var.str);
+        char *copy;
+        if (strlen(str) > BASIC_STRING_MAX) return BasicError = BASIC_ERR_STRING_LENGTH;
+        if ((copy = str_new(strlen(str))) == NULL) return BasicError;
+        strcpy(copy, str);
+        str = copy;
     }
-    tstrncpy(var->value.var.str,str,var->param.size[0]);
+    str_hold(str);
+    var->value.var.str = str;
+    str_release(old);
     return BasicError = BASIC_ERR_NONE;
 }
-	
\ No newline at end of file
@@ -25,12 +25,25 @@
 
 #include "bcore.h"
 
-#define BASIC_STRING_LEN 128
+#define BASIC_STRING_LEN 128 // input and scratch buffers, string values are limited by the memory only
+#define BASIC_STRING_MAX 0xfff0
+#define BASIC_STR_VIEWS 8 // RIGHT$/MID$ results sharing the heap per statement, a copy is made past that
+
 _bas_err_e __val$(_rpn_type_t *param);
 _bas_err_e __hex$(_rpn_type_t *param);
 _bas_err_e __bin$(_rpn_type_t *param);
+_bas_err_e __len(_rpn_type_t *param);
+_bas_err_e __left$(_rpn_type_t *param);
+_bas_err_e __right$(_rpn_type_t *param);
+_bas_err_e __mid$(_rpn_type_t *param);
+_bas_err_e __instr(_rpn_type_t *param);
 _bas_err_e string_add(char *str1, char *str2);
 _bas_err_e var_set_string(_bas_var_t *var, char *str);
+char *str_new(uint16_t len);
+void str_hold(char *str);
+void str_release(char *str);
+void str_sweep(void);
+void str_reset(void);
 
 extern char strTmpBuff[BASIC_STRING_LEN];
 
@@ -101,6 +101,31 @@ bool rpn_find_queue(_var_type_e varType)
    return false;
 }
 
+/// index of the last value of "varType", unlike rpn_find_queue the values after it stay in the queue
+int16_t rpn_index_queue(_var_type_e varType)
+{
+   for (int16_t i = RPNQueue.ptr - 1; i >= 0; i--)
+      if (RPNQueue.value[i].type == varType)
+         return i;
+   return -1;
+}
+
+_rpn_type_t *rpn_at_queue(uint8_t index)
+{
+   return &RPNQueue.value[index];
+}
+
+uint8_t rpn_len_queue(void)
+{
+   return RPNQueue.ptr;
+}
+
+void rpn_cut_queue(uint8_t len)
+{
+   if (len < RPNQueue.ptr)
+      RPNQueue.ptr = len;
+}
+
 _rpn_type_t *rpn_peek_queue(bool head)
 {
    BasicError = BASIC_ERR_NONE;
@@ -300,6 +325,11 @@ _bas_err_e rpn_eval(uint8_t op)
       value[0].var.i = value[1].var.i >> value[0].var.i;
       break;
    default:
+      if ((value[0].type == VAR_TYPE_STRING) && (op != OPERATOR_NOT) && (op != OPERATOR_AND) && (op != OPERATOR_OR)) // strings relate as strcmp() does
+      {
+         value[1] = RPN_INT(strcmp(value[1].var.str, value[0].var.str));
+         value[0] = RPN_INT(0);
+      }
       switch (op)
       {
       // conditional equations
@@ -314,17 +344,9 @@ _bas_err_e rpn_eval(uint8_t op)
          else value[0].var.i = ((value[1].var.i < value[0].var.i) ? 1 : 0);
          break;
       case OPERATOR_EQUAL:
-         if (value[0].type == VAR_TYPE_STRING)
-         {
-            value[0].var.i = strcmp(value[1].var.str, value[0].var.str) == 0 ? 1 : 0;
-            value[0].type = VAR_TYPE_BOOL;
-         }
-         else
-         {
-            if (doFloat)
-               value[0].var.i = ((value[1].var.f == value[0].var.f) ? 1 : 0);
-            else value[0].var.i = ((value[1].var.i == value[0].var.i) ? 1 : 0);
-         }
+         if (doFloat)
+            value[0].var.i = ((value[1].var.f == value[0].var.f) ? 1 : 0);
+         else value[0].var.i = ((value[1].var.i == value[0].var.i) ? 1 : 0);
          break;
       case OPERATOR_MORE_EQ:
          if (doFloat)
@@ -332,17 +354,9 @@ _bas_err_e rpn_eval(uint8_t op)
          else value[0].var.i = ((value[1].var.i >= value[0].var.i) ? 1 : 0);
          break;
       case OPERATOR_NOT_EQ:
-         if (value[0].type == VAR_TYPE_STRING)
-         {
-            value[0].var.i = strcmp(value[1].var.str, value[0].var.str) == 0 ? 0 : 1;
-            value[0].type = VAR_TYPE_BOOL;
-         }
-         else
-         {
-            if (doFloat)
-               value[0].var.i = ((value[1].var.f != value[0].var.f) ? 1 : 0);
-            else value[0].var.i = ((value[1].var.i != value[0].var.i) ? 1 : 0);
-         }
+         if (doFloat)
+            value[0].var.i = ((value[1].var.f != value[0].var.f) ? 1 : 0);
+         else value[0].var.i = ((value[1].var.i != value[0].var.i) ? 1 : 0);
          break;
       case OPERATOR_LESS_EQ:
          if (doFloat)
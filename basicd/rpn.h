@@ -102,10 +102,16 @@ typedef struct// __attribute ((packed,aligned(4)))
 #define RPN_WORD(x)     ((_rpn_type_t){.type = VAR_TYPE_WORD,.var.i = x})
 #define RPN_STR(x)      ((_rpn_type_t){.type = VAR_TYPE_STRING,.var.str = x})
 
+extern const _rpn_type_t VarNone;
+
 _bas_err_e rpn_push_queue(_rpn_type_t var);
 _rpn_type_t *rpn_pull_queue(void);
 _rpn_type_t *rpn_peek_queue(bool head);
 bool rpn_find_queue(_var_type_e varType);
+int16_t rpn_index_queue(_var_type_e varType);
+_rpn_type_t *rpn_at_queue(uint8_t index);
+uint8_t rpn_len_queue(void);
+void rpn_cut_queue(uint8_t len);
 
 _bas_err_e rpn_push_stack(uint8_t op);
 uint8_t rpn_pull_stack(void);
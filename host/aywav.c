@@ -0,0 +1,170 @@
+/**-----------------------------------------------------------------------------
+ * Copyright (c) 2025 Sergey Sanders
+ * sergey@sesadesign.com
+ * -----------------------------------------------------------------------------
+ * Licensed under Creative Commons Attribution-NonCommercial-ShareAlike 4.0
+ * International (CC BY-NC-SA 4.0).
+ *
+ * You are free to:
+ *  - Share: Copy and redistribute the material.
+ *  - Adapt: Remix, transform, and build upon the material.
+ *
+ * Under the following terms:
+ *  - Attribution: Give appropriate credit and indicate changes.
+ *  - NonCommercial: Do not use for commercial purposes.
+ *  - ShareAlike: Distribute under the same license.
+ *
+ * DISCLAIMER: This work is provided "as is" without any guarantees. The authors
+ * aren’t responsible for any issues, damages, or claims that come up from using
+ * it. Use at your own risk!
+ *
+ * Full license: http://creativecommons.org/licenses/by-nc-sa/4.0/
+ * ---------------------------------------------------------------------------*/
+/**
+ * @file aywav.c
+ * @brief Render an AY-3-8912 register dump to a WAV file on the host
+ *
+ * aywav [-v volume] [-b] dump.psg [out.wav]
+ *
+ * The .psg dump holds the register writes of every 50Hz frame, each frame is rendered by
+ * ay_render() into one DMA block as the firmware plays it, and the 12-bit DAC samples are
+ * saved as 16-bit mono PCM (0 is silence as on the DAC). The CPU time taken per second of audio is reported, -b renders
+ * without writing the file.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <getopt.h>
+#include "bsp.h"
+#include "host.h"
+#include "zx80sys.h"
+#include "ay8912.h"
+
+#define PSG_HEADER_SIZE 16
+#define PSG_FRAME       0xff // end of a frame
+#define PSG_SKIP        0xfe // followed by n, n * 4 frames with no writes
+#define PSG_END         0xfd
+
+/** Little endian RIFF header of a 16-bit mono PCM file */
+static void wav_header(uint8_t *hdr, uint32_t samples)
+{
+   static const uint8_t riff[44] = {'R', 'I', 'F', 'F', 0, 0, 0, 0, 'W', 'A', 'V', 'E', 'f', 'm', 't', ' ',
+                                    16, 0, 0, 0, 1, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 2, 0, 16, 0,
+                                    'd', 'a', 't', 'a', 0, 0, 0, 0};
+   uint32_t fields[][2] = {{4, 36 + samples * 2}, {24, AY_SAMPLE_RATE}, {28, AY_SAMPLE_RATE * 2}, {40, samples * 2}};
+   memcpy(hdr, riff, sizeof(riff));
+   for (uint8_t i = 0; i < 4; i++)
+      for (uint8_t b = 0; b < 4; b++)
+         hdr[fields[i][0] + b] = (uint8_t)(fields[i][1] >> (b * 8));
+}
+
+static void usage(void)
+{
+   fprintf(stderr, "usage: aywav [-v volume] [-b] dump.psg [out.wav]\n"
+                   "  -v, --volume N  volume in %% (100)\n"
+                   "  -b, --bench     report the speed only\n");
+}
+
+int main(int argc, char **argv)
+{
+   static const struct option options[] = {
+       {"volume", required_argument, NULL, 'v'},
+       {"bench", no_argument, NULL, 'b'},
+       {"help", no_argument, NULL, 'h'},
+       {NULL, 0, NULL, 0}};
+   uint16_t volume = DEF_CONF_SPKR_MAX;
+   bool bench = false;
+   int opt;
+   while ((opt = getopt_long(argc, argv, "v:bh", options, NULL)) != -1)
+   {
+      switch (opt)
+      {
+      case 'v':
+         volume = strtoul(optarg, NULL, 0) * (DEF_CONF_SPKR_MAX / 100);
+         break;
+      case 'b':
+         bench = true;
+         break;
+      default:
+         usage();
+         return opt == 'h' ? 0 : 2;
+      }
+   }
+   if (optind >= argc || argc - optind > 2 || (!bench && argc - optind != 2))
+   {
+      usage();
+      return 2;
+   }
+
+   long size = 0;
+   uint8_t *psg = host_load_file(argv[optind], &size);
+   if (!psg || size < PSG_HEADER_SIZE || memcmp(psg, "PSG\x1a", 4))
+   {
+      fprintf(stderr, "%s: not a PSG register dump\n", argv[optind]);
+      return 1;
+   }
+   FILE *wavFile = NULL;
+   uint8_t hdr[44];
+   if (!bench && (!(wavFile = fopen(argv[optind + 1], "wb")) || fwrite(hdr, 1, sizeof(hdr), wavFile) != sizeof(hdr)))
+   {
+      fprintf(stderr, "%s: can't write\n", argv[optind + 1]);
+      return 1;
+   }
+
+   static _ay_t ay;
+   uint16_t dac[AY_FRAME_SAMPLES];
+   int16_t pcm[AY_FRAME_SAMPLES];
+   uint32_t frames = 0, repeat = 0;
+   uint64_t renderTime = 0;
+   long pos = PSG_HEADER_SIZE;
+   ay_reset(&ay);
+   while (repeat || (pos < size && psg[pos] != PSG_END))
+   {
+      if (!repeat) // the writes up to the frame end
+      {
+         for (; pos < size && psg[pos] < AY_REGISTERS; pos += 2)
+         {
+            ay_select(&ay, psg[pos]);
+            ay_write(&ay, pos + 1 < size ? psg[pos + 1] : 0);
+         }
+         if (pos >= size || psg[pos] == PSG_END)
+            break;
+         if (psg[pos] == PSG_SKIP)
+         {
+            repeat = (pos + 1 < size) ? psg[pos + 1] * 4 : 0;
+            pos += 2;
+            continue;
+         }
+         pos++; // PSG_FRAME, other values are taken as one
+      }
+      else
+         repeat--;
+      uint64_t start = host_time_us();
+      ay_render(&ay, dac, NULL, 0, 0, volume);
+      renderTime += host_time_us() - start;
+      frames++;
+      if (bench)
+         continue;
+      for (uint16_t i = 0; i < AY_FRAME_SAMPLES; i++)
+         pcm[i] = (int16_t)(dac[i] * 8);
+      if (fwrite(pcm, sizeof(int16_t), AY_FRAME_SAMPLES, wavFile) != AY_FRAME_SAMPLES)
+      {
+         fprintf(stderr, "%s: write error\n", argv[optind + 1]);
+         return 1;
+      }
+   }
+   free(psg);
+   if (wavFile)
+   {
+      wav_header(hdr, frames * AY_FRAME_SAMPLES);
+      if (fseek(wavFile, 0, SEEK_SET) || fwrite(hdr, 1, sizeof(hdr), wavFile) != sizeof(hdr) || fclose(wavFile))
+      {
+         fprintf(stderr, "%s: write error\n", argv[optind + 1]);
+         return 1;
+      }
+   }
+   double seconds = (double)frames * AY_FRAME_SAMPLES / AY_SAMPLE_RATE;
+   printf("%u frames, %.2f s of audio at %lu Hz: %.2f ms, %.3f ms per second of audio\n", frames, seconds,
+          AY_SAMPLE_RATE, renderTime / 1000.0, seconds > 0 ? renderTime / 1000.0 / seconds : 0.0);
+   return 0;
+}
@@ -0,0 +1,144 @@
+/**-----------------------------------------------------------------------------
+ * Copyright (c) 2025 Sergey Sanders
+ * sergey@sesadesign.com
+ * -----------------------------------------------------------------------------
+ * Licensed under Creative Commons Attribution-NonCommercial-ShareAlike 4.0
+ * International (CC BY-NC-SA 4.0).
+ *
+ * You are free to:
+ *  - Share: Copy and redistribute the material.
+ *  - Adapt: Remix, transform, and build upon the material.
+ *
+ * Under the following terms:
+ *  - Attribution: Give appropriate credit and indicate changes.
+ *  - NonCommercial: Do not use for commercial purposes.
+ *  - ShareAlike: Distribute under the same license.
+ *
+ * DISCLAIMER: This work is provided "as is" without any guarantees. The authors
+ * aren’t responsible for any issues, damages, or claims that come up from using
+ * it. Use at your own risk!
+ *
+ * Full license: http://creativecommons.org/licenses/by-nc-sa/4.0/
+ * ---------------------------------------------------------------------------*/
+/**
+ * @file basrun.c
+ * @brief Headless BASIC runner for the host build
+ *
+ * basrun [-t] [-r count] [-s] [-n lines] [-k keys] [program [command...]]
+ *
+ * Loads a program file, or a ROM program by its index, and runs the commands
+ * given after it (RUN without any). Without a program the lines of stdin are
+ * taken as typed at the prompt: numbered lines edit the program, the others
+ * run at once. The terminal output goes to stdout a line at a time, -t times
+ * every command on stderr, -r runs the commands again and keeps the fastest
+ * time, -s prints the screen at the end.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <getopt.h>
+#include "host.h"
+#include "basic_host.h"
+
+#define BASRUN_LINE_LEN 256
+
+static bool timing = false;
+static uint32_t repeat = 1;
+
+static void usage(void)
+{
+   fprintf(stderr, "usage: basrun [-t] [-r count] [-s] [-n lines] [-k keys] [program.bas|0..2 [command...]]\n"
+                   "  -t, --time       time every command, report the heap at the end\n"
+                   "  -r, --repeat N   run every command N times, the fastest run is reported\n"
+                   "  -s, --screen     print the terminal screen at the end\n"
+                   "  -n, --lines N    break a run after N lines\n"
+                   "  -k, --keys KEYS  keys for INKEY$, INPUT and the questions, Enter when used up\n");
+}
+
+static void on_break(int sig)
+{
+   bas_host_interrupt();
+}
+
+static void command(const char *str)
+{
+   uint64_t best = UINT64_MAX;
+   if (*str >= '0' && *str <= '9')
+   {
+      bas_host_line(str); // a program line
+      return;
+   }
+   for (uint32_t i = 0; i < repeat; i++)
+   {
+      uint64_t start = host_time_us();
+      bas_host_line(str);
+      if (host_time_us() - start < best)
+         best = host_time_us() - start;
+   }
+   if (timing)
+      fprintf(stderr, "%.*s: %.3f ms\n", (int)strcspn(str, "\r\n"), str, best / 1000.0);
+}
+
+int main(int argc, char **argv)
+{
+   static const struct option options[] = {
+       {"time", no_argument, NULL, 't'},
+       {"repeat", required_argument, NULL, 'r'},
+       {"screen", no_argument, NULL, 's'},
+       {"lines", required_argument, NULL, 'n'},
+       {"keys", required_argument, NULL, 'k'},
+       {"help", no_argument, NULL, 'h'},
+       {NULL, 0, NULL, 0}};
+   bool screenOut = false;
+   int opt;
+   while ((opt = getopt_long(argc, argv, "tr:sn:k:h", options, NULL)) != -1)
+   {
+      switch (opt)
+      {
+      case 't':
+         timing = true;
+         break;
+      case 'r':
+         repeat = strtoul(optarg, NULL, 0) ? strtoul(optarg, NULL, 0) : 1;
+         break;
+      case 's':
+         screenOut = true;
+         break;
+      case 'n':
+         bas_host_break(strtoul(optarg, NULL, 0));
+         break;
+      case 'k':
+         bas_host_keys(optarg);
+         break;
+      default:
+         usage();
+         return opt == 'h' ? 0 : 2;
+      }
+   }
+
+   signal(SIGINT, on_break);
+   bas_host_output(stdout);
+   bas_host_init();
+   if (optind < argc)
+   {
+      bas_host_load(argv[optind]);
+      if (optind + 1 == argc)
+         command("run");
+      for (int i = optind + 1; i < argc; i++)
+         command(argv[i]);
+   }
+   else
+   {
+      char str[BASRUN_LINE_LEN];
+      while (fgets(str, sizeof(str), stdin))
+         command(str);
+   }
+   bas_host_flush();
+   if (screenOut)
+      bas_host_screen(stdout);
+   if (timing)
+      fprintf(stderr, "heap: %u bytes in use, %u peak, %u allocations, %u refused\n", HostHeap.used, HostHeap.peak,
+              HostHeap.allocs, HostHeap.failed);
+   return 0;
+}
@@ -0,0 +1,39 @@
+/**-----------------------------------------------------------------------------
+ * Copyright (c) 2025 Sergey Sanders
+ * sergey@sesadesign.com
+ * -----------------------------------------------------------------------------
+ * Licensed under Creative Commons Attribution-NonCommercial-ShareAlike 4.0
+ * International (CC BY-NC-SA 4.0).
+ *
+ * You are free to:
+ *  - Share: Copy and redistribute the material.
+ *  - Adapt: Remix, transform, and build upon the material.
+ *
+ * Under the following terms:
+ *  - Attribution: Give appropriate credit and indicate changes.
+ *  - NonCommercial: Do not use for commercial purposes.
+ *  - ShareAlike: Distribute under the same license.
+ *
+ * DISCLAIMER: This work is provided "as is" without any guarantees. The authors
+ * aren’t responsible for any issues, damages, or claims that come up from using
+ * it. Use at your own risk!
+ *
+ * Full license: http://creativecommons.org/licenses/by-nc-sa/4.0/
+ * ---------------------------------------------------------------------------*/
+/**
+ * @file basic_compat.h
+ * @brief Included ahead of every BASIC source in the host build
+ *
+ * glibc declares __sin, __cos, __tan and __log in math.h, the interpreter
+ * uses the same names for its functions. math.h goes first, then the BASIC
+ * ones are renamed.
+ */
+#ifndef _BASIC_COMPAT_H_INCLUDED
+#define _BASIC_COMPAT_H_INCLUDED
+#include <math.h>
+
+#define __sin bas__sin
+#define __cos bas__cos
+#define __tan bas__tan
+#define __log bas__log
+#endif //_BASIC_COMPAT_H_INCLUDED
@@ -0,0 +1,86 @@
+/**-----------------------------------------------------------------------------
+ * Copyright (c) 2025 Sergey Sanders
+ * sergey@sesadesign.com
+ * -----------------------------------------------------------------------------
+ * Licensed under Creative Commons Attribution-NonCommercial-ShareAlike 4.0
+ * International (CC BY-NC-SA 4.0).
+ *
+ * You are free to:
+ *  - Share: Copy and redistribute the material.
+ *  - Adapt: Remix, transform, and build upon the material.
+ *
+ * Under the following terms:
+ *  - Attribution: Give appropriate credit and indicate changes.
+ *  - NonCommercial: Do not use for commercial purposes.
+ *  - ShareAlike: Distribute under the same license.
+ *
+ * DISCLAIMER: This work is provided "as is" without any guarantees. The authors
+ * aren’t responsible for any issues, damages, or claims that come up from using
+ * it. Use at your own risk!
+ *
+ * Full license: http://creativecommons.org/licenses/by-nc-sa/4.0/
+ * ---------------------------------------------------------------------------*/
+/**
+ * @file basic_host.c
+ * @brief The BASIC prompt on the host
+ *
+ * bas_host_line takes a line as basic_exe does after the editor returned it:
+ * a numbered line edits the program, anything else runs at once as line zero.
+ */
+#include <string.h>
+#include <stdlib.h>
+#include "banalizer.h"
+#include "bcore.h"
+#include "bedit.h"
+#include "bhighlight.h"
+#include "bmem.h"
+#include "uterm.h"
+#include "basic_host.h"
+
+static const _rpn_type_t paramLineZero = {.type = VAR_TYPE_BYTE, .var.i = 0};
+
+void bas_host_init(void)
+{
+   stdio = &basicStream;
+   uTerm.cursorSize = uTerm.font->height;
+   uTerm.bgColour = HLScheme[SYNCOL_BACKGROUND];
+   uTerm.fgColour = HLScheme[SYNCOL_DEFAULT];
+   text_cls();
+   if (BasicLineZero == NULL)
+   {
+      BasicLineZero = arena_alloc(&ProgArena, sizeof(_bas_line_t));
+      memset(BasicLineZero, 0x00, sizeof(_bas_line_t));
+   }
+}
+
+void bas_host_line(const char *str)
+{
+   char buf[BASIC_LINE_LEN + 6];
+   char *bLineStr = buf;
+   uint16_t lineNumber;
+   size_t len = strcspn(str, "\r\n");
+   if (!len)
+      return; // empty line, nothing to do
+   if (len > BASIC_LINE_LEN)
+      len = BASIC_LINE_LEN;
+   memcpy(buf, str, len);
+   strcpy(buf + len, "\n");
+   lineNumber = is_digit(*bLineStr) ? (uint16_t)strtol(bLineStr, &bLineStr, 10) : 0;
+   prog_add_line(lineNumber, (uint8_t **)&bLineStr);
+   if (!lineNumber)
+      __run((_rpn_type_t *)&paramLineZero);
+}
+
+/** A file name, or the index of a ROM program */
+void bas_host_load(const char *progName)
+{
+   char name[BASIC_LINE_LEN];
+   tstrncpy(name, (char *)progName, sizeof(name));
+   prog_load(name);
+}
+
+/// SYS runs a shell command on the board, the host has no shell
+bool exec_line(char *str)
+{
+   return false;
+}
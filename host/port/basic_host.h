@@ -0,0 +1,55 @@
+/**-----------------------------------------------------------------------------
+ * Copyright (c) 2025 Sergey Sanders
+ * sergey@sesadesign.com
+ * -----------------------------------------------------------------------------
+ * Licensed under Creative Commons Attribution-NonCommercial-ShareAlike 4.0
+ * International (CC BY-NC-SA 4.0).
+ *
+ * You are free to:
+ *  - Share: Copy and redistribute the material.
+ *  - Adapt: Remix, transform, and build upon the material.
+ *
+ * Under the following terms:
+ *  - Attribution: Give appropriate credit and indicate changes.
+ *  - NonCommercial: Do not use for commercial purposes.
+ *  - ShareAlike: Distribute under the same license.
+ *
+ * DISCLAIMER: This work is provided "as is" without any guarantees. The authors
+ * aren’t responsible for any issues, damages, or claims that come up from using
+ * it. Use at your own risk!
+ *
+ * Full license: http://creativecommons.org/licenses/by-nc-sa/4.0/
+ * ---------------------------------------------------------------------------*/
+/**
+ * @file basic_host.h
+ * @brief Host build of the BASIC interpreter: the prompt, the terminal transcript and the heap
+ */
+#ifndef _BASIC_HOST_H_INCLUDED
+#define _BASIC_HOST_H_INCLUDED
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+/// FreeRTOS heap accounting, pvPortMalloc fails past configTOTAL_HEAP_SIZE as on the board
+typedef struct
+{
+   uint32_t used;   // bytes allocated now
+   uint32_t peak;   // most bytes allocated at once
+   uint32_t allocs; // pvPortMalloc calls
+   uint32_t frees;  // vPortFree calls
+   uint32_t failed; // allocations refused
+} _host_heap_t;
+
+extern _host_heap_t HostHeap;
+extern uint8_t HostLcd[]; // LCD_WIDTH x LCD_HEIGHT colour indexes, the graphics statements draw here
+
+void bas_host_init(void);
+void bas_host_output(FILE *out);
+void bas_host_line(const char *str);
+void bas_host_load(const char *progName);
+void bas_host_keys(const char *keys);
+void bas_host_break(uint32_t lines);
+void bas_host_interrupt(void);
+void bas_host_flush(void);
+void bas_host_screen(FILE *out);
+#endif //_BASIC_HOST_H_INCLUDED
@@ -0,0 +1,112 @@
+/**-----------------------------------------------------------------------------
+ * Copyright (c) 2025 Sergey Sanders
+ * sergey@sesadesign.com
+ * -----------------------------------------------------------------------------
+ * Licensed under Creative Commons Attribution-NonCommercial-ShareAlike 4.0
+ * International (CC BY-NC-SA 4.0).
+ *
+ * You are free to:
+ *  - Share: Copy and redistribute the material.
+ *  - Adapt: Remix, transform, and build upon the material.
+ *
+ * Under the following terms:
+ *  - Attribution: Give appropriate credit and indicate changes.
+ *  - NonCommercial: Do not use for commercial purposes.
+ *  - ShareAlike: Distribute under the same license.
+ *
+ * DISCLAIMER: This work is provided "as is" without any guarantees. The authors
+ * aren’t responsible for any issues, damages, or claims that come up from using
+ * it. Use at your own risk!
+ *
+ * Full license: http://creativecommons.org/licenses/by-nc-sa/4.0/
+ * ---------------------------------------------------------------------------*/
+/**
+ * @file ff.c
+ * @brief The FatFS calls of the BASIC interpreter over host files
+ *
+ * The FILE of an open file is kept in obj.fs, the size and the pointer are
+ * kept up to date for f_size, f_tell and f_eof.
+ */
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include "ff.h"
+
+#define HOST_FILE(fp) ((FILE *)(void *)(fp)->obj.fs)
+
+FRESULT f_open(FIL *fp, const TCHAR *path, BYTE mode)
+{
+   FILE *file;
+   const char *fmode = "rb";
+   memset(fp, 0, sizeof(FIL));
+   if (mode & FA_WRITE)
+   {
+      if (mode & FA_CREATE_NEW)
+      {
+         if ((file = fopen(path, "rb")))
+         {
+            fclose(file);
+            return FR_EXIST;
+         }
+         fmode = "w+b";
+      }
+      else if (mode & FA_CREATE_ALWAYS)
+         fmode = "w+b";
+      else
+         fmode = "r+b";
+   }
+   if (!(file = fopen(path, fmode)))
+      return FR_NO_FILE;
+   fseek(file, 0, SEEK_END);
+   fp->obj.objsize = ftell(file);
+   fseek(file, 0, SEEK_SET);
+   fp->obj.fs = (FATFS *)(void *)file;
+   fp->flag = mode;
+   return FR_OK;
+}
+
+FRESULT f_close(FIL *fp)
+{
+   if (!HOST_FILE(fp))
+      return FR_INVALID_OBJECT;
+   fclose(HOST_FILE(fp));
+   fp->obj.fs = NULL;
+   return FR_OK;
+}
+
+FRESULT f_read(FIL *fp, void *buff, UINT btr, UINT *br)
+{
+   if (!HOST_FILE(fp))
+      return FR_INVALID_OBJECT;
+   *br = fread(buff, 1, btr, HOST_FILE(fp));
+   fp->fptr += *br;
+   return ferror(HOST_FILE(fp)) ? FR_DISK_ERR : FR_OK;
+}
+
+FRESULT f_write(FIL *fp, const void *buff, UINT btw, UINT *bw)
+{
+   if (!HOST_FILE(fp) || !(fp->flag & FA_WRITE))
+      return FR_DENIED;
+   *bw = fwrite(buff, 1, btw, HOST_FILE(fp));
+   fp->fptr += *bw;
+   if (fp->fptr > fp->obj.objsize)
+      fp->obj.objsize = fp->fptr;
+   return (*bw == btw) ? FR_OK : FR_DISK_ERR;
+}
+
+FRESULT f_truncate(FIL *fp)
+{
+   if (!HOST_FILE(fp) || !(fp->flag & FA_WRITE))
+      return FR_DENIED;
+   fflush(HOST_FILE(fp));
+   if (ftruncate(fileno(HOST_FILE(fp)), fp->fptr))
+      return FR_DISK_ERR;
+   fp->obj.objsize = fp->fptr;
+   return FR_OK;
+}
+
+int f_puts(const TCHAR *str, FIL *cp)
+{
+   UINT len = strlen(str), done;
+   return ((f_write(cp, str, len, &done) == FR_OK) && (done == len)) ? (int)len : -1;
+}
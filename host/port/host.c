@@ -0,0 +1,131 @@
+/**-----------------------------------------------------------------------------
+ * Copyright (c) 2025 Sergey Sanders
+ * sergey@sesadesign.com
+ * -----------------------------------------------------------------------------
+ * Licensed under Creative Commons Attribution-NonCommercial-ShareAlike 4.0
+ * International (CC BY-NC-SA 4.0).
+ *
+ * You are free to:
+ *  - Share: Copy and redistribute the material.
+ *  - Adapt: Remix, transform, and build upon the material.
+ *
+ * Under the following terms:
+ *  - Attribution: Give appropriate credit and indicate changes.
+ *  - NonCommercial: Do not use for commercial purposes.
+ *  - ShareAlike: Distribute under the same license.
+ *
+ * DISCLAIMER: This work is provided "as is" without any guarantees. The authors
+ * aren’t responsible for any issues, damages, or claims that come up from using
+ * it. Use at your own risk!
+ *
+ * Full license: http://creativecommons.org/licenses/by-nc-sa/4.0/
+ * ---------------------------------------------------------------------------*/
+/**
+ * @file host.c
+ * @brief Host build support
+ *
+ * The board's keyboard driver owns keyRows, here it only backs the firmware's
+ * zxMachine. Every host machine gets its own memory, keyboard rows and AY.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <time.h>
+#include "host.h"
+#include "bsp.h"
+#include "zx80sys.h"
+#include "zxscreen.h"
+#include "snapshot.h"
+
+uint8_t keyRows[8] = {0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff};
+
+/** Read up to size bytes of a file, returns the count or -1 */
+long host_load(const char *fileName, uint8_t *buf, long size)
+{
+   FILE *f;
+   long n;
+   if (!(f = fopen(fileName, "rb")))
+      return -1;
+   n = (long)fread(buf, 1, size, f);
+   fclose(f);
+   return n;
+}
+
+/** Read a whole file into a new buffer */
+uint8_t *host_load_file(const char *fileName, long *size)
+{
+   FILE *f;
+   uint8_t *buf = NULL;
+   long n;
+   if (!(f = fopen(fileName, "rb")))
+      return NULL;
+   if (!fseek(f, 0, SEEK_END) && (n = ftell(f)) >= 0 && !fseek(f, 0, SEEK_SET) && (buf = malloc(n + 1)))
+   {
+      if ((long)fread(buf, 1, n, f) == n)
+         *size = n;
+      else
+      {
+         free(buf);
+         buf = NULL;
+      }
+   }
+   fclose(f);
+   return buf;
+}
+
+uint64_t host_time_us(void)
+{
+   struct timespec ts;
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+   return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+/** A powered on 48K machine with no keys pressed, the ROM is left empty */
+Z80_CONTEXT *zx_host_new(void)
+{
+   static bool tablesReady = false;
+   Z80_CONTEXT *ctx = calloc(1, sizeof(Z80_CONTEXT));
+   _zx_machine_t *zx = calloc(1, sizeof(_zx_machine_t));
+   if (!tablesReady) // shared read-only tables, create the machines before starting threads
+   {
+      ula_init();
+      zx_screen_init();
+      tablesReady = true;
+   }
+   zx->keyRows = malloc(8);
+   memset(zx->keyRows, 0xff, 8);
+   ay_reset(&zx->ay);
+   ctx->mem = calloc(1, Z80SYS_MEMORY_SIZE);
+   ctx->machine = zx;
+   Z80Reset(ctx);
+   return ctx;
+}
+
+void zx_host_free(Z80_CONTEXT *ctx)
+{
+   free(ctx->machine->keyRows);
+   free(ctx->machine);
+   free(ctx->mem);
+   free(ctx);
+}
+
+/** Load a .z80 or .sna snapshot, the type is taken from the file extension */
+bool zx_host_snapshot(Z80_CONTEXT *ctx, const char *fileName)
+{
+   const char *ext = strrchr(fileName, '.');
+   uint8_t *data;
+   long size = 0;
+   if (!ext || (strcasecmp(ext, ".z80") && strcasecmp(ext, ".sna")))
+      return false;
+   if (!(data = host_load_file(fileName, &size)))
+      return false;
+   if (!strcasecmp(ext, ".sna") && size >= (long)sizeof(_snap_sna_hdr_t))
+      load_snapshot_sna(ctx, data);
+   else if (!strcasecmp(ext, ".z80") && size >= (long)sizeof(_snap_z80_hdr_t))
+      load_snapshot_z80(ctx, data);
+   else
+      size = 0;
+   free(data);
+   return size != 0;
+}
@@ -0,0 +1,40 @@
+/**-----------------------------------------------------------------------------
+ * Copyright (c) 2025 Sergey Sanders
+ * sergey@sesadesign.com
+ * -----------------------------------------------------------------------------
+ * Licensed under Creative Commons Attribution-NonCommercial-ShareAlike 4.0
+ * International (CC BY-NC-SA 4.0).
+ *
+ * You are free to:
+ *  - Share: Copy and redistribute the material.
+ *  - Adapt: Remix, transform, and build upon the material.
+ *
+ * Under the following terms:
+ *  - Attribution: Give appropriate credit and indicate changes.
+ *  - NonCommercial: Do not use for commercial purposes.
+ *  - ShareAlike: Distribute under the same license.
+ *
+ * DISCLAIMER: This work is provided "as is" without any guarantees. The authors
+ * aren’t responsible for any issues, damages, or claims that come up from using
+ * it. Use at your own risk!
+ *
+ * Full license: http://creativecommons.org/licenses/by-nc-sa/4.0/
+ * ---------------------------------------------------------------------------*/
+/**
+ * @file host.h
+ * @brief Host build support: machines without the board, files and timing
+ */
+#ifndef _HOST_H_INCLUDED
+#define _HOST_H_INCLUDED
+#include <stdint.h>
+#include <stdbool.h>
+#include "z80cpu.h"
+
+long host_load(const char *fileName, uint8_t *buf, long size);
+uint8_t *host_load_file(const char *fileName, long *size);
+uint64_t host_time_us(void);
+
+Z80_CONTEXT *zx_host_new(void);
+void zx_host_free(Z80_CONTEXT *ctx);
+bool zx_host_snapshot(Z80_CONTEXT *ctx, const char *fileName);
+#endif //_HOST_H_INCLUDED
@@ -0,0 +1,109 @@
+/**-----------------------------------------------------------------------------
+ * Copyright (c) 2025 Sergey Sanders
+ * sergey@sesadesign.com
+ * -----------------------------------------------------------------------------
+ * Licensed under Creative Commons Attribution-NonCommercial-ShareAlike 4.0
+ * International (CC BY-NC-SA 4.0).
+ *
+ * You are free to:
+ *  - Share: Copy and redistribute the material.
+ *  - Adapt: Remix, transform, and build upon the material.
+ *
+ * Under the following terms:
+ *  - Attribution: Give appropriate credit and indicate changes.
+ *  - NonCommercial: Do not use for commercial purposes.
+ *  - ShareAlike: Distribute under the same license.
+ *
+ * DISCLAIMER: This work is provided "as is" without any guarantees. The authors
+ * aren’t responsible for any issues, damages, or claims that come up from using
+ * it. Use at your own risk!
+ *
+ * Full license: http://creativecommons.org/licenses/by-nc-sa/4.0/
+ * ---------------------------------------------------------------------------*/
+/**
+ * @file rtos.c
+ * @brief The FreeRTOS calls of the BASIC interpreter on the host
+ *
+ * The heap is malloc with a size header so the board's 80K limit, the free
+ * size and the peak can be reported. Ticks are milliseconds of the monotonic
+ * clock, a delay only moves the tick count on instead of sleeping.
+ */
+#include <stdlib.h>
+#include <time.h>
+#include "freeRTOS.h"
+#include "task.h"
+#include "basic_host.h"
+
+_host_heap_t HostHeap;
+static TickType_t TickDelay = 0;
+
+/// size header keeping the block aligned for any type
+typedef union
+{
+   size_t size;
+   long double align;
+} _host_block_t;
+
+void *pvPortMalloc(size_t size)
+{
+   _host_block_t *block;
+   HostHeap.allocs++;
+   if ((HostHeap.used + size > configTOTAL_HEAP_SIZE) || !(block = malloc(sizeof(_host_block_t) + size)))
+   {
+      HostHeap.failed++;
+      return NULL;
+   }
+   block->size = size;
+   HostHeap.used += size;
+   if (HostHeap.used > HostHeap.peak)
+      HostHeap.peak = HostHeap.used;
+   return block + 1;
+}
+
+void vPortFree(void *pv)
+{
+   _host_block_t *block = pv;
+   if (!pv)
+      return;
+   block--;
+   HostHeap.frees++;
+   HostHeap.used -= block->size;
+   free(block);
+}
+
+size_t xPortGetFreeHeapSize(void)
+{
+   return configTOTAL_HEAP_SIZE - HostHeap.used;
+}
+
+TickType_t xTaskGetTickCount(void)
+{
+   struct timespec ts;
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+   return (TickType_t)(ts.tv_sec * 1000 + ts.tv_nsec / 1000000) + TickDelay;
+}
+
+void vTaskDelay(const TickType_t xTicksToDelay)
+{
+   TickDelay += xTicksToDelay;
+}
+
+void vTaskSuspend(TaskHandle_t xTaskToSuspend)
+{
+}
+
+void vTaskResume(TaskHandle_t xTaskToResume)
+{
+}
+
+/// the TRNG of the board, RND seeds from it unless RANDOMIZE n was given
+uint32_t host_rnd_word(void)
+{
+   static uint32_t state = 0;
+   if (!state)
+      state = (uint32_t)time(NULL) | 1;
+   state ^= state << 13;
+   state ^= state >> 17;
+   state ^= state << 5;
+   return state;
+}
@@ -0,0 +1,332 @@
+/**-----------------------------------------------------------------------------
+ * Copyright (c) 2025 Sergey Sanders
+ * sergey@sesadesign.com
+ * -----------------------------------------------------------------------------
+ * Licensed under Creative Commons Attribution-NonCommercial-ShareAlike 4.0
+ * International (CC BY-NC-SA 4.0).
+ *
+ * You are free to:
+ *  - Share: Copy and redistribute the material.
+ *  - Adapt: Remix, transform, and build upon the material.
+ *
+ * Under the following terms:
+ *  - Attribution: Give appropriate credit and indicate changes.
+ *  - NonCommercial: Do not use for commercial purposes.
+ *  - ShareAlike: Distribute under the same license.
+ *
+ * DISCLAIMER: This work is provided "as is" without any guarantees. The authors
+ * aren’t responsible for any issues, damages, or claims that come up from using
+ * it. Use at your own risk!
+ *
+ * Full license: http://creativecommons.org/licenses/by-nc-sa/4.0/
+ * ---------------------------------------------------------------------------*/
+/**
+ * @file term.c
+ * @brief Terminal, graphics, keyboard and line editor of the BASIC interpreter on the host
+ *
+ * The terminal keeps the board's 40x20 character screen. A line is written
+ * to the transcript when the cursor leaves it with a new line, so the output
+ * reads as the board would have scrolled it. Keys come from a script, an
+ * empty script reads as Enter and a key wait never blocks.
+ */
+#include <string.h>
+#include "uterm.h"
+#include "graph.h"
+#include "keyboard.h"
+#include "editline.h"
+#include "basic_host.h"
+
+#define HOST_TERM_COLS (LCD_WIDTH / _TERM_FONT_WIDTH)
+#define HOST_TERM_LINES (LCD_HEIGHT / _TERM_FONT_HEIGHT)
+#define HOST_KEYS_LEN 256
+
+static const uFont_t hostFont = {.height = _TERM_FONT_HEIGHT, .width = _TERM_FONT_WIDTH, .first = ' ', .last = 0x7f};
+static glyph_t screenBuf[HOST_TERM_COLS * HOST_TERM_LINES];
+glyph_t *screen = screenBuf;
+_terminal_t uTerm = {
+    .cols = HOST_TERM_COLS,
+    .lines = HOST_TERM_LINES,
+    .font = &hostFont,
+    .cursorSize = TERM_CURSOR_SIZE,
+    .cursorEn = TERM_CURSOR_EN,
+    .fgColour = TERM_FG_COLOUR,
+    .bgColour = TERM_BG_COLOUR};
+TaskHandle_t xuTermTask = NULL;
+static FILE *termOut = NULL;
+
+uint8_t HostLcd[LCD_WIDTH * LCD_HEIGHT];
+void (*x_pixel)(uint16_t x, uint8_t y, uint8_t c) = put_pixel;
+
+static struct
+{
+   char str[HOST_KEYS_LEN];
+   uint16_t ptr;
+} keys;
+static uint32_t breakLines = 0, breakCount = 0;
+static volatile bool breakNow = false;
+
+void bas_host_output(FILE *out)
+{
+   termOut = out;
+}
+
+/** Write a screen line to the transcript, trailing spaces dropped */
+static void term_line_out(FILE *out, uint8_t line)
+{
+   glyph_t *row = &screen[line * uTerm.cols];
+   uint8_t len = uTerm.cols;
+   while (len && (!row[len - 1].gl.c || (row[len - 1].gl.c == ' ')))
+      len--;
+   for (uint8_t i = 0; i < len; i++)
+      fputc(row[i].gl.c ? row[i].gl.c : ' ', out);
+   fputc('\n', out);
+}
+
+/** The line under the cursor, if the output stopped without a new line */
+void bas_host_flush(void)
+{
+   if (uTerm.cursorCol)
+   {
+      term_line_out(termOut ? termOut : stdout, uTerm.cursorLine);
+      uTerm.cursorCol = 0;
+      if (uTerm.cursorLine < uTerm.lines - 1)
+         uTerm.cursorLine++;
+   }
+   fflush(termOut ? termOut : stdout);
+}
+
+void bas_host_screen(FILE *out)
+{
+   for (uint8_t i = 0; i < uTerm.lines; i++)
+      term_line_out(out, i);
+}
+
+void glyph_xy(uint8_t col, uint8_t row, glyph_t glyph)
+{
+   if ((col < uTerm.cols) && (row < uTerm.lines))
+      screen[row * uTerm.cols + col] = glyph;
+}
+
+void ut_new_line(bool lineReturn)
+{
+   term_line_out(termOut ? termOut : stdout, uTerm.cursorLine);
+   if (lineReturn)
+      uTerm.cursorCol = 0;
+   if (uTerm.cursorLine < uTerm.lines - 1)
+      uTerm.cursorLine++;
+   else
+   {
+      memmove(screen, &screen[uTerm.cols], (uTerm.lines - 1) * uTerm.cols * sizeof(glyph_t));
+      memset(&screen[(uTerm.lines - 1) * uTerm.cols], 0, uTerm.cols * sizeof(glyph_t));
+   }
+}
+
+void text_cls(void)
+{
+   memset(screen, 0, uTerm.cols * uTerm.lines * sizeof(glyph_t));
+   uTerm.cursorCol = uTerm.cursorLine = 0;
+}
+
+void text_fg_colour(uint8_t colour)
+{
+   uTerm.fgColour = colour;
+}
+
+void text_bg_colour(uint8_t colour)
+{
+   uTerm.bgColour = colour;
+}
+
+void cursor_move(uint8_t line, uint8_t col)
+{
+   uTerm.cursorLine = line;
+   uTerm.cursorCol = col;
+}
+
+void cursor_invert(void)
+{
+}
+
+void put_pixel(uint16_t x, uint8_t y, uint8_t c)
+{
+   if ((x < LCD_WIDTH) && (y < LCD_HEIGHT))
+      HostLcd[y * LCD_WIDTH + x] = c;
+}
+
+void put_xpixel(uint16_t x, uint8_t y, uint8_t c)
+{
+   if ((x < LCD_WIDTH) && (y < LCD_HEIGHT))
+      HostLcd[y * LCD_WIDTH + x] ^= c;
+}
+
+void line_h(int16_t x, uint8_t y, uint16_t len, uint8_t c)
+{
+   while (len--)
+      x_pixel(x++, y, c);
+}
+
+void line_v(int16_t x, uint8_t y, uint16_t len, uint8_t c)
+{
+   while (len--)
+      x_pixel(x, y++, c);
+}
+
+void line(int16_t x1, uint8_t y1, int16_t x2, uint8_t y2, uint8_t c)
+{
+   int16_t dx = x2 > x1 ? x2 - x1 : x1 - x2, sx = x1 < x2 ? 1 : -1;
+   int16_t dy = y2 > y1 ? y1 - y2 : y2 - y1, sy = y1 < y2 ? 1 : -1;
+   int16_t err = dx + dy, y = y1, e2;
+   while (1)
+   {
+      x_pixel(x1, y, c);
+      if ((x1 == x2) && (y == y2))
+         break;
+      e2 = 2 * err; // both steps test the error before either of them
+      if (e2 >= dy)
+      {
+         err += dy;
+         x1 += sx;
+      }
+      if (e2 <= dx)
+      {
+         err += dx;
+         y += sy;
+      }
+   }
+}
+
+void rect(uint16_t x, uint8_t y, uint16_t sizeX, uint8_t sizeY, uint8_t c)
+{
+   line_h(x, y, sizeX, c);
+   line_h(x, y + sizeY - 1, sizeX, c);
+   line_v(x, y + 1, sizeY - 2, c);
+   line_v(x + sizeX - 1, y + 1, sizeY - 2, c);
+}
+
+void rect_fill(uint16_t x, uint8_t y, uint16_t sizeX, uint8_t sizeY, uint8_t c)
+{
+   while (sizeY--)
+      line_h(x, y++, sizeX, c);
+}
+
+void circle(uint16_t x, uint8_t y, int16_t r, uint8_t c)
+{
+   int16_t cx = r, cy = 0, err = 1 - r;
+   while (cx >= cy)
+   {
+      x_pixel(x + cx, y + cy, c);
+      x_pixel(x - cx, y + cy, c);
+      x_pixel(x + cx, y - cy, c);
+      x_pixel(x - cx, y - cy, c);
+      x_pixel(x + cy, y + cx, c);
+      x_pixel(x - cy, y + cx, c);
+      x_pixel(x + cy, y - cx, c);
+      x_pixel(x - cy, y - cx, c);
+      cy++;
+      if (err < 0)
+         err += 2 * cy + 1;
+      else
+         err += 2 * (cy - --cx) + 1;
+   }
+}
+
+void circle_fill(uint16_t x, uint8_t y, int16_t r, uint8_t c)
+{
+   int16_t cx = r, cy = 0, err = 1 - r;
+   while (cx >= cy)
+   {
+      line_h(x - cx, y + cy, 2 * cx + 1, c);
+      line_h(x - cx, y - cy, 2 * cx + 1, c);
+      line_h(x - cy, y + cx, 2 * cy + 1, c);
+      line_h(x - cy, y - cx, 2 * cy + 1, c);
+      cy++;
+      if (err < 0)
+         err += 2 * cy + 1;
+      else
+         err += 2 * (cy - --cx) + 1;
+   }
+}
+
+/** Keys for INKEY$, INPUT, PAUSE and the y/n questions, added to the ones not read yet */
+void bas_host_keys(const char *str)
+{
+   uint16_t len = strlen(keys.str + keys.ptr);
+   memmove(keys.str, keys.str + keys.ptr, len + 1);
+   keys.ptr = 0;
+   strncat(keys.str, str, HOST_KEYS_LEN - len - 1);
+}
+
+/** Break every run after the given count of lines, 0 runs to the end */
+void bas_host_break(uint32_t lines)
+{
+   breakLines = lines;
+   breakCount = 0;
+}
+
+/** Break the running program at the end of its line, the host's Caps Shift + BREAK */
+void bas_host_interrupt(void)
+{
+   breakNow = true;
+}
+
+bool keyboard_getch(char *cc)
+{
+   *cc = keys.str[keys.ptr] ? keys.str[keys.ptr++] : '\r';
+   return true;
+}
+
+bool keyboard_wait(char *str)
+{
+   char cc;
+   if (!keys.str[keys.ptr])
+      return true;
+   keyboard_getch(&cc);
+   return strchr(str, cc) != NULL;
+}
+
+bool keyboard_break(void)
+{
+   if (breakNow)
+   {
+      breakNow = false;
+      return true;
+   }
+   if (breakLines && (++breakCount > breakLines))
+   {
+      breakCount = 0;
+      return true;
+   }
+   return false;
+}
+
+void editline_set(_editline_t *eLine, char *str)
+{
+   strncpy(eLine->str, str, eLine->maxLen - 1);
+   eLine->str[eLine->maxLen - 1] = 0;
+   eLine->curPos = eLine->length = strlen(eLine->str);
+}
+
+/** Typing at the end of the line, Backspace and Enter, the script has no cursor keys */
+_ed_stat_t editline(_editline_t *eLine, char cc)
+{
+   switch (cc)
+   {
+   case '\r':
+   case '\n':
+      return ED_ENTER;
+   case '\b':
+   case 0x7f:
+      if (!eLine->curPos)
+         return ED_IN_PROCESS;
+      eLine->str[--eLine->length] = 0;
+      eLine->curPos = eLine->length;
+      return ED_BACKSPACE;
+   default:
+      if ((cc < ' ') || (eLine->length >= eLine->maxLen - 2))
+         return ED_IN_PROCESS;
+      eLine->str[eLine->length++] = cc;
+      eLine->str[eLine->length] = 0;
+      eLine->curPos = eLine->length;
+      return ED_CHAR;
+   }
+}
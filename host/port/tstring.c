@@ -0,0 +1,99 @@
+/**-----------------------------------------------------------------------------
+ * Copyright (c) 2025 Sergey Sanders
+ * sergey@sesadesign.com
+ * -----------------------------------------------------------------------------
+ * Licensed under Creative Commons Attribution-NonCommercial-ShareAlike 4.0
+ * International (CC BY-NC-SA 4.0).
+ *
+ * You are free to:
+ *  - Share: Copy and redistribute the material.
+ *  - Adapt: Remix, transform, and build upon the material.
+ *
+ * Under the following terms:
+ *  - Attribution: Give appropriate credit and indicate changes.
+ *  - NonCommercial: Do not use for commercial purposes.
+ *  - ShareAlike: Distribute under the same license.
+ *
+ * DISCLAIMER: This work is provided "as is" without any guarantees. The authors
+ * aren’t responsible for any issues, damages, or claims that come up from using
+ * it. Use at your own risk!
+ *
+ * Full license: http://creativecommons.org/licenses/by-nc-sa/4.0/
+ * ---------------------------------------------------------------------------*/
+/**
+ * @file tstring.c
+ * @brief The tstring calls of the BASIC interpreter over the C library formatter
+ */
+#include <stdio.h>
+#include "tstring.h"
+
+#define TSTRING_BUF_LEN 256
+
+static void host_putch(char c)
+{
+   putchar(c);
+}
+
+static _stream_io_t hostStream = {.putch = host_putch, .getch = NULL, .write = NULL};
+_stream_io_t *stdio = &hostStream;
+
+void tformat(_stream_io_t *stream, const char *str, va_list *arg)
+{
+   char buf[TSTRING_BUF_LEN];
+   int len = vsnprintf(buf, sizeof(buf), str, *arg);
+   if (len <= 0)
+      return;
+   if (len >= (int)sizeof(buf))
+      len = sizeof(buf) - 1;
+   if (stream->write)
+      stream->write(buf, len);
+   else
+      for (int i = 0; i < len; i++)
+         stream->putch(buf[i]);
+}
+
+void tprintf(const char *str, ...)
+{
+   va_list arg;
+   va_start(arg, str);
+   tformat(stdio, str, &arg);
+   va_end(arg);
+}
+
+void tfprintf(_stream_io_t *stream, const char *str, ...)
+{
+   va_list arg;
+   va_start(arg, str);
+   tformat(stream, str, &arg);
+   va_end(arg);
+}
+
+int tsprintf(char *dst, const char *str, ...)
+{
+   va_list arg;
+   int len;
+   va_start(arg, str);
+   len = vsprintf(dst, str, arg);
+   va_end(arg);
+   return len;
+}
+
+/// the count of the characters stored, the string is cut to size - 1
+int tsnprintf(char *dst, uint16_t size, const char *str, ...)
+{
+   va_list arg;
+   int len;
+   va_start(arg, str);
+   len = vsnprintf(dst, size, str, arg);
+   va_end(arg);
+   return (len < size) ? len : size - 1;
+}
+
+void tstrncpy(char *dst, char *src, uint16_t size)
+{
+   if (!size)
+      return;
+   while (--size && *src)
+      *dst++ = *src++;
+   *dst = 0;
+}
@@ -0,0 +1,144 @@
+/**-----------------------------------------------------------------------------
+ * Copyright (c) 2025 Sergey Sanders
+ * sergey@sesadesign.com
+ * -----------------------------------------------------------------------------
+ * Licensed under Creative Commons Attribution-NonCommercial-ShareAlike 4.0
+ * International (CC BY-NC-SA 4.0).
+ *
+ * You are free to:
+ *  - Share: Copy and redistribute the material.
+ *  - Adapt: Remix, transform, and build upon the material.
+ *
+ * Under the following terms:
+ *  - Attribution: Give appropriate credit and indicate changes.
+ *  - NonCommercial: Do not use for commercial purposes.
+ *  - ShareAlike: Distribute under the same license.
+ *
+ * DISCLAIMER: This work is provided "as is" without any guarantees. The authors
+ * aren’t responsible for any issues, damages, or claims that come up from using
+ * it. Use at your own risk!
+ *
+ * Full license: http://creativecommons.org/licenses/by-nc-sa/4.0/
+ * ---------------------------------------------------------------------------*/
+/**
+ * @file romtok.c
+ * @brief Regenerates the tokenized ROM tables of basicd/bprog_rom_tok.c
+ *
+ * romtok [file]
+ *
+ * Every ROM program is LOADed from its text, the way test_rom does, and the
+ * lines in memory are written out as the linked _bas_line_t tables, with
+ * ROM_LinesSignature set to the current keyword table. The file keeps what
+ * comes before its #include line, the rest is replaced. Without a file the
+ * tables go to stdout. Run it in host/ after changing a ROM program or the
+ * keywords:
+ *
+ *    <build>/romtok ../basicd/bprog_rom_tok.c
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "basic_host.h"
+#include "bcore.h"
+#include "bfunc.h"
+#include "bprog_rom.h"
+
+#define ROMTOK_INCLUDE "#include \"bprog_rom.h\"\n"
+
+/** The lines of ROM "index" as LOAD tokenizes them from the text */
+static void romtok_load(uint8_t index)
+{
+   char name[4];
+   bas_host_line("new");
+   bas_host_line("1 rem"); // LOAD merges into it from the text, the tables are not used
+   snprintf(name, sizeof(name), "%u", index);
+   bas_host_load(name);
+   bas_host_line("1");
+}
+
+static void romtok_string(FILE *out, const uint8_t *str)
+{
+   fputc('"', out);
+   for (; *str; str++)
+      if ((*str >= 0x80) || (*str < ' '))
+         fprintf(out, "\\%03o", *str);
+      else if ((*str == '"') || (*str == '\\'))
+         fprintf(out, "\\%c", *str);
+      else
+         fputc(*str, out);
+   fputc('"', out);
+}
+
+static void romtok_emit(FILE *out, const char *name)
+{
+   const _bas_line_t *line;
+   fprintf(out, "\n/// %s\nstatic const _bas_line_t", name);
+   for (line = BasicProg->next; line; line = line->next)
+      fprintf(out, "%s %s_%u", (line == BasicProg->next) ? "" : ",", name, line->number);
+   fprintf(out, ";\n");
+   for (line = BasicProg; line; line = line->next)
+   {
+      if (line == BasicProg)
+         fprintf(out, "const _bas_line_t ROM_%s_lines = {%u, %u, ", name, line->number, line->len);
+      else
+         fprintf(out, "static const _bas_line_t %s_%u = {%u, %u, ", name, line->number, line->number, line->len);
+      if (line->next)
+         fprintf(out, "(void *)&%s_%u, ", name, ((const _bas_line_t *)line->next)->number);
+      else
+         fprintf(out, "NULL, ");
+      fprintf(out, "%u, {", line->stmtCount);
+      for (uint8_t i = 0; i < BASIC_STMT_INDEX; i++)
+         fprintf(out, "%s%u", i ? ", " : "", (i < line->stmtCount) ? line->stmtOffset[i] : 0);
+      fprintf(out, "}, ");
+      romtok_string(out, line->string);
+      fprintf(out, "};\n");
+   }
+}
+
+int main(int argc, char **argv)
+{
+   static const _bas_rom_t *rom[3] = {&ROM_bounce, &ROM_ctree, &ROM_snake};
+   FILE *devNull = fopen("/dev/null", "w"), *out = stdout;
+   char *head = NULL;
+
+   if (argc > 1) // keep the comment of the file
+   {
+      FILE *in = fopen(argv[1], "r");
+      long size;
+      char *end;
+      if (!in)
+      {
+         perror(argv[1]);
+         return 1;
+      }
+      fseek(in, 0, SEEK_END);
+      size = ftell(in);
+      rewind(in);
+      head = calloc(1, size + 1);
+      if (fread(head, 1, size, in) != (size_t)size || !(end = strstr(head, ROMTOK_INCLUDE)))
+      {
+         fprintf(stderr, "%s: no %s", argv[1], ROMTOK_INCLUDE);
+         return 1;
+      }
+      end[strlen(ROMTOK_INCLUDE)] = '\0';
+      fclose(in);
+   }
+   bas_host_output(devNull);
+   bas_host_init();
+   if (head && !(out = fopen(argv[1], "w")))
+   {
+      perror(argv[1]);
+      return 1;
+   }
+   fputs(head ? head : ROMTOK_INCLUDE, out);
+   fprintf(out, "\nconst uint32_t ROM_LinesSignature = 0x%08x;\n", bas_func_signature());
+   for (uint8_t index = 0; index < 3; index++)
+   {
+      romtok_load(index);
+      romtok_emit(out, rom[index]->name);
+   }
+   if (out != stdout)
+      fclose(out);
+   free(head);
+   return 0;
+}
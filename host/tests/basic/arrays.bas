@@ -0,0 +1,26 @@
+10 rem arrays of 1 to 4 dimensions and every element type, their bounds, and string cells
+20 dim a[5]: dim b.i[3,4]: dim c.w[2,3,4]: dim d.b[2,2,2,3]: dim s$[3,6]
+30 for i=0 to 4: a[i]=i/2: next i: print a[0];" ";a[4]
+40 for i=0 to 2: for j=0 to 3: b.i[i,j]=i*10+j: next j: next i
+50 print b.i[0,0];" ";b.i[1,2];" ";b.i[2,3]
+60 for i=0 to 1: for j=0 to 2: for k=0 to 3: c.w[i,j,k]=i*100+j*10+k: next k
+70 next j: next i: print c.w[0,1,2];" ";c.w[1,2,3];" ";c.w[1,0,0]
+80 d.b[1,1,1,2]=300: d.b[0,1,0,1]=7
+85 print d.b[1,1,1,2];" ";d.b[0,1,0,1];" ";d.b[0,0,0,0]
+90 c.w[0,0,0]=-1: print c.w[0,0,0];" ";c.w[0,0,1]
+100 s$[0]="abcdefghij": s$[2]="x": print s$[0];" ";s$[2];" [";s$[1];"]"
+run
+print b.i[2,4]
+print a[-1]
+print c.w[2,0,0]
+print c.w[1,3,0]
+print d.b[0,0,0]
+print b.i[1]
+dim e[2,2,2,2,2]
+print a[5]
+dim a[3]
+dim z[0]
+dim y[70000]
+print a[4.9];" ";b.i[2.5,3]
+dim q.i[30000]
+for q.i=1 to 2: print q.i;: next q.i
@@ -0,0 +1,13 @@
+10 rem 1000 floats: fill, sum and sort as builtins (run) against FOR loops and an insertion sort (run 100)
+20 clear: dim a[1000]: fill(a,1.5): s=sum(a)
+30 for i.i=0 to 999: a[i.i]=i.i*37 % 1000: next i.i
+40 sort(a): print s;" ";a[0];" ";a[999]: stop
+100 clear: dim a[1000]: for i.i=0 to 999: a[i.i]=1.5: next i.i
+110 s=0: for i.i=0 to 999: s=s+a[i.i]: next i.i
+120 for i.i=0 to 999: a[i.i]=i.i*37 % 1000: next i.i
+130 for i.i=1 to 999: v=a[i.i]: j.i=i.i-1
+140 while j.i>=0 and a[j.i]>v: a[j.i+1]=a[j.i]: j.i=j.i-1: wend
+150 a[j.i+1]=v: next i.i
+160 print s;" ";a[0];" ";a[999]: stop
+run
+run 100
@@ -0,0 +1,11 @@
+10 rem 10000 calls of a compiled DEF FN (run), of a nested one (run 100) and the same sum inline (run 200)
+20 s.i=0: for i.i=1 to 10000: s.i=s.i+f.i(i.i,3): next i.i
+30 print s.i: stop
+100 s.i=0: for i.i=1 to 10000: s.i=s.i+f.i(f.i(i.i,3),2)-2: next i.i
+110 print s.i: stop
+200 s.i=0: for i.i=1 to 10000: s.i=s.i+i.i*3+3-i.i: next i.i
+210 print s.i: stop
+def f.i(a.i,b.i)=a.i*b.i+b.i-a.i
+run
+run 100
+run 200
@@ -0,0 +1,9 @@
+10 rem guarded scans of 1000 elements, 20 times: the right operand decides in 1 of 10
+20 clear: dim a[1000]: for i.i=0 to 999 step 10: a[i.i]=i.i: next i.i
+30 c.i=0: for r.i=1 to 20
+40 for i.i=0 to 999: if i.i<100 and a[i.i]>0 then c.i=c.i+1
+50 next i.i
+60 for i.i=0 to 999: if a[i.i]=0 or sqr(a[i.i])>20 then c.i=c.i+1
+70 next i.i: next r.i
+80 print c.i
+run
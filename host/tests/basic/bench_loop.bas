@@ -0,0 +1,18 @@
+x=0: for i=1 to 100000: x=x+1: next i: print x
+x=0: a=0: b=0: c=0: for i=1 to 100000: a=a+1: b=b+2: c=c+3: x=x+1: next i: print x
+10 x=0
+20 for i=1 to 100000
+30 x=x+1
+40 next i
+50 print x
+run
+new
+10 x=0: a=0: b=0: c=0
+20 for i=1 to 100000
+30 a=a+1
+40 b=b+2
+50 c=c+3
+60 x=x+1
+70 next i
+80 print x
+run
@@ -0,0 +1,16 @@
+10 rem 20x20 matrix product by MAT (run) and by BASIC loops (run 100), and 1000 dot products of 400 elements (run 200)
+20 clear: dim a[20,20]: dim b[20,20]: dim c[20,20]
+30 for i.i=0 to 19: for j.i=0 to 19: a[i.i,j.i]=i.i+j.i: b[i.i,j.i]=i.i*j.i+1: next j.i: next i.i
+40 mat c=a*b
+50 t=0: for i.i=0 to 19: t=t+c[i.i,i.i]: next i.i: print t: stop
+100 clear: dim a[20,20]: dim b[20,20]: dim c[20,20]
+110 for i.i=0 to 19: for j.i=0 to 19: a[i.i,j.i]=i.i+j.i: b[i.i,j.i]=i.i*j.i+1: next j.i: next i.i
+120 for i.i=0 to 19: for j.i=0 to 19: s=0
+130 for k.i=0 to 19: s=s+a[i.i,k.i]*b[k.i,j.i]: next k.i
+140 c[i.i,j.i]=s: next j.i: next i.i
+150 t=0: for i.i=0 to 19: t=t+c[i.i,i.i]: next i.i: print t: stop
+200 clear: dim p[400]: fill(p,0.5): t=0
+210 for i.i=1 to 1000: t=t+dot(p,p): next i.i: print t: stop
+run
+run 100
+run 200
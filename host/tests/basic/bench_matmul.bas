@@ -0,0 +1,16 @@
+10 rem 20x20 matrix product with 2-D arrays (run) and with 1-D arrays indexed by hand (run 200)
+20 clear: dim a[20,20]: dim b[20,20]: dim c[20,20]
+30 for i.i=0 to 19: for j.i=0 to 19: a[i.i,j.i]=i.i+j.i: b[i.i,j.i]=i.i*j.i+1: next j.i: next i.i
+40 for i.i=0 to 19: for j.i=0 to 19: s=0
+50 for k.i=0 to 19: s=s+a[i.i,k.i]*b[k.i,j.i]: next k.i
+60 c[i.i,j.i]=s: next j.i: next i.i
+70 t=0: for i.i=0 to 19: t=t+c[i.i,i.i]: next i.i: print t: stop
+200 clear: dim p[400]: dim q[400]: dim r[400]
+210 for i.i=0 to 399: r.i=(i.i-i.i%20)/20: c.i=i.i%20
+215 p[i.i]=r.i+c.i: q[i.i]=r.i*c.i+1: next i.i
+220 for i.i=0 to 19: for j.i=0 to 19: s=0
+230 for k.i=0 to 19: s=s+p[i.i*20+k.i]*q[k.i*20+j.i]: next k.i
+240 r[i.i*20+j.i]=s: next j.i: next i.i
+250 t=0: for i.i=0 to 19: t=t+r[i.i*21]: next i.i: print t: stop
+run
+run 200
@@ -0,0 +1,56 @@
+10 rem NEXT without the loop records walks the variables and the lines, a program of some size pays for both
+20 a=1: b=2: c=3: d=4
+30 e=5: f=6: g=7: h=8
+40 k=9: l=10: m=11: n=12
+50 o=13: p=14: q=15: r=16
+60 rem
+70 rem
+80 rem
+90 rem
+100 rem
+110 rem
+120 rem
+130 rem
+140 rem
+150 rem
+160 rem
+170 rem
+180 rem
+190 rem
+200 rem
+210 rem
+220 rem
+230 rem
+240 rem
+250 rem
+260 rem
+270 rem
+280 rem
+290 rem
+300 rem
+310 rem
+320 rem
+330 rem
+340 rem
+350 rem
+360 rem
+370 rem
+380 rem
+390 rem
+400 x=0
+410 for i=1 to 100
+420 for j=1 to 100
+430 x=x+1
+440 next j
+450 next i
+460 print x
+470 stop
+500 x.i=0
+510 for i.i=1 to 100
+520 for j.i=1 to 100
+530 x.i=x.i+1
+540 next j.i
+550 next i.i
+560 print x.i
+run
+run 500
@@ -0,0 +1,32 @@
+10 rem an 8 way state machine, 4000 steps through ON GOTO (run) and through an IF chain (run 50)
+20 s.i=1: c.i=0: for n.i=1 to 4000
+30 on s.i goto 110,120,130,140,150,160,170,180
+40 next n.i: print c.i: stop
+50 s.i=1: c.i=0: for n.i=1 to 4000
+60 if s.i=1 then goto 210
+61 if s.i=2 then goto 220
+62 if s.i=3 then goto 230
+63 if s.i=4 then goto 240
+64 if s.i=5 then goto 250
+65 if s.i=6 then goto 260
+66 if s.i=7 then goto 270
+67 if s.i=8 then goto 280
+70 next n.i: print c.i: stop
+110 c.i=c.i+1: s.i=8: goto 40
+120 c.i=c.i+2: s.i=1: goto 40
+130 c.i=c.i+3: s.i=2: goto 40
+140 c.i=c.i+4: s.i=3: goto 40
+150 c.i=c.i+5: s.i=4: goto 40
+160 c.i=c.i+6: s.i=5: goto 40
+170 c.i=c.i+7: s.i=6: goto 40
+180 c.i=c.i+8: s.i=7: goto 40
+210 c.i=c.i+1: s.i=8: goto 70
+220 c.i=c.i+2: s.i=1: goto 70
+230 c.i=c.i+3: s.i=2: goto 70
+240 c.i=c.i+4: s.i=3: goto 70
+250 c.i=c.i+5: s.i=4: goto 70
+260 c.i=c.i+6: s.i=5: goto 70
+270 c.i=c.i+7: s.i=6: goto 70
+280 c.i=c.i+8: s.i=7: goto 70
+run
+run 50
@@ -0,0 +1,11 @@
+10 rem split a comma separated record into fields 500 times and add up the field lengths
+20 r$="alpha,beta,gamma,delta,epsilon,zeta,eta,theta,iota,kappa,lambda,mu"
+30 t.i=0: f.i=0
+40 for n.i=1 to 500: s$=r$
+50 p.i=instr(s$,",")
+60 if p.i=0 then t.i=t.i+len(s$): f.i=f.i+1: goto 90
+70 t.i=t.i+len(left$(s$,p.i-1)): f.i=f.i+1
+80 s$=mid$(s$,p.i+1,-1): goto 50
+90 next n.i
+100 print f.i;" fields, ";t.i;" characters"
+run
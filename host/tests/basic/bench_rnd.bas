@@ -0,0 +1,7 @@
+10 rem 10000 draws of rnd(100) (run) and rnd(0) (run 100) after randomize 1, and the same loop calling ABS (run 200)
+20 randomize 1: s.i=0: for i.i=1 to 10000: s.i=s.i+rnd(100): next i.i: print s.i: stop
+100 randomize 1: s=0: for i.i=1 to 10000: s=s+rnd(0): next i.i: print int(s): stop
+200 s.i=0: for i.i=1 to 10000: s.i=s.i+abs(50): next i.i: print s.i: stop
+run
+run 100
+run 200
@@ -0,0 +1,12 @@
+a$="": for i=1 to 2000: a$=a$+"x": next i: print len(a$)
+b$="": for i=1 to 200: b$=b$+hex$(i)+",": next i: print len(b$)
+10 rem bubble sort of 200 strings, then a check of the order
+20 dim s$[200,8]
+30 for i=0 to 199: s$[i]=hex$(int(rnd(65536))): next i
+40 for i=0 to 198: for j=0 to 198-i
+50 if s$[j]>s$[j+1] then t$=s$[j]: s$[j]=s$[j+1]: s$[j+1]=t$
+60 next j: next i
+70 ok=1: for i=0 to 198: if s$[i]>s$[i+1] then ok=0
+80 next i: print "sorted: ";ok
+randomize 1
+run
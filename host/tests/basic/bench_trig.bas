@@ -0,0 +1,9 @@
+10 rem a rose and a spiral of 3000 points each drawn with sin/cos, atn and sqr, as the graphics programs do
+20 cls: x0=160: y0=120: plot(x0+100,y0)
+30 for i.i=1 to 3000: a=i.i*0.00628318: r=100*cos(4*a)
+40 draw(x0+r*cos(a),y0+r*sin(a)): next i.i
+50 plot(x0,y0): t=0
+60 for i.i=1 to 3000: x=i.i*0.03*cos(i.i*0.01): y=i.i*0.03*sin(i.i*0.01)
+70 draw(x0+x,y0+y): t=t+atn(y/(abs(x)+1))+sqr(x*x+y*y): next i.i
+80 print int(t): stop
+run
@@ -0,0 +1,80 @@
+10 rem 10000 trips of WHILE (run 1000), REPEAT (run 1100), IF GOTO (run 1200) and FOR (run 1300)
+20 rem the loops sit behind 60 lines, as in a program of some size, GOTO searches past them
+30 rem line 30
+40 rem line 40
+50 rem line 50
+60 rem line 60
+70 rem line 70
+80 rem line 80
+90 rem line 90
+100 rem line 100
+110 rem line 110
+120 rem line 120
+130 rem line 130
+140 rem line 140
+150 rem line 150
+160 rem line 160
+170 rem line 170
+180 rem line 180
+190 rem line 190
+200 rem line 200
+210 rem line 210
+220 rem line 220
+230 rem line 230
+240 rem line 240
+250 rem line 250
+260 rem line 260
+270 rem line 270
+280 rem line 280
+290 rem line 290
+300 rem line 300
+310 rem line 310
+320 rem line 320
+330 rem line 330
+340 rem line 340
+350 rem line 350
+360 rem line 360
+370 rem line 370
+380 rem line 380
+390 rem line 390
+400 rem line 400
+410 rem line 410
+420 rem line 420
+430 rem line 430
+440 rem line 440
+450 rem line 450
+460 rem line 460
+470 rem line 470
+480 rem line 480
+490 rem line 490
+500 rem line 500
+510 rem line 510
+520 rem line 520
+530 rem line 530
+540 rem line 540
+550 rem line 550
+560 rem line 560
+570 rem line 570
+580 rem line 580
+590 rem line 590
+600 rem line 600
+610 rem line 610
+620 rem line 620
+1000 i.i=0: s.i=0
+1010 while i.i<10000: s.i=s.i+i.i: i.i=i.i+1: wend
+1020 print s.i: stop
+1100 i.i=0: s.i=0
+1110 repeat: s.i=s.i+i.i: i.i=i.i+1: until i.i>=10000
+1120 print s.i: stop
+1200 i.i=0: s.i=0
+1210 if i.i>=10000 then goto 1240
+1220 s.i=s.i+i.i: i.i=i.i+1
+1230 goto 1210
+1240 print s.i: stop
+1300 s.i=0
+1310 for i.i=0 to 9999: s.i=s.i+i.i: next i.i
+1320 print s.i: stop
+run 1000
+run 1100
+run 1200
+run 1300
@@ -0,0 +1,16 @@
+10 rem fill, copy, sum, min, max, imin, imax, sort and search on every numeric element type
+20 dim f[6]: dim n.i[2,3]: dim w.w[6]: dim b.b[6]: dim g[4]
+30 f[0]=3.5: f[1]=-2: f[2]=7: f[3]=0: f[4]=7: f[5]=-2.5
+40 print sum(f);" ";min(f);" ";max(f);" ";imin(f);" ";imax(f)
+50 sort(f): print f[0];" ";f[1];" ";f[5];" ";search(f,7);" ";search(f,1)
+60 copy(n.i,f): print n.i[0,0];" ";n.i[1,2];" ";sum(n.i)
+70 fill(w.w,70000): print w.w[0];" ";w.w[5];" ";sum(w.w)
+80 fill(b.b,-1): print b.b[3];" ";imax(b.b)
+90 copy(g,f): print g[0];" ";g[3];" ";sum(g)
+100 copy(f,g): print f[4];" ";f[5]
+110 b.b[2]=9: b.b[4]=1: sort(b.b): print b.b[0];" ";b.b[5];" ";search(b.b,9)
+120 print min(3,4);" ";max(3,4)
+run
+print sum(q)
+print sort(3)
+print search(f)
@@ -0,0 +1,14 @@
+10 rem DEF FN: arguments by slot, more than 4 of them, nesting, strings, globals left alone
+20 x=100: def sq(x)=x*x
+30 print sq(3);" ";x;" ";sq(sq(2));" ";2*sq(3)+1
+40 def f6(a,b,c,d,e,f)=a+2*b+3*c+4*d+5*e+6*f
+50 print f6(1,1,1,1,1,1);" ";f6(1,0,0,0,0,0);" ";f6(0,0,0,0,0,1)
+60 def g(x,y)=sq(x)+sq(y)
+70 print g(3,4);" ";g(g(1,1),1);" ";x
+80 def w$(s$)=s$+"-"+s$
+90 print w$("ab");" ";w$(w$("c"));" ";len(w$("xyz"))
+100 def k.i(n.i)=n.i*n.i%7
+110 for i.i=1 to 6: print k.i(i.i);" ";: next i.i: print
+120 def sq(y)=y
+run
+print sq(5)
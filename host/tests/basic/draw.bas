@@ -0,0 +1,6 @@
+10 rem lines out of the centre in every octant, a stepping error used to loop forever past 45 degrees
+20 cls: for a.i=0 to 359 step 15: r=100
+30 plot(160,120): draw(160+r*cos(rad(a.i)),120+r*sin(rad(a.i))): next a.i
+40 plot(0,0): draw(319,1): draw(2,239): draw(319,238): draw(0,0)
+50 print "drawn"
+run
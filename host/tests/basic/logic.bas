@@ -0,0 +1,17 @@
+10 rem AND, OR and NOT truth tables, guards whose right operand would fail, bitwise operators
+20 for a.i=0 to 1: for b.i=0 to 1
+30 print a.i;b.i;" ";a.i and b.i;" ";a.i or b.i;" ";not a.i
+40 next b.i: next a.i
+50 x=0.5: y=0: print x and y;" ";x or y;" ";y or x;" ";not x;" ";x and not y
+60 print 0 or 0 and 1;" ";1 or 0 and 0;" ";(1 or 0) and 0;" ";not 0 and 0
+70 dim a[10]: dim m[3,3]: a[9]=4: m[2,2]=7
+80 for i=8 to 11: if i<10 and a[i]>0 then print "a[";i;"] ";a[i]
+90 next i
+100 i=10: if i>=10 or a[i]>0 then print "guarded or"
+110 j=3: if j<3 and m[j,j]>0 then print "no"
+120 j=2: if j<3 and m[j,j]>0 then print "m ";m[j,j]
+130 if (j>5 and a[j*9]=1) or j=2 then print "brackets"
+140 def g(p,q)=p and q or not p
+150 print g(0,0);" ";g(1,0);" ";g(1,1);" ";g(0,1)
+160 print 6 & 3;" ";6 | 3;" ";6 ^ 3;" ";1 << 4;" ";~0 & 255
+run
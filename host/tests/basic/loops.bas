@@ -0,0 +1,20 @@
+10 rem WHILE/WEND and REPEAT/UNTIL: zero trips, nesting, mid-line loops, early exits
+20 i=0: while i<3: print "w";i;: i=i+1: wend: print
+30 i=5: while i<3: print "never": wend: print "skipped"
+40 i=0: repeat: print "r";i;: i=i+1: until i>=3: print
+50 i=9: repeat: print "once";: until 1: print
+60 a=0: while a<2
+70 b=0: repeat
+80 print a;b;" ";: b=b+1
+90 until b=2
+100 a=a+1: wend: print
+110 n=0: while 1: n=n+1: if n=4 then goto 130
+120 wend
+130 print "left at ";n
+140 k=0: for j=1 to 3: while k<j: k=k+1: wend: next j: print k
+run
+clear
+wend
+until 1
+i=0: while i<2: i=i+1: wend: print i
+i=0: repeat: i=i+2: until i>5: print i
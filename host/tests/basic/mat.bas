@@ -0,0 +1,41 @@
+10 rem MAT results against the same sums in BASIC loops, e is the largest difference
+20 dim a[3,3]: dim b[3,3]: dim c[3,3]: dim r[3,3]: dim v[3]: dim w[3]
+30 for i.i=0 to 2: for j.i=0 to 2: a[i.i,j.i]=i.i*3+j.i+1: b[i.i,j.i]=j.i-i.i*0.5: next j.i
+35 a[i.i,i.i]=a[i.i,i.i]+5: v[i.i]=i.i+1: next i.i
+40 mat c=a+b
+45 for i.i=0 to 2: for j.i=0 to 2: r[i.i,j.i]=a[i.i,j.i]+b[i.i,j.i]: next j.i: next i.i
+48 gosub 900: print "add ";e
+50 mat c=a-b
+55 for i.i=0 to 2: for j.i=0 to 2: r[i.i,j.i]=a[i.i,j.i]-b[i.i,j.i]: next j.i: next i.i
+58 gosub 900: print "sub ";e
+60 mat c=a*b
+65 for i.i=0 to 2: for j.i=0 to 2: s=0: for k.i=0 to 2: s=s+a[i.i,k.i]*b[k.i,j.i]: next k.i
+66 r[i.i,j.i]=s: next j.i: next i.i
+68 gosub 900: print "mul ";e
+70 mat c=a*2.5
+75 for i.i=0 to 2: for j.i=0 to 2: r[i.i,j.i]=a[i.i,j.i]*2.5: next j.i: next i.i
+78 gosub 900: print "scale ";e
+80 mat c=(1+1)*a: print "(k) ";c[1,2];" ";c[2,2]
+90 mat c=trn(a)
+95 for i.i=0 to 2: for j.i=0 to 2: r[i.i,j.i]=a[j.i,i.i]: next j.i: next i.i
+98 gosub 900: print "trn ";e
+100 mat c=inv(a): mat c=a*c
+105 for i.i=0 to 2: for j.i=0 to 2: r[i.i,j.i]=(i.i=j.i): next j.i: next i.i
+108 gosub 900: print "inv ";e<1e-5
+110 mat w=a*v: print "vector ";w[0];" ";w[1];" ";w[2]
+120 print "dot ";dot(v,v);" ";dot(w,v)-(w[0]+2*w[1]+3*w[2])
+130 mat c=a: mat c=c*c: mat r=a*a: gosub 900: print "in place ";e
+140 mat c=trn(c): print "trn in place ";c[0,2];" ";r[2,0]
+150 stop
+900 e=0: for i.i=0 to 2: for j.i=0 to 2: e=max(e,abs(c[i.i,j.i]-r[i.i,j.i])): next j.i: next i.i
+910 return
+run
+dim z[2,2]: dim n.i[3,3]: dim t[2,3]
+mat z=inv(z)
+mat n.i=a
+mat c=a+t
+mat c=a*t
+mat t=a
+mat c=foo(a)
+mat c=q
+mat c=a b
@@ -0,0 +1,20 @@
+10 rem ON GOTO and ON GOSUB: in range, out of range falls through, float and loop selectors
+20 for k=0 to 4
+30 on k goto 100,200,300
+40 print "fall ";k
+50 next k
+60 for k.i=-1 to 3: on k.i gosub 500,600: next k.i
+70 x=2.7: on x gosub 500,600: print "back"
+80 on 1 goto 9999
+90 stop
+100 print "one": goto 50
+200 print "two": goto 50
+300 print "three": goto 50
+500 print "s1 ";: return
+600 print "s2 ";: return
+run
+on 1 goto 100,
+on 3 gosub 500
+print "after"
+on 1 print 100
+on "a" goto 100
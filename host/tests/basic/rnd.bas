@@ -0,0 +1,22 @@
+10 rem RANDOMIZE n repeats the RND sequence, another seed gives another one, and the ranges hold
+20 dim a.i[20]
+30 randomize 7: for i.i=0 to 19: a.i[i.i]=rnd(1000): next i.i
+40 randomize 7: gosub 200: print "repeated ";d.i
+50 randomize 8: gosub 200: print "other seed ";d.i>10
+60 randomize 7: print rnd(1000);" ";rnd(1000);" ";rnd(1000);" ";a.i[0];" ";a.i[1];" ";a.i[2]
+70 randomize 3: lo=9: hi=-1: for i.i=1 to 10000: r=rnd(6): lo=min(lo,r): hi=max(hi,r): next i.i
+75 print "rnd(6) ";lo;" ";hi
+80 lo=1: hi=0: s=0: for i.i=1 to 10000: r=rnd(0): lo=min(lo,r): hi=max(hi,r): s=s+r: next i.i
+85 print "rnd(0) ";lo>=0;" ";hi<1;" ";abs(s/10000-0.5)<0.02
+90 randomize 2.9: x=rnd(1000): randomize 2: print "fraction dropped ";x=rnd(1000)
+100 randomize: x=rnd(1000): print "trng ";x>=0 and x<1000
+110 randomize -5: x=rnd(1000): randomize -5: print "negative ";x=rnd(1000)
+120 stop
+200 rem d.i counts the draws that differ from a.i[]
+210 d.i=0: for i.i=0 to 19
+220 if a.i[i.i] <> rnd(1000) then d.i=d.i+1
+230 next i.i: return
+run
+print rnd()
+print rnd("a")
+randomize "a"
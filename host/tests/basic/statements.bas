@@ -0,0 +1,19 @@
+10 rem loops, subroutines and branches resuming in the middle of a line
+20 for i=1 to 3: print i;: gosub 200: print "b";: next i: print
+30 for i=1 to 2: for j=1 to 3: print i*10+j;" ";: next j: next i: print
+40 for i=1 to 2: print "a:b";": ";: print "c";: next i: print
+50 k=0: for i=1 to 5: if i>2 then k=k+i
+60 next i: print k
+70 for i=1 to 3: gosub 300: next i: print
+80 x=0: for i=1 to 4: for j=1 to i: x=x+1: next j: next i: print x
+90 for i=5 to 1 step -2: print i;: next i: print
+100 for i=1 to 2: s=0: for j=1 to 10: s=s+j: next j: print s;" ";: next i: print
+110 goto 130: print "skipped"
+120 print "not reached"
+130 print "done"
+140 stop
+200 print "s";: return
+300 print "[";: for j=1 to i: print "*";: next j: print "]";: return
+run
+x=0: for i=1 to 1000: x=x+i: next i: print x
+for i=1 to 3: gosub 200: next i: print
@@ -0,0 +1,12 @@
+10 rem string growth past the scratch buffers, relations and a sort
+20 a$="": for i.i=0 to 299: a$=a$+mid$("abcdefghijklmnopqrstuvwxyz",i.i%26+1,1): next i.i
+30 print len(a$);" ";left$(a$,5);" ";right$(a$,5)
+40 print "abc"<"abd";" ";"b">"abc";" ";"a"="a";" ";"a"<>"a";" ";"ab"<="ab";" ";"b">="c";" ";""<"a"
+50 dim w$[6,8]
+60 w$[0]="pear": w$[1]="apple": w$[2]="fig": w$[3]="banana": w$[4]="apple": w$[5]="cherry"
+70 for i=0 to 4: for j=0 to 4-i
+80 if w$[j]>w$[j+1] then t$=w$[j]: w$[j]=w$[j+1]: w$[j+1]=t$
+90 next j: next i
+100 for i=0 to 5: print w$[i];" ";: next i: print
+110 b$=a$: a$="": print len(b$);" ";len(a$)
+run
@@ -0,0 +1,19 @@
+10 rem substring functions at and past the edges of the string
+20 a$="hello": e$=""
+30 print "[";left$(a$,0);"|";left$(a$,-1);"|";left$(a$,3);"]"
+31 print "[";left$(a$,5);"|";left$(a$,99);"|";left$(a$,1e10);"]"
+40 print "[";right$(a$,0);"|";right$(a$,-1);"|";right$(a$,3);"]"
+41 print "[";right$(a$,5);"|";right$(a$,99);"|";right$(a$,-1e10);"]"
+50 print "[";mid$(a$,0,2);"|";mid$(a$,-5,2);"|";mid$(a$,2,3);"]"
+51 print "[";mid$(a$,5,1);"|";mid$(a$,6,1);"|";mid$(a$,99,1);"]"
+52 print "[";mid$(a$,2,0);"|";mid$(a$,2,-1);"|";mid$(a$,2,99);"]"
+53 print "[";mid$(a$,1,5);"|";mid$(a$,1e10,1);"|";mid$(a$,2,1e10);"]"
+60 print "[";left$(e$,1);"|";right$(e$,1);"|";mid$(e$,1,1);"]"
+70 print len(a$);" ";len(e$);" ";len(left$(a$,2));" ";len(mid$(a$,3,99))
+80 print instr(a$,"l");" ";instr(a$,"lo");" ";instr(a$,"x");" ";instr(a$,"hello!")
+81 print instr(a$,"");" ";instr(e$,"a");" ";instr(e$,"");" ";instr(mid$(a$,2,99),"l")
+90 b$=mid$(a$,2,3): c$=right$(a$,2): a$="world"
+91 print b$;" ";c$;" ";a$;" ";left$(b$+c$,4)
+100 d$="": for i=1 to 40: d$=d$+right$(a$,1)+left$(a$,1): next i
+110 print len(d$);" ";mid$(d$,79,2);" ";instr(d$,"wdw")
+run
@@ -0,0 +1,24 @@
+# Run basrun and check the terminal output.
+#   ARGS    - basrun options and arguments, ';' separated
+#   SCRIPT  - lines typed at the prompt, read from stdin
+#   GOLDEN  - the output must match this file, without it the run is a benchmark and
+#             the timings of -t are printed
+#   WORKDIR - LOAD and SAVE files go here
+if(SCRIPT)
+  set(input INPUT_FILE ${SCRIPT})
+endif()
+execute_process(COMMAND ${BASRUN} ${ARGS} ${input} WORKING_DIRECTORY ${WORKDIR}
+                OUTPUT_VARIABLE out ERROR_VARIABLE err RESULT_VARIABLE rc)
+if(rc)
+  message(FATAL_ERROR "basrun failed: ${rc}\n${err}")
+endif()
+if(NOT GOLDEN)
+  message(STATUS "${out}${err}")
+  return()
+endif()
+file(READ ${GOLDEN} golden)
+if(NOT out STREQUAL golden)
+  get_filename_component(name ${GOLDEN} NAME)
+  file(WRITE ${WORKDIR}/${name} "${out}")
+  message(FATAL_ERROR "output differs from ${GOLDEN}, see ${WORKDIR}/${name}")
+endif()
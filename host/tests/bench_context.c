@@ -0,0 +1,81 @@
+/**-----------------------------------------------------------------------------
+ * Copyright (c) 2025 Sergey Sanders
+ * sergey@sesadesign.com
+ * -----------------------------------------------------------------------------
+ * Licensed under Creative Commons Attribution-NonCommercial-ShareAlike 4.0
+ * International (CC BY-NC-SA 4.0).
+ *
+ * You are free to:
+ *  - Share: Copy and redistribute the material.
+ *  - Adapt: Remix, transform, and build upon the material.
+ *
+ * Under the following terms:
+ *  - Attribution: Give appropriate credit and indicate changes.
+ *  - NonCommercial: Do not use for commercial purposes.
+ *  - ShareAlike: Distribute under the same license.
+ *
+ * DISCLAIMER: This work is provided "as is" without any guarantees. The authors
+ * aren’t responsible for any issues, damages, or claims that come up from using
+ * it. Use at your own risk!
+ *
+ * Full license: http://creativecommons.org/licenses/by-nc-sa/4.0/
+ * ---------------------------------------------------------------------------*/
+/**
+ * @file bench_context.c
+ * @brief Z80 core speed with the machine passed as a context against the fixed address globals
+ *
+ * Built twice: bench_context links the core as the firmware builds it, bench_static links
+ * it with Z80_STATIC_CONTEXT where z80_step works on z80ctx at a fixed address, bench_lazy
+ * with Z80_LAZY_FLAGS.
+ * usage: bench_context rom snapshot [frames]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include "bsp.h"
+#include "host.h"
+#include "zx80sys.h"
+
+#if defined(Z80_LAZY_FLAGS)
+#define BENCH_ACCESS "context, lazy flags"
+#elif defined(Z80_STATIC_CONTEXT)
+#define BENCH_ACCESS "globals"
+#else
+#define BENCH_ACCESS "context"
+#endif
+
+int main(int argc, char **argv)
+{
+   uint32_t frames = argc > 3 ? strtoul(argv[3], NULL, 0) : 500;
+   uint64_t instructions = 0;
+   Z80_CONTEXT *ctx = zx_host_new();
+#ifdef Z80_STATIC_CONTEXT
+   Z80_CONTEXT *hostCtx = ctx;
+   z80ctx.mem = hostCtx->mem;
+   z80ctx.machine = hostCtx->machine;
+   Z80Reset(&z80ctx);
+   ctx = &z80ctx;
+#endif
+   if (argc < 3 || host_load(argv[1], ctx->mem, ROM_SIZE) != ROM_SIZE || !zx_host_snapshot(ctx, argv[2]))
+   {
+      fprintf(stderr, "usage: %s rom snapshot [frames]\n", argv[0]);
+      return 2;
+   }
+   uint64_t start = host_time_us();
+   for (uint32_t frame = 0; frame < frames; frame++)
+   {
+      while (ULA_FRAME_T(ctx) < ULA_FRAME_TSTATES)
+      {
+         z80_step(ctx);
+         instructions++;
+      }
+      zx_frame(ctx);
+   }
+   uint64_t time = host_time_us() - start;
+   printf("%s: %u frames, %llu instructions in %.1f ms, %.2f Minstr/s\n", BENCH_ACCESS, frames,
+          (unsigned long long)instructions, time / 1000.0, time ? (double)instructions / time : 0.0);
+#ifdef Z80_STATIC_CONTEXT
+   ctx = hostCtx;
+#endif
+   zx_host_free(ctx);
+   return 0;
+}
@@ -0,0 +1,21 @@
+# Run the eager and the lazy flags cores on the same random streams, the checkpoint hashes must match.
+#   EAGER, LAZY - the two test_flags builds
+foreach(core EAGER LAZY)
+  execute_process(COMMAND ${${core}} OUTPUT_VARIABLE ${core}_out ERROR_VARIABLE speed RESULT_VARIABLE rc)
+  if(rc)
+    message(FATAL_ERROR "${${core}} failed: ${rc}")
+  endif()
+  message(STATUS "${speed}")
+endforeach()
+if(NOT EAGER_out STREQUAL LAZY_out)
+  string(REPLACE "\n" ";" eager "${EAGER_out}")
+  string(REPLACE "\n" ";" lazy "${LAZY_out}")
+  foreach(line IN LISTS eager)
+    list(GET lazy 0 other)
+    list(REMOVE_AT lazy 0)
+    if(NOT line STREQUAL other)
+      message(FATAL_ERROR "lazy flags differ: eager ${line}, lazy ${other}")
+    endif()
+  endforeach()
+  message(FATAL_ERROR "lazy flags output differs")
+endif()
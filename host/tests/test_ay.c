@@ -0,0 +1,148 @@
+/**-----------------------------------------------------------------------------
+ * Copyright (c) 2025 Sergey Sanders
+ * sergey@sesadesign.com
+ * -----------------------------------------------------------------------------
+ * Licensed under Creative Commons Attribution-NonCommercial-ShareAlike 4.0
+ * International (CC BY-NC-SA 4.0).
+ *
+ * You are free to:
+ *  - Share: Copy and redistribute the material.
+ *  - Adapt: Remix, transform, and build upon the material.
+ *
+ * Under the following terms:
+ *  - Attribution: Give appropriate credit and indicate changes.
+ *  - NonCommercial: Do not use for commercial purposes.
+ *  - ShareAlike: Distribute under the same license.
+ *
+ * DISCLAIMER: This work is provided "as is" without any guarantees. The authors
+ * aren’t responsible for any issues, damages, or claims that come up from using
+ * it. Use at your own risk!
+ *
+ * Full license: http://creativecommons.org/licenses/by-nc-sa/4.0/
+ * ---------------------------------------------------------------------------*/
+/**
+ * @file test_ay.c
+ * @brief AY-3-8912 block rendering: tone pitch, levels, mixer, envelope and the beeper mix
+ */
+#include <stdio.h>
+#include <string.h>
+#include "bsp.h"
+#include "zx80sys.h"
+#include "ay8912.h"
+
+#define TEST_FRAMES 50
+#define TEST_VOLUME 256 // DAC value = mix level
+
+static uint16_t Buf[TEST_FRAMES * AY_FRAME_SAMPLES];
+static uint32_t Failed;
+
+#define CHECK(cond, ...)           \
+   if (!(cond))                    \
+   {                               \
+      printf(__VA_ARGS__);         \
+      putchar('\n');               \
+      Failed++;                    \
+   }
+
+static void ay_set(_ay_t *ay, uint8_t reg, uint8_t value)
+{
+   ay_select(ay, reg);
+   ay_write(ay, value);
+}
+
+static void render(_ay_t *ay, uint16_t frames)
+{
+   for (uint16_t f = 0; f < frames; f++)
+      ay_render(ay, &Buf[f * AY_FRAME_SAMPLES], NULL, 0, 0, TEST_VOLUME);
+}
+
+/** Tone A half periods counted over TEST_FRAMES blocks, against AY_CLOCK / 16 / period */
+static void test_tone(uint16_t period)
+{
+   static _ay_t ay;
+   uint32_t edges = 0, samples = TEST_FRAMES * AY_FRAME_SAMPLES;
+   ay_reset(&ay);
+   ay_set(&ay, AY_FINE_A, period & 0xff);
+   ay_set(&ay, AY_COARSE_A, period >> 8);
+   ay_set(&ay, AY_MIXER, 0x3e);
+   ay_set(&ay, AY_AMPLITUDE_A, 0x0f);
+   render(&ay, TEST_FRAMES);
+   for (uint32_t i = 1; i < samples; i++)
+   {
+      CHECK(Buf[i] == 0 || Buf[i] == 255, "tone %u: sample %u level %u", period, i, Buf[i]);
+      edges += Buf[i] != Buf[i - 1];
+   }
+   uint32_t expected = (uint32_t)((uint64_t)samples * 2 * AY_CLOCK / 16 / period / AY_SAMPLE_RATE);
+   CHECK(edges + 2 >= expected && edges <= expected + 2, "tone %u: %u edges, expected %u", period, edges, expected);
+}
+
+int main(void)
+{
+   static _ay_t ay;
+   static const uint8_t volume[16] = {0, 3, 4, 6, 8, 12, 17, 26, 32, 51, 71, 90, 120, 154, 192, 255};
+
+   test_tone(0x0100);
+   test_tone(0x01c0);
+   test_tone(0x0fff);
+
+   /// tone and noise off: the channel sits at its volume, the three channels add up
+   ay_reset(&ay);
+   ay_set(&ay, AY_MIXER, 0x3f);
+   for (uint8_t v = 0; v < 16; v++)
+   {
+      ay_set(&ay, AY_AMPLITUDE_A, v);
+      ay_set(&ay, AY_AMPLITUDE_B, v);
+      render(&ay, 1);
+      CHECK(Buf[0] == volume[v] * 2 && Buf[AY_FRAME_SAMPLES - 1] == volume[v] * 2, "volume %u: %u", v, Buf[0]);
+   }
+   ay_set(&ay, AY_AMPLITUDE_B, 0);
+
+   /// noise on channel B only: both levels, no other channel
+   ay_reset(&ay);
+   ay_set(&ay, AY_MIXER, 0x2f);
+   ay_set(&ay, AY_NOISE_PERIOD, 0x01);
+   ay_set(&ay, AY_AMPLITUDE_B, 0x0f);
+   render(&ay, 1);
+   uint32_t high = 0;
+   for (uint16_t i = 0; i < AY_FRAME_SAMPLES; i++)
+   {
+      CHECK(Buf[i] == 0 || Buf[i] == 255, "noise: sample %u level %u", i, Buf[i]);
+      high += Buf[i] != 0;
+   }
+   CHECK(high > AY_FRAME_SAMPLES / 4 && high < AY_FRAME_SAMPLES * 3 / 4, "noise: %u high samples", high);
+
+   /// envelope shape 0x0d: one attack to the top, then held there
+   ay_reset(&ay);
+   ay_set(&ay, AY_MIXER, 0x3f);
+   ay_set(&ay, AY_AMPLITUDE_C, 0x10);
+   ay_set(&ay, AY_ENV_FINE, 0x00);
+   ay_set(&ay, AY_ENV_COARSE, 0x01);
+   ay_set(&ay, AY_ENV_SHAPE, 0x0d);
+   render(&ay, 2);
+   CHECK(Buf[0] == 0, "attack: starts at %u", Buf[0]);
+   for (uint16_t i = 1; i < 2 * AY_FRAME_SAMPLES; i++)
+      CHECK(Buf[i] >= Buf[i - 1], "attack: falls at sample %u", i);
+   CHECK(Buf[2 * AY_FRAME_SAMPLES - 1] == 255, "attack: holds at %u", Buf[2 * AY_FRAME_SAMPLES - 1]);
+
+   /// the beeper edges are mixed at their sample positions, the EAR level quieter
+   static const uint16_t events[] = {100 | AY_BEEPER_ON, 200 | AY_BEEPER_ON | AY_EAR_ON, 300};
+   ay_reset(&ay);
+   ay_render(&ay, Buf, events, 3, AY_EAR_ON, TEST_VOLUME);
+   CHECK(Buf[99] == AY_EAR_LEVEL && Buf[100] == AY_BEEPER_LEVEL && Buf[200] == AY_BEEPER_LEVEL + AY_EAR_LEVEL &&
+             Buf[299] == AY_BEEPER_LEVEL + AY_EAR_LEVEL && Buf[300] == 0,
+         "beeper: %u %u %u %u %u", Buf[99], Buf[100], Buf[200], Buf[299], Buf[300]);
+
+   /// the DAC value is scaled by the volume and clipped at 12 bits
+   ay_reset(&ay);
+   ay_set(&ay, AY_MIXER, 0x3f);
+   ay_set(&ay, AY_AMPLITUDE_A, 0x0f);
+   ay_render(&ay, Buf, NULL, 0, 0, DEF_CONF_SPKR_MAX);
+   CHECK(Buf[0] == 255 * DEF_CONF_SPKR_MAX / 256, "volume scale: %u", Buf[0]);
+   ay_set(&ay, AY_AMPLITUDE_B, 0x0f);
+   ay_set(&ay, AY_AMPLITUDE_C, 0x0f);
+   ay_render(&ay, Buf, NULL, 0, AY_BEEPER_ON, DEF_CONF_SPKR_MAX);
+   CHECK(Buf[0] == 4095, "clipping: %u", Buf[0]);
+
+   printf("%u failed\n", Failed);
+   return Failed != 0;
+}
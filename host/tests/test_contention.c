@@ -0,0 +1,308 @@
+/**-----------------------------------------------------------------------------
+ * Copyright (c) 2025 Sergey Sanders
+ * sergey@sesadesign.com
+ * -----------------------------------------------------------------------------
+ * Licensed under Creative Commons Attribution-NonCommercial-ShareAlike 4.0
+ * International (CC BY-NC-SA 4.0).
+ *
+ * You are free to:
+ *  - Share: Copy and redistribute the material.
+ *  - Adapt: Remix, transform, and build upon the material.
+ *
+ * Under the following terms:
+ *  - Attribution: Give appropriate credit and indicate changes.
+ *  - NonCommercial: Do not use for commercial purposes.
+ *  - ShareAlike: Distribute under the same license.
+ *
+ * DISCLAIMER: This work is provided "as is" without any guarantees. The authors
+ * aren’t responsible for any issues, damages, or claims that come up from using
+ * it. Use at your own risk!
+ *
+ * Full license: http://creativecommons.org/licenses/by-nc-sa/4.0/
+ * ---------------------------------------------------------------------------*/
+/**
+ * @file test_contention.c
+ * @brief 48K memory and I/O contention of the Z80 core against the documented cycle patterns
+ *
+ * Every instruction below is listed with its machine cycles in the usual contention notation:
+ * "hl:3" is a 3 T-state access to the address in HL, "ir:1x2" two internal T-states with IR
+ * on the bus, "io" the I/O cycle of the port. The reference adds the ULA delay
+ * (6,5,4,3,2,1,0,0 from T-state 14335, 128 of every 224 T-states of 192 lines) before each
+ * T-state cycle on an address in 0x4000-0x7fff, the core must take the same time from every
+ * start T-state around the display area's first and last lines.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bsp.h"
+#include "host.h"
+#include "zx80sys.h"
+
+#define FIRST_CONTENDED 14335
+
+typedef struct
+{
+   const char *name;
+   uint8_t code[4];
+   uint8_t nnAt;  // index of a 16-bit operand set to the register set's nn, 0 - none
+   uint8_t portAt; // index of a port byte set to the register set's C, A is set to B
+   uint8_t f;     // flags
+   const char *cycles;
+} _case_t;
+
+typedef struct
+{
+   uint16_t pc, hl, de, bc, sp, ix, nn;
+   uint8_t i;
+} _regs_t;
+
+static const _case_t Cases[] = {
+    {"NOP", {0x00}, 0, 0, 0, "pc:4"},
+    {"LD B,C", {0x41}, 0, 0, 0, "pc:4"},
+    {"LD B,n", {0x06, 0x12}, 0, 0, 0, "pc:4 pc+1:3"},
+    {"LD A,(HL)", {0x7e}, 0, 0, 0, "pc:4 hl:3"},
+    {"ADC A,(HL)", {0x8e}, 0, 0, 0, "pc:4 hl:3"},
+    {"LD (HL),A", {0x77}, 0, 0, 0, "pc:4 hl:3"},
+    {"LD (HL),n", {0x36, 0x55}, 0, 0, 0, "pc:4 pc+1:3 hl:3"},
+    {"LD A,(BC)", {0x0a}, 0, 0, 0, "pc:4 bc:3"},
+    {"LD (DE),A", {0x12}, 0, 0, 0, "pc:4 de:3"},
+    {"LD A,(nn)", {0x3a}, 1, 0, 0, "pc:4 pc+1:3 pc+2:3 nn:3"},
+    {"LD (nn),A", {0x32}, 1, 0, 0, "pc:4 pc+1:3 pc+2:3 nn:3"},
+    {"LD HL,(nn)", {0x2a}, 1, 0, 0, "pc:4 pc+1:3 pc+2:3 nn:3 nn+1:3"},
+    {"LD (nn),HL", {0x22}, 1, 0, 0, "pc:4 pc+1:3 pc+2:3 nn:3 nn+1:3"},
+    {"LD BC,nn", {0x01}, 1, 0, 0, "pc:4 pc+1:3 pc+2:3"},
+    {"INC (HL)", {0x34}, 0, 0, 0, "pc:4 hl:3 hl:1 hl:3"},
+    {"DEC (HL)", {0x35}, 0, 0, 0, "pc:4 hl:3 hl:1 hl:3"},
+    {"INC BC", {0x03}, 0, 0, 0, "pc:4 ir:1x2"},
+    {"LD SP,HL", {0xf9}, 0, 0, 0, "pc:4 ir:1x2"},
+    {"ADD HL,BC", {0x09}, 0, 0, 0, "pc:4 ir:1x7"},
+    {"PUSH BC", {0xc5}, 0, 0, 0, "pc:4 ir:1 sp-1:3 sp-2:3"},
+    {"POP BC", {0xc1}, 0, 0, 0, "pc:4 sp:3 sp+1:3"},
+    {"JP nn", {0xc3}, 1, 0, 0, "pc:4 pc+1:3 pc+2:3"},
+    {"JP NZ,nn", {0xc2}, 1, 0, Z80_Z_FLAG, "pc:4 pc+1:3 pc+2:3"},
+    {"JP (HL)", {0xe9}, 0, 0, 0, "pc:4"},
+    {"JR e", {0x18, 0x05}, 0, 0, 0, "pc:4 pc+1:3 pc+1:1x5"},
+    {"JR NZ,e taken", {0x20, 0x05}, 0, 0, 0, "pc:4 pc+1:3 pc+1:1x5"},
+    {"JR NZ,e", {0x20, 0x05}, 0, 0, Z80_Z_FLAG, "pc:4 pc+1:3"},
+    {"DJNZ e", {0x10, 0x05}, 0, 0, 0, "pc:4 ir:1 pc+1:3 pc+1:1x5"},
+    {"CALL nn", {0xcd}, 1, 0, 0, "pc:4 pc+1:3 pc+2:3 pc+2:1 sp-1:3 sp-2:3"},
+    {"CALL NZ,nn", {0xc4}, 1, 0, Z80_Z_FLAG, "pc:4 pc+1:3 pc+2:3"},
+    {"RET", {0xc9}, 0, 0, 0, "pc:4 sp:3 sp+1:3"},
+    {"RET NZ taken", {0xc0}, 0, 0, 0, "pc:4 ir:1 sp:3 sp+1:3"},
+    {"RET Z", {0xc8}, 0, 0, 0, "pc:4 ir:1"},
+    {"RST 38", {0xff}, 0, 0, 0, "pc:4 ir:1 sp-1:3 sp-2:3"},
+    {"EX (SP),HL", {0xe3}, 0, 0, 0, "pc:4 sp:3 sp+1:3 sp+1:1 sp+1:3 sp:3 sp:1x2"},
+    {"EX DE,HL", {0xeb}, 0, 0, 0, "pc:4"},
+    {"IN A,(n)", {0xdb, 0x00}, 0, 1, 0, "pc:4 pc+1:3 io"},
+    {"OUT (n),A", {0xd3, 0x00}, 0, 1, 0, "pc:4 pc+1:3 io"},
+    {"RLC B", {0xcb, 0x00}, 0, 0, 0, "pc:4 pc+1:4"},
+    {"RLC (HL)", {0xcb, 0x06}, 0, 0, 0, "pc:4 pc+1:4 hl:3 hl:1 hl:3"},
+    {"BIT 0,(HL)", {0xcb, 0x46}, 0, 0, 0, "pc:4 pc+1:4 hl:3 hl:1"},
+    {"SET 0,(HL)", {0xcb, 0xc6}, 0, 0, 0, "pc:4 pc+1:4 hl:3 hl:1 hl:3"},
+    {"NEG", {0xed, 0x44}, 0, 0, 0, "pc:4 pc+1:4"},
+    {"IM 1", {0xed, 0x56}, 0, 0, 0, "pc:4 pc+1:4"},
+    {"LD A,I", {0xed, 0x57}, 0, 0, 0, "pc:4 pc+1:4 ir:1"},
+    {"LD A,R", {0xed, 0x5f}, 0, 0, 0, "pc:4 pc+1:4 ir:1"},
+    {"SBC HL,BC", {0xed, 0x42}, 0, 0, 0, "pc:4 pc+1:4 ir:1x7"},
+    {"LD BC,(nn)", {0xed, 0x4b}, 2, 0, 0, "pc:4 pc+1:4 pc+2:3 pc+3:3 nn:3 nn+1:3"},
+    {"LD (nn),BC", {0xed, 0x43}, 2, 0, 0, "pc:4 pc+1:4 pc+2:3 pc+3:3 nn:3 nn+1:3"},
+    {"RETN", {0xed, 0x45}, 0, 0, 0, "pc:4 pc+1:4 sp:3 sp+1:3"},
+    {"IN A,(C)", {0xed, 0x78}, 0, 0, 0, "pc:4 pc+1:4 io"},
+    {"OUT (C),A", {0xed, 0x79}, 0, 0, 0, "pc:4 pc+1:4 io"},
+    {"RLD", {0xed, 0x6f}, 0, 0, 0, "pc:4 pc+1:4 hl:3 hl:1x4 hl:3"},
+    {"LDI", {0xed, 0xa0}, 0, 0, 0, "pc:4 pc+1:4 hl:3 de:3 de:1x2"},
+    {"LDIR", {0xed, 0xb0}, 0, 0, 0, "pc:4 pc+1:4 hl:3 de:3 de:1x2 de:1x5"},
+    {"CPI", {0xed, 0xa1}, 0, 0, 0, "pc:4 pc+1:4 hl:3 hl:1x5"},
+    {"CPIR", {0xed, 0xb1}, 0, 0, 0, "pc:4 pc+1:4 hl:3 hl:1x5 hl:1x5"},
+    {"INI", {0xed, 0xa2}, 0, 0, 0, "pc:4 pc+1:4 ir:1 io hl:3"},
+    {"OUTI", {0xed, 0xa3}, 0, 0, 0, "pc:4 pc+1:4 ir:1 hl:3 io-"},
+    {"LD B,C (DD)", {0xdd, 0x41}, 0, 0, 0, "pc:4 pc+1:4"},
+    {"LD IX,nn", {0xdd, 0x21}, 2, 0, 0, "pc:4 pc+1:4 pc+2:3 pc+3:3"},
+    {"INC IX", {0xdd, 0x23}, 0, 0, 0, "pc:4 pc+1:4 ir:1x2"},
+    {"LD SP,IX", {0xdd, 0xf9}, 0, 0, 0, "pc:4 pc+1:4 ir:1x2"},
+    {"ADD IX,BC", {0xdd, 0x09}, 0, 0, 0, "pc:4 pc+1:4 ir:1x7"},
+    {"PUSH IX", {0xdd, 0xe5}, 0, 0, 0, "pc:4 pc+1:4 ir:1 sp-1:3 sp-2:3"},
+    {"POP IX", {0xdd, 0xe1}, 0, 0, 0, "pc:4 pc+1:4 sp:3 sp+1:3"},
+    {"EX (SP),IX", {0xdd, 0xe3}, 0, 0, 0, "pc:4 pc+1:4 sp:3 sp+1:3 sp+1:1 sp+1:3 sp:3 sp:1x2"},
+    {"LD A,(IX+d)", {0xdd, 0x7e, 0x05}, 0, 0, 0, "pc:4 pc+1:4 pc+2:3 pc+2:1x5 ii:3"},
+    {"LD (IX+d),A", {0xdd, 0x77, 0x05}, 0, 0, 0, "pc:4 pc+1:4 pc+2:3 pc+2:1x5 ii:3"},
+    {"ADD A,(IY+d)", {0xfd, 0x86, 0x05}, 0, 0, 0, "pc:4 pc+1:4 pc+2:3 pc+2:1x5 ii:3"},
+    {"LD (IX+d),n", {0xdd, 0x36, 0x05, 0x55}, 0, 0, 0, "pc:4 pc+1:4 pc+2:3 pc+3:3 pc+3:1x2 ii:3"},
+    {"INC (IX+d)", {0xdd, 0x34, 0x05}, 0, 0, 0, "pc:4 pc+1:4 pc+2:3 pc+2:1x5 ii:3 ii:1 ii:3"},
+    {"RLC (IX+d)", {0xdd, 0xcb, 0x05, 0x06}, 0, 0, 0, "pc:4 pc+1:4 pc+2:3 pc+3:3 pc+3:1x2 ii:3 ii:1 ii:3"},
+    {"BIT 0,(IY+d)", {0xfd, 0xcb, 0x05, 0x46}, 0, 0, 0, "pc:4 pc+1:4 pc+2:3 pc+3:3 pc+3:1x2 ii:3 ii:1"},
+};
+
+/// register sets: contended code and data, uncontended code, nothing contended, code and data across 0x8000
+static const _regs_t Sets[] = {
+    {.pc = 0x6000, .hl = 0x4100, .de = 0x5100, .bc = 0x4200, .sp = 0x7000, .ix = 0x5800, .nn = 0x4400, .i = 0x40},
+    {.pc = 0x8000, .hl = 0x4100, .de = 0x5100, .bc = 0x42ff, .sp = 0x7000, .ix = 0x5800, .nn = 0x4400, .i = 0x00},
+    {.pc = 0x8000, .hl = 0x9100, .de = 0xa100, .bc = 0x92fe, .sp = 0xf000, .ix = 0xb800, .nn = 0xc400, .i = 0x3f},
+    {.pc = 0x7ffe, .hl = 0x4100, .de = 0xa100, .bc = 0x92ff, .sp = 0x8001, .ix = 0x7ffd, .nn = 0x7fff, .i = 0x7f},
+};
+
+static int ula_delay(uint32_t t)
+{
+   static const uint8_t pattern[8] = {6, 5, 4, 3, 2, 1, 0, 0};
+   if (t < FIRST_CONTENDED)
+      return 0;
+   t -= FIRST_CONTENDED;
+   if (t / ULA_LINE_TSTATES >= ULA_CONTENDED_LINES || t % ULA_LINE_TSTATES >= ULA_CONTENDED_TSTATES)
+      return 0;
+   return pattern[t % 8];
+}
+
+static bool contended(uint16_t address)
+{
+   return (address & 0xc000) == 0x4000;
+}
+
+/** T-state cycles of an I/O access, the ULA (A0 = 0) contends its last 3 T-states */
+static uint32_t ref_io(uint32_t t, uint16_t port)
+{
+   if (port & 0x01)
+   {
+      for (uint8_t c = 0; c < 4; c++)
+         t += (contended(port) ? ula_delay(t) : 0) + 1;
+      return t;
+   }
+   t += (contended(port) ? ula_delay(t) : 0) + 1;
+   return t + ula_delay(t) + 3;
+}
+
+/** Time of the cycles from the start T-state t */
+static uint32_t ref_time(const char *cycles, const _regs_t *r, uint32_t t)
+{
+   const char *p = cycles;
+   uint16_t ii = r->ix + 5;
+   while (*p)
+   {
+      char name[4] = {0};
+      uint8_t n = 0;
+      long offset = 0, count = 1;
+      uint16_t address;
+      while (*p == ' ')
+         p++;
+      for (uint8_t i = 0; *p >= 'a' && *p <= 'z' && i < 3; i++)
+         name[i] = *p++;
+      if (*p == '+' || (*p == '-' && p[1] != ' ' && p[1]))
+         offset = strtol(p, (char **)&p, 10);
+      if (!strcmp(name, "io"))
+      {
+         uint16_t port = r->bc;
+         if (*p == '-') // OUTI outputs after B is decremented
+         {
+            port -= 0x100;
+            p++;
+         }
+         t = ref_io(t, port);
+         continue;
+      }
+      if (*p++ != ':')
+         return 0;
+      n = (uint8_t)strtol(p, (char **)&p, 10);
+      if (*p == 'x')
+         count = strtol(p + 1, (char **)&p, 10);
+      if (!strcmp(name, "pc"))
+         address = r->pc;
+      else if (!strcmp(name, "hl"))
+         address = r->hl;
+      else if (!strcmp(name, "de"))
+         address = r->de;
+      else if (!strcmp(name, "bc"))
+         address = r->bc;
+      else if (!strcmp(name, "sp"))
+         address = r->sp;
+      else if (!strcmp(name, "nn"))
+         address = r->nn;
+      else if (!strcmp(name, "ii"))
+         address = ii;
+      else if (!strcmp(name, "ir"))
+         address = (uint16_t)r->i << 8;
+      else
+         return 0;
+      address += offset;
+      while (count--)
+         t += (contended(address) ? ula_delay(t) : 0) + n;
+   }
+   return t;
+}
+
+/** Put the machine at the frame T-state t */
+static void set_frame_t(Z80_CONTEXT *ctx, uint32_t t)
+{
+   ctx->ulaScanLine = (t + 1) / ULA_LINE_TSTATES;
+   ctx->ulaLineT = (t + 1) % ULA_LINE_TSTATES;
+   ctx->ulaLine = UlaContention[ULA_LINE_TYPE(ctx->ulaScanLine)];
+}
+
+static uint32_t run_case(Z80_CONTEXT *ctx, const _case_t *tc, const _regs_t *r, uint32_t t)
+{
+   uint8_t *mem = ctx->mem;
+   uint16_t ii = r->ix + 5;
+   const uint16_t data[] = {r->hl, r->hl + 1, r->de, r->bc, r->nn, r->nn + 1, ii, r->sp - 2, r->sp - 1, r->sp, r->sp + 1};
+   for (uint8_t i = 0; i < sizeof(data) / sizeof(data[0]); i++)
+      mem[data[i]] = 0x55;
+   for (uint8_t i = 0; i < 4; i++)
+      mem[(uint16_t)(r->pc + i)] = tc->code[i];
+   if (tc->nnAt)
+   {
+      mem[(uint16_t)(r->pc + tc->nnAt)] = r->nn & 0xff;
+      mem[(uint16_t)(r->pc + tc->nnAt + 1)] = r->nn >> 8;
+   }
+   if (tc->portAt)
+      mem[(uint16_t)(r->pc + tc->portAt)] = r->bc & 0xff;
+   ctx->state.pc = r->pc;
+   ctx->state.registers.word[Z80_HL] = r->hl;
+   ctx->state.registers.word[Z80_DE] = r->de;
+   ctx->state.registers.word[Z80_BC] = r->bc;
+   ctx->state.registers.word[Z80_SP] = r->sp;
+   ctx->state.registers.word[Z80_IX] = r->ix;
+   ctx->state.registers.word[Z80_IY] = r->ix;
+   ctx->state.registers.byte[Z80_A] = tc->portAt ? r->bc >> 8 : 0x00;
+   ctx->state.registers.byte[Z80_F] = tc->f;
+   ctx->state.i = r->i;
+   set_frame_t(ctx, t);
+   uint32_t took = z80_step(ctx);
+   if (ULA_FRAME_T(ctx) != t + took)
+      return 0; // the line position must move by the instruction's time
+   return took;
+}
+
+int main(void)
+{
+   /// start T-states: the lines before, at the start and at the end of the display area, and one in the middle
+   static const uint32_t ranges[][2] = {
+       {FIRST_CONTENDED - 2 * ULA_LINE_TSTATES, FIRST_CONTENDED + 2 * ULA_LINE_TSTATES},
+       {FIRST_CONTENDED + 100 * ULA_LINE_TSTATES, FIRST_CONTENDED + 101 * ULA_LINE_TSTATES},
+       {FIRST_CONTENDED + 190 * ULA_LINE_TSTATES, FIRST_CONTENDED + 193 * ULA_LINE_TSTATES},
+   };
+   Z80_CONTEXT *ctx = zx_host_new();
+   uint32_t runs = 0, failed = 0;
+   for (uint8_t c = 0; c < sizeof(Cases) / sizeof(Cases[0]); c++)
+      for (uint8_t s = 0; s < sizeof(Sets) / sizeof(Sets[0]); s++)
+      {
+         uint32_t caseFailed = 0;
+         for (uint8_t rg = 0; rg < sizeof(ranges) / sizeof(ranges[0]); rg++)
+            for (uint32_t t = ranges[rg][0]; t < ranges[rg][1]; t++, runs++)
+            {
+               uint32_t expected = ref_time(Cases[c].cycles, &Sets[s], t) - t;
+               uint32_t took = run_case(ctx, &Cases[c], &Sets[s], t);
+               if (took != expected && !caseFailed++)
+                  printf("%-14s set %d, T %5u: %2u T-states, expected %2u\n", Cases[c].name, s, t, took, expected);
+            }
+         failed += caseFailed;
+      }
+   /// a frame boundary keeps the T-states the last instruction ran past the frame end
+   ctx->state.iff1 = 0;
+   for (uint32_t over = 0; over < 2 * ULA_LINE_TSTATES; over++, runs++)
+   {
+      set_frame_t(ctx, ULA_FRAME_TSTATES + over);
+      zx_frame(ctx);
+      if (ULA_FRAME_T(ctx) != over && !failed++)
+         printf("frame carry %3u: next frame at T %u\n", over, ULA_FRAME_T(ctx));
+   }
+   zx_host_free(ctx);
+   printf("%u runs, %u failed\n", runs, failed);
+   return failed != 0;
+}
@@ -0,0 +1,110 @@
+/**-----------------------------------------------------------------------------
+ * Copyright (c) 2025 Sergey Sanders
+ * sergey@sesadesign.com
+ * -----------------------------------------------------------------------------
+ * Licensed under Creative Commons Attribution-NonCommercial-ShareAlike 4.0
+ * International (CC BY-NC-SA 4.0).
+ *
+ * You are free to:
+ *  - Share: Copy and redistribute the material.
+ *  - Adapt: Remix, transform, and build upon the material.
+ *
+ * Under the following terms:
+ *  - Attribution: Give appropriate credit and indicate changes.
+ *  - NonCommercial: Do not use for commercial purposes.
+ *  - ShareAlike: Distribute under the same license.
+ *
+ * DISCLAIMER: This work is provided "as is" without any guarantees. The authors
+ * aren’t responsible for any issues, damages, or claims that come up from using
+ * it. Use at your own risk!
+ *
+ * Full license: http://creativecommons.org/licenses/by-nc-sa/4.0/
+ * ---------------------------------------------------------------------------*/
+/**
+ * @file test_flags.c
+ * @brief Lazy flags differential run: random machine states and instruction streams
+ *
+ * Built twice, test_flags with the eager flags and test_flags_lazy with Z80_LAZY_FLAGS.
+ * Each run fills the memory and the registers from a fixed seed and steps through whatever
+ * the bytes decode to, with frame interrupts, printing a hash of the state and memory every
+ * FLAGS_CHECK_STEPS instructions. F is only synced at the checkpoints, so the lazy record
+ * lives across the instructions in between. flags_check.cmake compares the two outputs.
+ * usage: test_flags [runs] [steps]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include "bsp.h"
+#include "host.h"
+#include "zx80sys.h"
+
+#define FLAGS_CHECK_STEPS 4096
+
+#ifdef Z80_LAZY_FLAGS
+#define FLAGS_CORE "lazy"
+#else
+#define FLAGS_CORE "eager"
+#endif
+
+static uint32_t xorshiftState;
+
+/** xorshift32, the same sequence on every host */
+static uint32_t xorshift(void)
+{
+   xorshiftState ^= xorshiftState << 13;
+   xorshiftState ^= xorshiftState >> 17;
+   xorshiftState ^= xorshiftState << 5;
+   return xorshiftState;
+}
+
+static uint32_t state_hash(Z80_CONTEXT *ctx)
+{
+   uint32_t hash = 2166136261UL;
+   const uint8_t *state = (const uint8_t *)&ctx->state;
+   Z80FlagsSync(ctx);
+   for (uint32_t i = 0; i < sizeof(ctx->state); i++)
+      hash = (hash ^ state[i]) * 16777619UL;
+   for (uint32_t i = 0; i < Z80SYS_MEMORY_SIZE; i++)
+      hash = (hash ^ ctx->mem[i]) * 16777619UL;
+   return hash;
+}
+
+int main(int argc, char **argv)
+{
+   uint32_t runs = argc > 1 ? strtoul(argv[1], NULL, 0) : 64;
+   uint32_t steps = argc > 2 ? strtoul(argv[2], NULL, 0) : 65536;
+   uint64_t instructions = 0, time = 0;
+   Z80_CONTEXT *ctx = zx_host_new();
+   for (uint32_t run = 0; run < runs; run++)
+   {
+      xorshiftState = 0x9e3779b9UL ^ (run * 2654435761UL);
+      Z80Reset(ctx);
+      for (uint32_t i = 0; i < Z80SYS_MEMORY_SIZE; i++)
+         ctx->mem[i] = (uint8_t)xorshift();
+      for (uint8_t i = 0; i < 7; i++)
+         ctx->state.registers.word[i] = (uint16_t)xorshift();
+      for (uint8_t i = 0; i < 4; i++)
+         ctx->state.alternates[i] = (uint16_t)xorshift();
+      ctx->state.pc = (uint16_t)xorshift();
+      ctx->state.i = (uint8_t)xorshift();
+      ctx->state.im = Z80_INTERRUPT_MODE_1 + (xorshift() & 1);
+      ctx->state.iff1 = ctx->state.iff2 = xorshift() & 1;
+      uint64_t start = host_time_us();
+      for (uint32_t step = 1; step <= steps; step++)
+      {
+         z80_step(ctx);
+         if (ULA_FRAME_T(ctx) >= ULA_FRAME_TSTATES)
+            zx_frame(ctx);
+         if (!(step % FLAGS_CHECK_STEPS) || step == steps)
+         {
+            time += host_time_us() - start;
+            printf("%u.%u: %08x\n", run, step, state_hash(ctx));
+            start = host_time_us();
+         }
+      }
+      instructions += steps;
+   }
+   zx_host_free(ctx);
+   fprintf(stderr, "%s: %llu instructions, %.2f Minstr/s\n", FLAGS_CORE, (unsigned long long)instructions,
+           time ? (double)instructions / time : 0.0);
+   return 0;
+}
@@ -0,0 +1,183 @@
+/**-----------------------------------------------------------------------------
+ * Copyright (c) 2025 Sergey Sanders
+ * sergey@sesadesign.com
+ * -----------------------------------------------------------------------------
+ * Licensed under Creative Commons Attribution-NonCommercial-ShareAlike 4.0
+ * International (CC BY-NC-SA 4.0).
+ *
+ * You are free to:
+ *  - Share: Copy and redistribute the material.
+ *  - Adapt: Remix, transform, and build upon the material.
+ *
+ * Under the following terms:
+ *  - Attribution: Give appropriate credit and indicate changes.
+ *  - NonCommercial: Do not use for commercial purposes.
+ *  - ShareAlike: Distribute under the same license.
+ *
+ * DISCLAIMER: This work is provided "as is" without any guarantees. The authors
+ * aren’t responsible for any issues, damages, or claims that come up from using
+ * it. Use at your own risk!
+ *
+ * Full license: http://creativecommons.org/licenses/by-nc-sa/4.0/
+ * ---------------------------------------------------------------------------*/
+/**
+ * @file test_format.c
+ * @brief num_itoa, num_htoa and num_ftoa against the C library formatting, and their speed
+ *
+ * test_format [values]
+ *
+ * Integers and hex must match snprintf exactly. num_ftoa rounds in float, so
+ * its output may be one off in the last decimal from snprintf's rounding of
+ * the exact value; it must never be further off, must drop the trailing zeros
+ * but one, and past 2^32 must have the exponent form of the value, one off
+ * in the last mantissa decimal at most.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <math.h>
+#include "host.h"
+#include "basic_host.h"
+#include "bcore.h"
+
+#define FORMAT_VALUES 1000000 // random values of each kind without the argument
+
+static uint32_t Failed;
+
+#define CHECK(cond, ...)           \
+   if (!(cond))                    \
+   {                               \
+      printf(__VA_ARGS__);         \
+      putchar('\n');               \
+      Failed++;                    \
+   }
+
+static uint32_t Seed = 2463534242u;
+
+static uint32_t xorshift(void)
+{
+   Seed ^= Seed << 13;
+   Seed ^= Seed >> 17;
+   Seed ^= Seed << 5;
+   return Seed;
+}
+
+/** A float of any sign and of a magnitude from 2^-24 to 2^40 */
+static float random_float(void)
+{
+   float val = ldexpf((float)(xorshift() & 0xffffff) / 0x1000000, (int)(xorshift() % 65) - 24);
+   return (xorshift() & 1) ? -val : val;
+}
+
+/** snprintf rounding of the exact value, with the trailing zeros dropped as num_ftoa does */
+static void reference_ftoa(char *buf, size_t size, float val, uint8_t decimals)
+{
+   char *end;
+   snprintf(buf, size, "%.*f", decimals, val);
+   for (end = buf + strlen(buf) - 1; *end == '0' && end[-1] != '.'; end--)
+      *end = '\0';
+   if (!strcmp(buf, "-0.0"))
+      strcpy(buf, "0.0");
+}
+
+/** count[0] values compared with snprintf, count[1] of them the same string */
+static void check_ftoa(float val, uint8_t decimals, uint32_t *count)
+{
+   char str[NUM_STR_LEN], ref[64];
+   uint8_t len = num_ftoa(str, val, decimals);
+   const char *dot = strchr(str, '.'), *exp = strchr(str, 'e');
+   CHECK(len == strlen(str) && len < NUM_STR_LEN, "%.9g: length %u of \"%s\"", val, len, str);
+   CHECK(dot && dot[1] && (exp ? exp[-1] != '.' : (str[len - 1] != '0' || dot[2] == '\0')),
+         "%.9g: \"%s\" is not trimmed", val, str);
+   if (fabsf(val) >= 4294967296.0f)
+   {
+      CHECK(exp && fabs(strtod(str, NULL) / val - 1) <= pow(10, -decimals) * 1.01, "%.9g: \"%s\"", val, str);
+      return;
+   }
+   reference_ftoa(ref, sizeof(ref), val, decimals);
+   count[0]++;
+   if (!strcmp(str, ref))
+      count[1]++;
+   else
+      CHECK(!exp && fabs(strtod(str, NULL) - strtod(ref, NULL)) <= pow(10, -decimals) * 1.01,
+            "%.9g, %u decimals: \"%s\", snprintf \"%s\"", val, decimals, str, ref);
+}
+
+int main(int argc, char **argv)
+{
+   static const int32_t edges[] = {0, 1, -1, 9, 10, 99, 100, 999999999, 1000000000, -1000000000, INT32_MAX, INT32_MIN};
+   static const float fedges[] = {0.0f, 0.0005f, 0.9995f, 0.9999f, -0.9999f, 1.5f, 99.9996f, 4294967040.0f,
+                                  4294967296.0f, 9.9999e12f, -1.5e12f, 3.4e38f};
+   uint32_t values = argc > 1 ? strtoul(argv[1], NULL, 0) : FORMAT_VALUES, exact[2][2] = {{0, 0}, {0, 0}};
+   char str[NUM_STR_LEN], ref[64];
+
+   for (uint8_t i = 0; i < sizeof(edges) / sizeof(edges[0]); i++)
+   {
+      num_itoa(str, edges[i]);
+      snprintf(ref, sizeof(ref), "%d", edges[i]);
+      CHECK(!strcmp(str, ref), "%d: \"%s\"", edges[i], str);
+   }
+   for (uint32_t n = 0; n < values; n++)
+   {
+      int32_t val = (int32_t)xorshift() >> (xorshift() % 32);
+      uint8_t width = (uint8_t[]){2, 4, 8}[n % 3];
+      num_itoa(str, val);
+      snprintf(ref, sizeof(ref), "%d", val);
+      CHECK(!strcmp(str, ref), "%d: \"%s\"", val, str);
+      num_htoa(str, (uint32_t)val, width);
+      snprintf(ref, sizeof(ref), "%0*X", width, (uint32_t)val);
+      CHECK(!strcmp(str, ref), "%08X, %u digits: \"%s\"", (uint32_t)val, width, str);
+   }
+   for (uint8_t i = 0; i < sizeof(fedges) / sizeof(fedges[0]); i++)
+   {
+      check_ftoa(fedges[i], 3, exact[0]);
+      check_ftoa(fedges[i], NUM_DECIMALS, exact[1]);
+   }
+   num_ftoa(str, 0.9999f, 3);
+   CHECK(!strcmp(str, "1.0"), "0.9999: \"%s\", the rounding carry is lost", str);
+   num_ftoa(str, INFINITY, 3);
+   CHECK(!strcmp(str, "inf"), "inf: \"%s\"", str);
+   num_ftoa(str, -INFINITY, 3);
+   CHECK(!strcmp(str, "-inf"), "-inf: \"%s\"", str);
+   num_ftoa(str, NAN, 3);
+   CHECK(!strcmp(str, "nan"), "nan: \"%s\"", str);
+   for (uint32_t n = 0; n < values; n++)
+   {
+      float val = random_float();
+      check_ftoa(val, 3, exact[0]);
+      check_ftoa(val, NUM_DECIMALS, exact[1]);
+   }
+   printf("%u values below 2^32: num_ftoa is snprintf's string for %.3f%% with 3 decimals, %.3f%% with %u\n",
+          exact[0][0], exact[0][1] * 100.0 / exact[0][0], exact[1][1] * 100.0 / exact[1][0], NUM_DECIMALS);
+
+   volatile uint32_t sink = 0;
+   uint64_t start, times[4];
+   Seed = 1;
+   start = host_time_us();
+   for (uint32_t n = 0; n < values; n++)
+      sink += num_itoa(str, (int32_t)xorshift());
+   times[0] = host_time_us() - start;
+   Seed = 1;
+   start = host_time_us();
+   for (uint32_t n = 0; n < values; n++)
+      sink += snprintf(ref, sizeof(ref), "%d", (int32_t)xorshift());
+   times[1] = host_time_us() - start;
+   Seed = 1;
+   start = host_time_us();
+   for (uint32_t n = 0; n < values; n++)
+      sink += num_ftoa(str, random_float(), 3);
+   times[2] = host_time_us() - start;
+   Seed = 1;
+   start = host_time_us();
+   for (uint32_t n = 0; n < values; n++)
+   {
+      reference_ftoa(ref, sizeof(ref), random_float(), 3);
+      sink += ref[0];
+   }
+   times[3] = host_time_us() - start;
+   printf("integers: num_itoa %.1f ns, snprintf %.1f ns; floats: num_ftoa %.1f ns, snprintf %.1f ns\n",
+          times[0] * 1000.0 / values, times[1] * 1000.0 / values, times[2] * 1000.0 / values,
+          times[3] * 1000.0 / values);
+   return Failed ? 1 : 0;
+}
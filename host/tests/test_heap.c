@@ -0,0 +1,205 @@
+/**-----------------------------------------------------------------------------
+ * Copyright (c) 2025 Sergey Sanders
+ * sergey@sesadesign.com
+ * -----------------------------------------------------------------------------
+ * Licensed under Creative Commons Attribution-NonCommercial-ShareAlike 4.0
+ * International (CC BY-NC-SA 4.0).
+ *
+ * You are free to:
+ *  - Share: Copy and redistribute the material.
+ *  - Adapt: Remix, transform, and build upon the material.
+ *
+ * Under the following terms:
+ *  - Attribution: Give appropriate credit and indicate changes.
+ *  - NonCommercial: Do not use for commercial purposes.
+ *  - ShareAlike: Distribute under the same license.
+ *
+ * DISCLAIMER: This work is provided "as is" without any guarantees. The authors
+ * aren’t responsible for any issues, damages, or claims that come up from using
+ * it. Use at your own risk!
+ *
+ * Full license: http://creativecommons.org/licenses/by-nc-sa/4.0/
+ * ---------------------------------------------------------------------------*/
+/**
+ * @file test_heap.c
+ * @brief BASIC heap under a long editing session: lines added, replaced and deleted, runs, CLEAR and NEW
+ *
+ * test_heap [edits]
+ *
+ * The edits come from a fixed random stream. After every NEW the heap must
+ * be back to at most one chunk, no allocation may be refused, and the peak
+ * stays within the board's heap. The time of an edit and of an arena
+ * allocation against a heap allocation is reported.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include "freeRTOS.h"
+#include "host.h"
+#include "basic_host.h"
+#include "bmem.h"
+
+#define HEAP_EDITS 5000     // without the argument
+#define HEAP_NEW_EVERY 500  // edits between NEWs
+#define HEAP_ALLOCS 100000  // timed allocations
+#define HEAP_LIVE 256       // blocks kept alive while timing
+
+static uint32_t Failed;
+static uint32_t XorshiftState = 2463534242UL;
+
+#define CHECK(cond, ...)           \
+   if (!(cond))                    \
+   {                               \
+      printf(__VA_ARGS__);         \
+      putchar('\n');               \
+      Failed++;                    \
+   }
+
+static uint32_t xorshift(uint32_t range)
+{
+   XorshiftState ^= XorshiftState << 13;
+   XorshiftState ^= XorshiftState >> 17;
+   XorshiftState ^= XorshiftState << 5;
+   return XorshiftState % range;
+}
+
+/** A random program line, or a command */
+static void edit(char *str, size_t size)
+{
+   uint16_t number = 10 * (1 + xorshift(60));
+   uint32_t a = xorshift(16), b = xorshift(16), n = 1 + xorshift(50);
+   switch (xorshift(10))
+   {
+   case 0:
+   case 1:
+      snprintf(str, size, "%u v%u=v%u*2+%u", number, a, b, n);
+      break;
+   case 2:
+      snprintf(str, size, "%u s%u$=\"%.*s\"+s%u$", number, a, (int)n, "the quick brown fox jumps over the lazy dog, again and again", b);
+      break;
+   case 3:
+      snprintf(str, size, "%u dim d%u[%u]: d%u[0]=%u", number, number, n, number, b);
+      break;
+   case 4:
+      snprintf(str, size, "%u for i=1 to %u: v%u=v%u+i: next i", number, n, a, a);
+      break;
+   case 5:
+      snprintf(str, size, "%u rem %.*s", number, (int)n, "a remark long enough to need a bigger block when it replaces a short line");
+      break;
+   case 6:
+      snprintf(str, size, "%u", number); // delete the line
+      break;
+   case 7:
+   case 8:
+      snprintf(str, size, "run");
+      break;
+   default:
+      snprintf(str, size, "clear");
+      break;
+   }
+}
+
+/** Lines 1 to 4 set the variables the edits use */
+static void prog_header(void)
+{
+   char str[128];
+   for (uint8_t line = 0; line < 4; line++)
+   {
+      int len = snprintf(str, sizeof(str), "%u", line + 1);
+      for (uint8_t i = 0; i < 8; i++)
+         len += snprintf(str + len, sizeof(str) - len, line < 2 ? "%sv%u=0" : "%ss%u$=\"\"", i ? ": " : " ", (line & 1) * 8 + i);
+      bas_host_line(str);
+   }
+}
+
+/** Blocks of 4..64 bytes. Churn frees a random one of HEAP_LIVE before each allocation,
+    otherwise HEAP_LIVE blocks are allocated and all dropped at once, as CLEAR does */
+static double alloc_ns(_bas_arena_t *arena, bool churn)
+{
+   static void *live[HEAP_LIVE];
+   uint64_t start = host_time_us();
+   memset(live, 0, sizeof(live));
+   for (uint32_t i = 0; i < HEAP_ALLOCS; i++)
+   {
+      uint32_t slot = churn ? xorshift(HEAP_LIVE) : i % HEAP_LIVE;
+      if (churn && live[slot])
+      {
+         if (arena)
+            arena_free(arena, live[slot]);
+         else
+            vPortFree(live[slot]);
+      }
+      live[slot] = arena ? arena_alloc(arena, 4 + xorshift(61)) : pvPortMalloc(4 + xorshift(61));
+      CHECK(live[slot], "allocation %u refused", i);
+      if (!churn && (slot == HEAP_LIVE - 1))
+      {
+         if (arena)
+            arena_reset(arena);
+         else
+            for (uint32_t j = 0; j < HEAP_LIVE; j++)
+               vPortFree(live[j]);
+         memset(live, 0, sizeof(live));
+      }
+   }
+   uint64_t time = host_time_us() - start;
+   if (arena)
+      arena_reset(arena);
+   else
+      for (uint32_t i = 0; i < HEAP_LIVE; i++)
+         vPortFree(live[i]);
+   return time * 1000.0 / HEAP_ALLOCS;
+}
+
+int main(int argc, char **argv)
+{
+   uint32_t edits = argc > 1 ? strtoul(argv[1], NULL, 0) : HEAP_EDITS;
+   uint32_t runs = 0, news = 0;
+   uint64_t editTime = 0, editMax = 0;
+   char str[128];
+   FILE *devNull = fopen(getenv("HEAP_LOG") ? getenv("HEAP_LOG") : "/dev/null", "w");
+
+   bas_host_output(devNull);
+   bas_host_init();
+   prog_header();
+   for (uint32_t e = 1; e <= edits; e++)
+   {
+      edit(str, sizeof(str));
+      if (!strcmp(str, "run"))
+         bas_host_line("clear"); // RUN keeps the variables, DIM would fail the second time
+      uint64_t start = host_time_us();
+      bas_host_line(str);
+      uint64_t time = host_time_us() - start;
+      if (str[0] >= '0' && str[0] <= '9')
+      {
+         editTime += time;
+         if (time > editMax)
+            editMax = time;
+      }
+      else
+         runs++;
+      if (!(e % HEAP_NEW_EVERY))
+      {
+         bas_host_line("new");
+         news++;
+         prog_header();
+         CHECK(HostHeap.used <= sizeof(_arena_chunk_t) + BASIC_ARENA_CHUNK, "edit %u: %u bytes left after NEW", e, HostHeap.used);
+      }
+   }
+   CHECK(!HostHeap.failed, "%u allocations refused", HostHeap.failed);
+   CHECK(HostHeap.peak <= configTOTAL_HEAP_SIZE, "peak %u", HostHeap.peak);
+   printf("%u edits, %u runs, %u NEWs: heap peak %u of %u bytes, %u allocations, %u compactions\n", edits, runs, news,
+          HostHeap.peak, configTOTAL_HEAP_SIZE, HostHeap.allocs, ProgArena.compactions);
+   printf("edit %.2f us average, %.2f us worst\n", (double)editTime / (edits - runs), (double)editMax);
+
+   bas_host_line("new");
+   _bas_arena_t arena = {.name = "bench"};
+   double arenaNs = alloc_ns(&arena, false), heapNs = alloc_ns(NULL, false);
+   printf("allocation, dropped at once: arena %.1f ns, heap %.1f ns\n", arenaNs, heapNs);
+   arenaNs = alloc_ns(&arena, true);
+   heapNs = alloc_ns(NULL, true);
+   printf("allocation, random frees: arena %.1f ns, heap %.1f ns\n", arenaNs, heapNs);
+   CHECK(!HostHeap.used || HostHeap.used <= sizeof(_arena_chunk_t) + BASIC_ARENA_CHUNK, "%u bytes left", HostHeap.used);
+   fclose(devNull);
+   return Failed ? 1 : 0;
+}
@@ -0,0 +1,145 @@
+/**-----------------------------------------------------------------------------
+ * Copyright (c) 2025 Sergey Sanders
+ * sergey@sesadesign.com
+ * -----------------------------------------------------------------------------
+ * Licensed under Creative Commons Attribution-NonCommercial-ShareAlike 4.0
+ * International (CC BY-NC-SA 4.0).
+ *
+ * You are free to:
+ *  - Share: Copy and redistribute the material.
+ *  - Adapt: Remix, transform, and build upon the material.
+ *
+ * Under the following terms:
+ *  - Attribution: Give appropriate credit and indicate changes.
+ *  - NonCommercial: Do not use for commercial purposes.
+ *  - ShareAlike: Distribute under the same license.
+ *
+ * DISCLAIMER: This work is provided "as is" without any guarantees. The authors
+ * aren’t responsible for any issues, damages, or claims that come up from using
+ * it. Use at your own risk!
+ *
+ * Full license: http://creativecommons.org/licenses/by-nc-sa/4.0/
+ * ---------------------------------------------------------------------------*/
+/**
+ * @file test_keywords.c
+ * @brief Keyword lookup: every BasicFunction[] name maps to its own opcode, and the time to LOAD a large program
+ *
+ * test_keywords [lines]
+ *
+ * bas_func_opcode is checked against a linear scan of the table, and both are
+ * timed over all the keywords. A generated program of keyword heavy lines is
+ * then written out and LOADed, every line must be there afterwards.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include "host.h"
+#include "basic_host.h"
+#include "bcore.h"
+#include "bfunc.h"
+
+#define KEYWORD_LINES 1000    // program lines without the argument
+#define KEYWORD_ROUNDS 2000   // lookups of every keyword while timing
+#define KEYWORD_FILE "keywords.bas"
+
+static uint32_t Failed;
+
+#define CHECK(cond, ...)           \
+   if (!(cond))                    \
+   {                               \
+      printf(__VA_ARGS__);         \
+      putchar('\n');               \
+      Failed++;                    \
+   }
+
+/** The lookup before the sorted index */
+static uint8_t linear_opcode(char *name)
+{
+   for (uint8_t fCnt = 0; fCnt < (__OPCODE_LAST - OPCODE_MASK); fCnt++)
+      if (!strcmp(name, BasicFunction[fCnt].name))
+         return OPCODE_MASK + fCnt;
+   return 0;
+}
+
+/** ns per lookup of every typed keyword */
+static double lookup_ns(uint8_t (*lookup)(char *name))
+{
+   volatile uint8_t sink = 0;
+   uint32_t count = 0;
+   uint64_t start = host_time_us();
+   for (uint32_t round = 0; round < KEYWORD_ROUNDS; round++)
+      for (uint8_t fCnt = 0; fCnt < (__OPCODE_LAST - OPCODE_MASK); fCnt++)
+         if (*BasicFunction[fCnt].name != ' ')
+         {
+            sink += lookup((char *)BasicFunction[fCnt].name);
+            count++;
+         }
+   return (host_time_us() - start) * 1000.0 / count;
+}
+
+/** Lines with several keywords each, a few of them functions */
+static void write_program(uint32_t lines)
+{
+   FILE *prog = fopen(KEYWORD_FILE, "w");
+   for (uint32_t line = 1; line <= lines; line++)
+      switch (line % 4)
+      {
+      case 0:
+         fprintf(prog, "%u if a>%u and b<2 then print sin(a);: gosub 10\n", line * 10, line);
+         break;
+      case 1:
+         fprintf(prog, "%u for i=1 to %u step 2: let a=a+abs(i): next i\n", line * 10, line);
+         break;
+      case 2:
+         fprintf(prog, "%u s$=left$(hex$(%u),2)+mid$(\"abc\",2,1): rem %u\n", line * 10, line, line);
+         break;
+      default:
+         fprintf(prog, "%u while a<%u: a=a+sqr(b): wend: return\n", line * 10, line);
+         break;
+      }
+   fclose(prog);
+}
+
+int main(int argc, char **argv)
+{
+   uint32_t lines = argc > 1 ? strtoul(argv[1], NULL, 0) : KEYWORD_LINES, count = 0, keywords = 0;
+   char name[16];
+   FILE *log = tmpfile();
+
+   for (uint8_t fCnt = 0; fCnt < (__OPCODE_LAST - OPCODE_MASK); fCnt++)
+   {
+      if (*BasicFunction[fCnt].name == ' ') // internal opcodes, never typed
+         continue;
+      keywords++;
+      CHECK(bas_func_opcode((char *)BasicFunction[fCnt].name) == OPCODE_MASK + fCnt, "%s: opcode %02X, expected %02X",
+            BasicFunction[fCnt].name, bas_func_opcode((char *)BasicFunction[fCnt].name), OPCODE_MASK + fCnt);
+      CHECK(bas_func_opcode((char *)BasicFunction[fCnt].name) == linear_opcode((char *)BasicFunction[fCnt].name),
+            "%s: differs from the table scan", BasicFunction[fCnt].name);
+      snprintf(name, sizeof(name), "%sx", BasicFunction[fCnt].name);
+      CHECK(!bas_func_opcode(name), "%s: found", name);
+      snprintf(name, sizeof(name), "%.*s", (int)strlen(BasicFunction[fCnt].name) - 1, BasicFunction[fCnt].name);
+      CHECK(!*name || (bas_func_opcode(name) == linear_opcode(name)), "%s: differs from the table scan", name);
+   }
+   CHECK(!bas_func_opcode("") && !bas_func_opcode(" ") && !bas_func_opcode("PRINT") && !bas_func_opcode("zzz"),
+         "unknown names found");
+   double sortedNs = lookup_ns(bas_func_opcode), linearNs = lookup_ns(linear_opcode);
+   printf("%u keywords: sorted index %.1f ns, table scan %.1f ns a lookup\n", keywords, sortedNs, linearNs);
+
+   write_program(lines);
+   bas_host_output(log);
+   bas_host_init();
+   uint64_t start = host_time_us();
+   bas_host_load(KEYWORD_FILE);
+   uint64_t time = host_time_us() - start;
+   for (_bas_line_t *line = BasicProg; line; line = line->next)
+      count++;
+   CHECK(count == lines, "%u lines loaded of %u", count, lines);
+   CHECK(!BasicError, "LOAD error %d", BasicError);
+   printf("LOAD of %u lines: %.2f ms, %.2f us a line, %u bytes of heap\n", lines, time / 1000.0, (double)time / lines,
+          HostHeap.used);
+   bas_host_line("new");
+   remove(KEYWORD_FILE);
+   fclose(log);
+   return Failed ? 1 : 0;
+}
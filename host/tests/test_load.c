@@ -0,0 +1,135 @@
+/**-----------------------------------------------------------------------------
+ * Copyright (c) 2025 Sergey Sanders
+ * sergey@sesadesign.com
+ * -----------------------------------------------------------------------------
+ * Licensed under Creative Commons Attribution-NonCommercial-ShareAlike 4.0
+ * International (CC BY-NC-SA 4.0).
+ *
+ * You are free to:
+ *  - Share: Copy and redistribute the material.
+ *  - Adapt: Remix, transform, and build upon the material.
+ *
+ * Under the following terms:
+ *  - Attribution: Give appropriate credit and indicate changes.
+ *  - NonCommercial: Do not use for commercial purposes.
+ *  - ShareAlike: Distribute under the same license.
+ *
+ * DISCLAIMER: This work is provided "as is" without any guarantees. The authors
+ * aren’t responsible for any issues, damages, or claims that come up from using
+ * it. Use at your own risk!
+ *
+ * Full license: http://creativecommons.org/licenses/by-nc-sa/4.0/
+ * ---------------------------------------------------------------------------*/
+/**
+ * @file test_load.c
+ * @brief File backed LOAD of a large program, in line number order and shuffled
+ *
+ * test_load [lines]
+ *
+ * Line N adds N to a sum and the last line prints it, so a run checks that
+ * every line is there with its text. The ascending file has no final new
+ * line. The shuffled file takes the sorted insert for every line, its time
+ * is reported next to the append of the ascending one.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include "freeRTOS.h"
+#include "host.h"
+#include "basic_host.h"
+#include "bcore.h"
+
+#define LOAD_LINES 2000 // without the argument
+#define LOAD_FILE "load.bas"
+
+static uint32_t Failed;
+static uint32_t XorshiftState = 2463534242UL;
+
+#define CHECK(cond, ...)           \
+   if (!(cond))                    \
+   {                               \
+      printf(__VA_ARGS__);         \
+      putchar('\n');               \
+      Failed++;                    \
+   }
+
+static uint32_t xorshift(uint32_t range)
+{
+   XorshiftState ^= XorshiftState << 13;
+   XorshiftState ^= XorshiftState >> 17;
+   XorshiftState ^= XorshiftState << 5;
+   return XorshiftState % range;
+}
+
+/** Lines 10, 20... in "order", the print line last in the file */
+static void write_program(uint16_t *order, uint32_t lines)
+{
+   FILE *prog = fopen(LOAD_FILE, "w");
+   for (uint32_t i = 0; i < lines; i++)
+      fprintf(prog, "%u s.i=s.i+%u\n", order[i] * 10, order[i]);
+   fprintf(prog, "%u print \"sum \";s.i", (lines + 1) * 10);
+   fclose(prog);
+}
+
+/** LOAD and RUN, the time of the LOAD in us */
+static uint64_t load_run(FILE *log, uint32_t lines, const char *title)
+{
+   char str[128], expect[32];
+   uint32_t count = 0;
+   uint16_t last = 0;
+   bool found = false;
+
+   bas_host_line("new");
+   rewind(log);
+   uint64_t start = host_time_us();
+   bas_host_load(LOAD_FILE);
+   uint64_t time = host_time_us() - start;
+   CHECK(!BasicError, "%s: LOAD error %d", title, BasicError);
+   for (_bas_line_t *line = BasicProg; line; line = line->next, count++)
+   {
+      CHECK(line->number > last, "%s: line %u after %u", title, line->number, last);
+      last = line->number;
+   }
+   CHECK(count == lines + 1, "%s: %u lines loaded of %u", title, count, lines + 1);
+   bas_host_line("s.i=0");
+   bas_host_line("run");
+   bas_host_flush();
+   fflush(log);
+   rewind(log);
+   snprintf(expect, sizeof(expect), "sum %u", lines * (lines + 1) / 2);
+   while (fgets(str, sizeof(str), log))
+      found |= !strncmp(str, expect, strlen(expect));
+   CHECK(found, "%s: no \"%s\" in the run", title, expect);
+   printf("%s LOAD of %u lines: %.2f ms, %.2f us a line\n", title, lines + 1, time / 1000.0, (double)time / (lines + 1));
+   return time;
+}
+
+int main(int argc, char **argv)
+{
+   uint32_t lines = argc > 1 ? strtoul(argv[1], NULL, 0) : LOAD_LINES;
+   uint16_t *order = malloc(lines * sizeof(uint16_t));
+   FILE *log = tmpfile();
+
+   bas_host_output(log);
+   bas_host_init();
+   for (uint32_t i = 0; i < lines; i++)
+      order[i] = i + 1;
+   write_program(order, lines);
+   load_run(log, lines, "ascending");
+   printf("heap: %u of %u bytes in use\n", HostHeap.used, configTOTAL_HEAP_SIZE);
+   for (uint32_t i = lines - 1; i; i--)
+   {
+      uint32_t j = xorshift(i + 1);
+      uint16_t tmp = order[i];
+      order[i] = order[j];
+      order[j] = tmp;
+   }
+   write_program(order, lines);
+   load_run(log, lines, "shuffled");
+   bas_host_line("new");
+   remove(LOAD_FILE);
+   free(order);
+   fclose(log);
+   return Failed ? 1 : 0;
+}
@@ -0,0 +1,143 @@
+/**-----------------------------------------------------------------------------
+ * Copyright (c) 2025 Sergey Sanders
+ * sergey@sesadesign.com
+ * -----------------------------------------------------------------------------
+ * Licensed under Creative Commons Attribution-NonCommercial-ShareAlike 4.0
+ * International (CC BY-NC-SA 4.0).
+ *
+ * You are free to:
+ *  - Share: Copy and redistribute the material.
+ *  - Adapt: Remix, transform, and build upon the material.
+ *
+ * Under the following terms:
+ *  - Attribution: Give appropriate credit and indicate changes.
+ *  - NonCommercial: Do not use for commercial purposes.
+ *  - ShareAlike: Distribute under the same license.
+ *
+ * DISCLAIMER: This work is provided "as is" without any guarantees. The authors
+ * aren’t responsible for any issues, damages, or claims that come up from using
+ * it. Use at your own risk!
+ *
+ * Full license: http://creativecommons.org/licenses/by-nc-sa/4.0/
+ * ---------------------------------------------------------------------------*/
+/**
+ * @file test_print.c
+ * @brief PRINT through the block write of basicStream against a character at a time
+ *
+ * test_print [lines]
+ *
+ * A PRINT loop runs three times: with basicStream as it is, with its write
+ * entry removed so that every character goes through putch, and with both
+ * entries replaced by a stub that only counts. The calls and the characters
+ * are counted on the way to the terminal, the two terminal transcripts must
+ * be the same.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include "host.h"
+#include "basic_host.h"
+#include "bedit.h"
+
+#define PRINT_LINES 10000 // lines printed without the argument
+
+static uint32_t Failed;
+
+#define CHECK(cond, ...)           \
+   if (!(cond))                    \
+   {                               \
+      printf(__VA_ARGS__);         \
+      putchar('\n');               \
+      Failed++;                    \
+   }
+
+typedef enum
+{
+   PRINT_WRITE,
+   PRINT_PUTCH,
+   PRINT_STUB,
+} _print_mode_e;
+
+static const char *PrintMode[] = {"write", "putch", "stub"};
+
+static struct
+{
+   void (*putch)(char);
+   void (*write)(const char *, uint16_t);
+   uint32_t putchCalls;
+   uint32_t writeCalls;
+   uint32_t chars;
+   bool stub; // count only, nothing reaches the terminal
+} Count;
+
+static void count_putch(char cc)
+{
+   Count.putchCalls++;
+   Count.chars++;
+   if (!Count.stub) Count.putch(cc);
+}
+
+static void count_write(const char *buf, uint16_t len)
+{
+   Count.writeCalls++;
+   Count.chars += len;
+   if (!Count.stub) Count.write(buf, len);
+}
+
+/** Run the loop with the stream in "mode", the transcript is returned malloc'ed */
+static char *print_run(_print_mode_e mode, uint32_t lines)
+{
+   FILE *out = tmpfile();
+   char cmd[64];
+   long size;
+   char *text;
+
+   bas_host_output(out);
+   basicStream.putch = count_putch;
+   basicStream.write = (mode == PRINT_PUTCH) ? NULL : count_write;
+   Count.stub = (mode == PRINT_STUB);
+   Count.putchCalls = Count.writeCalls = Count.chars = 0;
+   snprintf(cmd, sizeof(cmd), "10 for i.i=1 to %u: print \"line \";i.i;\" of \";%u: next i.i", lines, lines);
+   bas_host_line(cmd);
+   uint64_t start = host_time_us();
+   bas_host_line("run");
+   uint64_t time = host_time_us() - start;
+   basicStream.putch = Count.putch;
+   basicStream.write = Count.write;
+   bas_host_flush();
+   printf("%s: %.2f ms, %u putch and %u write calls for %u characters\n", PrintMode[mode], time / 1000.0,
+          Count.putchCalls, Count.writeCalls, Count.chars);
+   size = ftell(out);
+   text = calloc(1, size + 1);
+   rewind(out);
+   if (fread(text, 1, size, out) != (size_t)size)
+      *text = '\0';
+   fclose(out);
+   return text;
+}
+
+int main(int argc, char **argv)
+{
+   uint32_t lines = argc > 1 ? strtoul(argv[1], NULL, 0) : PRINT_LINES;
+   char *text[3];
+
+   bas_host_init();
+   Count.putch = basicStream.putch;
+   Count.write = basicStream.write;
+   CHECK(Count.write, "basicStream has no write entry");
+   for (_print_mode_e mode = PRINT_WRITE; mode <= PRINT_STUB; mode++)
+   {
+      text[mode] = print_run(mode, lines);
+      if (mode == PRINT_WRITE)
+         CHECK(Count.writeCalls >= lines, "%u write calls for %u PRINTs", Count.writeCalls, lines);
+      if (mode == PRINT_PUTCH)
+         CHECK(!Count.writeCalls, "write called with no write entry");
+   }
+   CHECK(!strcmp(text[PRINT_WRITE], text[PRINT_PUTCH]), "the transcripts differ");
+   CHECK(strstr(text[PRINT_WRITE], "line 1 of ") && strstr(text[PRINT_WRITE], "Done"), "no output\n%s",
+         text[PRINT_WRITE]);
+   for (_print_mode_e mode = PRINT_WRITE; mode <= PRINT_STUB; mode++)
+      free(text[mode]);
+   return Failed ? 1 : 0;
+}
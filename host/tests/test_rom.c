@@ -0,0 +1,153 @@
+/**-----------------------------------------------------------------------------
+ * Copyright (c) 2025 Sergey Sanders
+ * sergey@sesadesign.com
+ * -----------------------------------------------------------------------------
+ * Licensed under Creative Commons Attribution-NonCommercial-ShareAlike 4.0
+ * International (CC BY-NC-SA 4.0).
+ *
+ * You are free to:
+ *  - Share: Copy and redistribute the material.
+ *  - Adapt: Remix, transform, and build upon the material.
+ *
+ * Under the following terms:
+ *  - Attribution: Give appropriate credit and indicate changes.
+ *  - NonCommercial: Do not use for commercial purposes.
+ *  - ShareAlike: Distribute under the same license.
+ *
+ * DISCLAIMER: This work is provided "as is" without any guarantees. The authors
+ * aren’t responsible for any issues, damages, or claims that come up from using
+ * it. Use at your own risk!
+ *
+ * Full license: http://creativecommons.org/licenses/by-nc-sa/4.0/
+ * ---------------------------------------------------------------------------*/
+/**
+ * @file test_rom.c
+ * @brief ROM programs run in place from the flash tables the same as from their text
+ *
+ * test_rom [lines]
+ *
+ * Every ROM program is LOADed twice: in place from its bprog_rom_tok.c table,
+ * and from its text, merged into a program that is not empty so that the
+ * tokenizer takes it. The lines must be equal byte for byte, and a run of
+ * each, from the same RND seed and keys, must leave the same terminal output
+ * and LCD. The program arena bytes and the time of both LOADs are reported.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <unistd.h>
+#include "host.h"
+#include "basic_host.h"
+#include "bcore.h"
+#include "bfunc.h"
+#include "bprog_rom.h"
+#include "lcd.h"
+#include "uterm.h"
+
+#define ROM_LINES 20000 // lines run without the argument
+
+static uint32_t Failed;
+
+#define CHECK(cond, ...)           \
+   if (!(cond))                    \
+   {                               \
+      printf(__VA_ARGS__);         \
+      putchar('\n');               \
+      Failed++;                    \
+   }
+
+typedef struct
+{
+   char *out;       // terminal output, malloc'ed
+   uint8_t *lcd;    // HostLcd at the end, malloc'ed
+   uint32_t bytes;  // program arena bytes the LOAD took
+   uint64_t loadUs; // time of the LOAD
+} _rom_run_t;
+
+/** LOAD ROM "index", in place or from its text, then run "lines" lines of it with "keys" typed */
+static void rom_run(uint8_t index, const char *keys, bool text, uint32_t lines, _rom_run_t *run)
+{
+   FILE *out = tmpfile();
+   char name[4];
+   long size;
+
+   bas_host_output(out);
+   bas_host_line("new");
+   uint32_t used = ProgArena.used;
+   if (text)
+      bas_host_line("1 rem"); // LOAD merges into it from the text
+   snprintf(name, sizeof(name), "%u", index);
+   uint64_t start = host_time_us();
+   bas_host_load(name);
+   run->loadUs = host_time_us() - start;
+   if (text)
+      bas_host_line("1");
+   run->bytes = ProgArena.used - used;
+   fflush(out);
+   fseek(out, 0, SEEK_SET);
+   if (ftruncate(fileno(out), 0)) // the LOAD message has the time in it
+      CHECK(false, "ROM %u: no transcript", index);
+   memset(HostLcd, 0, FB_SIZE);
+   text_cls();
+   bas_host_keys(keys);
+   bas_host_line("randomize 1");
+   bas_host_break(lines);
+   bas_host_line("run");
+   bas_host_break(0);
+   bas_host_flush();
+   size = ftell(out);
+   run->out = calloc(1, size + 1);
+   rewind(out);
+   if (fread(run->out, 1, size, out) != (size_t)size)
+      *run->out = '\0';
+   fclose(out);
+   run->lcd = malloc(FB_SIZE);
+   memcpy(run->lcd, HostLcd, FB_SIZE);
+}
+
+/** The lines in memory against the ROM table */
+static void rom_compare_lines(uint8_t index, const _bas_line_t *rom)
+{
+   const _bas_line_t *line = BasicProg;
+   for (; line && rom; line = line->next, rom = rom->next)
+      CHECK((line->number == rom->number) && (line->len == rom->len) && (line->stmtCount == rom->stmtCount) &&
+                !memcmp(line->stmtOffset, rom->stmtOffset, rom->stmtCount) && // the rest is not set in the heap copy
+                !strcmp((char *)line->string, (char *)rom->string),
+            "ROM %u: line %u differs from the table", index, rom->number);
+   CHECK(!line && !rom, "ROM %u: the table and the text have different line counts", index);
+}
+
+int main(int argc, char **argv)
+{
+   static const _bas_rom_t *rom[3] = {&ROM_bounce, &ROM_ctree, &ROM_snake};
+   static const char *keys[3] = {"", "12\r", "3\r"}; // the tree size, the snake's starting level
+   uint32_t lines = argc > 1 ? strtoul(argv[1], NULL, 0) : ROM_LINES;
+   FILE *devNull = fopen("/dev/null", "w");
+
+   bas_host_output(devNull);
+   bas_host_init();
+   CHECK(ROM_LinesSignature == bas_func_signature(), "the ROM tables are stale: %08X, the keywords %08X, run romtok",
+         ROM_LinesSignature, bas_func_signature());
+   for (uint8_t index = 0; index < 3; index++)
+   {
+      _rom_run_t flash, text;
+      rom_run(index, keys[index], false, lines, &flash);
+      rom_run(index, keys[index], true, lines, &text);
+      rom_compare_lines(index, rom[index]->lines);
+      CHECK(!strcmp(flash.out, text.out), "%s: the terminal output differs\n%s\n---\n%s", rom[index]->name, flash.out,
+            text.out);
+      CHECK(!memcmp(flash.lcd, text.lcd, FB_SIZE), "%s: the LCD differs", rom[index]->name);
+      CHECK(!flash.bytes, "%s: %u bytes of program arena in place", rom[index]->name, flash.bytes);
+      printf("%s: in place %u bytes, %.1f us; from the text %u bytes, %.1f us\n", rom[index]->name, flash.bytes,
+             (double)flash.loadUs, text.bytes, (double)text.loadUs);
+      free(flash.out);
+      free(flash.lcd);
+      free(text.out);
+      free(text.lcd);
+   }
+   bas_host_output(devNull);
+   bas_host_line("new");
+   fclose(devNull);
+   return Failed ? 1 : 0;
+}
@@ -0,0 +1,167 @@
+/**-----------------------------------------------------------------------------
+ * Copyright (c) 2025 Sergey Sanders
+ * sergey@sesadesign.com
+ * -----------------------------------------------------------------------------
+ * Licensed under Creative Commons Attribution-NonCommercial-ShareAlike 4.0
+ * International (CC BY-NC-SA 4.0).
+ *
+ * You are free to:
+ *  - Share: Copy and redistribute the material.
+ *  - Adapt: Remix, transform, and build upon the material.
+ *
+ * Under the following terms:
+ *  - Attribution: Give appropriate credit and indicate changes.
+ *  - NonCommercial: Do not use for commercial purposes.
+ *  - ShareAlike: Distribute under the same license.
+ *
+ * DISCLAIMER: This work is provided "as is" without any guarantees. The authors
+ * aren’t responsible for any issues, damages, or claims that come up from using
+ * it. Use at your own risk!
+ *
+ * Full license: http://creativecommons.org/licenses/by-nc-sa/4.0/
+ * ---------------------------------------------------------------------------*/
+/**
+ * @file test_save.c
+ * @brief SAVE and LOAD through the text and the tokenized (.bdb) formats must LIST the same program
+ *
+ * test_save
+ *
+ * Each program is listed, saved as .bdb, loaded back and listed, then saved
+ * as text from there, loaded back and listed again. The three listings must
+ * match. The ROM programs and a generated program with strings, remarks and
+ * every kind of statement go round. The file sizes and the LOAD times of the
+ * two formats are reported.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include "host.h"
+#include "basic_host.h"
+#include "bcore.h"
+
+#define SAVE_ROUNDS 20 // LOADs of each format while timing
+#define SAVE_TEXT "round.bas"
+#define SAVE_BIN "round.bdb"
+
+static uint32_t Failed;
+static FILE *Log;
+
+#define CHECK(cond, ...)           \
+   if (!(cond))                    \
+   {                               \
+      printf(__VA_ARGS__);         \
+      putchar('\n');               \
+      Failed++;                    \
+   }
+
+static const char *Program[] = {
+    "10 rem every kind of statement, \"quoted\" text: and colons",
+    "20 dim a[10], s$[4,16]: def fn f(x)=x*x+1",
+    "30 for i=0 to 9 step 1: a[i]=fn f(i): next i",
+    "40 s$[0]=\"a:b\": s$[1]=left$(\"hello\",2)+mid$(\"xyz\",2,1)",
+    "50 if a[3]>5 and not a[1]<>2 then print \"yes\";: goto 70",
+    "60 on i.i gosub 100,110: print hex$(255);bin$(5)",
+    "70 while i>0: i=i-1: wend: repeat: i=i+1: until i>=3",
+    "80 mat a=a*2: print sum(a);imax(a);sin(pi/4);-1.5e3",
+    "90 plot 1,2: draw 3,4: circle 10,10,5: ink 3: paper 0: stop",
+    "100 return",
+    "110 print \"   spaces   \";: return",
+};
+
+/** The LIST of the program in memory, malloc'ed */
+static char *listing(void)
+{
+   FILE *out = tmpfile();
+   long size;
+   char *str;
+   bas_host_flush();
+   bas_host_output(out);
+   bas_host_line("list");
+   bas_host_flush();
+   bas_host_output(Log);
+   size = ftell(out);
+   str = calloc(1, size + 1);
+   rewind(out);
+   if (fread(str, 1, size, out) != (size_t)size)
+      *str = '\0';
+   fclose(out);
+   return str;
+}
+
+static long file_size(const char *name)
+{
+   FILE *file = fopen(name, "rb");
+   long size = -1;
+   if (file)
+   {
+      fseek(file, 0, SEEK_END);
+      size = ftell(file);
+      fclose(file);
+   }
+   return size;
+}
+
+/** us per LOAD of "name" */
+static double load_us(const char *name)
+{
+   uint64_t start = host_time_us();
+   for (uint8_t i = 0; i < SAVE_ROUNDS; i++)
+   {
+      bas_host_line("new");
+      bas_host_load(name);
+   }
+   return (double)(host_time_us() - start) / SAVE_ROUNDS;
+}
+
+/** The program in memory through both formats */
+static void round_trip(const char *title)
+{
+   char *text = listing(), *bin, *again;
+   CHECK(strlen(text) > 0, "%s: empty listing", title);
+   remove(SAVE_BIN);
+   remove(SAVE_TEXT);
+   bas_host_line("save \"" SAVE_BIN "\"");
+   CHECK(!BasicError, "%s: SAVE .bdb error %d", title, BasicError);
+   bas_host_line("new");
+   bas_host_load(SAVE_BIN);
+   CHECK(!BasicError, "%s: LOAD .bdb error %d", title, BasicError);
+   bin = listing();
+   CHECK(!strcmp(text, bin), "%s: the .bdb listing differs\n%s\n---\n%s", title, text, bin);
+   bas_host_line("save \"" SAVE_TEXT "\"");
+   CHECK(!BasicError, "%s: SAVE text error %d", title, BasicError);
+   bas_host_line("new");
+   bas_host_load(SAVE_TEXT);
+   CHECK(!BasicError, "%s: LOAD text error %d", title, BasicError);
+   again = listing();
+   CHECK(!strcmp(text, again), "%s: the text listing differs\n%s\n---\n%s", title, text, again);
+   double textUs = load_us(SAVE_TEXT), binUs = load_us(SAVE_BIN);
+   printf("%s: text %ld bytes, LOAD %.1f us; .bdb %ld bytes, LOAD %.1f us\n", title, file_size(SAVE_TEXT), textUs,
+          file_size(SAVE_BIN), binUs);
+   bas_host_line("new");
+   free(text);
+   free(bin);
+   free(again);
+}
+
+int main(void)
+{
+   char title[16];
+   Log = fopen("/dev/null", "w");
+   bas_host_output(Log);
+   bas_host_init();
+   for (uint8_t rom = 0; rom < 3; rom++)
+   {
+      snprintf(title, sizeof(title), "%u", rom);
+      bas_host_load(title);
+      snprintf(title, sizeof(title), "ROM %u", rom);
+      round_trip(title);
+   }
+   for (uint8_t line = 0; line < sizeof(Program) / sizeof(Program[0]); line++)
+      bas_host_line(Program[line]);
+   round_trip("statements");
+   remove(SAVE_BIN);
+   remove(SAVE_TEXT);
+   fclose(Log);
+   return Failed ? 1 : 0;
+}
@@ -0,0 +1,136 @@
+/**-----------------------------------------------------------------------------
+ * Copyright (c) 2025 Sergey Sanders
+ * sergey@sesadesign.com
+ * -----------------------------------------------------------------------------
+ * Licensed under Creative Commons Attribution-NonCommercial-ShareAlike 4.0
+ * International (CC BY-NC-SA 4.0).
+ *
+ * You are free to:
+ *  - Share: Copy and redistribute the material.
+ *  - Adapt: Remix, transform, and build upon the material.
+ *
+ * Under the following terms:
+ *  - Attribution: Give appropriate credit and indicate changes.
+ *  - NonCommercial: Do not use for commercial purposes.
+ *  - ShareAlike: Distribute under the same license.
+ *
+ * DISCLAIMER: This work is provided "as is" without any guarantees. The authors
+ * aren’t responsible for any issues, damages, or claims that come up from using
+ * it. Use at your own risk!
+ *
+ * Full license: http://creativecommons.org/licenses/by-nc-sa/4.0/
+ * ---------------------------------------------------------------------------*/
+/**
+ * @file test_threads.c
+ * @brief Several machines in one process: each thread runs its own context
+ *
+ * The machines run the test ROM alone, the .sna and the .z80 snapshot in turn. Every machine
+ * is run once on the main thread and once with all of them on their own threads, the frame
+ * hashes of both runs must match.
+ * usage: test_threads dir [machines]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include "bsp.h"
+#include "host.h"
+#include "lcd.h"
+#include "zx80sys.h"
+#include "zxscreen.h"
+
+#define THREADS_MAX 64
+#define THREADS_FRAMES 200
+
+typedef struct
+{
+   Z80_CONTEXT *ctx;
+   uint8_t *fb;
+   uint32_t hash; // FNV-1a of all frames
+} _run_t;
+
+static const char *Snapshots[] = {NULL, "zxtest.sna", "zxtest.z80"};
+
+static void *run_machine(void *arg)
+{
+   _run_t *run = arg;
+   run->hash = 2166136261UL;
+   for (uint32_t frame = 0; frame < THREADS_FRAMES; frame++)
+   {
+      zx_run_frame(run->ctx);
+      zx_render_frame(run->ctx, run->fb);
+      for (uint32_t i = 0; i < FB_SIZE; i++)
+         run->hash = (run->hash ^ run->fb[i]) * 16777619UL;
+   }
+   return NULL;
+}
+
+/** New machines, created on the main thread before any of them runs */
+static bool machines_new(_run_t *runs, uint32_t count, const char *dir)
+{
+   char path[FILENAME_MAX];
+   for (uint32_t i = 0; i < count; i++)
+   {
+      runs[i].ctx = zx_host_new();
+      runs[i].fb = malloc(FB_SIZE);
+      snprintf(path, sizeof(path), "%s/zxtest.rom", dir);
+      if (host_load(path, runs[i].ctx->mem, ROM_SIZE) != ROM_SIZE)
+         return false;
+      if (Snapshots[i % 3])
+      {
+         snprintf(path, sizeof(path), "%s/%s", dir, Snapshots[i % 3]);
+         if (!zx_host_snapshot(runs[i].ctx, path))
+            return false;
+      }
+   }
+   return true;
+}
+
+static void machines_free(_run_t *runs, uint32_t count)
+{
+   for (uint32_t i = 0; i < count; i++)
+   {
+      free(runs[i].fb);
+      zx_host_free(runs[i].ctx);
+   }
+}
+
+int main(int argc, char **argv)
+{
+   static _run_t single[THREADS_MAX], threaded[THREADS_MAX];
+   pthread_t threads[THREADS_MAX];
+   uint32_t count = argc > 2 ? strtoul(argv[2], NULL, 0) : 8;
+   uint32_t failed = 0;
+   if (argc < 2 || count < 1 || count > THREADS_MAX)
+   {
+      fprintf(stderr, "usage: %s dir [machines 1..%d]\n", argv[0], THREADS_MAX);
+      return 2;
+   }
+   if (!machines_new(single, count, argv[1]) || !machines_new(threaded, count, argv[1]))
+   {
+      fprintf(stderr, "%s: can't load the test ROM or snapshots\n", argv[1]);
+      return 1;
+   }
+   uint64_t start = host_time_us();
+   for (uint32_t i = 0; i < count; i++)
+      run_machine(&single[i]);
+   uint64_t singleTime = host_time_us() - start;
+   start = host_time_us();
+   for (uint32_t i = 0; i < count; i++)
+      pthread_create(&threads[i], NULL, run_machine, &threaded[i]);
+   for (uint32_t i = 0; i < count; i++)
+      pthread_join(threads[i], NULL);
+   uint64_t threadedTime = host_time_us() - start;
+   for (uint32_t i = 0; i < count; i++)
+   {
+      if (single[i].hash != threaded[i].hash || single[i].hash != single[i % 3].hash)
+      {
+         printf("machine %u: %08x on a thread, %08x alone\n", i, threaded[i].hash, single[i].hash);
+         failed++;
+      }
+   }
+   printf("%u machines x %u frames: %.1f ms in turn, %.1f ms on threads\n", count, THREADS_FRAMES,
+          singleTime / 1000.0, threadedTime / 1000.0);
+   machines_free(single, count);
+   machines_free(threaded, count);
+   return failed != 0;
+}
@@ -0,0 +1,113 @@
+/**-----------------------------------------------------------------------------
+ * Copyright (c) 2025 Sergey Sanders
+ * sergey@sesadesign.com
+ * -----------------------------------------------------------------------------
+ * Licensed under Creative Commons Attribution-NonCommercial-ShareAlike 4.0
+ * International (CC BY-NC-SA 4.0).
+ *
+ * You are free to:
+ *  - Share: Copy and redistribute the material.
+ *  - Adapt: Remix, transform, and build upon the material.
+ *
+ * Under the following terms:
+ *  - Attribution: Give appropriate credit and indicate changes.
+ *  - NonCommercial: Do not use for commercial purposes.
+ *  - ShareAlike: Distribute under the same license.
+ *
+ * DISCLAIMER: This work is provided "as is" without any guarantees. The authors
+ * aren’t responsible for any issues, damages, or claims that come up from using
+ * it. Use at your own risk!
+ *
+ * Full license: http://creativecommons.org/licenses/by-nc-sa/4.0/
+ * ---------------------------------------------------------------------------*/
+/**
+ * @file test_trig.c
+ * @brief SIN/COS/TAN/ATN/SQR: the largest error over the domain and the time of a call
+ *
+ * test_trig [samples]
+ *
+ * The functions are called as BASIC calls them, with the argument in an RPN
+ * value and the result pulled from the queue. The reference is libm in double
+ * precision. The bounds are the ones documented in bmath.c, libm float ones
+ * when BASIC_FAST_MATH is off.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include "basic_compat.h" // math.h first, glibc has its own __sin
+#include "host.h"
+#include "basic_host.h"
+#include "bcore.h"
+#include "bmath.h"
+
+#define TRIG_SAMPLES 200000 // arguments over each domain
+#define TRIG_CALLS 1000000  // calls while timing
+
+static uint32_t Failed;
+
+#define CHECK(cond, ...)           \
+   if (!(cond))                    \
+   {                               \
+      printf(__VA_ARGS__);         \
+      putchar('\n');               \
+      Failed++;                    \
+   }
+
+typedef struct
+{
+   const char *name;
+   _bas_err_e (*func)(_rpn_type_t *param);
+   double (*ref)(double x);
+   double from, to;
+   double bound;  // absolute error, relative for TAN and SQR
+   bool relative;
+} _trig_case_t;
+
+static const _trig_case_t TrigCase[] = {
+    {"sin", __sin, sin, -BASIC_SIN_LIMIT, BASIC_SIN_LIMIT, 2e-5, false},
+    {"cos", __cos, cos, -BASIC_SIN_LIMIT, BASIC_SIN_LIMIT, 2e-5, false},
+    {"sin", __sin, sin, BASIC_SIN_LIMIT, 1000.0, 1e-6, false}, // past the table
+    {"tan", __tan, tan, -1.47, 1.47, 2e-4, true},              // |cos| > 0.1, the sin error over cos
+    {"atn", __atn, atan, -1000.0, 1000.0, 1.2e-5, false},
+    {"sqr", __sqr, sqrt, 0.0, 1e6, 1.2e-7, true},
+};
+
+static float call(_bas_err_e (*func)(_rpn_type_t *param), float x)
+{
+   _rpn_type_t param = RPN_FLOAT(x);
+   func(&param);
+   return rpn_pull_queue()->var.f;
+}
+
+int main(int argc, char **argv)
+{
+   uint32_t samples = argc > 1 ? strtoul(argv[1], NULL, 0) : TRIG_SAMPLES;
+   bas_host_init();
+   for (uint8_t i = 0; i < sizeof(TrigCase) / sizeof(TrigCase[0]); i++)
+   {
+      const _trig_case_t *c = &TrigCase[i];
+      double worst = 0, at = c->from, step = (c->to - c->from) / samples;
+      for (uint32_t n = 0; n <= samples; n++)
+      {
+         float x = c->from + step * n;
+         double ref = c->ref(x), err = fabs(call(c->func, x) - ref);
+         if (c->relative && ref) err /= fabs(ref);
+         if (err > worst)
+         {
+            worst = err;
+            at = x;
+         }
+      }
+      volatile float sink = 0;
+      uint64_t start = host_time_us();
+      for (uint32_t n = 0; n < TRIG_CALLS; n++)
+         sink += call(c->func, c->from + (c->to - c->from) * (n & 1023) / 1024);
+      double ns = (host_time_us() - start) * 1000.0 / TRIG_CALLS;
+      start = host_time_us();
+      for (uint32_t n = 0; n < TRIG_CALLS; n++)
+         sink += c->ref(c->from + (c->to - c->from) * (n & 1023) / 1024);
+      printf("%s [%g, %g]: %s error %.2e at %g, %.1f ns a call, libm double %.1f ns\n", c->name, c->from, c->to,
+             c->relative ? "relative" : "absolute", worst, at, ns, (host_time_us() - start) * 1000.0 / TRIG_CALLS);
+      CHECK(worst <= c->bound, "%s: error %.2e over %.2e", c->name, worst, c->bound);
+   }
+   return Failed ? 1 : 0;
+}
@@ -0,0 +1,26 @@
+# Run zxrun and check its output.
+#   GOLDEN - the frame hashes must match this file
+#   PPM    - two frames are saved with this prefix, the files must be complete P6 images
+if(PPM)
+  execute_process(COMMAND ${ZXRUN} -n 2 -o ${PPM} ${ROM} RESULT_VARIABLE rc)
+  if(rc)
+    message(FATAL_ERROR "zxrun failed: ${rc}")
+  endif()
+  foreach(frame 0000 0001)
+    file(SIZE ${PPM}${frame}.ppm size)
+    if(NOT size EQUAL 230415) # "P6\n320 240\n255\n" + 320 * 240 * 3
+      message(FATAL_ERROR "${PPM}${frame}.ppm: ${size} bytes")
+    endif()
+  endforeach()
+  return()
+endif()
+
+execute_process(COMMAND ${ZXRUN} -n 100 ${ROM} ${SNAP} OUTPUT_VARIABLE out RESULT_VARIABLE rc)
+if(rc)
+  message(FATAL_ERROR "zxrun failed: ${rc}")
+endif()
+file(READ ${GOLDEN} golden)
+if(NOT out STREQUAL golden)
+  file(WRITE ${CMAKE_CURRENT_BINARY_DIR}/zxrun.out "${out}")
+  message(FATAL_ERROR "frame hashes differ from ${GOLDEN}, see ${CMAKE_CURRENT_BINARY_DIR}/zxrun.out")
+endif()
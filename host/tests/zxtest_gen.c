@@ -0,0 +1,200 @@
+/**-----------------------------------------------------------------------------
+ * Copyright (c) 2025 Sergey Sanders
+ * sergey@sesadesign.com
+ * -----------------------------------------------------------------------------
+ * Licensed under Creative Commons Attribution-NonCommercial-ShareAlike 4.0
+ * International (CC BY-NC-SA 4.0).
+ *
+ * You are free to:
+ *  - Share: Copy and redistribute the material.
+ *  - Adapt: Remix, transform, and build upon the material.
+ *
+ * Under the following terms:
+ *  - Attribution: Give appropriate credit and indicate changes.
+ *  - NonCommercial: Do not use for commercial purposes.
+ *  - ShareAlike: Distribute under the same license.
+ *
+ * DISCLAIMER: This work is provided "as is" without any guarantees. The authors
+ * aren’t responsible for any issues, damages, or claims that come up from using
+ * it. Use at your own risk!
+ *
+ * Full license: http://creativecommons.org/licenses/by-nc-sa/4.0/
+ * ---------------------------------------------------------------------------*/
+/**
+ * @file zxtest_gen.c
+ * @brief Writes the zxrun test machine: zxtest.rom, zxtest.sna and zxtest.z80, and the aywav dump zxtest.psg
+ *
+ * The ROM clears the screen, sets every attribute to its address' low byte, so
+ * all the ink/paper/bright/flash combinations are shown, and waits for interrupts.
+ * The IM 1 handler steps the border colour and draws a byte a frame.
+ * The snapshots hold the same machine: it runs INC (HL) over the middle third
+ * of the screen, so the picture depends on the contended timing as well.
+ * The register dump plays a tone, enveloped noise and a chord for about a second each.
+ */
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include "bsp.h"
+#include "zx80sys.h"
+#include "snapshot.h"
+
+static const uint8_t TestRom[] = {
+    0xf3,             // 0000 DI
+    0x31, 0x00, 0x00, // 0001 LD SP,0x0000
+    0xed, 0x56,       // 0004 IM 1
+    0x21, 0x00, 0x40, // 0006 LD HL,0x4000
+    0x11, 0x01, 0x40, // 0009 LD DE,0x4001
+    0x01, 0xff, 0x17, // 000C LD BC,0x17FF
+    0x36, 0x00,       // 000F LD (HL),0
+    0xed, 0xb0,       // 0011 LDIR
+    0x21, 0x00, 0x58, // 0013 LD HL,0x5800
+    0x01, 0x00, 0x03, // 0016 LD BC,0x0300
+    0x75,             // 0019 LD (HL),L
+    0x23,             // 001A INC HL
+    0x0b,             // 001B DEC BC
+    0x78,             // 001C LD A,B
+    0xb1,             // 001D OR C
+    0x20, 0xf9,       // 001E JR NZ,0x0019
+    0x21, 0x00, 0x40, // 0020 LD HL,0x4000
+    0x22, 0x01, 0x80, // 0023 LD (0x8001),HL
+    0xaf,             // 0026 XOR A
+    0x32, 0x00, 0x80, // 0027 LD (0x8000),A
+    0xfb,             // 002A EI
+    0x76,             // 002B HALT
+    0x18, 0xfd,       // 002C JR 0x002B
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0xf5,             // 0038 PUSH AF
+    0xe5,             // 0039 PUSH HL
+    0x3a, 0x00, 0x80, // 003A LD A,(0x8000)
+    0x3c,             // 003D INC A
+    0x32, 0x00, 0x80, // 003E LD (0x8000),A
+    0xe6, 0x07,       // 0041 AND 7
+    0xd3, 0xfe,       // 0043 OUT (0xFE),A
+    0x2a, 0x01, 0x80, // 0045 LD HL,(0x8001)
+    0x36, 0xaa,       // 0048 LD (HL),0xAA
+    0x23,             // 004A INC HL
+    0x22, 0x01, 0x80, // 004B LD (0x8001),HL
+    0xe1,             // 004E POP HL
+    0xf1,             // 004F POP AF
+    0xfb,             // 0050 EI
+    0xc9,             // 0051 RET
+};
+
+static const uint8_t TestProg[] = {
+    0x21, 0x00, 0x48, // 8100 LD HL,0x4800
+    0x34,             // 8103 INC (HL)
+    0x2c,             // 8104 INC L
+    0x20, 0xfc,       // 8105 JR NZ,0x8103
+    0x24,             // 8107 INC H
+    0x7c,             // 8108 LD A,H
+    0xfe, 0x50,       // 8109 CP 0x50
+    0x20, 0xf6,       // 810B JR NZ,0x8103
+    0x18, 0xf1,       // 810D JR 0x8100
+};
+#define TEST_PROG 0x8100
+#define TEST_SP   0xff00 // SP after the .sna "RETN"
+
+static uint8_t ram[0xc000]; // 0x4000-0xffff
+
+/// PSG register dump: reg, value pairs, 0xff ends a frame, 0xfe n skips n * 4 frames, 0xfd ends the dump
+static const uint8_t TestPsg[] = {
+    'P', 'S', 'G', 0x1a, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    7, 0x3e, 0, 0x00, 1, 0x01, 8, 0x0f, 0xff,                       // tone A, period 256
+    0xfe, 12,
+    7, 0x1f, 8, 0x00, 6, 0x10, 10, 0x10, 11, 0x00, 12, 0x08,       // noise C, triangle envelope
+    13, 0x0e, 0xff,
+    0xfe, 12,
+    7, 0x38, 0, 0xfc, 1, 0x00, 2, 0x50, 3, 0x01, 4, 0x1c, 5, 0x01,  // tones A, B and C
+    8, 0x0c, 9, 0x0a, 10, 0x08, 0xff,
+    0xfe, 12, 0xfd};
+
+static bool write_file(const char *dir, const char *name, const void *hdr, size_t hdrSize, const void *data, size_t size)
+{
+   char path[FILENAME_MAX];
+   FILE *f;
+   bool ok;
+   snprintf(path, sizeof(path), "%s/%s", dir, name);
+   if (!(f = fopen(path, "wb")))
+      return false;
+   ok = (fwrite(hdr, 1, hdrSize, f) == hdrSize) && (!size || fwrite(data, 1, size, f) == size);
+   return (fclose(f) == 0) && ok;
+}
+
+/** .z80 compression: a run of 5 or more bytes, or of 2 or more 0xed, is ED ED count byte.
+ *  The byte after a single 0xed is never the start of a run. */
+static size_t z80_compress(uint8_t *dst, const uint8_t *src, size_t size)
+{
+   size_t n = 0;
+   for (size_t i = 0; i < size;)
+   {
+      size_t run = 1;
+      while (i + run < size && run < 255 && src[i + run] == src[i])
+         run++;
+      if (run >= 5 || (src[i] == 0xed && run >= 2))
+      {
+         dst[n++] = 0xed;
+         dst[n++] = 0xed;
+         dst[n++] = (uint8_t)run;
+         dst[n++] = src[i];
+         i += run;
+      }
+      else
+      {
+         dst[n++] = src[i++];
+         if (src[i - 1] == 0xed && i < size)
+            dst[n++] = src[i++];
+      }
+   }
+   dst[n++] = 0x00; // version 1 end marker
+   dst[n++] = 0xed;
+   dst[n++] = 0xed;
+   dst[n++] = 0x00;
+   return n;
+}
+
+int main(int argc, char **argv)
+{
+   static uint8_t rom[ROM_SIZE];
+   static uint8_t packed[sizeof(ram) * 5 / 4 + 4];
+   static _snap_sna_hdr_t sna;
+   _snap_z80_hdr_t z80 = {0};
+   const char *dir = argc > 1 ? argv[1] : ".";
+
+   memcpy(rom, TestRom, sizeof(TestRom));
+
+   for (uint16_t i = 0; i < 0x300; i++) // attributes
+      ram[0x1800 + i] = (uint8_t)(i * 7);
+   ram[0x4001] = 0x00; // 0x8001: the interrupt's draw pointer, bottom third
+   ram[0x4002] = 0x50;
+   memcpy(&ram[TEST_PROG - 0x4000], TestProg, sizeof(TestProg));
+   ram[TEST_SP - 2 - 0x4000] = TEST_PROG & 0xff; // return address of the .sna "RETN"
+   ram[TEST_SP - 1 - 0x4000] = TEST_PROG >> 8;
+
+   sna.I = 0x3f;
+   sna.IFF = 0x04; // IFF2 set
+   sna.SPL = (TEST_SP - 2) & 0xff;
+   sna.SPH = (TEST_SP - 2) >> 8;
+   sna.IM = 1;
+   sna.border = 2;
+   memcpy(sna.data, ram, sizeof(ram));
+
+   z80.PCL = TEST_PROG & 0xff;
+   z80.PCH = TEST_PROG >> 8;
+   z80.SPL = TEST_SP & 0xff;
+   z80.SPH = TEST_SP >> 8;
+   z80.I = 0x3f;
+   z80.hwCtrl = (2 << 1) | 0x20; // border 2, compressed
+   z80.IE = 1;
+   z80.IFF2 = 1;
+   z80.flags = 1; // IM 1
+
+   if (!write_file(dir, "zxtest.rom", rom, sizeof(rom), NULL, 0) ||
+       !write_file(dir, "zxtest.sna", &sna, sizeof(sna), NULL, 0) ||
+       !write_file(dir, "zxtest.z80", &z80, sizeof(z80), packed, z80_compress(packed, ram, sizeof(ram))) ||
+       !write_file(dir, "zxtest.psg", TestPsg, sizeof(TestPsg), NULL, 0))
+   {
+      fprintf(stderr, "%s: can't write the test files\n", dir);
+      return 1;
+   }
+   return 0;
+}
@@ -0,0 +1,171 @@
+/**-----------------------------------------------------------------------------
+ * Copyright (c) 2025 Sergey Sanders
+ * sergey@sesadesign.com
+ * -----------------------------------------------------------------------------
+ * Licensed under Creative Commons Attribution-NonCommercial-ShareAlike 4.0
+ * International (CC BY-NC-SA 4.0).
+ *
+ * You are free to:
+ *  - Share: Copy and redistribute the material.
+ *  - Adapt: Remix, transform, and build upon the material.
+ *
+ * Under the following terms:
+ *  - Attribution: Give appropriate credit and indicate changes.
+ *  - NonCommercial: Do not use for commercial purposes.
+ *  - ShareAlike: Distribute under the same license.
+ *
+ * DISCLAIMER: This work is provided "as is" without any guarantees. The authors
+ * aren’t responsible for any issues, damages, or claims that come up from using
+ * it. Use at your own risk!
+ *
+ * Full license: http://creativecommons.org/licenses/by-nc-sa/4.0/
+ * ---------------------------------------------------------------------------*/
+/**
+ * @file zxrun.c
+ * @brief Headless ZX Spectrum runner for the host build
+ *
+ * zxrun [-n frames] [-o prefix] [-b] rom [snapshot.z80|snapshot.sna]
+ *
+ * Loads the 48K ROM and a snapshot, runs the machine a frame at a time and
+ * renders every frame with zx_render_frame() into a memory frame buffer. The
+ * CPU does not run while a frame is rendered and the flash phase follows the
+ * frame count, so the same input always gives the same frames.
+ * Each frame's FNV-1a hash is printed as "frame: hash", -o also saves the frames as
+ * prefix0000.ppm..., -b only reports the CPU and render speed.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <getopt.h>
+#include "host.h"
+#include "lcd.h"
+#include "zx80sys.h"
+#include "zxscreen.h"
+#include "snapshot.h"
+
+#define ZXRUN_FRAMES 50 // frames to run without -n
+
+/** FNV-1a hash of the rendered frame */
+static uint32_t frame_hash(const uint8_t *fb)
+{
+   uint32_t hash = 2166136261UL;
+   for (uint32_t i = 0; i < FB_SIZE; i++)
+      hash = (hash ^ fb[i]) * 16777619UL;
+   return hash;
+}
+
+/** Save the RGB332 frame buffer as a binary PPM (P6) file */
+static bool frame_save_ppm(const char *fileName, const uint8_t *fb)
+{
+   FILE *ppmFile;
+   uint8_t line[LCD_WIDTH * 3];
+   bool ok = true;
+   if (!(ppmFile = fopen(fileName, "wb")))
+      return false;
+   fprintf(ppmFile, "P6\n%d %d\n255\n", LCD_WIDTH, LCD_HEIGHT);
+   for (uint16_t y = 0; y < LCD_HEIGHT && ok; y++)
+   {
+      uint8_t *rgb = line;
+      for (uint16_t x = 0; x < LCD_WIDTH; x++, fb++)
+      {
+         *rgb++ = *fb & 0xe0;
+         *rgb++ = (*fb << 3) & 0xe0;
+         *rgb++ = (*fb << 6) & 0xc0;
+      }
+      ok = fwrite(line, 1, sizeof(line), ppmFile) == sizeof(line);
+   }
+   return (fclose(ppmFile) == 0) && ok;
+}
+
+static void usage(void)
+{
+   fprintf(stderr, "usage: zxrun [-n frames] [-o ppm_prefix] [-b] rom [snapshot.z80|snapshot.sna]\n"
+                   "  -n, --frames N  frames to run (%d)\n"
+                   "  -o, --ppm NAME  save the frames as NAME0000.ppm...\n"
+                   "  -b, --bench     report the speed only\n",
+           ZXRUN_FRAMES);
+}
+
+int main(int argc, char **argv)
+{
+   static const struct option options[] = {
+       {"frames", required_argument, NULL, 'n'},
+       {"ppm", required_argument, NULL, 'o'},
+       {"bench", no_argument, NULL, 'b'},
+       {"help", no_argument, NULL, 'h'},
+       {NULL, 0, NULL, 0}};
+   uint32_t frames = ZXRUN_FRAMES;
+   char *ppmName = NULL;
+   bool bench = false;
+   int opt;
+   while ((opt = getopt_long(argc, argv, "n:o:bh", options, NULL)) != -1)
+   {
+      switch (opt)
+      {
+      case 'n':
+         frames = strtoul(optarg, NULL, 0);
+         break;
+      case 'o':
+         ppmName = optarg;
+         break;
+      case 'b':
+         bench = true;
+         break;
+      default:
+         usage();
+         return opt == 'h' ? 0 : 2;
+      }
+   }
+   if (optind >= argc || argc - optind > 2)
+   {
+      usage();
+      return 2;
+   }
+
+   Z80_CONTEXT *ctx = zx_host_new();
+   if (host_load(argv[optind], ctx->mem, ROM_SIZE) != ROM_SIZE)
+   {
+      fprintf(stderr, "%s: can't read the %d byte ROM\n", argv[optind], ROM_SIZE);
+      return 1;
+   }
+   if (optind + 1 < argc && !zx_host_snapshot(ctx, argv[optind + 1]))
+   {
+      fprintf(stderr, "%s: not a .z80 or .sna snapshot\n", argv[optind + 1]);
+      return 1;
+   }
+
+   uint8_t *fb = malloc(FB_SIZE);
+   uint64_t cpuTime = 0, renderTime = 0;
+   char path[FILENAME_MAX];
+   for (uint32_t frame = 0; frame < frames; frame++)
+   {
+      uint64_t start = host_time_us();
+      zx_run_frame(ctx);
+      uint64_t rendered = host_time_us();
+      zx_render_frame(ctx, fb);
+      renderTime += host_time_us() - rendered;
+      cpuTime += rendered - start;
+      if (bench)
+         continue;
+      printf("%4u: %08x\n", frame, frame_hash(fb));
+      if (ppmName)
+      {
+         snprintf(path, sizeof(path), "%s%04u.ppm", ppmName, frame);
+         if (!frame_save_ppm(path, fb))
+         {
+            fprintf(stderr, "%s: write error\n", path);
+            return 1;
+         }
+      }
+   }
+   if (bench)
+   {
+      uint64_t total = cpuTime + renderTime;
+      printf("%u frames: cpu %.1f ms, render %.1f ms, %.1f fps (%.1fx real time)\n", frames,
+             cpuTime / 1000.0, renderTime / 1000.0, total ? frames * 1e6 / total : 0.0,
+             total ? frames * 20000.0 / total : 0.0);
+   }
+   free(fb);
+   zx_host_free(ctx);
+   return 0;
+}
@@ -122,5 +122,8 @@ static cmd_err_t bas_vars(_cl_param_t *sParam)
       tprintf("name: %s; type 0x%2x\n", var->name, var->value.type);
       var = var->next;
    }
+   arena_print(&ProgArena);
+   arena_print(&VarArena);
+   tprintf("System heap: %d bytes free\n", xPortGetFreeHeapSize());
    return CMD_NO_ERR;
 }
\ No newline at end of file
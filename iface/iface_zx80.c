@@ -42,6 +42,7 @@
 #include "zxscreen.h"
 #include "snapshot.h"
 #include "z80dbg.h"
+#include "ay8912.h"
 
 #define ZX_ROM_DIR "/zx80"               // all emulator's files will be located here
 #define ZX_ROM_FILE "48.rom"             // ZX Spectrum 48k ROM file
@@ -51,6 +52,7 @@ static bool iface_zx80_init(bool verbose);
 static cmd_err_t zx_zx(_cl_param_t *sParam);
 static cmd_err_t zx_load(_cl_param_t *sParam);
 static cmd_err_t zx_dbg(_cl_param_t *sParam);
+static cmd_err_t zx_ay(_cl_param_t *sParam);
 
 const _iface_t ifaceZX80 =
     {
@@ -63,6 +65,7 @@ const _iface_t ifaceZX80 =
                 {.name = "zx", .desc = "Start emulator", .func = zx_zx},
                 {.name = "load", .desc = "Load program", .func = zx_load},
                 {.name = "dbg", .desc = "Start z80 debugger", .func = zx_dbg},
+                {.name = "ay", .desc = "AY registers [-b] [reg value]", .func = zx_ay},
                 {.name = NULL, .func = NULL},
             }};
 
@@ -111,6 +114,7 @@ bool zx_init(void)
    zxInitialized = true;
    vTaskDelay(100);
    int50Hz_init();
+   ay_init();
    xTaskCreate(lcd_zx_task, "lcdZx", configMINIMAL_STACK_SIZE, NULL, 2, &xLcdZxTask);
    z80_init();
    z80state.pc = 0x0000;
@@ -214,11 +218,13 @@ static cmd_err_t zx_load(_cl_param_t *sParam)
    }
    f_close(&progFile);
    for (uint8_t i = 0; i < 8; i++)
-      keyRows[i] = 0xff;
+      zxMachine.keyRows[i] = 0xff;
+   int50Hz_stop();
+   z80cpu_stop();
    if (fType == SNAP_TYPE_Z80)
-      load_snapshot_z80(frameBuffer);
+      load_snapshot_z80(&z80ctx, frameBuffer);
    else
-      load_snapshot_sna(frameBuffer);
+      load_snapshot_sna(&z80ctx, frameBuffer);
    if (debug)
    {
       z80dbg(z80state.pc);
@@ -258,4 +264,42 @@ static cmd_err_t zx_dbg(_cl_param_t *sParam)
    vTaskDelay(60);
    keyboard_flush();
    return CMD_NO_ERR;
-}
\ No newline at end of file
+}
+#define AY_BENCH_SECONDS 10
+/** AY state: ay - dump the registers, ay reg value - write a register,
+ *  ay -b - render AY_BENCH_SECONDS of audio from the current registers and report the CPU time.
+ */
+static cmd_err_t zx_ay(_cl_param_t *sParam)
+{
+   if (!zxInitialized)
+   {
+      if (!zx_init())
+         return CMD_NO_ERR;
+   }
+   if (sParam->argc && !strcmp(sParam->argv[0], "-b"))
+   {
+      uint16_t *buf;
+      uint16_t blocks = AY_BENCH_SECONDS * AY_SAMPLE_RATE / AY_FRAME_SAMPLES;
+      TickType_t startTime;
+      if (!(buf = pvPortMalloc(AY_FRAME_SAMPLES * sizeof(uint16_t))))
+         return "Can't allocate memory!";
+      startTime = xTaskGetTickCount();
+      for (uint16_t i = 0; i < blocks; i++)
+         ay_render(&zxMachine.ay, buf, NULL, 0, 0, sysConf.volume);
+      startTime = xTaskGetTickCount() - startTime;
+      vPortFree(buf);
+      tprintf("%d samples in %d ms, %d us per second of audio\n", blocks * AY_FRAME_SAMPLES, startTime,
+              startTime * 1000 / AY_BENCH_SECONDS);
+      return CMD_NO_ERR;
+   }
+   if (sParam->argc >= 2)
+   {
+      ay_select(&zxMachine.ay, (uint8_t)strtol(sParam->argv[0], NULL, 0));
+      ay_write(&zxMachine.ay, (uint8_t)strtol(sParam->argv[1], NULL, 0));
+      return CMD_NO_ERR;
+   }
+   for (uint8_t i = 0; i < AY_REGISTERS; i++)
+      tprintf("R%d=%x%c", i, zxMachine.ay.reg[i], (i & 0x07) == 0x07 ? '\n' : ' ');
+   tprintf("sample rate %d Hz\n", AY_SAMPLE_RATE);
+   return CMD_NO_ERR;
+}
@@ -141,8 +141,16 @@ typedef struct __attribute__((packed))
 	uint64_t USB_TRIM:3; // 44:42
 } sw_cal_area_t;
 
+#ifdef HOST_BUILD // no TRNG, the host port supplies the words
+uint32_t host_rnd_word(void);
+#define rnd_init()
+#define rnd(range) (host_rnd_word() % range)
+#define rnd_word() host_rnd_word()
+#else
 #define rnd_init() {REG_MCLK_APBCMASK |= MCLK_APBCMASK_TRNG;TRNG->CTRLA.bit.ENABLE = 1;}
 #define rnd(range) (TRNG->DATA.reg % range)
+#define rnd_word() ({while (!TRNG->INTFLAG.bit.DATARDY); TRNG->DATA.reg;}) // a fresh 32 bit value
+#endif
 
 void bsp_init(void);
 uint8_t crc8(uint8_t *data, uint16_t len);
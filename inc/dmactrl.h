@@ -31,6 +31,8 @@
 enum
 {
     DMA_LCD_CHAN,
+    DMA_LCD_LINK,   // no channel, its base descriptor slot holds DMA_LCD_DESC1
+    DMA_AY_CHAN,
     DMA_CHANNELS
 };
 
@@ -38,6 +40,8 @@ enum
 {
     DMA_LCD_DESC0,
     DMA_LCD_DESC1,
+    DMA_AY_DESC0,   // base descriptor of DMA_AY_CHAN
+    DMA_AY_DESC1,
     DMA_DESCRIPTORS
 };
 
@@ -48,6 +52,10 @@ extern DmacDescriptor bspDMAWback[DMA_CHANNELS]; // Write back descriptors for a
 #define DMAC_LCD_IRQ_Handler    DMAC_0_Handler
 extern DmacChannel *dmaLCD;
 
+#define DMAC_AY_IRQn            DMAC_2_IRQn
+#define DMAC_AY_IRQ_Handler     DMAC_2_Handler
+extern DmacChannel *dmaAY;
+
 void dma_init(void);
 
 #endif //_DMACTRL_H_INCLUDED
\ No newline at end of file
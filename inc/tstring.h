@@ -34,6 +34,7 @@ typedef struct
 {
     void (*putch)(char);
     bool (*getch)(char *);
+    void (*write)(const char *, uint16_t); // optional block output, NULL - putch per character. The library streams end before it
 }_stream_io_t;
 
 char* titoa(char *buff,int32_t val,uint8_t padding);
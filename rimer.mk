@@ -70,7 +70,7 @@ Objects1=$(IntermediateDirectory)/src_startup.c$(ObjectSuffix) $(IntermediateDir
 	$(IntermediateDirectory)/iface_iface_sd.c$(ObjectSuffix) $(IntermediateDirectory)/zx80_zxscreen.c$(ObjectSuffix) $(IntermediateDirectory)/zx80_z80dbg.c$(ObjectSuffix) $(IntermediateDirectory)/basicd_bscreen.c$(ObjectSuffix) $(IntermediateDirectory)/iface_iface_aio.c$(ObjectSuffix) 
 
 Objects2=$(IntermediateDirectory)/iface_iface_zx80.c$(ObjectSuffix) $(IntermediateDirectory)/basicd_banalizer.c$(ObjectSuffix) $(IntermediateDirectory)/iface_iface_set.c$(ObjectSuffix) $(IntermediateDirectory)/iface_enums.c$(ObjectSuffix) $(IntermediateDirectory)/iface_iface_dio.c$(ObjectSuffix) \
-	$(IntermediateDirectory)/basicd_bmath.c$(ObjectSuffix) $(IntermediateDirectory)/iface_iface_bas.c$(ObjectSuffix) 
+	$(IntermediateDirectory)/basicd_bmath.c$(ObjectSuffix) $(IntermediateDirectory)/iface_iface_bas.c$(ObjectSuffix) $(IntermediateDirectory)/zx80_ay8912.c$(ObjectSuffix) $(IntermediateDirectory)/src_dmactrl.c$(ObjectSuffix) $(IntermediateDirectory)/basicd_bmem.c$(ObjectSuffix) $(IntermediateDirectory)/basicd_bprog_rom_tok.c$(ObjectSuffix) 
 
 
 
@@ -301,6 +301,30 @@ $(IntermediateDirectory)/iface_iface_bas.c$(ObjectSuffix): iface/iface_bas.c
 $(IntermediateDirectory)/iface_iface_bas.c$(PreprocessSuffix): iface/iface_bas.c
 	$(CC) $(CFLAGS) $(IncludePath) $(PreprocessOnlySwitch) $(OutputSwitch) $(IntermediateDirectory)/iface_iface_bas.c$(PreprocessSuffix) iface/iface_bas.c
 
+$(IntermediateDirectory)/zx80_ay8912.c$(ObjectSuffix): zx80/ay8912.c
+	@$(CC) $(CFLAGS) $(IncludePath) -MG -MP -MT$(IntermediateDirectory)/zx80_ay8912.c$(ObjectSuffix) -MF$(IntermediateDirectory)/zx80_ay8912.c$(DependSuffix) -MM zx80/ay8912.c
+	$(CC) $(SourceSwitch) "/Users/sergey/projloc/rimer/fw/zx80/ay8912.c" $(CFLAGS) $(ObjectSwitch)$(IntermediateDirectory)/zx80_ay8912.c$(ObjectSuffix) $(IncludePath)
+$(IntermediateDirectory)/zx80_ay8912.c$(PreprocessSuffix): zx80/ay8912.c
+	$(CC) $(CFLAGS) $(IncludePath) $(PreprocessOnlySwitch) $(OutputSwitch) $(IntermediateDirectory)/zx80_ay8912.c$(PreprocessSuffix) zx80/ay8912.c
+
+$(IntermediateDirectory)/src_dmactrl.c$(ObjectSuffix): src/dmactrl.c
+	@$(CC) $(CFLAGS) $(IncludePath) -MG -MP -MT$(IntermediateDirectory)/src_dmactrl.c$(ObjectSuffix) -MF$(IntermediateDirectory)/src_dmactrl.c$(DependSuffix) -MM src/dmactrl.c
+	$(CC) $(SourceSwitch) "/Users/sergey/projloc/rimer/fw/src/dmactrl.c" $(CFLAGS) $(ObjectSwitch)$(IntermediateDirectory)/src_dmactrl.c$(ObjectSuffix) $(IncludePath)
+$(IntermediateDirectory)/src_dmactrl.c$(PreprocessSuffix): src/dmactrl.c
+	$(CC) $(CFLAGS) $(IncludePath) $(PreprocessOnlySwitch) $(OutputSwitch) $(IntermediateDirectory)/src_dmactrl.c$(PreprocessSuffix) src/dmactrl.c
+
+$(IntermediateDirectory)/basicd_bmem.c$(ObjectSuffix): basicd/bmem.c
+	@$(CC) $(CFLAGS) $(IncludePath) -MG -MP -MT$(IntermediateDirectory)/basicd_bmem.c$(ObjectSuffix) -MF$(IntermediateDirectory)/basicd_bmem.c$(DependSuffix) -MM basicd/bmem.c
+	$(CC) $(SourceSwitch) "/Users/sergey/projloc/rimer/fw/basicd/bmem.c" $(CFLAGS) $(ObjectSwitch)$(IntermediateDirectory)/basicd_bmem.c$(ObjectSuffix) $(IncludePath)
+$(IntermediateDirectory)/basicd_bmem.c$(PreprocessSuffix): basicd/bmem.c
+	$(CC) $(CFLAGS) $(IncludePath) $(PreprocessOnlySwitch) $(OutputSwitch) $(IntermediateDirectory)/basicd_bmem.c$(PreprocessSuffix) basicd/bmem.c
+
+$(IntermediateDirectory)/basicd_bprog_rom_tok.c$(ObjectSuffix): basicd/bprog_rom_tok.c
+	@$(CC) $(CFLAGS) $(IncludePath) -MG -MP -MT$(IntermediateDirectory)/basicd_bprog_rom_tok.c$(ObjectSuffix) -MF$(IntermediateDirectory)/basicd_bprog_rom_tok.c$(DependSuffix) -MM basicd/bprog_rom_tok.c
+	$(CC) $(SourceSwitch) "/Users/sergey/projloc/rimer/fw/basicd/bprog_rom_tok.c" $(CFLAGS) $(ObjectSwitch)$(IntermediateDirectory)/basicd_bprog_rom_tok.c$(ObjectSuffix) $(IncludePath)
+$(IntermediateDirectory)/basicd_bprog_rom_tok.c$(PreprocessSuffix): basicd/bprog_rom_tok.c
+	$(CC) $(CFLAGS) $(IncludePath) $(PreprocessOnlySwitch) $(OutputSwitch) $(IntermediateDirectory)/basicd_bprog_rom_tok.c$(PreprocessSuffix) basicd/bprog_rom_tok.c
+
 
 -include $(IntermediateDirectory)/*$(DependSuffix)
 ##
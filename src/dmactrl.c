@@ -0,0 +1,43 @@
+/**-----------------------------------------------------------------------------
+ * Copyright (c) 2025 Sergey Sanders
+ * sergey@sesadesign.com
+ * -----------------------------------------------------------------------------
+ * Licensed under Creative Commons Attribution-NonCommercial-ShareAlike 4.0
+ * International (CC BY-NC-SA 4.0).
+ *
+ * You are free to:
+ *  - Share: Copy and redistribute the material.
+ *  - Adapt: Remix, transform, and build upon the material.
+ *
+ * Under the following terms:
+ *  - Attribution: Give appropriate credit and indicate changes.
+ *  - NonCommercial: Do not use for commercial purposes.
+ *  - ShareAlike: Distribute under the same license.
+ *
+ * DISCLAIMER: This work is provided "as is" without any guarantees. The authors
+ * aren’t responsible for any issues, damages, or claims that come up from using
+ * it. Use at your own risk!
+ *
+ * Full license: http://creativecommons.org/licenses/by-nc-sa/4.0/
+ * ---------------------------------------------------------------------------*/
+/**
+ * @file dmactrl.c
+ * @author Sergey Sanders
+ * @brief DMA descriptor memory
+ *
+ * Replaces the library's dmactrl module, the descriptor tables are sized by
+ * inc/dmactrl.h so the application can add channels next to the LCD one.
+ */
+#include "dmactrl.h"
+
+DmacDescriptor bspDMABase[DMA_DESCRIPTORS] __attribute__((aligned(16)));  // Base descriptors for all channels
+DmacDescriptor bspDMAWback[DMA_CHANNELS] __attribute__((aligned(16))); // Write back descriptors for all channels
+DmacChannel *dmaLCD = &DMAC->Channel[DMA_LCD_CHAN];
+
+void dma_init(void)
+{
+    DMAC->DBGCTRL.bit.DBGRUN = 1;
+    DMAC->BASEADDR.reg = (uint32_t)bspDMABase;
+    DMAC->WRBADDR.reg = (uint32_t)bspDMAWback;
+    DMAC->CTRL.reg |= DMAC_CTRL_DMAENABLE | DMAC_CTRL_LVLEN0;
+}
@@ -0,0 +1,277 @@
+/**-----------------------------------------------------------------------------
+ * Copyright (c) 2025 Sergey Sanders
+ * sergey@sesadesign.com
+ * -----------------------------------------------------------------------------
+ * Licensed under Creative Commons Attribution-NonCommercial-ShareAlike 4.0
+ * International (CC BY-NC-SA 4.0).
+ *
+ * You are free to:
+ *  - Share: Copy and redistribute the material.
+ *  - Adapt: Remix, transform, and build upon the material.
+ *
+ * Under the following terms:
+ *  - Attribution: Give appropriate credit and indicate changes.
+ *  - NonCommercial: Do not use for commercial purposes.
+ *  - ShareAlike: Distribute under the same license.
+ *
+ * DISCLAIMER: This work is provided "as is" without any guarantees. The authors
+ * aren’t responsible for any issues, damages, or claims that come up from using
+ * it. Use at your own risk!
+ *
+ * Full license: http://creativecommons.org/licenses/by-nc-sa/4.0/
+ * ---------------------------------------------------------------------------*/
+/**
+ * @file ay8912.c
+ * @author Sergey Sanders
+ * @brief AY-3-8912 sound chip and beeper mixer
+ *
+ * The samples are rendered a frame at a time into one half of a double buffer,
+ * TC2 overflow triggers the DMA channel which moves a sample per beat to the DAC.
+ * The only interrupt is the DMA block complete, once per frame.
+ * The beeper edges are logged with their frame position by the CPU and replayed
+ * by the renderer one frame later.
+ * The chip state is per machine (_zx_machine_t), the DAC plays the firmware's zxMachine.
+ */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "string.h"
+#include "bsp.h"
+#include "dmactrl.h"
+#include "zx80sys.h"
+#include "ay8912.h"
+
+static const uint8_t AyRegMask[AY_REGISTERS] = {0xff, 0x0f, 0xff, 0x0f, 0xff, 0x0f, 0x1f, 0xff,
+                                                0x1f, 0x1f, 0x1f, 0xff, 0xff, 0x0f, 0xff, 0xff};
+/// Logarithmic DAC of the chip, 0..255
+static const uint8_t AyVolume[16] = {0, 3, 4, 6, 8, 12, 17, 26, 32, 51, 71, 90, 120, 154, 192, 255};
+
+#ifndef HOST_BUILD
+static uint16_t ayBuffer[2][AY_FRAME_SAMPLES];
+static uint8_t ayFreeBlock = 0; // the block the DMA has just finished
+
+TcCount16 *tmrAySample = (TcCount16 *)TC2;
+DmacChannel *dmaAY = &DMAC->Channel[DMA_AY_CHAN];
+#endif
+
+static void ay_env_restart(_ay_t *ay)
+{
+   uint8_t shape = ay->reg[AY_ENV_SHAPE];
+   ay->envAttack = (shape & 0x04) ? 0x0f : 0x00;
+   if (!(shape & 0x08)) // shapes 0-7 decay/attack once and hold at 0
+   {
+      ay->envHold = 1;
+      ay->envAlternate = ay->envAttack;
+   }
+   else
+   {
+      ay->envHold = shape & 0x01;
+      ay->envAlternate = shape & 0x02;
+   }
+   ay->envStep = 0x0f;
+   ay->envHolding = 0;
+   ay->envCount = 0;
+}
+
+void ay_reset(_ay_t *ay)
+{
+   memset(ay, 0, sizeof(_ay_t));
+   ay->noiseShift = 1;
+   ay->logReady = ay->logRd = AY_NO_LOG;
+   ay_env_restart(ay);
+}
+
+void ay_write(_ay_t *ay, uint8_t data)
+{
+   ay->reg[ay->selected] = data & AyRegMask[ay->selected];
+   if (ay->selected == AY_ENV_SHAPE)
+      ay_env_restart(ay);
+}
+
+uint8_t ay_read(_ay_t *ay)
+{
+   return ay->reg[ay->selected];
+}
+
+/** Log an edge of one speaker source at the frame position frameT (T-states since the interrupt).
+ *  source - AY_BEEPER_ON for the OUT bit, AY_EAR_ON for the tape input, each keeps its own level.
+ */
+void __attribute__((long_call, section(".ramfunc"), optimize("3"))) ay_beeper(_ay_t *ay, uint32_t frameT, uint16_t source, bool level)
+{
+   uint16_t pos, n, state;
+   uint16_t *log;
+   state = level ? (ay->beeper | source) : (ay->beeper & ~source);
+   if (state == ay->beeper)
+      return;
+   ay->beeper = state;
+   pos = (frameT >= ULA_FRAME_TSTATES) ? AY_FRAME_SAMPLES - 1 : frameT * AY_FRAME_SAMPLES / ULA_FRAME_TSTATES;
+   log = ay->beeperLog[ay->logWr];
+   n = ay->beeperCount[ay->logWr];
+   if (n && (log[n - 1] & AY_EVENT_POS) == pos) // same sample, the last levels win
+      log[n - 1] = pos | state;
+   else if (n < AY_BEEPER_EVENTS)
+   {
+      log[n] = pos | state;
+      ay->beeperCount[ay->logWr] = n + 1;
+   }
+}
+
+/// Frame interrupt: publish the finished beeper log, a log not picked up by the renderer is dropped
+void __attribute__((long_call, section(".ramfunc"), optimize("3"))) ay_frame(_ay_t *ay)
+{
+   uint8_t i;
+   ay->logReady = ay->logWr;
+   for (i = 0; i < AY_LOGS; i++)
+      if (i != ay->logReady && i != ay->logRd)
+         break;
+   ay->logWr = i;
+   ay->beeperCount[i] = 0;
+   ay->beeperStart[i] = ay->beeper;
+}
+
+/** Render a block of DAC samples.
+ *  events - speaker edges sorted by the sample position, beeper - AY_BEEPER_ON/AY_EAR_ON at the block start,
+ *  volume - DAC value of a full scale channel (sysConf.volume).
+ */
+void __attribute__((long_call, section(".ramfunc"), optimize("3"))) ay_render(_ay_t *ay, uint16_t *buf, const uint16_t *events, uint16_t count, uint16_t beeper, uint16_t volume)
+{
+   uint32_t period[3], noisePeriod, envPeriod, n;
+   uint16_t e = 0;
+   uint8_t mixer = ay->reg[AY_MIXER];
+   uint32_t beeperOut = AY_SPEAKER(beeper);
+   for (uint8_t ch = 0; ch < 3; ch++)
+   {
+      n = ay->reg[AY_FINE_A + ch * 2] | (ay->reg[AY_COARSE_A + ch * 2] << 8);
+      period[ch] = (n ? n : 1) << AY_TICK_FRACT;
+   }
+   n = ay->reg[AY_NOISE_PERIOD];
+   noisePeriod = (n ? n : 1) << (AY_TICK_FRACT + 1);
+   n = ay->reg[AY_ENV_FINE] | (ay->reg[AY_ENV_COARSE] << 8);
+   envPeriod = (n ? n : 1) << (AY_TICK_FRACT + 1);
+   for (uint16_t s = 0; s < AY_FRAME_SAMPLES; s++)
+   {
+      uint32_t mix, envVol, noiseOut;
+      while (e < count && (events[e] & AY_EVENT_POS) <= s)
+      {
+         beeperOut = AY_SPEAKER(events[e]);
+         e++;
+      }
+      for (uint8_t ch = 0; ch < 3; ch++)
+      {
+         ay->toneCount[ch] += AY_TICK_STEP;
+         if (ay->toneCount[ch] >= period[ch])
+         {
+            n = ay->toneCount[ch] / period[ch];
+            ay->toneCount[ch] -= n * period[ch];
+            ay->toneOut[ch] ^= n & 0x01;
+         }
+      }
+      for (ay->noiseCount += AY_TICK_STEP; ay->noiseCount >= noisePeriod; ay->noiseCount -= noisePeriod)
+         ay->noiseShift = (ay->noiseShift >> 1) | (((ay->noiseShift ^ (ay->noiseShift >> 3)) & 0x01) << 16);
+      for (ay->envCount += AY_TICK_STEP; ay->envCount >= envPeriod; ay->envCount -= envPeriod)
+      {
+         if (ay->envHolding)
+         {
+            ay->envCount = 0;
+            break;
+         }
+         if (--ay->envStep < 0)
+         {
+            if (ay->envHold)
+            {
+               if (ay->envAlternate)
+                  ay->envAttack ^= 0x0f;
+               ay->envHolding = 1;
+               ay->envStep = 0;
+            }
+            else
+            {
+               if (ay->envAlternate)
+                  ay->envAttack ^= 0x0f;
+               ay->envStep &= 0x0f;
+            }
+         }
+      }
+      noiseOut = ay->noiseShift & 0x01;
+      envVol = AyVolume[(ay->envStep ^ ay->envAttack) & 0x0f];
+      mix = beeperOut;
+      for (uint8_t ch = 0; ch < 3; ch++)
+         if ((ay->toneOut[ch] | (mixer >> ch)) & (noiseOut | (mixer >> (ch + 3))) & 0x01)
+            mix += (ay->reg[AY_AMPLITUDE_A + ch] & 0x10) ? envVol : AyVolume[ay->reg[AY_AMPLITUDE_A + ch] & 0x0f];
+      mix = (mix * volume) >> 8;
+      buf[s] = (mix > 4095) ? 4095 : mix;
+   }
+}
+
+/// Render the next frame of a machine with the beeper log published by its last ay_frame()
+void __attribute__((long_call, section(".ramfunc"), optimize("3"))) ay_render_frame(_ay_t *ay, uint16_t *buf, uint16_t volume)
+{
+   const uint16_t *events = NULL;
+   uint16_t count = 0;
+   uint16_t beeper = ay->beeper;
+   AY_LOG_LOCK();
+   ay->logRd = ay->logReady;
+   ay->logReady = AY_NO_LOG;
+   AY_LOG_UNLOCK();
+   if (ay->logRd != AY_NO_LOG)
+   {
+      events = ay->beeperLog[ay->logRd];
+      count = ay->beeperCount[ay->logRd];
+      beeper = ay->beeperStart[ay->logRd];
+   }
+   ay_render(ay, buf, events, count, beeper, volume);
+   ay->logRd = AY_NO_LOG;
+}
+
+#ifndef HOST_BUILD
+/// DMA block complete: the DMA went on with the other half, refill the finished one
+void __attribute__((long_call, section(".ramfunc"), optimize("3"))) DMAC_AY_IRQ_Handler(void)
+{
+   dmaAY->CHINTFLAG.reg = DMAC_CHINTFLAG_TCMPL;
+   ay_render_frame(&zxMachine.ay, ayBuffer[ayFreeBlock], sysConf.volume);
+   ayFreeBlock ^= 1;
+}
+
+void ay_init(void)
+{
+   DmacDescriptor *desc;
+   ay_reset(&zxMachine.ay);
+   memset(ayBuffer, 0, sizeof(ayBuffer));
+   /// sample timer, every overflow triggers one DMA beat
+   REG_MCLK_APBBMASK |= MCLK_APBBMASK_TC2;             // enable TC2 clock
+   REG_GCLK_PCHCTRL26 = CLK_60MHZ | GCLK_PCHCTRL_CHEN; // GCLK peripheral TC2 clock @ 60MHz
+   tmrAySample->WAVE.reg = TC_WAVE_WAVEGEN_MFRQ;       // top = CC0
+   tmrAySample->CC[0].reg = AY_SAMPLE_PERIOD - 1;
+   tmrAySample->CTRLA.bit.ENABLE = 1;
+   vTaskDelay(1);
+   tmrAySample->CTRLBSET.bit.CMD = 0x02; // stop the timer
+   /// two linked descriptors loop over the double buffer
+   for (uint8_t i = 0; i < 2; i++)
+   {
+      desc = &bspDMABase[DMA_AY_DESC0 + i];
+      desc->BTCTRL.reg = DMAC_BTCTRL_VALID | DMAC_BTCTRL_BEATSIZE_HWORD | DMAC_BTCTRL_SRCINC | DMAC_BTCTRL_BLOCKACT_INT;
+      desc->BTCNT.reg = AY_FRAME_SAMPLES;
+      desc->SRCADDR.reg = (uint32_t)&ayBuffer[i][AY_FRAME_SAMPLES]; // end address for the incremented source
+      desc->DSTADDR.reg = (uint32_t)&DAC->DATA[1].reg;
+      desc->DESCADDR.reg = (uint32_t)&bspDMABase[DMA_AY_DESC0 + (i ^ 1)];
+   }
+   dmaAY->CHCTRLA.reg = DMAC_CHCTRLA_TRIGSRC(TC2_DMAC_ID_OVF) | DMAC_CHCTRLA_TRIGACT_BURST | DMAC_CHCTRLA_BURSTLEN_SINGLE;
+   dmaAY->CHPRILVL.reg = 0;
+   dmaAY->CHINTENSET.reg = DMAC_CHINTENSET_TCMPL;
+   NVIC_SetPriority(DMAC_AY_IRQn, (1 << __NVIC_PRIO_BITS) - 1); // rendering must not delay the CPU timer
+   NVIC_EnableIRQ(DMAC_AY_IRQn);
+}
+
+void ay_start(void)
+{
+   ayFreeBlock = 0;
+   dmaAY->CHCTRLA.bit.ENABLE = 1;
+   tmrAySample->CTRLBSET.bit.CMD = 0x01; // start the timer
+}
+
+void ay_stop(void)
+{
+   tmrAySample->CTRLBSET.bit.CMD = 0x02; // stop the timer
+   dmaAY->CHCTRLA.bit.ENABLE = 0;
+   DAC->DATA[1].reg = 0;
+}
+#endif
@@ -0,0 +1,119 @@
+/**-----------------------------------------------------------------------------
+ * Copyright (c) 2025 Sergey Sanders
+ * sergey@sesadesign.com
+ * -----------------------------------------------------------------------------
+ * Licensed under Creative Commons Attribution-NonCommercial-ShareAlike 4.0
+ * International (CC BY-NC-SA 4.0).
+ *
+ * You are free to:
+ *  - Share: Copy and redistribute the material.
+ *  - Adapt: Remix, transform, and build upon the material.
+ *
+ * Under the following terms:
+ *  - Attribution: Give appropriate credit and indicate changes.
+ *  - NonCommercial: Do not use for commercial purposes.
+ *  - ShareAlike: Distribute under the same license.
+ *
+ * DISCLAIMER: This work is provided "as is" without any guarantees. The authors
+ * aren’t responsible for any issues, damages, or claims that come up from using
+ * it. Use at your own risk!
+ *
+ * Full license: http://creativecommons.org/licenses/by-nc-sa/4.0/
+ * ---------------------------------------------------------------------------*/
+
+#ifndef _AY8912_H_INCLUDED
+#define _AY8912_H_INCLUDED
+
+#include "stdint.h"
+#include "stdbool.h"
+
+#define AY_CLOCK            1773400UL // ZX Spectrum 128 AY clock, Hz
+#define AY_REGISTERS        16
+
+/// One DMA block holds exactly one 50Hz frame, the sample timer runs from the same 60MHz clock (ZX_FRAME_PERIOD in zx80sys.h)
+#define AY_FRAME_SAMPLES    640
+#define AY_SAMPLE_PERIOD    (ZX_FRAME_PERIOD * ZX_FRAME_PRESCALER / AY_FRAME_SAMPLES) // 60MHz ticks
+#define AY_SAMPLE_RATE      (60000000UL / AY_SAMPLE_PERIOD)                          // ~31.5KHz
+
+/// Tone/noise/envelope counters run at AY_CLOCK/8, 8 bits of fraction per output sample
+#define AY_TICK_FRACT       8
+#define AY_TICK_STEP        (((AY_CLOCK / 8) << AY_TICK_FRACT) / AY_SAMPLE_RATE)
+
+#define AY_BEEPER_LEVEL     255 // same weight as an AY channel at full volume
+#define AY_EAR_LEVEL        64  // the tape signal is monitored quieter than the beeper
+#define AY_BEEPER_EVENTS    256 // beeper edges per frame, edges on the same sample are merged
+#define AY_BEEPER_ON        0x8000 // speaker level set by OUT 0xfe bit 4
+#define AY_EAR_ON           0x4000 // EAR input level seen by IN 0xfe
+#define AY_EVENT_POS        0x03ff // sample position of a logged edge
+#define AY_LOGS             3 // write, ready and render, the renderer never races the CPU
+#define AY_NO_LOG           0xff
+/// the log handoff between the CPU and the renderer runs with the interrupts off
+#ifdef HOST_BUILD
+#define AY_LOG_LOCK()
+#define AY_LOG_UNLOCK()
+#else
+#define AY_LOG_LOCK()       __disable_irq()
+#define AY_LOG_UNLOCK()     __enable_irq()
+#endif
+#define AY_SPEAKER(state)   ((((state) & AY_BEEPER_ON) ? AY_BEEPER_LEVEL : 0) + (((state) & AY_EAR_ON) ? AY_EAR_LEVEL : 0))
+
+/// Port decoding (partial, as on the 128K): A15 = 1, A1 = 0, A14 selects register/data
+#define AY_PORT_SELECT(port) (((port) & 0xc002) == 0xc000) // 0xfffd
+#define AY_PORT_DATA(port)   (((port) & 0xc002) == 0x8000) // 0xbffd
+
+enum
+{
+   AY_FINE_A,
+   AY_COARSE_A,
+   AY_FINE_B,
+   AY_COARSE_B,
+   AY_FINE_C,
+   AY_COARSE_C,
+   AY_NOISE_PERIOD,
+   AY_MIXER,
+   AY_AMPLITUDE_A,
+   AY_AMPLITUDE_B,
+   AY_AMPLITUDE_C,
+   AY_ENV_FINE,
+   AY_ENV_COARSE,
+   AY_ENV_SHAPE,
+   AY_PORT_A,
+   AY_PORT_B
+};
+
+typedef struct
+{
+   uint8_t reg[AY_REGISTERS];
+   uint8_t selected;
+   uint8_t toneOut[3];
+   uint32_t toneCount[3];
+   uint32_t noiseCount;
+   uint32_t noiseShift; // 17 bit LFSR
+   uint32_t envCount;
+   int8_t envStep;
+   uint8_t envAttack;
+   uint8_t envAlternate;
+   uint8_t envHold;
+   uint8_t envHolding;
+   uint16_t beeper; // current AY_BEEPER_ON/AY_EAR_ON levels, logged on change
+   /// speaker edges of the last frames, sample position | levels
+   uint16_t beeperLog[AY_LOGS][AY_BEEPER_EVENTS];
+   uint16_t beeperCount[AY_LOGS];
+   uint16_t beeperStart[AY_LOGS]; // speaker levels at the frame start
+   volatile uint8_t logWr, logReady, logRd;
+} _ay_t;
+
+void ay_init(void);
+void ay_reset(_ay_t *ay);
+void ay_start(void);
+void ay_stop(void);
+void ay_write(_ay_t *ay, uint8_t data);
+uint8_t ay_read(_ay_t *ay);
+void ay_beeper(_ay_t *ay, uint32_t frameT, uint16_t source, bool level);
+void ay_frame(_ay_t *ay);
+void ay_render(_ay_t *ay, uint16_t *buf, const uint16_t *events, uint16_t count, uint16_t beeper, uint16_t volume);
+void ay_render_frame(_ay_t *ay, uint16_t *buf, uint16_t volume);
+
+#define ay_select(ay, r) (ay)->selected = (r) & 0x0f
+
+#endif //_AY8912_H_INCLUDED
@@ -55,38 +55,38 @@ void snap_decode_block(uint8_t *dest,uint8_t *src,uint16_t blkSize)
     }
 }
 
-void load_snapshot_z80(uint8_t *data)
+/// Load a .z80 snapshot into a stopped machine
+void load_snapshot_z80(Z80_CONTEXT *ctx, uint8_t *data)
 {
     _snap_z80_hdr_t *snap = (_snap_z80_hdr_t *)data;
     bool ver2_3 = false;
 //    tprintf("Load .z80 snap.\n");
-    int50Hz_stop();
-    z80cpu_stop();
-    z80state.registers.word[Z80_AF] = snap->F + (snap->A << 8);
-    z80state.registers.word[Z80_BC] = snap->C + (snap->B << 8);
-    z80state.registers.word[Z80_HL] = snap->L + (snap->H << 8);
-    z80state.registers.word[Z80_DE] = snap->E + (snap->D << 8);
-    z80state.registers.word[Z80_SP] = snap->SPL + (snap->SPH << 8);
-    z80state.registers.word[Z80_IY] = snap->IYL + (snap->IYH << 8);
-    z80state.registers.word[Z80_IX] = snap->IXL + (snap->IXH << 8);
-    z80state.alternates[0] = snap->F_ + (snap->A_ << 8);
-    z80state.alternates[1] = snap->C_ + (snap->B_ << 8);
-    z80state.alternates[2] = snap->E_ + (snap->D_ << 8);
-    z80state.alternates[3] = snap->L_ + (snap->H_ << 8);
-    z80state.pc = snap->PCL + (snap->PCH << 8);
-    if (!z80state.pc)
+    Z80FlagsSync(ctx); // drop a pending flags record, F is loaded here
+    ctx->state.registers.word[Z80_AF] = snap->F + (snap->A << 8);
+    ctx->state.registers.word[Z80_BC] = snap->C + (snap->B << 8);
+    ctx->state.registers.word[Z80_HL] = snap->L + (snap->H << 8);
+    ctx->state.registers.word[Z80_DE] = snap->E + (snap->D << 8);
+    ctx->state.registers.word[Z80_SP] = snap->SPL + (snap->SPH << 8);
+    ctx->state.registers.word[Z80_IY] = snap->IYL + (snap->IYH << 8);
+    ctx->state.registers.word[Z80_IX] = snap->IXL + (snap->IXH << 8);
+    ctx->state.alternates[0] = snap->F_ + (snap->A_ << 8);
+    ctx->state.alternates[1] = snap->C_ + (snap->B_ << 8);
+    ctx->state.alternates[2] = snap->E_ + (snap->D_ << 8);
+    ctx->state.alternates[3] = snap->L_ + (snap->H_ << 8);
+    ctx->state.pc = snap->PCL + (snap->PCH << 8);
+    if (!ctx->state.pc)
     {
-        z80state.pc = *(uint16_t *)&data[SNAPSHOT_V23_PC_POS];
+        ctx->state.pc = *(uint16_t *)&data[SNAPSHOT_V23_PC_POS];
         ver2_3 = true;
     }
-    z80state.i = snap->I;
-    z80state.r = snap->R;
+    ctx->state.i = snap->I;
+    ctx->state.r = snap->R;
     /// Hardware control
-    z80state.r = (snap->hwCtrl & 0x01) ? z80state.r | 0x80 : z80state.r & ~0x80;
-    borderRGB = ZxColour[0][(snap->hwCtrl) >> 1 & 0x07];
-    z80state.iff1 = snap->IE;
-    z80state.iff2 = snap->IFF2;
-    z80state.im = snap->flags & 0x03;
+    ctx->state.r = (snap->hwCtrl & 0x01) ? ctx->state.r | 0x80 : ctx->state.r & ~0x80;
+    ctx->machine->border = (snap->hwCtrl >> 1) & 0x07;
+    ctx->state.iff1 = snap->IE;
+    ctx->state.iff2 = snap->IFF2;
+    ctx->state.im = snap->flags & 0x03;
 
     uint8_t *dataPtr = (uint8_t *)(data + sizeof(_snap_z80_hdr_t));
     if (ver2_3)
@@ -112,18 +112,18 @@ void load_snapshot_z80(uint8_t *data)
             dataPtr += 3;
             if (blkSize == 0xffff)// 16384 uncompressed bytes
             {
-                memcpy(&z80mem[z80memOffset],dataPtr,0x4000);
+                memcpy(&ctx->mem[z80memOffset],dataPtr,0x4000);
                 dataPtr += 0x4000;
             }
             else
             {
-                snap_decode_block(&z80mem[z80memOffset],dataPtr,0x4000); // decode 16Kb
+                snap_decode_block(&ctx->mem[z80memOffset],dataPtr,0x4000); // decode 16Kb
                 dataPtr += blkSize;
             }
         }
     }
     else // .z80 version 1
-        snap_decode_block(&z80mem[ROM_SIZE],dataPtr,0xc000); // decode 48Kb
+        snap_decode_block(&ctx->mem[ROM_SIZE],dataPtr,0xc000); // decode 48Kb
 
  //   print_debug_status();
 }
@@ -144,34 +144,31 @@ When the registers have been loaded, a RETN command is required to start the pro
    ------------------------------------------------------------------------
    */
 //void load_snapshot_sna(uint8_t *data)
-void load_snapshot_sna(uint8_t *snapPtr)
+/// Load a .sna snapshot into a stopped machine
+void load_snapshot_sna(Z80_CONTEXT *ctx, uint8_t *snapPtr)
 {
     _snap_sna_hdr_t *snap = (_snap_sna_hdr_t *)snapPtr;
-    tprintf("Load .sna snap.\n");
-    int50Hz_stop();
-    z80cpu_stop();
-    z80state.registers.word[Z80_AF] = snap->F + (snap->A << 8);
-    z80state.registers.word[Z80_BC] = snap->C + (snap->B << 8);
-    z80state.registers.word[Z80_HL] = snap->L + (snap->H << 8);
-    z80state.registers.word[Z80_DE] = snap->E + (snap->D << 8);
-    z80state.registers.word[Z80_SP] = snap->SPL + (snap->SPH << 8);
-    z80state.registers.word[Z80_IY] = snap->IYL + (snap->IYH << 8);
-    z80state.registers.word[Z80_IX] = snap->IXL + (snap->IXH << 8);
-    z80state.alternates[0] = snap->F_ + (snap->A_ << 8);
-    z80state.alternates[1] = snap->C_ + (snap->B_ << 8);
-    z80state.alternates[2] = snap->E_ + (snap->D_ << 8);
-    z80state.alternates[3] = snap->L_ + (snap->H_ << 8);
-    z80state.i = snap->I;
-    z80state.r = snap->R;
-    borderRGB = ZxColour[0][snap->border];
-    z80state.iff1 = snap->IFF & 0x01;
-    z80state.iff2 = (snap->IFF >> 1) & 0x01;
-    z80state.im = snap->IM;
-    memcpy(&z80mem[ROM_SIZE],snap->data,sizeof(snap->data));
+    Z80FlagsSync(ctx); // drop a pending flags record, F is loaded here
+    ctx->state.registers.word[Z80_AF] = snap->F + (snap->A << 8);
+    ctx->state.registers.word[Z80_BC] = snap->C + (snap->B << 8);
+    ctx->state.registers.word[Z80_HL] = snap->L + (snap->H << 8);
+    ctx->state.registers.word[Z80_DE] = snap->E + (snap->D << 8);
+    ctx->state.registers.word[Z80_SP] = snap->SPL + (snap->SPH << 8);
+    ctx->state.registers.word[Z80_IY] = snap->IYL + (snap->IYH << 8);
+    ctx->state.registers.word[Z80_IX] = snap->IXL + (snap->IXH << 8);
+    ctx->state.alternates[0] = snap->F_ + (snap->A_ << 8);
+    ctx->state.alternates[1] = snap->C_ + (snap->B_ << 8);
+    ctx->state.alternates[2] = snap->E_ + (snap->D_ << 8);
+    ctx->state.alternates[3] = snap->L_ + (snap->H_ << 8);
+    ctx->state.i = snap->I;
+    ctx->state.r = snap->R;
+    ctx->machine->border = snap->border & 0x07;
+    ctx->state.iff1 = ctx->state.iff2 = (snap->IFF >> 2) & 0x01; // bit 2 is IFF2, "RETN" copies it to IFF1
+    ctx->state.im = snap->IM;
+    memcpy(&ctx->mem[ROM_SIZE],snap->data,sizeof(snap->data));
 //    print_debug_status();
-    z80state.pc = z80mem[z80state.registers.word[Z80_SP]]; // implement "RETN"
-    z80state.registers.word[Z80_SP] += 2;
+    uint16_t sp = ctx->state.registers.word[Z80_SP];
+    ctx->state.pc = ctx->mem[sp] | (ctx->mem[(uint16_t)(sp + 1)] << 8); // implement "RETN"
+    ctx->state.registers.word[Z80_SP] += 2;
 //    print_debug_status();
-    z80cpu_run();
-    int50Hz_start();
 }
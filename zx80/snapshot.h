@@ -22,6 +22,7 @@
  */
 #ifndef SNAPSHOT_H_INCLUDED
 #define SNAPSHOT_H_INCLUDED
+#include "z80cpu.h"
 /**
 
  Reference data from https://worldofspectrum.org/faq/reference/z80format.htm
@@ -180,6 +181,6 @@ typedef struct
 #define SNAPSHOT_HEADER_BLOCK_SIZE_POS    30
 #define SNAPSHOT_V23_PC_POS               32
 
-void load_snapshot_z80(uint8_t *data);
-void load_snapshot_sna(uint8_t *data);
+void load_snapshot_z80(Z80_CONTEXT *ctx, uint8_t *data);
+void load_snapshot_sna(Z80_CONTEXT *ctx, uint8_t *data);
 #endif //SNAPSHOT_H_INCLUDED
\ No newline at end of file
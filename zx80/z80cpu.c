@@ -28,6 +28,7 @@
 #include "z80macros.h"
 #include "zx80sys.h"
 #include "zxscreen.h"
+#include "ay8912.h"
 #include "string.h"
 /* Indirect (HL) or prefixed indexed (IX + d) and (IY + d) memory operands are
  * encoded using the 3 bits "110" (0x06).
@@ -91,7 +92,7 @@ static const uint8_t DefaultTStates[256] =
         4, 4, 4, 4, 4, 4, 7, 4, 4, 4, 4, 4, 4, 4, 7, 4,            // 40
         4, 4, 4, 4, 4, 4, 7, 4, 4, 4, 4, 4, 4, 4, 7, 4,            // 50
         4, 4, 4, 4, 4, 4, 7, 4, 4, 4, 4, 4, 4, 4, 7, 4,            // 60
-        7, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 7, 4,            // 70
+        7, 7, 7, 7, 7, 7, 4, 7, 4, 4, 4, 4, 4, 4, 7, 4,            // 70
         4, 4, 4, 4, 4, 4, 7, 4, 4, 4, 4, 4, 4, 4, 7, 4,            // 80
         4, 4, 4, 4, 4, 4, 7, 4, 4, 4, 4, 4, 4, 4, 7, 4,            // 90
         4, 4, 4, 4, 4, 4, 7, 4, 4, 4, 4, 4, 4, 4, 7, 4,            // a0
@@ -111,7 +112,7 @@ static const uint8_t DefaultTStatesDDFD[256] =
         8, 8, 8, 8, 8, 8, 19, 8, 8, 8, 8, 8, 8, 8, 19, 8,       // 40
         8, 8, 8, 8, 8, 8, 19, 8, 8, 8, 8, 8, 8, 8, 19, 8,       // 50
         8, 8, 8, 8, 8, 8, 19, 8, 8, 8, 8, 8, 8, 8, 19, 8,       // 60
-        19, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 19, 8,       // 70
+        19, 19, 19, 19, 19, 19, 8, 19, 8, 8, 8, 8, 8, 8, 19, 8, // 70
         8, 8, 8, 8, 8, 8, 19, 8, 8, 8, 8, 8, 8, 8, 19, 8,       // 80
         8, 8, 8, 8, 8, 8, 19, 8, 8, 8, 8, 8, 8, 8, 19, 8,       // 90
         8, 8, 8, 8, 8, 8, 19, 8, 8, 8, 8, 8, 8, 8, 19, 8,       // a0
@@ -145,33 +146,27 @@ static const uint8_t DefaultTStatesED[256] =
 };
 #endif
 
-Z80_STATE z80state;
-uint16_t WS_Div_Table[24];
+Z80_CONTEXT z80ctx = {.machine = &zxMachine};
+uint16_t WS_Div_Table[64]; // wait states + accumulated ULA contention
 uint16_t TStatesTable[256];
 uint16_t TStatesTableDDFD[256];
 // uint16_t TStatesTableED[256];
 
-/* Register decoding tables. */
-void *register_table[16];
-void *dd_register_table[16];
-void *fd_register_table[16];
-
 // #define PROFILE_PIN	PORT_PB04
 #define Z80_MAX_CLOCK 4000000
 #define Z80_MIN_CLOCK (SYS_CLOCK_FREQ / (60000 / 23)) // maximum cycles number is 23
 #define Z80_DEFAULT_CLOCK 3500000
 TcCount16 *tmrZ80Cpu = (TcCount16 *)TC0;
-uint8_t dataOnBus = 0; // data to be used with the interrupts
 uint16_t clkZ80div;
-volatile uint8_t addWaitStates = 0;
-void Z80Reset(Z80_STATE *state)
+void Z80Reset(Z80_CONTEXT *ctx)
 {
    int i;
-   z80state.status = 0;
+   ctx->state.status = 0;
    AF = 0xffff;
    SP = 0xffff;
-   z80state.i = z80state.pc = z80state.iff1 = z80state.iff2 = 0;
-   z80state.im = Z80_INTERRUPT_MODE_0;
+   ctx->state.i = ctx->state.pc = ctx->state.iff1 = ctx->state.iff2 = 0;
+   ctx->state.im = Z80_INTERRUPT_MODE_0;
+   ULA_FRAME_START(ctx);
    /* Build register decoding tables for both 3-bit encoded 8-bit
     * registers and 2-bit encoded 16-bit registers. When an opcode is
     * prefixed by 0xdd, HL is replaced by IX. When 0xfd prefixed, HL is
@@ -179,56 +174,101 @@ void Z80Reset(Z80_STATE *state)
     */
 
    /* 8-bit "R" registers. */
-   register_table[0] = &z80state.registers.byte[Z80_B];
-   register_table[1] = &z80state.registers.byte[Z80_C];
-   register_table[2] = &z80state.registers.byte[Z80_D];
-   register_table[3] = &z80state.registers.byte[Z80_E];
-   register_table[4] = &z80state.registers.byte[Z80_H];
-   register_table[5] = &z80state.registers.byte[Z80_L];
+   ctx->register_table[0] = &ctx->state.registers.byte[Z80_B];
+   ctx->register_table[1] = &ctx->state.registers.byte[Z80_C];
+   ctx->register_table[2] = &ctx->state.registers.byte[Z80_D];
+   ctx->register_table[3] = &ctx->state.registers.byte[Z80_E];
+   ctx->register_table[4] = &ctx->state.registers.byte[Z80_H];
+   ctx->register_table[5] = &ctx->state.registers.byte[Z80_L];
    /* Encoding 0x06 is used for indexed memory operands and direct HL or
     * IX/IY register access.
     */
-   register_table[6] = &z80state.registers.word[Z80_HL];
-   register_table[7] = &z80state.registers.byte[Z80_A];
+   ctx->register_table[6] = &ctx->state.registers.word[Z80_HL];
+   ctx->register_table[7] = &ctx->state.registers.byte[Z80_A];
    /* "Regular" 16-bit "RR" registers. */
-   register_table[8] = &z80state.registers.word[Z80_BC];
-   register_table[9] = &z80state.registers.word[Z80_DE];
-   register_table[10] = &z80state.registers.word[Z80_HL];
-   register_table[11] = &z80state.registers.word[Z80_SP];
+   ctx->register_table[8] = &ctx->state.registers.word[Z80_BC];
+   ctx->register_table[9] = &ctx->state.registers.word[Z80_DE];
+   ctx->register_table[10] = &ctx->state.registers.word[Z80_HL];
+   ctx->register_table[11] = &ctx->state.registers.word[Z80_SP];
    /* 16-bit "SS" registers for PUSH and POP instructions (note that SP is
     * replaced by AF).
     */
-   register_table[12] = &z80state.registers.word[Z80_BC];
-   register_table[13] = &z80state.registers.word[Z80_DE];
-   register_table[14] = &z80state.registers.word[Z80_HL];
-   register_table[15] = &z80state.registers.word[Z80_AF];
+   ctx->register_table[12] = &ctx->state.registers.word[Z80_BC];
+   ctx->register_table[13] = &ctx->state.registers.word[Z80_DE];
+   ctx->register_table[14] = &ctx->state.registers.word[Z80_HL];
+   ctx->register_table[15] = &ctx->state.registers.word[Z80_AF];
    /* 0xdd and 0xfd prefixed register decoding tables. */
    for (i = 0; i < 16; i++)
-      dd_register_table[i] = fd_register_table[i] = register_table[i];
-   dd_register_table[4] = &z80state.registers.byte[Z80_IXH];
-   dd_register_table[5] = &z80state.registers.byte[Z80_IXL];
-   dd_register_table[6] = &z80state.registers.word[Z80_IX];
-   dd_register_table[10] = &z80state.registers.word[Z80_IX];
-   dd_register_table[14] = &z80state.registers.word[Z80_IX];
-   fd_register_table[4] = &z80state.registers.byte[Z80_IYH];
-   fd_register_table[5] = &z80state.registers.byte[Z80_IYL];
-   fd_register_table[6] = &z80state.registers.word[Z80_IY];
-   fd_register_table[10] = &z80state.registers.word[Z80_IY];
-   fd_register_table[14] = &z80state.registers.word[Z80_IY];
+      ctx->dd_register_table[i] = ctx->fd_register_table[i] = ctx->register_table[i];
+   ctx->dd_register_table[4] = &ctx->state.registers.byte[Z80_IXH];
+   ctx->dd_register_table[5] = &ctx->state.registers.byte[Z80_IXL];
+   ctx->dd_register_table[6] = &ctx->state.registers.word[Z80_IX];
+   ctx->dd_register_table[10] = &ctx->state.registers.word[Z80_IX];
+   ctx->dd_register_table[14] = &ctx->state.registers.word[Z80_IX];
+   ctx->fd_register_table[4] = &ctx->state.registers.byte[Z80_IYH];
+   ctx->fd_register_table[5] = &ctx->state.registers.byte[Z80_IYL];
+   ctx->fd_register_table[6] = &ctx->state.registers.word[Z80_IY];
+   ctx->fd_register_table[10] = &ctx->state.registers.word[Z80_IY];
+   ctx->fd_register_table[14] = &ctx->state.registers.word[Z80_IY];
 }
 
-void Z80NonMaskableInterrupt(void)
+void Z80NonMaskableInterrupt(Z80_CONTEXT *ctx)
 {
-   z80state.status = 0;
-   z80state.iff2 = z80state.iff1;
-   z80state.iff1 = 0;
-   z80state.r = (z80state.r & 0x80) | ((z80state.r + 1) & 0x7f);
+   ctx->state.status = 0;
+   ctx->state.iff2 = ctx->state.iff1;
+   ctx->state.iff1 = 0;
+   ctx->state.r = (ctx->state.r & 0x80) | ((ctx->state.r + 1) & 0x7f);
    SP -= 2;
-   Z80_WRITE_WORD_INTERRUPT(SP, z80state.pc);
-   z80state.pc = 0x0066;
+   Z80_WRITE_WORD_INTERRUPT(SP, ctx->state.pc);
+   ctx->state.pc = 0x0066;
    // return elapsed_cycles + 11;
 }
 
+void __attribute__((long_call, section(".ramfunc"), optimize("3"))) Z80Interrupt(Z80_CONTEXT *ctx)
+{
+   ctx->state.status = 0; // the frame position is set by the caller, see zx_frame
+   if (ctx->state.iff1)
+   {
+      ctx->state.iff1 = ctx->state.iff2 = 0;
+      ctx->state.r = (ctx->state.r & 0x80) | ((ctx->state.r + 1) & 0x7f);
+      switch (ctx->state.im)
+      {
+      case Z80_INTERRUPT_MODE_0:
+      {
+         /* Assuming the opcode in data_on_bus is an
+          * RST instruction, accepting the interrupt
+          * should take 2 + 11 = 13 cycles.
+          */
+         // tmrZ80Cpu->CC[0].reg = clkZ80div*13;
+         asm("nop");
+         break; // Not used in ZX Spectrum
+      }
+      case Z80_INTERRUPT_MODE_1:
+      {
+         ctx->ulaLineT += 13; // the acknowledge and the PC push
+         SP -= 2;
+         Z80_WRITE_WORD_INTERRUPT(SP, ctx->state.pc);
+         ctx->state.pc = 0x0038;
+         // tmrZ80Cpu->CC[0].reg = clkZ80div*13;
+         break;
+      }
+      case Z80_INTERRUPT_MODE_2:
+      default:
+      {
+         uint16_t vector;
+         ctx->ulaLineT += 19; // the acknowledge, the PC push and the vector read
+         SP -= 2;
+         Z80_WRITE_WORD_INTERRUPT(SP, ctx->state.pc);
+         vector = ((uint16_t)ctx->state.i) << 8 | ctx->dataOnBus;
+#ifdef Z80_MASK_IM2_VECTOR_ADDRESS
+         vector &= 0xfffe;
+#endif
+         ctx->state.pc = Z80_READ_WORD_INTERRUPT(vector);
+      }
+      }
+   }
+}
+
 void z80_set_clock(uint32_t fClkHz)
 {
    uint16_t i;
@@ -237,7 +277,7 @@ void z80_set_clock(uint32_t fClkHz)
    if (fClkHz > Z80_MAX_CLOCK)
       fClkHz = Z80_MAX_CLOCK;
    clkZ80div = SYS_CLOCK_FREQ / 2 / fClkHz; // 1 machine state @ 60MHz
-   for (i = 0; i < 24; i++)
+   for (i = 0; i < 64; i++)
       WS_Div_Table[i] = clkZ80div * i;
    for (i = 0; i < 256; i++)
       TStatesTable[i] = clkZ80div * DefaultTStates[i];
@@ -250,25 +290,34 @@ uint32_t z80_get_clock(void)
 {
    return SYS_CLOCK_FREQ / clkZ80div;
 }
+#ifndef HOST_BUILD
 void z80cpu_run(void)
 {
    vTaskResume(xLcdZxTask);
+   z80cpu_start();
+}
+/** Start the CPU and 50Hz timers only, the screen task is left as is */
+void z80cpu_start(void)
+{
    tmrZ80Cpu->COUNT.reg = 0;
    tmrZ80Cpu->CC[0].reg = clkZ80div * 4; // Match comparator
    tmrZ80Cpu->CTRLBSET.bit.CMD = 0x01;   // start the timer
    tmrZX50Hz->CTRLBSET.bit.CMD = 0x01;   // start the timer
+   ay_start();
 }
 void z80cpu_stop(void)
 {
    vTaskSuspend(xLcdZxTask);
    tmrZ80Cpu->CTRLBSET.bit.CMD = 0x02; // stop the timer
    tmrZX50Hz->CTRLBSET.bit.CMD = 0x02; // stop the timer
+   ay_stop();
 }
 
 void z80_init(void)
 {
    z80_set_clock(Z80_DEFAULT_CLOCK);
-   Z80Reset(&z80state);
+   ula_init();
+   Z80Reset(&z80ctx);
    /// z80CPU timer initialization
    REG_MCLK_APBAMASK |= MCLK_APBAMASK_TC0;            // enable TC0 clock
    REG_GCLK_PCHCTRL9 = CLK_60MHZ | GCLK_PCHCTRL_CHEN; // GCLK peripheral TC0 clock @ 12MHz
@@ -279,27 +328,29 @@ void z80_init(void)
    // while(!tmrZ80Cpu->SYNCBUSY.bit.ENABLE)
    __asm("nop");
    vTaskDelay(1);
-   addWaitStates = WS_Div_Table[3];
    tmrZ80Cpu->CTRLBSET.bit.CMD = 0x02; // stop the timer
    vTaskSuspend(xLcdZxTask);
    NVIC_EnableIRQ(TC0_IRQn);
    NVIC_SetPriority(TC0_IRQn, 0);
 }
+#endif
 
+#ifdef HOST_BUILD
+#define R_REG_CNT ((uint8_t)(ULA_FRAME_T(ctx) >> 2) & 0x7f) // no free running counter, the frame position stands in
+#else
 #define R_REG_CNT ((uint8_t)SysTick->VAL & 0x7f)
-#define TSTATES_ADD(n) tmrZ80Cpu->CC[0].reg += WS_Div_Table[n]
+#endif
+#define TSTATES_ADD(n)                        \
+   {                                          \
+      Z80_TIMING_ADD(WS_Div_Table[n]);        \
+      tStates += (n);                         \
+   }
 // #define TSTATES_ADD(n)
 
-#if 1
+#ifndef HOST_BUILD
+/// CPU timer interrupt: execute a single instruction of the firmware's machine
 void __attribute__((long_call, section(".ramfunc"), optimize("3"))) TC0_Handler(void)
-#else
-#warning Z80cpu compiled in debug mode!
-void __attribute__((long_call, section(".ramfunc"), optimize("0"))) TC0_Handler(void)
-#endif
 {
-#include "tables.h"
-   void **registers;
-   uint8_t opcode;                                  //,instruction;
    tmrZ80Cpu->INTFLAG.reg = tmrZ80Cpu->INTFLAG.reg; // clear interrupt flag
    if (addrMatch == z80state.pc)
    {
@@ -311,16 +362,99 @@ void __attribute__((long_call, section(".ramfunc"), optimize("0"))) TC0_Handler(
          return;
       }
    }
-   opcode = Z80_FETCH_BYTE(z80state.pc++);
-   tmrZ80Cpu->CC[0].reg = TStatesTable[opcode];
-   registers = register_table;
+   z80_step(&z80ctx);
+}
+#endif
+
+#ifdef Z80_LAZY_FLAGS
+/** Compute F from the last deferred 8-bit operation, the results of the flags
+ *  tables are computed here as the tables are local to z80_step().
+ */
+void __attribute__((long_call, section(".ramfunc"), optimize("3"))) Z80FlagsSync(Z80_CONTEXT *ctx)
+{
+   int a = ctx->lazy.a, x = ctx->lazy.x, z = ctx->lazy.z, c, f;
+   uint8_t r = z;
+   if (ctx->lazy.op == Z80_LAZY_NONE)
+      return;
+   f = (r & SYX_FLAGS) | (r ? 0 : Z80_Z_FLAG);
+   switch (ctx->lazy.op)
+   {
+   case Z80_LAZY_ADD:
+      c = a ^ x ^ z;
+      f |= (c & Z80_H_FLAG) | OVERFLOW_TABLE[c >> 7] | (z >> (8 - Z80_C_FLAG_SHIFT));
+      break;
+   case Z80_LAZY_SUB:
+      c = a ^ x ^ z;
+      f |= Z80_N_FLAG | (c & Z80_H_FLAG);
+      c &= 0x0180;
+      f |= OVERFLOW_TABLE[c >> 7] | (c >> (8 - Z80_C_FLAG_SHIFT));
+      break;
+   case Z80_LAZY_CP:
+      c = a ^ x ^ z;
+      f = (f & SZ_FLAGS) | (x & YX_FLAGS) | Z80_N_FLAG | (c & Z80_H_FLAG);
+      c &= 0x0180;
+      f |= OVERFLOW_TABLE[c >> 7] | (c >> (8 - Z80_C_FLAG_SHIFT));
+      break;
+   case Z80_LAZY_AND:
+      f |= Z80_H_FLAG;
+      /* fall through */
+   case Z80_LAZY_LOGIC:
+      f |= __builtin_parity(r) ? 0 : Z80_P_FLAG;
+      break;
+   case Z80_LAZY_INC:
+      c = a ^ z;
+      f |= ctx->lazy.c | (c & Z80_H_FLAG) | OVERFLOW_TABLE[(c >> 7) & 0x03];
+      break;
+   case Z80_LAZY_DEC:
+      c = a ^ z;
+      f |= Z80_N_FLAG | ctx->lazy.c | (c & Z80_H_FLAG) | OVERFLOW_TABLE[(c >> 7) & 0x03];
+      break;
+   }
+   ctx->state.registers.byte[Z80_F] = f;
+   ctx->lazy.op = Z80_LAZY_NONE;
+}
+#endif
+
+#ifdef Z80_STATIC_CONTEXT
+/* Host speed comparison only: the step works on z80ctx at a fixed address, the
+ * way the core used its globals, the argument is ignored. */
+#define Z80_STEP_CTX unusedCtx
+#define ctx (&z80ctx)
+#else
+#define Z80_STEP_CTX ctx
+#endif
+#if 1
+uint8_t __attribute__((long_call, section(".ramfunc"), optimize("3"))) z80_step(Z80_CONTEXT *Z80_STEP_CTX)
+#else
+#warning Z80cpu compiled in debug mode!
+uint8_t __attribute__((long_call, section(".ramfunc"), optimize("0"))) z80_step(Z80_CONTEXT *Z80_STEP_CTX)
+#endif
+{
+#include "tables.h"
+   void **registers;
+   uint8_t opcode;      //,instruction;
+   uint8_t tStates;     // instruction's T-states
+   uint8_t ulaT = 0;    // machine cycle position within the instruction, see ULA_CONTEND()
+   uint8_t ulaWait = 0; // ULA contention and I/O wait states of the current instruction
+   ULA_CONTEND(ctx->state.pc, 4);
+   opcode = Z80_FETCH_BYTE(ctx->state.pc++);
+   Z80_TIMING_SET(TStatesTable[opcode]);
+   tStates = DefaultTStates[opcode];
+   registers = ctx->register_table;
    goto *INSTRUCTION_TABLE[opcode];
-#define exec_done_wt()                                  \
-   tmrZ80Cpu->CC[0].reg += WS_Div_Table[addWaitStates]; \
-   addWaitStates = 0;                                   \
-   return;
-// #define exec_done_wt() return;
-#define exec_done() return;
+   /* The line position stays at the instruction's start while it runs, the
+    * accesses are placed by ulaT. */
+#define exec_done()                                  \
+   if (ulaWait)                                      \
+      Z80_TIMING_ADD(WS_Div_Table[ulaWait]);         \
+   ctx->ulaLineT += tStates + ulaWait;               \
+   if (ctx->ulaLineT >= ULA_LINE_TSTATES)            \
+      ULA_NEXT_LINE(ctx);                            \
+   return tStates + ulaWait;
+#define exec_done_wt()            \
+   ulaWait += ctx->waitStates;    \
+   ctx->waitStates = 0;           \
+   exec_done();
    /* 8-bit load group. */
 LD_R_R:
 {
@@ -334,7 +468,7 @@ LD_R_N:
 }
 LD_R_INDIRECT_HL:
 {
-   if (registers == register_table)
+   if (registers == ctx->register_table)
    {
       R(Y(opcode)) = READ_BYTE(HL);
    }
@@ -343,6 +477,7 @@ LD_R_INDIRECT_HL:
       uint16_t addr;
       int8_t dd;
       READ_D(dd);
+      ULA_CYCLES(ctx->state.pc - 1, 5);
       addr = (int)HL_IX_IY + dd;
       S(Y(opcode)) = READ_BYTE(addr);
    }
@@ -350,7 +485,7 @@ LD_R_INDIRECT_HL:
 }
 LD_INDIRECT_HL_R:
 {
-   if (registers == register_table)
+   if (registers == ctx->register_table)
    {
       WRITE_BYTE(HL, R(Z(opcode)));
    }
@@ -359,6 +494,7 @@ LD_INDIRECT_HL_R:
       uint16_t addr;
       int8_t dd;
       READ_D(dd);
+      ULA_CYCLES(ctx->state.pc - 1, 5);
       addr = (int)HL_IX_IY + dd;
       WRITE_BYTE(addr, S(Z(opcode)));
    }
@@ -367,7 +503,7 @@ LD_INDIRECT_HL_R:
 LD_INDIRECT_HL_N:
 {
    int n;
-   if (registers == register_table)
+   if (registers == ctx->register_table)
    {
       READ_N(n);
       WRITE_BYTE(HL, n);
@@ -379,6 +515,7 @@ LD_INDIRECT_HL_N:
       READ_D(dd);
       addr = (int)HL_IX_IY + dd;
       READ_N(n);
+      ULA_CYCLES(ctx->state.pc - 1, 2);
       WRITE_BYTE(addr, n);
    }
    exec_done();
@@ -420,15 +557,16 @@ LD_INDIRECT_NN_A:
 LD_A_I_LD_A_R:
 {
    TSTATES_ADD(1);
+   ULA_CYCLES_IR(1);
    int a, f;
-   a = opcode == OPCODE_LD_A_I ? z80state.i : (z80state.r & 0x80) | R_REG_CNT;
+   a = opcode == OPCODE_LD_A_I ? ctx->state.i : (ctx->state.r & 0x80) | R_REG_CNT;
    f = SZYX_FLAGS_TABLE[a];
    /* Note: On a real processor, if an interrupt
     * occurs during the execution of either
     * "LD A, I" or "LD A, R", the parity flag is
     * reset. That can never happen here.
     */
-   f |= z80state.iff2 << Z80_P_FLAG_SHIFT;
+   f |= ctx->state.iff2 << Z80_P_FLAG_SHIFT;
    f |= F & Z80_C_FLAG;
    AF = (a << 8) | f;
    exec_done();
@@ -436,11 +574,12 @@ LD_A_I_LD_A_R:
 LD_I_A_LD_R_A:
 {
    TSTATES_ADD(1);
+   ULA_CYCLES_IR(1);
    if (opcode == OPCODE_LD_I_A)
-      z80state.i = A;
+      ctx->state.i = A;
    else
    {
-      z80state.r = A;
+      ctx->state.r = A;
       // r = A & 0x7f;
    }
    exec_done();
@@ -483,16 +622,20 @@ LD_INDIRECT_NN_RR:
 }
 LD_SP_HL:
 {
+   ULA_CYCLES_IR(2);
    SP = HL_IX_IY;
    exec_done();
 }
 PUSH_SS:
 {
+   FLAGS_SYNC(); // SS(3) is AF
+   ULA_CYCLES_IR(1);
    PUSH(SS(P(opcode)));
    exec_done();
 }
 POP_SS:
 {
+   FLAGS_SYNC();
    POP(SS(P(opcode)));
    exec_done();
 }
@@ -504,21 +647,25 @@ EX_DE_HL:
 }
 EX_AF_AF_PRIME:
 {
-   EXCHANGE(AF, z80state.alternates[Z80_AF]);
+   EXCHANGE(AF, ctx->state.alternates[Z80_AF]);
    exec_done();
 }
 EXX:
 {
-   EXCHANGE(BC, z80state.alternates[Z80_BC]);
-   EXCHANGE(DE, z80state.alternates[Z80_DE]);
-   EXCHANGE(HL, z80state.alternates[Z80_HL]);
+   EXCHANGE(BC, ctx->state.alternates[Z80_BC]);
+   EXCHANGE(DE, ctx->state.alternates[Z80_DE]);
+   EXCHANGE(HL, ctx->state.alternates[Z80_HL]);
    exec_done();
 }
 EX_INDIRECT_SP_HL:
 {
    int t;
    t = READ_WORD(SP);
-   WRITE_WORD(SP, HL_IX_IY);
+   ULA_CYCLES(SP + 1, 1);
+   ULA_CONTEND(SP + 1, 3); // written high byte first
+   ULA_CONTEND(SP, 3);
+   Z80_WRITE_WORD(SP, HL_IX_IY);
+   ULA_CYCLES(SP, 2);
    HL_IX_IY = t;
    exec_done();
 }
@@ -528,6 +675,7 @@ LDI_LDD:
    int n, f, d;
    n = READ_BYTE(HL);
    WRITE_BYTE(DE, n);
+   ULA_CYCLES(DE, 2);
    f = F & SZC_FLAGS;
    f |= --BC ? Z80_P_FLAG : 0;
 #ifndef Z80_DOCUMENTED_FLAGS_ONLY
@@ -549,8 +697,9 @@ LDIR_LDDR:
    bc = BC;
    de = DE;
    hl = HL;
-   n = Z80_READ_BYTE(hl);
-   Z80_WRITE_BYTE(de, n);
+   n = READ_BYTE(hl);
+   WRITE_BYTE(de, n);
+   ULA_CYCLES(de, (bc != 1) ? 7 : 2); // repeated, the loop back costs 5 more
    if (opcode == OPCODE_LDIR)
    {
       HL++;
@@ -566,7 +715,7 @@ LDIR_LDDR:
    if (--bc)
    {
       TSTATES_ADD(13);
-      z80state.pc -= 2;
+      ctx->state.pc -= 2;
    }
    else
    {
@@ -589,6 +738,7 @@ CPI_CPD:
    int a, n, z, f;
    a = A;
    n = READ_BYTE(HL);
+   ULA_CYCLES(HL, 5);
    z = a - n;
    HL += opcode == OPCODE_CPI ? +1 : -1;
    f = (a ^ n ^ z) & Z80_H_FLAG;
@@ -611,13 +761,14 @@ CPIR_CPDR:
    hl = HL;
    // r -= 2;
    // r += 2;
-   n = Z80_READ_BYTE(hl);
+   n = READ_BYTE(hl);
    z = a - n;
+   ULA_CYCLES(hl, (bc != 1 && z) ? 10 : 5);
    hl += d;
    if (--bc && z)
    {
       TSTATES_ADD(13);
-      z80state.pc -= 2;
+      ctx->state.pc -= 2;
    }
    else
    {
@@ -797,9 +948,10 @@ INC_R:
 INC_INDIRECT_HL:
 {
    int x;
-   if (registers == register_table)
+   if (registers == ctx->register_table)
    {
       x = READ_BYTE(HL);
+      ULA_CYCLES(HL, 1);
       INC(x);
       WRITE_BYTE(HL, x);
    }
@@ -808,8 +960,10 @@ INC_INDIRECT_HL:
       uint16_t addr;
       int8_t dd;
       READ_D(dd);
+      ULA_CYCLES(ctx->state.pc - 1, 5);
       addr = (int)HL_IX_IY + dd;
       x = READ_BYTE(addr);
+      ULA_CYCLES(addr, 1);
       INC(x);
       WRITE_BYTE(addr, x);
    }
@@ -823,9 +977,10 @@ DEC_R:
 DEC_INDIRECT_HL:
 {
    int x;
-   if (registers == register_table)
+   if (registers == ctx->register_table)
    {
       x = READ_BYTE(HL);
+      ULA_CYCLES(HL, 1);
       DEC(x);
       WRITE_BYTE(HL, x);
    }
@@ -834,8 +989,10 @@ DEC_INDIRECT_HL:
       uint16_t addr;
       int8_t dd;
       READ_D(dd);
+      ULA_CYCLES(ctx->state.pc - 1, 5);
       addr = (int)HL_IX_IY + dd;
       x = READ_BYTE(addr);
+      ULA_CYCLES(addr, 1);
       DEC(x);
       WRITE_BYTE(addr, x);
    }
@@ -914,7 +1071,7 @@ NOP:
 HALT:
 {
 #if Z80_CATCH_HALT
-   z80state.status = Z80_STATUS_HALT;
+   ctx->state.status = Z80_STATUS_HALT;
    tmrZ80Cpu->CTRLBSET.bit.CMD = 0x02; // stop the CPU CLOCK fimer
 #else
    /* If an HALT instruction is executed, the Z80
@@ -928,9 +1085,9 @@ HALT:
 }
 DI:
 {
-   z80state.iff1 = z80state.iff2 = 0;
+   ctx->state.iff1 = ctx->state.iff2 = 0;
 #ifdef Z80_CATCH_DI
-   z80state.status = Z80_STATUS_FLAG_DI;
+   ctx->state.status = Z80_STATUS_FLAG_DI;
    goto stop_emulation;
 #else
    /* No interrupt can be accepted right after
@@ -948,9 +1105,9 @@ DI:
 }
 EI:
 {
-   z80state.iff1 = z80state.iff2 = 1;
+   ctx->state.iff1 = ctx->state.iff2 = 1;
 #ifdef Z80_CATCH_EI
-   z80state.status = Z80_STATUS_FLAG_EI;
+   ctx->state.status = Z80_STATUS_FLAG_EI;
    goto stop_emulation;
 #else
    /* See comment for DI. */
@@ -963,17 +1120,18 @@ IM_N:
     * 0x6e) is treated like a "IM 0".
     */
    if ((Y(opcode) & 0x03) <= 0x01)
-      z80state.im = Z80_INTERRUPT_MODE_0;
+      ctx->state.im = Z80_INTERRUPT_MODE_0;
    else if (!(Y(opcode) & 1))
-      z80state.im = Z80_INTERRUPT_MODE_1;
+      ctx->state.im = Z80_INTERRUPT_MODE_1;
    else
-      z80state.im = Z80_INTERRUPT_MODE_2;
+      ctx->state.im = Z80_INTERRUPT_MODE_2;
    exec_done();
 }
    /* 16-bit arithmetic group. */
 ADD_HL_RR:
 {
    int x, y, z, f, c;
+   ULA_CYCLES_IR(7);
    x = HL_IX_IY;
    y = RR(P(opcode));
    z = x + y;
@@ -991,6 +1149,7 @@ ADD_HL_RR:
 ADC_HL_RR:
 {
    TSTATES_ADD(7);
+   ULA_CYCLES_IR(7);
    int x, y, z, f, c;
    x = HL;
    y = RR(P(opcode));
@@ -1009,6 +1168,7 @@ ADC_HL_RR:
 SBC_HL_RR:
 {
    TSTATES_ADD(7);
+   ULA_CYCLES_IR(7);
    int x, y, z, f, c;
    x = HL;
    y = RR(P(opcode));
@@ -1029,6 +1189,7 @@ SBC_HL_RR:
 INC_RR:
 {
    int x;
+   ULA_CYCLES_IR(2);
    x = RR(P(opcode));
    x++;
    RR(P(opcode)) = x;
@@ -1037,6 +1198,7 @@ INC_RR:
 DEC_RR:
 {
    int x;
+   ULA_CYCLES_IR(2);
    x = RR(P(opcode));
    x--;
    RR(P(opcode)) = x;
@@ -1094,10 +1256,11 @@ RLC_R:
 RLC_INDIRECT_HL:
 {
    int x;
-   if (registers == register_table)
+   if (registers == ctx->register_table)
    {
       TSTATES_ADD(7);
       x = READ_BYTE(HL);
+      ULA_CYCLES(HL, 1);
       RLC(x);
       WRITE_BYTE(HL, x);
    }
@@ -1105,14 +1268,15 @@ RLC_INDIRECT_HL:
    {
       int d;
       TSTATES_ADD(15);
-      d = Z80_FETCH_BYTE(z80state.pc);
+      d = Z80_FETCH_BYTE(ctx->state.pc);
       d = ((signed char)d) + HL_IX_IY;
       x = READ_BYTE(d);
+      ULA_CYCLES(d, 1);
       RLC(x);
       WRITE_BYTE(d, x);
       if (Z(opcode) != INDIRECT_HL)
          R(Z(opcode)) = x;
-      z80state.pc += 2;
+      ctx->state.pc += 2;
    }
    exec_done();
 }
@@ -1124,10 +1288,11 @@ RL_R:
 RL_INDIRECT_HL:
 {
    int x;
-   if (registers == register_table)
+   if (registers == ctx->register_table)
    {
       TSTATES_ADD(7);
       x = READ_BYTE(HL);
+      ULA_CYCLES(HL, 1);
       RL(x);
       WRITE_BYTE(HL, x);
    }
@@ -1135,14 +1300,15 @@ RL_INDIRECT_HL:
    {
       int d;
       TSTATES_ADD(15);
-      d = Z80_FETCH_BYTE(z80state.pc);
+      d = Z80_FETCH_BYTE(ctx->state.pc);
       d = ((signed char)d) + HL_IX_IY;
       x = READ_BYTE(d);
+      ULA_CYCLES(d, 1);
       RL(x);
       WRITE_BYTE(d, x);
       if (Z(opcode) != INDIRECT_HL)
          R(Z(opcode)) = x;
-      z80state.pc += 2;
+      ctx->state.pc += 2;
    }
    exec_done();
 }
@@ -1154,10 +1320,11 @@ RRC_R:
 RRC_INDIRECT_HL:
 {
    int x;
-   if (registers == register_table)
+   if (registers == ctx->register_table)
    {
       TSTATES_ADD(7);
       x = READ_BYTE(HL);
+      ULA_CYCLES(HL, 1);
       RRC(x);
       WRITE_BYTE(HL, x);
    }
@@ -1165,14 +1332,15 @@ RRC_INDIRECT_HL:
    {
       int d;
       TSTATES_ADD(15);
-      d = Z80_FETCH_BYTE(z80state.pc);
+      d = Z80_FETCH_BYTE(ctx->state.pc);
       d = ((signed char)d) + HL_IX_IY;
       x = READ_BYTE(d);
+      ULA_CYCLES(d, 1);
       RRC(x);
       WRITE_BYTE(d, x);
       if (Z(opcode) != INDIRECT_HL)
          R(Z(opcode)) = x;
-      z80state.pc += 2;
+      ctx->state.pc += 2;
    }
    exec_done();
 }
@@ -1184,10 +1352,11 @@ RR_R:
 RR_INDIRECT_HL:
 {
    int x;
-   if (registers == register_table)
+   if (registers == ctx->register_table)
    {
       TSTATES_ADD(7);
       x = READ_BYTE(HL);
+      ULA_CYCLES(HL, 1);
       RR_INSTRUCTION(x);
       WRITE_BYTE(HL, x);
    }
@@ -1195,14 +1364,15 @@ RR_INDIRECT_HL:
    {
       int d;
       TSTATES_ADD(15);
-      d = Z80_FETCH_BYTE(z80state.pc);
+      d = Z80_FETCH_BYTE(ctx->state.pc);
       d = ((signed char)d) + HL_IX_IY;
       x = READ_BYTE(d);
+      ULA_CYCLES(d, 1);
       RR_INSTRUCTION(x);
       WRITE_BYTE(d, x);
       if (Z(opcode) != INDIRECT_HL)
          R(Z(opcode)) = x;
-      z80state.pc += 2;
+      ctx->state.pc += 2;
    }
    exec_done();
 }
@@ -1214,10 +1384,11 @@ SLA_R:
 SLA_INDIRECT_HL:
 {
    int x;
-   if (registers == register_table)
+   if (registers == ctx->register_table)
    {
       TSTATES_ADD(7);
       x = READ_BYTE(HL);
+      ULA_CYCLES(HL, 1);
       SLA(x);
       WRITE_BYTE(HL, x);
    }
@@ -1225,14 +1396,15 @@ SLA_INDIRECT_HL:
    {
       int d;
       TSTATES_ADD(15);
-      d = Z80_FETCH_BYTE(z80state.pc);
+      d = Z80_FETCH_BYTE(ctx->state.pc);
       d = ((signed char)d) + HL_IX_IY;
       x = READ_BYTE(d);
+      ULA_CYCLES(d, 1);
       SLA(x);
       WRITE_BYTE(d, x);
       if (Z(opcode) != INDIRECT_HL)
          R(Z(opcode)) = x;
-      z80state.pc += 2;
+      ctx->state.pc += 2;
    }
    exec_done();
 }
@@ -1244,10 +1416,11 @@ SLL_R:
 SLL_INDIRECT_HL:
 {
    int x;
-   if (registers == register_table)
+   if (registers == ctx->register_table)
    {
       TSTATES_ADD(7);
       x = READ_BYTE(HL);
+      ULA_CYCLES(HL, 1);
       SLL(x);
       WRITE_BYTE(HL, x);
    }
@@ -1255,14 +1428,15 @@ SLL_INDIRECT_HL:
    {
       int d;
       TSTATES_ADD(15);
-      d = Z80_FETCH_BYTE(z80state.pc);
+      d = Z80_FETCH_BYTE(ctx->state.pc);
       d = ((signed char)d) + HL_IX_IY;
       x = READ_BYTE(d);
+      ULA_CYCLES(d, 1);
       SLL(x);
       WRITE_BYTE(d, x);
       if (Z(opcode) != INDIRECT_HL)
          R(Z(opcode)) = x;
-      z80state.pc += 2;
+      ctx->state.pc += 2;
    }
    exec_done();
 }
@@ -1274,10 +1448,11 @@ SRA_R:
 SRA_INDIRECT_HL:
 {
    int x;
-   if (registers == register_table)
+   if (registers == ctx->register_table)
    {
       TSTATES_ADD(7);
       x = READ_BYTE(HL);
+      ULA_CYCLES(HL, 1);
       SRA(x);
       WRITE_BYTE(HL, x);
    }
@@ -1285,14 +1460,15 @@ SRA_INDIRECT_HL:
    {
       int d;
       TSTATES_ADD(15);
-      d = Z80_FETCH_BYTE(z80state.pc);
+      d = Z80_FETCH_BYTE(ctx->state.pc);
       d = ((signed char)d) + HL_IX_IY;
       x = READ_BYTE(d);
+      ULA_CYCLES(d, 1);
       SRA(x);
       WRITE_BYTE(d, x);
       if (Z(opcode) != INDIRECT_HL)
          R(Z(opcode)) = x;
-      z80state.pc += 2;
+      ctx->state.pc += 2;
    }
    exec_done();
 }
@@ -1304,10 +1480,11 @@ SRL_R:
 SRL_INDIRECT_HL:
 {
    int x;
-   if (registers == register_table)
+   if (registers == ctx->register_table)
    {
       TSTATES_ADD(7);
       x = READ_BYTE(HL);
+      ULA_CYCLES(HL, 1);
       SRL(x);
       WRITE_BYTE(HL, x);
    }
@@ -1315,14 +1492,15 @@ SRL_INDIRECT_HL:
    {
       int d;
       TSTATES_ADD(15);
-      d = Z80_FETCH_BYTE(z80state.pc);
+      d = Z80_FETCH_BYTE(ctx->state.pc);
       d = ((signed char)d) + HL_IX_IY;
       x = READ_BYTE(d);
+      ULA_CYCLES(d, 1);
       SRL(x);
       WRITE_BYTE(d, x);
       if (Z(opcode) != INDIRECT_HL)
          R(Z(opcode)) = x;
-      z80state.pc += 2;
+      ctx->state.pc += 2;
    }
    exec_done();
 }
@@ -1331,6 +1509,7 @@ RLD_RRD:
    TSTATES_ADD(10);
    int x, y;
    x = READ_BYTE(HL);
+   ULA_CYCLES(HL, 4);
    y = (A & 0xf0) << 8;
    y |= opcode == OPCODE_RLD ? (x << 4) | (A & 0x0f) : ((x & 0x0f) << 8) | ((A & 0x0f) << 4) | (x >> 4);
    WRITE_BYTE(HL, y);
@@ -1354,7 +1533,7 @@ BIT_B_R:
 BIT_B_INDIRECT_HL:
 {
    int d, x;
-   if (registers == register_table)
+   if (registers == ctx->register_table)
    {
       TSTATES_ADD(4);
       d = HL;
@@ -1362,11 +1541,12 @@ BIT_B_INDIRECT_HL:
    else
    {
       TSTATES_ADD(12);
-      d = Z80_FETCH_BYTE(z80state.pc);
+      d = Z80_FETCH_BYTE(ctx->state.pc);
       d = ((signed char)d) + HL_IX_IY;
-      z80state.pc += 2;
+      ctx->state.pc += 2;
    }
    x = READ_BYTE(d);
+   ULA_CYCLES(d, 1);
    x &= 1 << Y(opcode);
    F = (x ? 0 : Z80_Z_FLAG | Z80_P_FLAG)
 #ifndef Z80_DOCUMENTED_FLAGS_ONLY
@@ -1383,10 +1563,11 @@ SET_B_R:
 SET_B_INDIRECT_HL:
 {
    int x;
-   if (registers == register_table)
+   if (registers == ctx->register_table)
    {
       TSTATES_ADD(7);
       x = READ_BYTE(HL);
+      ULA_CYCLES(HL, 1);
       x |= 1 << Y(opcode);
       WRITE_BYTE(HL, x);
    }
@@ -1394,14 +1575,15 @@ SET_B_INDIRECT_HL:
    {
       int d;
       TSTATES_ADD(15);
-      d = Z80_FETCH_BYTE(z80state.pc);
+      d = Z80_FETCH_BYTE(ctx->state.pc);
       d = ((signed char)d) + HL_IX_IY;
       x = READ_BYTE(d);
+      ULA_CYCLES(d, 1);
       x |= 1 << Y(opcode);
       WRITE_BYTE(d, x);
       if (Z(opcode) != INDIRECT_HL)
          R(Z(opcode)) = x;
-      z80state.pc += 2;
+      ctx->state.pc += 2;
    }
    exec_done();
 }
@@ -1413,10 +1595,11 @@ RES_B_R:
 RES_B_INDIRECT_HL:
 {
    int x;
-   if (registers == register_table)
+   if (registers == ctx->register_table)
    {
       TSTATES_ADD(7);
       x = READ_BYTE(HL);
+      ULA_CYCLES(HL, 1);
       x &= ~(1 << Y(opcode));
       WRITE_BYTE(HL, x);
    }
@@ -1424,83 +1607,69 @@ RES_B_INDIRECT_HL:
    {
       int d;
       TSTATES_ADD(15);
-      d = Z80_FETCH_BYTE(z80state.pc);
+      d = Z80_FETCH_BYTE(ctx->state.pc);
       d = ((signed char)d) + HL_IX_IY;
       x = READ_BYTE(d);
+      ULA_CYCLES(d, 1);
       x &= ~(1 << Y(opcode));
       WRITE_BYTE(d, x);
       if (Z(opcode) != INDIRECT_HL)
          R(Z(opcode)) = x;
-      z80state.pc += 2;
+      ctx->state.pc += 2;
    }
    exec_done();
 }
    /* Jump group. */
 JP_NN:
 {
-   z80state.pc = Z80_FETCH_WORD(z80state.pc);
+   int nn;
+   READ_NN(nn);
+   ctx->state.pc = nn;
    exec_done();
 }
 JP_CC_NN:
 {
+   int nn;
+   READ_NN(nn); // the address is read whatever the condition
    if (CC(Y(opcode)))
-   {
-      z80state.pc = Z80_FETCH_WORD(z80state.pc);
-   }
-   else
-   {
-#ifdef Z80_FALSE_CONDITION_FETCH
-      Z80_FETCH_WORD(z80state.pc);
-#endif
-      z80state.pc += 2;
-   }
+      ctx->state.pc = nn;
    exec_done();
 }
 JR_E:
 {
-   int e;
-   e = Z80_FETCH_BYTE(z80state.pc);
-   z80state.pc += ((signed char)e) + 1;
+   int8_t e;
+   READ_D(e);
+   ULA_CYCLES(ctx->state.pc - 1, 5);
+   ctx->state.pc += e;
    exec_done();
 }
 JR_DD_E:
 {
-   int e;
+   int8_t e;
+   READ_D(e);
    if (DD(Q(opcode)))
    {
       TSTATES_ADD(5);
-      e = Z80_FETCH_BYTE(z80state.pc);
-      z80state.pc += ((signed char)e) + 1;
-   }
-   else
-   {
-#ifdef Z80_FALSE_CONDITION_FETCH
-      Z80_FETCH_BYTE(pc, e);
-#endif
-      z80state.pc++;
+      ULA_CYCLES(ctx->state.pc - 1, 5);
+      ctx->state.pc += e;
    }
    exec_done();
 }
 JP_HL:
 {
-   z80state.pc = HL_IX_IY;
+   ctx->state.pc = HL_IX_IY;
    exec_done();
 }
 DJNZ_E:
 {
-   int e;
+   int8_t e;
+   ULA_CYCLES_IR(1);
+   READ_D(e);
    if (--B)
    {
       TSTATES_ADD(5);
-      e = Z80_FETCH_BYTE(z80state.pc);
-      z80state.pc += ((signed char)e) + 1;
-   }
-   else
-   {
-#ifdef Z80_FALSE_CONDITION_FETCH
-      Z80_FETCH_BYTE(pc, e);
-#endif
-      z80state.pc++;
+      ULA_CYCLES(ctx->state.pc - 1, 5);
+      ctx->state.pc += e;
    }
    exec_done();
 }
@@ -1509,56 +1678,52 @@ CALL_NN:
 {
    int nn;
    READ_NN(nn);
-   PUSH(z80state.pc);
-   z80state.pc = nn;
+   ULA_CYCLES(ctx->state.pc - 1, 1);
+   PUSH(ctx->state.pc);
+   ctx->state.pc = nn;
    exec_done();
 }
 CALL_CC_NN:
 {
    int nn;
+   READ_NN(nn); // the address is read whatever the condition
    if (CC(Y(opcode)))
    {
       TSTATES_ADD(7);
-      READ_NN(nn);
-      PUSH(z80state.pc);
-      z80state.pc = nn;
-   }
-   else
-   {
-#ifdef Z80_FALSE_CONDITION_FETCH
-      Z80_FETCH_WORD(pc, nn);
-#endif
-      z80state.pc += 2;
+      ULA_CYCLES(ctx->state.pc - 1, 1);
+      PUSH(ctx->state.pc);
+      ctx->state.pc = nn;
    }
    exec_done();
 }
 RET:
 {
-   POP(z80state.pc);
+   POP(ctx->state.pc);
    exec_done();
 }
 RET_CC:
 {
+   ULA_CYCLES_IR(1);
    if (CC(Y(opcode)))
    {
       TSTATES_ADD(6);
-      POP(z80state.pc);
+      POP(ctx->state.pc);
    }
    exec_done();
 }
 RETI_RETN:
 {
    TSTATES_ADD(6);
-   z80state.iff1 = z80state.iff2;
-   POP(z80state.pc);
+   ctx->state.iff1 = ctx->state.iff2;
+   POP(ctx->state.pc);
 #if defined(Z80_CATCH_RETI) && defined(Z80_CATCH_RETN)
-   z80state.status = opcode == OPCODE_RETI ? Z80_STATUS_FLAG_RETI : Z80_STATUS_FLAG_RETN;
+   ctx->state.status = opcode == OPCODE_RETI ? Z80_STATUS_FLAG_RETI : Z80_STATUS_FLAG_RETN;
    goto stop_emulation;
 #elif defined(Z80_CATCH_RETI)
-   z80state.status = Z80_STATUS_FLAG_RETI;
+   ctx->state.status = Z80_STATUS_FLAG_RETI;
    goto stop_emulation;
 #elif defined(Z80_CATCH_RETN)
-   z80state.status = Z80_STATUS_FLAG_RETN;
+   ctx->state.status = Z80_STATUS_FLAG_RETN;
    goto stop_emulation;
 #else
    exec_done();
@@ -1566,8 +1731,9 @@ RETI_RETN:
 }
 RST_P:
 {
-   PUSH(z80state.pc);
-   z80state.pc = RST_TABLE[Y(opcode)];
+   ULA_CYCLES_IR(1);
+   PUSH(ctx->state.pc);
+   ctx->state.pc = RST_TABLE[Y(opcode)];
    exec_done();
 }
    /* Input and output group. */
@@ -1597,6 +1763,7 @@ INI_IND:
 {
    TSTATES_ADD(8);
    uint8_t x, f;
+   ULA_CYCLES_IR(1);
    x = Z80_INPUT_BYTE(((uint16_t)B << 8) + C);
    WRITE_BYTE(HL, x);
    f = SZYX_FLAGS_TABLE[--B & 0xff] | (x >> (7 - Z80_N_FLAG_SHIFT));
@@ -1626,13 +1793,16 @@ INIR_INDR:
    d = opcode == OPCODE_INIR ? +1 : -1;
    b = B;
    hl = HL;
+   ULA_CYCLES_IR(1);
    x = Z80_INPUT_BYTE(((uint16_t)B << 8) + C);
-   Z80_WRITE_BYTE(hl, x);
+   WRITE_BYTE(hl, x);
+   if (b != 1) // repeated
+      ULA_CYCLES(hl, 5);
    hl += d;
    if (--b)
    {
       TSTATES_ADD(13);
-      z80state.pc -= 2;
+      ctx->state.pc -= 2;
       f = SZYX_FLAGS_TABLE[b];
    }
    else
@@ -1676,6 +1846,7 @@ OUTI_OUTD:
 {
    TSTATES_ADD(8);
    int x, f;
+   ULA_CYCLES_IR(1);
    x = READ_BYTE(HL);
    Z80_OUTPUT_BYTE(((uint16_t)B << 8) + C, x);
    HL += opcode == OPCODE_OUTI ? +1 : -1;
@@ -1692,13 +1863,16 @@ OTIR_OTDR:
    d = opcode == OPCODE_OTIR ? +1 : -1;
    b = B;
    hl = HL;
-   x = Z80_READ_BYTE(hl);
+   ULA_CYCLES_IR(1);
+   x = READ_BYTE(hl);
    Z80_OUTPUT_BYTE(((uint16_t)B << 8) + C, x);
+   if (b != 1) // repeated, B is already decremented on the bus
+      ULA_CYCLES(((b - 1) << 8) | C, 5);
    hl += d;
    if (--b)
    {
       TSTATES_ADD(13);
-      z80state.pc -= 2;
+      ctx->state.pc -= 2;
       f = SZYX_FLAGS_TABLE[b];
    }
    else
@@ -1721,39 +1895,49 @@ CB_PREFIX:
    /* Special handling if the 0xcb prefix is
     * prefixed by a 0xdd or 0xfd prefix.
     */
-   if (registers != register_table)
+   if (registers != ctx->register_table)
    {
 
       /* Indexed memory access routine will
-       * correctly update pc.
+       * correctly update pc. The displacement and
+       * the opcode are read as operands.
        */
-      opcode = Z80_FETCH_BYTE(z80state.pc + 1);
+      ULA_CONTEND(ctx->state.pc, 3);
+      ULA_CONTEND(ctx->state.pc + 1, 3);
+      ULA_CYCLES(ctx->state.pc + 1, 2);
+      opcode = Z80_FETCH_BYTE(ctx->state.pc + 1);
    }
    else
    {
-      opcode = Z80_FETCH_BYTE(z80state.pc++);
+      ULA_CONTEND(ctx->state.pc, 4);
+      opcode = Z80_FETCH_BYTE(ctx->state.pc++);
    }
    goto *CB_INSTRUCTION_TABLE[opcode];
 }
 DD_PREFIX:
 {
-   tmrZ80Cpu->CC[0].reg = TStatesTableDDFD[opcode];
-   registers = dd_register_table;
-   opcode = Z80_FETCH_BYTE(z80state.pc++);
+   registers = ctx->dd_register_table;
+   ULA_CONTEND(ctx->state.pc, 4);
+   opcode = Z80_FETCH_BYTE(ctx->state.pc++);
+   Z80_TIMING_SET(TStatesTableDDFD[opcode]); // timed by the prefixed opcode
+   tStates = DefaultTStatesDDFD[opcode];
    goto *INSTRUCTION_TABLE[opcode];
 }
 FD_PREFIX:
 {
-   tmrZ80Cpu->CC[0].reg = TStatesTableDDFD[opcode];
-   registers = fd_register_table;
-   opcode = Z80_FETCH_BYTE(z80state.pc++);
+   registers = ctx->fd_register_table;
+   ULA_CONTEND(ctx->state.pc, 4);
+   opcode = Z80_FETCH_BYTE(ctx->state.pc++);
+   Z80_TIMING_SET(TStatesTableDDFD[opcode]);
+   tStates = DefaultTStatesDDFD[opcode];
    goto *INSTRUCTION_TABLE[opcode];
 }
 ED_PREFIX:
 {
-   // tmrZ80Cpu->CC[0].reg = TStatesTableED[opcode];
-   registers = register_table;
-   opcode = Z80_FETCH_BYTE(z80state.pc++);
+   // Z80_TIMING_SET(TStatesTableED[opcode]);
+   registers = ctx->register_table;
+   ULA_CONTEND(ctx->state.pc, 4);
+   opcode = Z80_FETCH_BYTE(ctx->state.pc++);
    goto *ED_INSTRUCTION_TABLE[opcode];
 }
    /* Special/pseudo instruction group. */
@@ -1763,5 +1947,8 @@ ED_UNDEFINED:
 }
    // EXEC_DONE:
    //	REG_PORT_OUTCLR1 = PROFILE_PIN;
-   return;
+   return tStates;
 }
+#ifdef Z80_STATIC_CONTEXT
+#undef ctx
+#endif
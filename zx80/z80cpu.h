@@ -11,6 +11,13 @@
 
 #include "stdint.h"
 
+/* Lazy flags: the 8-bit arithmetic and logic operations only record their
+ * operands and result, F is computed when it is read (conditions, PUSH AF,
+ * EX AF,AF', ADC/SBC carry, ...). Code outside the core reading or writing F
+ * in Z80_STATE must call Z80FlagsSync() first.
+ */
+/* #define Z80_LAZY_FLAGS */
+
 #define OPCODE_LD_A_I 0x57
 #define OPCODE_LD_I_A 0x47
 
@@ -136,35 +143,96 @@ typedef struct __attribute__((__packed__)) Z80_STATE
    uint8_t status;
 } Z80_STATE;
 
+#ifdef Z80_LAZY_FLAGS
+enum
+{
+   Z80_LAZY_NONE, // F is up to date
+   Z80_LAZY_ADD,  // ADD, ADC
+   Z80_LAZY_SUB,  // SUB, SBC
+   Z80_LAZY_CP,
+   Z80_LAZY_AND,
+   Z80_LAZY_LOGIC, // OR, XOR
+   Z80_LAZY_INC,   // INC/DEC keep the carry, must be the last ones
+   Z80_LAZY_DEC
+};
+
+typedef struct Z80_LAZY_FLAGS_STATE
+{
+   uint8_t op;
+   uint8_t a; // first operand
+   uint8_t x; // second operand
+   uint8_t c; // carry kept by INC/DEC
+   int16_t z; // result with the carry/borrow
+} Z80_LAZY_FLAGS_STATE;
+#endif
+
+/* Emulated machine instance: the processor's state, its memory, register
+ * decoding tables, the ULA timing position and the machine's I/O state. Every core function works on
+ * a context, so several machines can be emulated in the same process.
+ */
+
+struct _zx_machine_s;
+
+typedef struct Z80_CONTEXT
+{
+   Z80_STATE state;
+   uint8_t *mem;
+   struct _zx_machine_s *machine; /* I/O state: keyboard, border, sound, see zx80sys.h */
+   /* Register decoding tables. */
+   void *register_table[16];
+   void *dd_register_table[16];
+   void *fd_register_table[16];
+   /* ULA contention, see zx80sys.h */
+   const uint8_t *ulaLine;
+   uint16_t ulaLineT;
+   uint16_t ulaScanLine;
+   uint8_t waitStates; // I/O wait states set by the port handlers
+   uint8_t dataOnBus;  // data to be used with the interrupts
+#ifdef Z80_LAZY_FLAGS
+   Z80_LAZY_FLAGS_STATE lazy;
+#endif
+} Z80_CONTEXT;
+
 /* Initialize processor's state to power-on default. */
 
-extern void Z80Reset(Z80_STATE *state);
+extern void Z80Reset(Z80_CONTEXT *ctx);
 
-/* Trigger an interrupt according to the current interrupt mode and return the
- * number of cycles elapsed to accept it. If maskable interrupts are disabled,
- * this will return zero. In interrupt mode 0, data_on_bus must be a single
- * byte opcode.
+/* Trigger an interrupt according to the current interrupt mode. If maskable
+ * interrupts are disabled, nothing happens. In interrupt mode 0,
+ * ctx->dataOnBus must be a single byte opcode.
  */
 
-extern void Z80Interrupt(void);
-/* Trigger a non maskable interrupt, then return the number of cycles elapsed
- * to accept it.
+extern void Z80Interrupt(Z80_CONTEXT *ctx);
+/* Trigger a non maskable interrupt.
  */
 
-extern void Z80NonMaskableInterrupt(void);
+extern void Z80NonMaskableInterrupt(Z80_CONTEXT *ctx);
+
+/* Execute single instruction and return the number of T-states it took. The
+ * user macros (see z80user.h) control the emulation.
+ */
+extern uint8_t z80_step(Z80_CONTEXT *ctx);
+
+/* Compute F from the pending lazy flags record, see Z80_LAZY_FLAGS. */
+#ifdef Z80_LAZY_FLAGS
+extern void Z80FlagsSync(Z80_CONTEXT *ctx);
+#else
+#define Z80FlagsSync(ctx)
+#endif
 
-/* Execute single instruction. The user macros
- * (see z80user.h) control the emulation.
+/* The firmware runs a single machine, z80ctx, one instruction per CPU timer
+ * interrupt.
  */
 #define z80_cycle() TC0_Handler()
-extern volatile uint8_t addWaitStates;
 extern uint16_t clkZ80div;
-extern Z80_STATE z80state;
-extern uint8_t dataOnBus;
+extern Z80_CONTEXT z80ctx;
+#define z80state (z80ctx.state)
+#define z80mem (z80ctx.mem)
 
 void z80_set_clock(uint32_t fClkHz);
 uint32_t z80_get_clock(void);
 void z80_init(void);
 void z80cpu_run(void);
+void z80cpu_start(void);
 void z80cpu_stop(void);
 #endif
@@ -360,7 +360,9 @@ static void regs_update(bool all)
 
    uint8_t l;
    uint16_t *lastReg = (uint16_t *)&lastState;
-   uint8_t flags = lastState.registers.byte[Z80_F] ^= z80state.registers.byte[Z80_F];
+   uint8_t flags;
+   Z80FlagsSync(&z80ctx);
+   flags = lastState.registers.byte[Z80_F] ^= z80state.registers.byte[Z80_F];
    text_colour(layout.regs.fg, layout.regs.bg);
    if (all)
       for (uint8_t l = 0; l < uTerm.lines-5; l++)
@@ -16,16 +16,28 @@
 #define SYX_FLAGS       (Z80_S_FLAG | Z80_Y_FLAG | Z80_X_FLAG)
 #define HC_FLAGS        (Z80_H_FLAG | Z80_C_FLAG)
 
-#define A               (z80state.registers.byte[Z80_A])
-#define F               (z80state.registers.byte[Z80_F])
-#define B               (z80state.registers.byte[Z80_B])
-#define C               (z80state.registers.byte[Z80_C])
+#define A               (ctx->state.registers.byte[Z80_A])
+#ifdef Z80_LAZY_FLAGS
+#define F               (*(ctx->lazy.op ? (Z80FlagsSync(ctx), &ctx->state.registers.byte[Z80_F]) \
+                                        : &ctx->state.registers.byte[Z80_F]))
+#else
+#define F               (ctx->state.registers.byte[Z80_F])
+#endif
+#define B               (ctx->state.registers.byte[Z80_B])
+#define C               (ctx->state.registers.byte[Z80_C])
 
-#define AF              (z80state.registers.word[Z80_AF])
-#define BC              (z80state.registers.word[Z80_BC])
-#define DE              (z80state.registers.word[Z80_DE])
-#define HL              (z80state.registers.word[Z80_HL])
-#define SP              (z80state.registers.word[Z80_SP])
+#ifdef Z80_LAZY_FLAGS
+#define AF              (*(ctx->lazy.op ? (Z80FlagsSync(ctx), &ctx->state.registers.word[Z80_AF]) \
+                                        : &ctx->state.registers.word[Z80_AF]))
+#define FLAGS_SYNC()    { if (ctx->lazy.op) Z80FlagsSync(ctx); }
+#else
+#define AF              (ctx->state.registers.word[Z80_AF])
+#define FLAGS_SYNC()
+#endif
+#define BC              (ctx->state.registers.word[Z80_BC])
+#define DE              (ctx->state.registers.word[Z80_DE])
+#define HL              (ctx->state.registers.word[Z80_HL])
+#define SP              (ctx->state.registers.word[Z80_SP])
 
 #define HL_IX_IY        *((uint16_t *) registers[6])
 
@@ -43,56 +55,90 @@
  */
 
 #define R(r)            *((uint8_t *) (registers[(r)]))
-#define S(s)            *((uint8_t *) register_table[(s)])
+#define S(s)            *((uint8_t *) ctx->register_table[(s)])
 #define RR(rr)          *((uint16_t *) registers[(rr) + 8])
 #define SS(ss)          *((uint16_t *) registers[(ss) + 12])
 #define CC(cc)          ((F ^ XOR_CONDITION_TABLE[(cc)])                \
                          & AND_CONDITION_TABLE[(cc)])
 #define DD(dd)          CC(dd)
 
-/* Macros to read constants, displacements, or addresses from code. */
-
-#define READ_N(n)	n = Z80_FETCH_BYTE(z80state.pc++) // elapsed_cycles += 3;
-
-#define READ_NN(nn) {nn = Z80_FETCH_WORD(z80state.pc);\
-		z80state.pc += 2;} //elapsed_cycles += 6;
-
-#define READ_D(d)	{d = Z80_FETCH_BYTE(z80state.pc++);} //elapsed_cycles += 3; 
-
-/* Macros to read and write data. */
-#define CONTENDED 0
+/* ULA contention. ulaT is the T-state of the current machine cycle counted
+ * from the instruction's start, a bus access looks its delay up at the line
+ * position ctx->ulaLineT + ulaT + ulaWait and moves ulaT past its cycle
+ * (4 for an opcode fetch, 3 for a memory access). ULA_CYCLES() are the
+ * internal cycles which keep an address on the bus, contended one T-state at
+ * a time. The delays are accumulated in ulaWait and added to the
+ * instruction's T-states once the instruction is done (see exec_done()).
+ */
+#define CONTENDED 1
 #if CONTENDED
-#define READ_BYTE(address)	Z80_READ_BYTE(address) // elapsed_cycles += 3;
-#define WRITE_BYTE(address, x)	if (address > 16394 && address < 32768) TSTATES_ADD(10); Z80_WRITE_BYTE((address), (x)) // elapsed_cycles += 3; 
-#define READ_WORD(address)  Z80_READ_WORD(address) // elapsed_cycles += 6; 
-#define WRITE_WORD(address, x) if (address > 16394 && address < 32768) TSTATES_ADD(10); Z80_WRITE_WORD((address), (x)) //  elapsed_cycles += 6; 
+#define ULA_POS()		(ctx->ulaLineT + ulaT + ulaWait)
+#define ULA_CONTEND(address, n)	(ulaWait += ULA_MEM_DELAY(ULA_POS(), address), ulaT += (n))
+#define ULA_CONTEND_T(n)	(ulaWait += ULA_DELAY(ULA_POS()), ulaT += (n))
+#define ULA_CYCLES(address, n)                                          \
+	{                                                                       \
+		if (UlaContendedPage[(uint16_t)(address) >> 14])                \
+			for (uint8_t c = 0; c < (n); c++)                       \
+				ULA_CONTEND_T(1);                               \
+		else                                                            \
+			ulaT += (n);                                            \
+	}
+/* I/O cycle, 4 T-states: a high byte in 0x40-0x7f contends every T-state as a
+ * memory address, the ULA port (A0 = 0) contends the last 3 T-states.
+ */
+#define ULA_CONTEND_IO(port)                                            \
+	(UlaContendedPage[(uint16_t)(port) >> 14]                               \
+	 ? (((port) & 0x01) ? (ULA_CONTEND_T(1), ULA_CONTEND_T(1), ULA_CONTEND_T(1), ULA_CONTEND_T(1)) \
+	                    : (ULA_CONTEND_T(1), ULA_CONTEND_T(3)))              \
+	 : (((port) & 0x01) ? (ulaT += 4) : (ulaT += 1, ULA_CONTEND_T(3))))
+#define READ_BYTE(address)	(ULA_CONTEND(address, 3), Z80_READ_BYTE(address)) // elapsed_cycles += 3;
+#define WRITE_BYTE(address, x)	{ULA_CONTEND(address, 3); Z80_WRITE_BYTE((address), (x));} // elapsed_cycles += 3; 
+#define READ_WORD(address)  (ULA_CONTEND(address, 3), ULA_CONTEND((address) + 1, 3), Z80_READ_WORD(address)) // elapsed_cycles += 6; 
+#define WRITE_WORD(address, x) {ULA_CONTEND(address, 3); ULA_CONTEND((address) + 1, 3); Z80_WRITE_WORD((address), (x))} //  elapsed_cycles += 6; 
 #else
+#define ULA_CONTEND(address, n)	(0)
+#define ULA_CYCLES(address, n)
+#define ULA_CONTEND_IO(port)	(0)
 #define READ_BYTE(address)	Z80_READ_BYTE(address) // elapsed_cycles += 3;
 #define WRITE_BYTE(address, x)	Z80_WRITE_BYTE((address), (x)) // elapsed_cycles += 3; 
 #define READ_WORD(address)  Z80_READ_WORD(address) // elapsed_cycles += 6; 
 #define WRITE_WORD(address, x) Z80_WRITE_WORD((address), (x)) //  elapsed_cycles += 6; 
 #endif
+/// internal cycles with the IR register pair on the address bus
+#define ULA_CYCLES_IR(n)	ULA_CYCLES((uint16_t)ctx->state.i << 8, n)
+
+/* Macros to read constants, displacements, or addresses from code. */
+
+#define READ_N(n)	{ULA_CONTEND(ctx->state.pc, 3); n = Z80_FETCH_BYTE(ctx->state.pc++);} // elapsed_cycles += 3;
+
+#define READ_NN(nn) {ULA_CONTEND(ctx->state.pc, 3); ULA_CONTEND(ctx->state.pc + 1, 3);\
+		nn = Z80_FETCH_WORD(ctx->state.pc);\
+		ctx->state.pc += 2;} //elapsed_cycles += 6;
+
+#define READ_D(d)	{ULA_CONTEND(ctx->state.pc, 3); d = Z80_FETCH_BYTE(ctx->state.pc++);} //elapsed_cycles += 3; 
 /* Indirect (HL) and indexed (IX + d) or (IY + d) memory operands read and
  * write macros.
  */
 #define READ_INDIRECT_HL(x)                                             \
 	{                                                                       \
-		if (registers == register_table) {			\
+		if (registers == ctx->register_table) {			\
 			x = READ_BYTE(HL);                                     \
 		} else {                                                        \
 			int8_t d;                                              \
 			READ_D(d);                                              \
+			ULA_CYCLES(ctx->state.pc - 1, 5);                       \
 			x = READ_BYTE(HL_IX_IY+d);                                      \
 		}                                                               \
 	}
     
 #define WRITE_INDIRECT_HL(x)                                            \
 	{                                                                       \
-		if (registers == register_table) {			\
+		if (registers == ctx->register_table) {			\
 			WRITE_BYTE(HL, (x));                                    \
 		} else {                                                        \
 			int8_t d;                                              \
 			READ_D(d);                                              \
+			ULA_CYCLES(ctx->state.pc - 1, 5);                       \
 			WRITE_BYTE((HL_IX_IY+d), (x));                                     \
 		}                                                               \
 	}    
@@ -102,7 +148,9 @@
 #define PUSH(x)                                                         \
 	{                                                                       \
 		SP -= 2;                                                        \
-		WRITE_WORD(SP, (x));                                            \
+		ULA_CONTEND(SP + 1, 3); /* the high byte goes first */          \
+		ULA_CONTEND(SP, 3);                                             \
+		Z80_WRITE_WORD(SP, (x));                                        \
 	}
 
 #define POP(x)                                                          \
@@ -124,6 +172,113 @@
 
 /* 8-bit arithmetic and logic operations. */
 
+#ifdef Z80_LAZY_FLAGS
+
+/* Lazy flags versions: record the operation, Z80FlagsSync() computes F. */
+
+#define LAZY_CARRY()    (ctx->lazy.op >= Z80_LAZY_INC ? ctx->lazy.c           \
+                         : ctx->lazy.op ? (ctx->lazy.z >> 8) & Z80_C_FLAG     \
+                         : ctx->state.registers.byte[Z80_F] & Z80_C_FLAG)
+
+#define LAZY_RECORD(o, a_, x_, z_)                                      \
+	{                                                                       \
+		ctx->lazy.op = (o);                                             \
+		ctx->lazy.a = (a_);                                             \
+		ctx->lazy.x = (x_);                                             \
+		ctx->lazy.z = (z_);                                             \
+	}
+
+#define ADD(x)                                                          \
+	{                                                                       \
+		int     a, z;                                                   \
+		\
+		a = A;                                                          \
+		z = a + (x);                                                    \
+		LAZY_RECORD(Z80_LAZY_ADD, a, (x), z);                           \
+		A = z;                                                          \
+	}
+
+#define ADC(x)                                                          \
+	{                                                                       \
+		int     a, z;                                                   \
+		\
+		a = A;                                                          \
+		z = a + (x) + LAZY_CARRY();                                     \
+		LAZY_RECORD(Z80_LAZY_ADD, a, (x), z);                           \
+		A = z;                                                          \
+	}
+
+#define SUB(x)                                                          \
+	{                                                                       \
+		int     a, z;                                                   \
+		\
+		a = A;                                                          \
+		z = a - (x);                                                    \
+		LAZY_RECORD(Z80_LAZY_SUB, a, (x), z);                           \
+		A = z;                                                          \
+	}
+
+#define SBC(x)                                                          \
+	{                                                                       \
+		int     a, z;                                                   \
+		\
+		a = A;                                                          \
+		z = a - (x) - LAZY_CARRY();                                     \
+		LAZY_RECORD(Z80_LAZY_SUB, a, (x), z);                           \
+		A = z;                                                          \
+	}
+
+#define AND(x)                                                          \
+	{                                                                       \
+		A &= (x);                                                       \
+		ctx->lazy.op = Z80_LAZY_AND;                                    \
+		ctx->lazy.z = A;                                                \
+	}
+
+#define OR(x)                                                           \
+	{                                                                       \
+		A |= (x);                                                       \
+		ctx->lazy.op = Z80_LAZY_LOGIC;                                  \
+		ctx->lazy.z = A;                                                \
+	}
+
+#define XOR(x)                                                          \
+	{                                                                       \
+		A ^= (x);                                                       \
+		ctx->lazy.op = Z80_LAZY_LOGIC;                                  \
+		ctx->lazy.z = A;                                                \
+	}
+
+#define CP(x)                                                           \
+	{                                                                       \
+		int     a;                                                      \
+		\
+		a = A;                                                          \
+		LAZY_RECORD(Z80_LAZY_CP, a, (x), a - (x));                      \
+	}
+
+#define INC(x)                                                          \
+	{                                                                       \
+		int     z;                                                      \
+		\
+		z = (x) + 1;                                                    \
+		ctx->lazy.c = LAZY_CARRY();                                     \
+		LAZY_RECORD(Z80_LAZY_INC, (x), 0, z);                           \
+		(x) = z;                                                        \
+	}
+
+#define DEC(x)                                                          \
+	{                                                                       \
+		int     z;                                                      \
+		\
+		z = (x) - 1;                                                    \
+		ctx->lazy.c = LAZY_CARRY();                                     \
+		LAZY_RECORD(Z80_LAZY_DEC, (x), 0, z);                           \
+		(x) = z;                                                        \
+	}
+
+#else
+
 #define ADD(x)                                                          \
 	{                                                                       \
 		int     a, z, c, f;                                             \
@@ -259,6 +414,8 @@
 		F = f;                                                          \
 	}
 
+#endif /* Z80_LAZY_FLAGS */
+
 /* 0xcb prefixed logical operations. */
 
 #define RLC(x)                                                          \
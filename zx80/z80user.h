@@ -36,7 +36,7 @@ extern "C" {
  *
  * All macros have access to the following three variables:
  *
- *      state           Pointer to the current Z80_STATE. Because the 
+ *      ctx             Pointer to the current Z80_CONTEXT. Because the 
  *			instruction is currently executing, its members may not
  *			be fully up to date, depending on when the macro is 
  *			called in the process. It is rather suggested to access 
@@ -65,9 +65,9 @@ extern "C" {
  *      registers       Current register decoding table, use it to determine if
  * 			the current instruction is prefixed. It points on:
  *                      
- *				state->dd_register_table for 0xdd prefixes; 
- *                      	state->fd_register_table for 0xfd prefixes;
- *				state->register_table otherwise.
+ *				ctx->dd_register_table for 0xdd prefixes; 
+ *                      	ctx->fd_register_table for 0xfd prefixes;
+ *				ctx->register_table otherwise.
  *
  *      pc              Current PC register (upper bits are undefined), points
  *                      on the opcode, the displacement or constant to read for
@@ -91,25 +91,37 @@ extern "C" {
 
 #include "zx80sys.h"
 
-#define Z80_READ_BYTE(address)  z80mem[(address)]
+#define Z80_READ_BYTE(address)  ctx->mem[(address)]
 
 #define Z80_FETCH_BYTE(address)		Z80_READ_BYTE(address)
 
-#define Z80_READ_WORD(address) ((uint16_t)z80mem[(address)+1] << 8) + z80mem[(address)];
+#define Z80_READ_WORD(address) (((uint16_t)ctx->mem[(address)+1] << 8) + ctx->mem[(address)])
 #define Z80_FETCH_WORD(address)		Z80_READ_WORD(address)
 
-#define Z80_WRITE_BYTE(address, x) z80mem[address] = (uint8_t)(x)
+#define Z80_WRITE_BYTE(address, x) ctx->mem[address] = (uint8_t)(x)
 
 #define Z80_WRITE_WORD(address, x)                                      \
 {                                                                       \
-	z80mem[address] = (uint8_t)(x);\
-	z80mem[address+1] = (uint8_t)((x) >> 8);\
+	ctx->mem[address] = (uint8_t)(x);\
+	ctx->mem[address+1] = (uint8_t)((x) >> 8);\
 }
 
 #define Z80_READ_WORD_INTERRUPT(address)	Z80_READ_WORD(address)
 #define Z80_WRITE_WORD_INTERRUPT(address, x)	Z80_WRITE_WORD((address), (x))
-#define Z80_INPUT_BYTE(port) z80sys_input(port)
-#define Z80_OUTPUT_BYTE(port, data) z80sys_output(port,data)
+#define Z80_INPUT_BYTE(port) (ULA_CONTEND_IO(port), z80sys_input(ctx, port))
+#define Z80_OUTPUT_BYTE(port, data) {ULA_CONTEND_IO(port); z80sys_output(ctx, port,data);}
+
+/* The instruction timing drives the CPU timer: Z80_TIMING_SET() loads the
+ * compare value with the opcode's base time and Z80_TIMING_ADD() extends it
+ * by the extra states. Define both empty to run the core without the timer.
+ */
+#ifdef HOST_BUILD
+#define Z80_TIMING_SET(ticks)
+#define Z80_TIMING_ADD(ticks)
+#else
+#define Z80_TIMING_SET(ticks)	tmrZ80Cpu->CC[0].reg = (ticks)
+#define Z80_TIMING_ADD(ticks)	tmrZ80Cpu->CC[0].reg += (ticks)
+#endif
 
 #ifdef __cplusplus
 }
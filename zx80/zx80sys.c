@@ -31,22 +31,39 @@
 #include "zx80sys.h"
 #include "z80macros.h"
 #include "z80user.h"
+#include "ay8912.h"
 
-uint8_t *z80mem = NULL;
-
-uint8_t borderRGB = 0;
+_zx_machine_t zxMachine = {.keyRows = keyRows};
 
 volatile bool zx50HzSignal = true;
 volatile uint16_t addrMatch = 0xFFFF;
 
 TcCount16 *tmrZX50Hz = (TcCount16 *)TC1;
 
+uint8_t UlaContention[4][ULA_LINE_TABLE_SIZE]; // indexed by ULA_LINE_TYPE()
+const uint8_t UlaContendedPage[4] = {0x00, 0xff, 0x00, 0x00};
+
+void ula_init(void)
+{
+   static const uint8_t contPattern[8] = {6, 5, 4, 3, 2, 1, 0, 0};
+   memset(UlaContention, 0, sizeof(UlaContention));
+   for (uint8_t type = 0; type < 4; type++)
+      for (uint16_t i = 0; i < ULA_CONTENDED_TSTATES; i++)
+      {
+         if (type & 0x01) // display line
+            UlaContention[type][i] = contPattern[i & 0x07];
+         if (type & 0x02) // followed by a display line
+            UlaContention[type][ULA_LINE_TSTATES + i] = contPattern[i & 0x07];
+      }
+}
+
+#ifndef HOST_BUILD
 void int50Hz_init(void)
 {
    REG_MCLK_APBAMASK |= MCLK_APBAMASK_TC1;            // enable TC1 clock
    REG_GCLK_PCHCTRL9 = CLK_60MHZ | GCLK_PCHCTRL_CHEN; // GCLK peripheral TC0 and TC1 clock @ 12MHz
    tmrZX50Hz->CTRLA.bit.PRESCALER = 0x05;             // 60MHz / 64 = 937.5KHz
-   tmrZX50Hz->CC[0].reg = 18750 + 300;                // 937.5KHz / 18750 = 50Hz
+   tmrZX50Hz->CC[0].reg = ZX_FRAME_PERIOD;            // 937.5KHz / 18750 = 50Hz
    tmrZX50Hz->INTENSET.bit.OVF = 1;                   // enable interrupt
    tmrZX50Hz->INTENSET.bit.MC0 = 1;                   // enable interrupt
    tmrZX50Hz->WAVE.reg = 0x01;                        // Match compare
@@ -63,55 +80,46 @@ void int50Hz_stop(void)
 {
    tmrZX50Hz->CTRLBSET.bit.CMD = 0x02; // stop the timer
 }
+#endif
+
+/// Publish the speaker log, count the frame and raise the ULA interrupt
+static void __attribute__((long_call, section(".ramfunc"), optimize("3"))) zx_frame_interrupt(Z80_CONTEXT *ctx)
+{
+   ctx->machine->frames++;
+   ay_frame(&ctx->machine->ay);
+   Z80Interrupt(ctx);
+}
+
+/// Frame boundary of a machine run to the frame end: the T-states past it are carried into the next frame
+void __attribute__((long_call, section(".ramfunc"), optimize("3"))) zx_frame(Z80_CONTEXT *ctx)
+{
+   ULA_FRAME_CARRY(ctx);
+   zx_frame_interrupt(ctx);
+}
+
+/// Run a machine for one frame without the timers: the instructions up to the frame end, then the frame interrupt
+void zx_run_frame(Z80_CONTEXT *ctx)
+{
+   while (ULA_FRAME_T(ctx) < ULA_FRAME_TSTATES)
+      z80_step(ctx);
+   zx_frame(ctx);
+}
 
-void __attribute__((long_call, section(".ramfunc"), optimize("3"))) Z80Interrupt(void)
+#ifndef HOST_BUILD
+/// 50Hz frame interrupt
+void __attribute__((long_call, section(".ramfunc"), optimize("3"))) TC1_Handler(void)
 {
-   z80state.status = 0;
    zx50HzSignal = true;
-   if (z80state.iff1)
-   {
-      z80state.iff1 = z80state.iff2 = 0;
-      z80state.r = (z80state.r & 0x80) | ((z80state.r + 1) & 0x7f);
-      switch (z80state.im)
-      {
-      case Z80_INTERRUPT_MODE_0:
-      {
-         /* Assuming the opcode in data_on_bus is an
-          * RST instruction, accepting the interrupt
-          * should take 2 + 11 = 13 cycles.
-          */
-         // tmrZ80Cpu->CC[0].reg = clkZ80div*13;
-         asm("nop");
-         break; // Not used in ZX Spectrum
-      }
-      case Z80_INTERRUPT_MODE_1:
-      {
-         SP -= 2;
-         Z80_WRITE_WORD_INTERRUPT(SP, z80state.pc);
-         z80state.pc = 0x0038;
-         // tmrZ80Cpu->CC[0].reg = clkZ80div*13;
-         break;
-      }
-      case Z80_INTERRUPT_MODE_2:
-      default:
-      {
-         uint16_t vector;
-         SP -= 2;
-         Z80_WRITE_WORD_INTERRUPT(SP, z80state.pc);
-         vector = ((uint16_t)z80state.i) << 8 | dataOnBus;
-#ifdef Z80_MASK_IM2_VECTOR_ADDRESS
-         vector &= 0xfffe;
-#endif
-         z80state.pc = Z80_READ_WORD_INTERRUPT(vector);
-      }
-      }
-   }
+   ULA_FRAME_START(&z80ctx); // the timer doesn't follow the T-states, the frame starts over
+   zx_frame_interrupt(&z80ctx);
    CLEAR_Z80_INT_FLAGS();
 }
+#endif
 
-uint8_t __attribute__((long_call, section(".ramfunc"), optimize("3"))) z80sys_input(uint16_t port)
-// uint8_t __attribute__((long_call, section(".ramfunc"), optimize("0"))) z80sys_input(uint16_t port)
+uint8_t __attribute__((long_call, section(".ramfunc"), optimize("3"))) z80sys_input(Z80_CONTEXT *ctx, uint16_t port)
+// uint8_t __attribute__((long_call, section(".ramfunc"), optimize("0"))) z80sys_input(Z80_CONTEXT *ctx, uint16_t port)
 {
+   _zx_machine_t *zx = ctx->machine;
    uint8_t micBit;
    uint8_t hPort;
    switch ((uint8_t)port)
@@ -131,45 +139,39 @@ uint8_t __attribute__((long_call, section(".ramfunc"), optimize("3"))) z80sys_in
    case 0xfe:        // KEYBOARD and EAR input port
       micBit = 0xff; // 0xBF; // TODO: need to connect to real port
       hPort = port >> 8;
-      addWaitStates = 4;
-      if (hPort >= 0x40 && hPort <= 0x7f && !(port & 0x01))
-         addWaitStates = 3;
       for (uint8_t i = 0; i < 8; i++, hPort >>= 1)
          if (!(hPort & 0x01))
-            micBit &= keyRows[i];
-      if (!AC->STATUSA.bit.STATE0) // read Aanalog Comparator 0 output
-      {
+            micBit &= zx->keyRows[i];
+      if (!ZX_EAR_INPUT())
          micBit &= ~(0x1 << 6);
-         DAC->DATA[1].reg = 0;
-      }
-      else
-         DAC->DATA[1].reg = 500;
+      ay_beeper(&zx->ay, ULA_FRAME_T(ctx), AY_EAR_ON, ZX_EAR_INPUT()); // EAR monitor, mixed apart from the OUT level
       return micBit;
       break;
+   case 0xfd: // AY-3-8912
+      if (AY_PORT_SELECT(port))
+         return ay_read(&zx->ay);
+      break;
    }
    return 0xff;
 }
 
-void __attribute__((long_call, section(".ramfunc"), optimize("3"))) z80sys_output(uint16_t port, uint8_t data)
+void __attribute__((long_call, section(".ramfunc"), optimize("3"))) z80sys_output(Z80_CONTEXT *ctx, uint16_t port, uint8_t data)
 {
+   _zx_machine_t *zx = ctx->machine;
    switch ((uint8_t)port)
    {
    case 0x3b: // UART
       break;
    case 0xfe: // ear, mic and border
-      uint8_t hPort = (port >> 8);
-      addWaitStates = 4;
-      if (hPort >= 0x40 && hPort <= 0x7f && !(port & 0x01))
-         addWaitStates = 3;
-      if (data & 0x10)
-         DAC->DATA[1].reg = sysConf.volume;
-      else
-         DAC->DATA[1].reg = 0;
-      if (data & 0x08)
-         DAC->DATA[0].reg = 2000; // AIO_PIN_DACOUT 0-1.5V
-      else
-         DAC->DATA[0].reg = 0;
-      borderRGB = ZxColour[0][data & 0x07]; // set border colour
+      ay_beeper(&zx->ay, ULA_FRAME_T(ctx), AY_BEEPER_ON, data & 0x10);
+      ZX_MIC_OUTPUT(data & 0x08);
+      zx->border = data & 0x07; // set border colour
+      break;
+   case 0xfd: // AY-3-8912
+      if (AY_PORT_SELECT(port))
+         ay_select(&zx->ay, data);
+      else if (AY_PORT_DATA(port))
+         ay_write(&zx->ay, data);
       break;
    }
 }
@@ -32,9 +32,73 @@
 
 #define WII_ADDRESS 0x00a4
 
+/// 50Hz frame timer, 60MHz clock
+#define ZX_FRAME_PRESCALER 64          // 60MHz / 64 = 937.5KHz
+#define ZX_FRAME_PERIOD    (18750 + 300) // 937.5KHz / 18750 = 50Hz
+
+/// ULA memory contention, 48K frame timing
+#define ULA_LINE_TSTATES         224   // T-states per scan line
+#define ULA_CONTENDED_TSTATES    128   // contended T-states at the beginning of a display line
+#define ULA_FIRST_CONTENDED_LINE 64    // first display line, starts at T-state 14335
+#define ULA_CONTENDED_LINES      192
+#define ULA_LINE_TABLE_SIZE      384   // line table + the next line's start, an instruction may cross the line end
+#define ULA_FRAME_LINES          312
+#define ULA_FRAME_TSTATES        (ULA_FRAME_LINES * ULA_LINE_TSTATES)
+
 #include "z80cpu.h"
+#include "ay8912.h"
+
+/** I/O state of one emulated Spectrum. The port handlers, the renderer and the AY work on
+ *  the machine of the context they are called with (ctx->machine).
+ */
+typedef struct _zx_machine_s
+{
+   uint8_t *keyRows; // keyboard half rows, a pressed key reads 0
+   uint8_t border;   // border colour, ZxColour index
+   uint32_t frames;  // frames since the power on
+   _ay_t ay;         // AY-3-8912 and the speaker edge log
+} _zx_machine_t;
+
+/** The line position is counted from T-state 14335 of the frame (the first contended cycle),
+ *  so at the interrupt the CPU is at position 1 of the line 0 and the display starts at line 64. */
+#define ULA_FRAME_START(ctx)                   \
+   {                                           \
+      (ctx)->ulaScanLine = 0;                  \
+      (ctx)->ulaLineT = 1;                     \
+      (ctx)->ulaLine = UlaContention[0];       \
+   }
+/// T-states since the frame interrupt
+#define ULA_FRAME_T(ctx) ((uint32_t)(ctx)->ulaScanLine * ULA_LINE_TSTATES + (ctx)->ulaLineT - 1)
+/// line table: bit 0 - the line is a display line, bit 1 - the next one is, its start follows in the slack
+#define ULA_DISPLAY_LINE(line) ((uint16_t)((line) - ULA_FIRST_CONTENDED_LINE) < ULA_CONTENDED_LINES)
+#define ULA_LINE_TYPE(line)    (ULA_DISPLAY_LINE(line) | (ULA_DISPLAY_LINE((line) + 1) << 1))
+/// a frame run to its end starts the next one at the T-states the last instruction ran past the end
+#define ULA_FRAME_CARRY(ctx)                                                \
+   {                                                                        \
+      uint32_t over = ULA_FRAME_T(ctx) - ULA_FRAME_TSTATES;                 \
+      (ctx)->ulaScanLine = over / ULA_LINE_TSTATES;                         \
+      (ctx)->ulaLineT = over % ULA_LINE_TSTATES + 1;                        \
+      (ctx)->ulaLine = UlaContention[ULA_LINE_TYPE((ctx)->ulaScanLine)];    \
+   }
+#define ULA_NEXT_LINE(ctx)                                           \
+   {                                                                 \
+      (ctx)->ulaLineT -= ULA_LINE_TSTATES;                           \
+      (ctx)->ulaScanLine++;                                          \
+      (ctx)->ulaLine = UlaContention[ULA_LINE_TYPE((ctx)->ulaScanLine)]; \
+   }
+/// contention delay at the line position t
+#define ULA_DELAY(t) (ctx->ulaLine[(t)])
+/// contention delay of a memory access at the line position t, a single lookup (pages 0x4000-0x7fff only)
+#define ULA_MEM_DELAY(t, address) (ULA_DELAY(t) & UlaContendedPage[(uint16_t)(address) >> 14])
 #define CLEAR_Z80_INT_FLAGS() tmrZX50Hz->INTFLAG.reg = tmrZX50Hz->INTFLAG.reg
-#define  Z80Interrupt TC1_Handler
+/// tape signal pins: EAR in through the Analog Comparator, MIC out on the DAC
+#ifdef HOST_BUILD
+#define ZX_EAR_INPUT()    1 // no tape, the comparator idles high
+#define ZX_MIC_OUTPUT(on)
+#else
+#define ZX_EAR_INPUT()    (AC->STATUSA.bit.STATE0)
+#define ZX_MIC_OUTPUT(on) DAC->DATA[0].reg = (on) ? 2000 : 0 // AIO_PIN_DACOUT 0-1.5V
+#endif
 
 /// Internal flash partition
 #define SNAPS_FLASH_SIZE    0x00060000
@@ -61,19 +125,22 @@ enum
     SP_SSP_MNB
 };
 
-uint8_t z80sys_input(uint16_t port);
-void z80sys_output(uint16_t port,uint8_t data);
+uint8_t z80sys_input(Z80_CONTEXT *ctx, uint16_t port);
+void z80sys_output(Z80_CONTEXT *ctx, uint16_t port,uint8_t data);
 void zx80_task(void *vParam);
+void zx_frame(Z80_CONTEXT *ctx);
+void zx_run_frame(Z80_CONTEXT *ctx);
 
 extern volatile bool zx50HzSignal;
 extern volatile uint16_t addrMatch;
 extern _flash_snaps_partition_t *snapStorage;
-extern uint8_t *z80mem;//[Z80SYS_MEMORY_SIZE];
-extern uint8_t borderRGB;
-extern Z80_STATE z80state;
+extern _zx_machine_t zxMachine; // the firmware's machine, z80ctx.machine
 extern uint8_t keyRows[8];
+extern uint8_t UlaContention[4][ULA_LINE_TABLE_SIZE];
+extern const uint8_t UlaContendedPage[4];
 extern TcCount16 *tmrZX50Hz;
 void int50Hz_init(void);
 void int50Hz_start(void);
 void int50Hz_stop(void);
+void ula_init(void);
 #endif //Z80SYS_H_INCLUDED
\ No newline at end of file
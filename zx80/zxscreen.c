@@ -32,7 +32,6 @@
 #include "bsp.h"
 #include "lcd.h"
 #include "task.h"
-#include "timers.h"
 #include "zx80sys.h"
 #include "keyboard.h"
 
@@ -78,71 +77,74 @@ uint8_t zxBorderColour = _rgb(BASE_TONE, BASE_TONE, BASE_TONE); // should be upd
 //  display coord:   32,24    287,24
 //                   32,215   287,215
 
-static uint8_t *screenMem;
-static uint8_t *attrMem;
-
 uint16_t attrColorTable[256];
-uint8_t flash;        // 3Hz flash flag
-TimerHandle_t xFlash; // 3 Hz flash timer
-void on_flash_timer(TimerHandle_t xTimer)
+/// the ULA swaps ink and paper of the flashing attributes every 16 frames
+#define ZX_FLASH(frames) (((frames) & 0x10) ? 0x80 : 0x00)
+#if 1
+void zx_screen_init(void)
 {
-   flash = flash ? 0x00 : 0x80;
+   uint16_t i;
+   for (i = 0; i < 256; i++)
+      attrColorTable[i] = ZxColour[(i & 0x40) ? 1 : 0][(i & 0x80) ? (i & 0x07) : ((i >> 3) & 0x07)];
 }
-#if 1
-void __attribute__((long_call, section(".ramfunc"), optimize("3"))) lcd_zx_task(void *vParam)
+
+/** Render the ZX screen of a machine with the border into a 320x240 frame buffer */
+void __attribute__((long_call, section(".ramfunc"), optimize("3"))) zx_render_frame(Z80_CONTEXT *ctx, uint8_t *lcdData)
 {
    uint16_t i, j;
-   uint8_t *lcdData;
    uint8_t *attr;
    uint8_t *byte;
-   if ((xFlash = xTimerCreate("flash", 330, pdTRUE, (void *)0, on_flash_timer)) != NULL)
-      xTimerStart(xFlash, 0);
-   screenMem = (uint8_t *)(z80mem + 0x4000);
-   attrMem = (uint8_t *)(z80mem + 0x5800);
-   for (i = 0; i < 256; i++)
-      attrColorTable[i] = ZxColour[(i & 0x40) ? 1 : 0][(i & 0x80) ? (i & 0x07) : ((i >> 3) & 0x07)];
-   DIO0_PORT.DIRSET.reg = DIO0_PIN_WO1;
-   while (1)
+   uint8_t *screenMem = ctx->mem + 0x4000;
+   uint8_t *attrMem = ctx->mem + 0x5800;
+   uint8_t borderRGB = ZxColour[0][ctx->machine->border];
+   uint8_t flash = ZX_FLASH(ctx->machine->frames);
+   for (j = 0; j < 24; j++) // in order to update the border's colour faster, update 160 pixes of the border's line at once (instead of 320), then yield the tasks.
    {
-    lcdData = frameBuffer;
-    
-     while (!zx50HzSignal)
-        taskYIELD();
-     zx50HzSignal = false;
-      DIO0_PORT.OUTSET.reg = DIO0_PIN_WO1;
-      for (j = 0; j < 24; j++) // in order to update the border's colour faster, update 160 pixes of the border's line at once (instead of 320), then yield the tasks.
-      {
-         for (i = 0; i < 320; i++)
-            *lcdData++ = borderRGB;
+      for (i = 0; i < 320; i++)
+         *lcdData++ = borderRGB;
 /*         lcdData -= 128;
          for (i = 0; i < 128; i++)
             *lcdData++ = borderRGB;*/
-      }
-      for (uint8_t block = 0; block < 3; block++)
+   }
+   for (uint8_t block = 0; block < 3; block++)
+   {
+      for (i = 0; i < 64; i++)
       {
-         for (i = 0; i < 64; i++)
+         for (j = 0; j < 32; j++)
+            *lcdData++ = borderRGB;
+         attr = &attrMem[((i + block * 64) / 8 * 32)];
+         byte = &screenMem[(block * 2048) + (((i & 0x07) * 256) + ((i >> 3) * 32))];
+         for (uint8_t by = 0; by < 32; by++, attr++, byte++) // display horisontal line
          {
-            for (j = 0; j < 32; j++)
-               *lcdData++ = borderRGB;
-            attr = &attrMem[((i + block * 64) / 8 * 32)];
-            byte = &screenMem[(block * 2048) + (((i & 0x07) * 256) + ((i >> 3) * 32))];
-            for (uint8_t by = 0; by < 32; by++, attr++, byte++) // display horisontal line
-            {
-               uint8_t bb = (flash & *attr) ? ~*byte : *byte;
-               for (uint8_t p = 0; p < 8; p++, bb <<= 1)
-                  *lcdData++ = attrColorTable[(bb & 0x80) ? (*attr | 0x80) : (*attr & 0x7f)];
-            }
-            for (j = 0; j < 32; j++)
-               *lcdData++ = borderRGB;
-            //taskYIELD();
+            uint8_t bb = (flash & *attr) ? ~*byte : *byte;
+            for (uint8_t p = 0; p < 8; p++, bb <<= 1)
+               *lcdData++ = attrColorTable[(bb & 0x80) ? (*attr | 0x80) : (*attr & 0x7f)];
          }
-      }
-      for (j = 0; j < 24; j++)
-      {
-         for (i = 0; i < 320; i++)
+         for (j = 0; j < 32; j++)
             *lcdData++ = borderRGB;
          //taskYIELD();
       }
+   }
+   for (j = 0; j < 24; j++)
+   {
+      for (i = 0; i < 320; i++)
+         *lcdData++ = borderRGB;
+      //taskYIELD();
+   }
+}
+
+#ifndef HOST_BUILD
+void __attribute__((long_call, section(".ramfunc"), optimize("3"))) lcd_zx_task(void *vParam)
+{
+   zx_screen_init();
+   DIO0_PORT.DIRSET.reg = DIO0_PIN_WO1;
+   while (1)
+   {
+     while (!zx50HzSignal)
+        taskYIELD();
+     zx50HzSignal = false;
+      DIO0_PORT.OUTSET.reg = DIO0_PIN_WO1;
+      zx_render_frame(&z80ctx, frameBuffer);
       DIO0_PORT.OUTCLR.reg = DIO0_PIN_WO1;
       vSync = true; // start LCD flush
       // kbdScanRow = true; // scan next keyboard row
@@ -150,8 +152,11 @@ void __attribute__((long_call, section(".ramfunc"), optimize("3"))) lcd_zx_task(
       //vTaskSuspend(NULL);
    }
 }
+#endif
 
 #else
+static uint8_t *screenMem;
+static uint8_t *attrMem;
 void __attribute__((long_call, section(".ramfunc"), optimize("3"))) flush_zx_screen(void)
 {
    uint16_t i, j;
@@ -124,6 +124,7 @@ void lcd_x(uint16_t x,uint16_t y,uint16_t c);
 /// LCD ZX section
 #include "FreeRTOS.h"
 #include "task.h"
+#include "z80cpu.h"
 
 enum
 {
@@ -134,6 +135,8 @@ enum
 extern const uint8_t ZxColour[2][8]; // color mapping
 extern TaskHandle_t xLcdZxTask;
 void lcd_zx_task(void *vParam);
+void zx_screen_init(void);
+void zx_render_frame(Z80_CONTEXT *ctx, uint8_t *lcdData);
 
 //extern uint8_t *screenMem;
 //extern uint8_t *attrMem;